@@ -137,7 +137,18 @@ double FinalGlideThroughTerrain(const double bearing,
                                 double *retlat, double *retlon,
                                 const double maxrange,
 				bool *outofrange,
-				double *TerrainBase = NULL); 
+				double *TerrainBase = NULL);
+
+// RasterTerrain::mutex locked by caller, thread safe.
+double GlideRangeThroughTerrain(const double irange,
+                                const double bearing,
+                                const double start_lat,
+                                const double start_lon,
+                                const double start_alt,
+                                double *retlat, double *retlon,
+                                const double maxrange,
+                                bool *outofrange,
+                                double *TerrainBase = NULL);
 
 double FarFinalGlideThroughTerrain(const double bearing, NMEA_INFO *Basic, 
                                 DERIVED_INFO *Calculated,
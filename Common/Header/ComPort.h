@@ -17,6 +17,7 @@
 #include "Util/tstring.hpp"
 #include "Poco/Event.h"
 #include "Poco/Thread.h"
+#include "Comm/NmeaLineSplitter.h"
 
 class ComPort : public Poco::Runnable {
 public:
@@ -91,7 +92,17 @@ protected:
 
     virtual unsigned RxThread() = 0;
 
-    void ProcessChar(char c);
+    /**
+     * process chunk of received data :
+     *  whole chunk is given to stream device parser then splitted in NMEA sentences.
+     *  CritSec_Comm must be locked.
+     */
+    void ProcessData(char* data, size_t size);
+
+    // legacy byte by byte interface, same as ProcessData(&c, 1)
+    void ProcessChar(char c) {
+        ProcessData(&c, 1);
+    }
 
     auto GetProcessCharHandler() {
         return [&](char c) {
@@ -104,15 +115,12 @@ protected:
 
 private:
 
-    using _NmeaString_t = TCHAR[MAX_NMEA_LEN];
-
     void run();
 
     const size_t devIdx;
     const tstring sPortName;
 
-    _NmeaString_t _NmeaString;
-    TCHAR * pLastNmea;
+    NmeaLineSplitter<TCHAR, MAX_NMEA_LEN> _NmeaSplitter;
 
     virtual bool Write_Impl(const void *data, size_t size) = 0;
 };
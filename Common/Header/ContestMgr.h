@@ -13,6 +13,12 @@
 
 #include "Trace.h"
 #include "NavFunctions.h"
+#include "Thread/Mutex.hpp"
+#include "Thread/SPSCQueue.hpp"
+#include "Poco/Event.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include <atomic>
 #include <map>
 #include <memory>
 
@@ -36,7 +42,7 @@ class CTestContest;
  */
 
 
-class CContestMgr {
+class CContestMgr : private Poco::Runnable {
 public:
   /** 
    * @brief The type of contest
@@ -106,6 +112,39 @@ public:
     }
   };
 
+  /**
+   * @brief XC triangle values, published by optimizer thread together with results
+   */
+  struct CXCStatus {
+    XCFlightType bestXCType = XCFlightType::XC_INVALID;
+    XCFlightType bestXCTriangleType = XCFlightType::XC_INVALID;
+    XCTriangleStatus FAIStatus = XCTriangleStatus::INVALID;
+    XCTriangleStatus FTStatus = XCTriangleStatus::INVALID;
+
+    double triangleClosurePercentage = 0;
+    double triangleClosureDistance = 0;
+    double triangleDistance = 0;
+    double meanSpeed = 0;
+
+    CPointGPS freeTriangleClosePoint { 0, 0, 0, 0 };
+    double freeTriangleTogo = 0;
+    double freeTriangleBestTogo = 0;
+    CPointGPS FAITriangleClosePoint { 0, 0, 0, 0 };
+    double FAITriangleTogo = 0;
+    double FAITriangleBestTogo = 0;
+    bool FAI = false;
+
+    std::array<TriangleLeg, 3> FAIAssistantLegs;
+    int FAIAssistantMaxLeg = -1;        // index in FAIAssistantLegs, -1 if not yet valid
+    bool looksLikeAFAITriangle = false;
+    int FAITriangleClockwise = 0;
+
+    const TriangleLeg* MaxFAILeg() const {
+      return (FAIAssistantMaxLeg < 0) ? nullptr : &FAIAssistantLegs[FAIAssistantMaxLeg];
+    }
+    CPointGPS XCTriangleClosingPoint() const;
+  };
+
   /**
    * @brief Contest Result
    * 
@@ -165,6 +204,13 @@ private:
   typedef std::unique_ptr<CTrace> CTracePtr;
   typedef std::multimap<unsigned, const CTrace::CPoint *> CDistanceMap;
 
+  struct CFix {
+    unsigned time;
+    double lat;
+    double lon;
+    int alt;
+  };
+
   // Performance knobs
   static const unsigned TRACE_FIX_LIMIT = 100;              /**< @brief The number of GPS fixes to store in the main trace */
   static const unsigned TRACE_TRIANGLE_FIX_LIMIT = 20;      /**< @brief The number of GPS fixes to store in the FAI-OLC trace */
@@ -180,6 +226,8 @@ private:
   static const unsigned TRACE_SPRINT_TIME_LIMIT = 150 * 60; /**< @brief Time limit for OLC-League trace */
   static const unsigned TRACE_FAI_BIG_TRIANGLE_LENGTH = 500 * 1000; /**< @brief Minimum distance for big FAI triangle with lees strict rules */
 
+  static const unsigned FIX_QUEUE_SIZE = 256;                /**< @brief Maximum number of GPS fixes waiting for optimizer */
+
   // Other
   static const unsigned DEFAULT_HANDICAP = 100;
 
@@ -189,6 +237,8 @@ private:
   CTracePtr _traceSprint;                             /**< @brief Trace for OLC-League */
   CTracePtr _traceFreeTriangle;                       /**< @brief Trace for XContest Free Triangle */
   CTracePtr _traceLoop;                               /**< @brief Trace for OLC-League */
+  CTracePtr _traceResult;                             /**< @brief Result trace of OLC-Classic solver, reused */
+  CTracePtr _traceResultSprint;                       /**< @brief Result trace of OLC-League solver, reused */
   std::unique_ptr<CPointGPS> _prevFAIFront;           /**< @brief Last reviewed OLC-FAI loop end points */
   std::unique_ptr<CPointGPS> _prevFAIBack;            /**< @brief Last reviewed OLC-FAI loop end points */
   std::unique_ptr<CPointGPS> _prevFAIPredictedFront;  /**< @brief Last reviewed OLC-FAI Predicted loop end points */
@@ -219,12 +269,25 @@ private:
   TriangleLeg* _maxFAILeg;                                   // pointer to the longest current leg of the triangle to be promoted into a FAI one
   bool _bLooksLikeAFAITriangle;                          /**< @brief does the  FREE Triangle looks like a FAI attempt ?*/
   int _dFAITriangleClockwise;                           /**< @brief 1 clockwise. 1 counter clockwise*/
+  double _dLastFAIDistance;                             /**< @brief FAI triangle distance of last closing point search */
+  double _dLastFreeDistance;                            /**< @brief Free triangle distance of last closing point search */
 
-  mutable Mutex _mainCS;                                  /**< @brief Main critical section that prevents Reset() and Add() at the same time */
+  mutable Mutex _mainCS;                                  /**< @brief Main critical section that prevents Reset() and fixes processing at the same time */
   mutable Mutex _traceCS;                                  /**< @brief Main trace critical section for returning _trace points */
-  mutable Mutex _resultsCS;                               /**< @brief Contests results critical section for returning results */
 
-  CResultArray _resultArray;                                  /**< @brief Array of results */
+  CResultArray _resultArray;                                  /**< @brief Array of results, only used with _mainCS locked */
+  std::shared_ptr<const CResultArray> _publishedResults;      /**< @brief Last published results, accessed with std::atomic_load/atomic_store */
+  std::shared_ptr<const CXCStatus> _publishedXCStatus;        /**< @brief Last published XC values, accessed with std::atomic_load/atomic_store */
+
+  CPointGPS _lastFix;                                         /**< @brief Last fix given to Add(), used to filter out repeats */
+  SPSCQueue<CFix, FIX_QUEUE_SIZE> _fixQueue;                  /**< @brief GPS fixes waiting for optimizer, consumer side is serialized by _mainCS */
+  unsigned _step;                                             /**< @brief Round-robin solver step */
+  std::atomic<unsigned> _droppedFixes;                        /**< @brief Number of fixes lost because optimizer was too late */
+
+  Poco::Thread _optimizerThread;                              /**< @brief Contest optimizer worker */
+  Poco::Event _fixEvent;                                      /**< @brief Signaled by Add() when optimizer thread is running */
+  std::atomic<bool> _optimizerRunning;
+  std::atomic<bool> _optimizerStop;
   std::array<TriangleLeg,3> _faiAssistantTriangleLegs;       // To store data and speedup rendering of the FAI Assistant
   CResult _resultFREETriangle;                                /**< @brief private results for  XContest Free Triangle */
 
@@ -251,14 +314,15 @@ private:
   void FindFAITriangleClosingPoint();
   void FindFREETriangleClosingPoint();
 
+  void ProcessFix(const CFix &fix);
+  void ProcessFixes();
+  void PublishResults();
+  void run() override;
+
  public:
 
   CContestMgr();
 
-  TriangleLeg* GetFAIAssistantMaxLeg() {return _maxFAILeg;};
-  TriangleLeg* GetFAIAssistantLeg(int i) {return &_faiAssistantTriangleLegs[i];};
-  bool LooksLikeAFAITriangleAttempt() { return _bLooksLikeAFAITriangle;};
-  int isFAITriangleClockwise() { return _dFAITriangleClockwise;};
   bool hasValidPath(TType type);
   static CContestMgr &Instance() { return _instance; }
   static const TCHAR *TypeToString(TType type);
@@ -269,34 +333,38 @@ private:
   CPointGPS GetBestClosingPoint(void )     {return GetFAITriangleClosingPoint();};
   double GetClosingPointDist(void) { return GetFAITriangleClosingPointDist()  ;};
   double GetBestClosingPointDist(void) { return  GetFAITriangleBestClosingPointDist()  ;};
-  bool FAI(void) {return _bFAI;};
+  bool FAI(void) {return XCStatus()->FAI;};
 
   // Used by XC
-  double GetFreeTriangleClosingPointDist(void) { return _fFreeTriangleTogo;};
-  double GetFreeTriangleBestClosingPointDist(void) { return  _fFreeTriangleBestTogo ;};
-  CPointGPS GetFreeTriangleClosingPoint(void )         {return _pgpsFreeTriangleClosePoint;};
-  CPointGPS GetFAITriangleClosingPoint(void )         {return _pgpsFAITriangleClosePoint;};
-  double GetFAITriangleClosingPointDist(void) { return _fFAITriangleTogo;};
-  double GetFAITriangleBestClosingPointDist(void) { return  _fFAITriangleBestTogo ;};
+  double GetFreeTriangleClosingPointDist(void) { return XCStatus()->freeTriangleTogo;};
+  double GetFreeTriangleBestClosingPointDist(void) { return  XCStatus()->freeTriangleBestTogo ;};
+  CPointGPS GetFreeTriangleClosingPoint(void )         {return XCStatus()->freeTriangleClosePoint;};
+  CPointGPS GetFAITriangleClosingPoint(void )         {return XCStatus()->FAITriangleClosePoint;};
+  double GetFAITriangleClosingPointDist(void) { return XCStatus()->FAITriangleTogo;};
+  double GetFAITriangleBestClosingPointDist(void) { return  XCStatus()->FAITriangleBestTogo ;};
 
   void Reset(unsigned handicap);
   void Add(unsigned time, double lat, double lon, int alt);
 
+  void StartOptimizer();
+  void StopOptimizer();
+
   CResult Result(TType type, bool fillArray) const;
+  std::shared_ptr<const CXCStatus> XCStatus() const;
   void Trace(CPointGPSArray &array) const;
 
-  CContestMgr::XCFlightType GetBestXCType() {return _bestXCType;};
-  CContestMgr::XCFlightType GetBestXCTriangleType() {return _bestXCTriangleType;};
-  CContestMgr::XCTriangleStatus  GetFTTriangleStatus() { return _XCFTStatus;}
-  CContestMgr::XCTriangleStatus  GetFAITriangleStatus() { return _XCFAIStatus;}
-  double GetXCValidRadius();
-  double GetXCClosedRadius();
-
-  double GetXCTriangleClosureDistance(){return _XCTriangleClosureDistance;};
-  double GetXCTriangleClosurePercentage(){return _XCTriangleClosurePercentage;};
-  double GetXCTriangleDistance(){return _XCTriangleDistance;};
-  double GetXCMeanSpeed(){return _XCMeanSpeed;};
-  CPointGPS GetXCTriangleClosingPoint();
+  CContestMgr::XCFlightType GetBestXCType() {return XCStatus()->bestXCType;};
+  CContestMgr::XCFlightType GetBestXCTriangleType() {return XCStatus()->bestXCTriangleType;};
+  CContestMgr::XCTriangleStatus  GetFTTriangleStatus() { return XCStatus()->FTStatus;}
+  CContestMgr::XCTriangleStatus  GetFAITriangleStatus() { return XCStatus()->FAIStatus;}
+  static double GetXCValidRadius(const CXCStatus &status);
+  static double GetXCClosedRadius(const CXCStatus &status);
+
+  double GetXCTriangleClosureDistance(){return XCStatus()->triangleClosureDistance;};
+  double GetXCTriangleClosurePercentage(){return XCStatus()->triangleClosurePercentage;};
+  double GetXCTriangleDistance(){return XCStatus()->triangleDistance;};
+  double GetXCMeanSpeed(){return XCStatus()->meanSpeed;};
+  CPointGPS GetXCTriangleClosingPoint() {return XCStatus()->XCTriangleClosingPoint();};
 };
 
 /** 
@@ -392,13 +460,25 @@ inline void CContestMgr::CResult::Update()
 /** 
  * @brief Returns requested contest result
  * 
+ * Never block : results are read from last snapshot published by optimizer.
+ * 
  * @param type Contest type to return
  * @param fillArray When @c true GPS points will be copied
  */
 inline CContestMgr::CResult CContestMgr::Result(TType type, bool fillArray) const
 {
-  ScopeLock guard(_resultsCS);
-  return CResult(_resultArray[type], fillArray);
+  const std::shared_ptr<const CResultArray> results = std::atomic_load(&_publishedResults);
+  return CResult((*results)[type], fillArray);
+}
+
+/**
+ * @brief Returns last published XC values
+ *
+ * Hold returned pointer to get consistent values from the same optimizer step.
+ */
+inline std::shared_ptr<const CContestMgr::CXCStatus> CContestMgr::XCStatus() const
+{
+  return std::atomic_load(&_publishedXCStatus);
 }
 
 
@@ -0,0 +1,141 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   FlightTrail.h
+ */
+
+#ifndef FLIGHTTRAIL_H
+#define FLIGHTTRAIL_H
+
+#include "Thread/Mutex.hpp"
+#include "Geographic/GeoPoint.h"
+#include "Topology/shapelib/mapprimitive.h"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+/**
+ * Full flight trail storage.
+ *
+ * Points are stored in chunks of CHUNK_SIZE points, each point is encoded as
+ * 16 bits latitude/longitude delta from previous one (1e-6 degree unit), so a
+ * 10 hours flight with one fix per second need less than 200KB. Oldest chunks
+ * are discarded above MAX_CHUNKS.
+ *
+ * Once a chunk is full, Douglas-Peucker simplification is computed for each
+ * level of detail (tolerance is multiplied by 4 from one level to the next),
+ * so drawing only need points that make a difference at current map scale.
+ *
+ * Last RECENT_SIZE points also keep time, colour and drift factor, needed to
+ * draw the coloured (and drifted) recent snail trail. See GetRecent().
+ *
+ * Thread safe : Append() is called by calculation thread, Get() by draw thread.
+ */
+class FlightTrail final {
+public:
+  static constexpr unsigned CHUNK_SIZE = 256;
+  static constexpr unsigned MAX_CHUNKS = 512;
+  static constexpr unsigned LOD_LEVELS = 5; // not including full resolution
+  static constexpr double LOD_TOLERANCE = 4.; // meters, tolerance of first level
+  static constexpr unsigned RECENT_SIZE = 1024; // points with attributes
+
+  struct point_t {
+    GeoPoint position;
+    double time;
+    float drift_factor;
+    uint8_t colour;
+  };
+
+  FlightTrail() = default;
+
+  FlightTrail(const FlightTrail&) = delete;
+  FlightTrail& operator=(const FlightTrail&) = delete;
+
+  /**
+   * @time : fix time in second
+   * @colour : snail pen index
+   * @drift_factor : [0, 1], how much point is drifted by wind
+   */
+  void Append(double latitude, double longitude, double time, uint8_t colour, double drift_factor);
+  void Clear();
+
+  /**
+   * @return number of points stored since last Clear(), including discarded ones.
+   */
+  size_t Count() const;
+
+  /**
+   * Get trail points needed to draw trail at given resolution.
+   *
+   * @bounds : only chunks overlapping this rect are returned.
+   * @pixel_size : tolerance in meters, used to select level of detail.
+   * @last : index (see Count()) of last point to return.
+   * @points [out] : returned points, each polyline is followed by invalid
+   *                 point (see IsBreak()) used as separator.
+   */
+  void Get(const rectObj& bounds, double pixel_size, size_t last, std::vector<GeoPoint>& points) const;
+
+  /**
+   * Get full resolution recent points with their attributes.
+   *
+   * @last : index (see Count()) following last point to return.
+   * @count : number of points to return, no more than RECENT_SIZE.
+   * @points [out] : returned points, oldest first.
+   */
+  void GetRecent(size_t last, size_t count, std::vector<point_t>& points) const;
+
+  static bool IsBreak(const GeoPoint& pt) {
+    return pt.latitude > 90.;
+  }
+
+  size_t MemoryUsage() const;
+
+private:
+  struct delta_t {
+    int16_t latitude;
+    int16_t longitude;
+  };
+
+  struct attr_t {
+    uint16_t time; // 1/10 second from first point of chunk
+    uint8_t colour;
+    uint8_t drift; // drift factor * 255
+  };
+
+  struct chunk_t {
+    int32_t latitude; // first point, 1e-6 degree
+    int32_t longitude;
+    double time; // first point
+    unsigned size = 0; // number of points, including first one.
+    size_t first_index; // index of first point in trail
+
+    rectObj bounds;
+
+    std::array<delta_t, CHUNK_SIZE - 1> deltas;
+
+    // released once all points of chunk are older than RECENT_SIZE points.
+    std::unique_ptr<std::array<attr_t, CHUNK_SIZE>> attrs;
+
+    // index of points kept for each level of detail, only for full chunk.
+    std::array<std::vector<uint8_t>, LOD_LEVELS> lod;
+
+    void Decode(GeoPoint* out) const;
+    void Simplify();
+  };
+
+  using chunk_ptr = std::unique_ptr<chunk_t>;
+
+  static unsigned Level(double pixel_size);
+
+  mutable Mutex _mutex;
+  std::deque<chunk_ptr> _chunks;
+  size_t _count = 0;
+  int32_t _last_latitude = 0;
+  int32_t _last_longitude = 0;
+};
+
+#endif // FLIGHTTRAIL_H
@@ -17,6 +17,8 @@
 #include "Poco/Event.h"
 #include "Time/PeriodClock.hpp"
 #include "Comm/PortConfig.h"
+#include "Thread/SeqLock.hpp"
+#include "FlightTrail.h"
 
 
   #undef  GEXTERN
@@ -525,6 +527,10 @@ GEXTERN int GearWarningMode;
 GEXTERN NMEA_INFO GPS_INFO;
 GEXTERN DERIVED_INFO CALCULATED_INFO;
 
+// copy of master flight data published by calculation thread, can be read without LockFlightData()
+GEXTERN SeqLock<NMEA_INFO> GPS_INFO_Snapshot;
+GEXTERN SeqLock<DERIVED_INFO> CALCULATED_INFO_Snapshot;
+
 // units
 GEXTERN double SPEEDMODIFY;
 GEXTERN double LIFTMODIFY;
@@ -550,10 +556,7 @@ GEXTERN int Handicap;
 GEXTERN bool InfoWindowActive;
 
 // snail trail
-GEXTERN SNAIL_POINT SnailTrail[TRAILSIZE];
-GEXTERN	int SnailNext;
-GEXTERN LONG_SNAIL_POINT LongSnailTrail[LONGTRAILSIZE+1];
-GEXTERN	int LongSnailNext;
+GEXTERN FlightTrail FullTrail; // whole flight
 GEXTERN int TrailLock;
 
 // Logger
@@ -11,11 +11,17 @@
 #include <deque>
 #include <list>
 #include <algorithm>
+#include <optional>
+#include "Util/tstring.hpp"
 #include <zzip/zzip.h>
 #include "Screen/LKSurface.h"
 #include "Geographic/GeoPoint.h"
+#include "Airspace/AirspaceIndex.h"
+#include "Draw/ScreenProjection.h"
+#ifdef ENABLE_OPENGL
+#include "Screen/OpenGL/PolygonRenderer.h"
+#endif
 
-class ScreenProjection;
 class MD5;
 
 // changed by AlphaLima since we have a second airspace view to next waypoint,
@@ -172,7 +178,7 @@ public:
     _except_saturday = b;
   }
   
-  bool ExceptSaturday() {
+  bool ExceptSaturday() const {
     return _except_saturday;
   }
   
@@ -180,7 +186,7 @@ public:
     _except_sunday = b;
   }
   
-  bool ExceptSunday() {
+  bool ExceptSunday() const {
     return _except_sunday;
   }
 
@@ -270,6 +276,38 @@ protected:
   static bool _pred_blindtime;                 // disable predicted position based warnings near takeoff
 };
 
+// Screen coordinate cache of airspaces, owned by CAirspaceManager, used only by draw thread.
+struct CAirspaceScreenCache {
+  unsigned generation = 0; // incremented each time projection, draw rect or screen bounds change
+  unsigned hits = 0; // visible airspaces drawn using cached screen coordinate
+  unsigned misses = 0; // visible airspaces projected again
+};
+
+// Sample points of sideview scan line, with values shared by all airspaces
+// tested against it by CAirspace::ScanLine()
+struct CAirspaceScanLine {
+  CAirspaceScanLine(const double (&Lats)[AIRSPACE_SCANSIZE_X], const double (&Lons)[AIRSPACE_SCANSIZE_X]);
+
+  // signed distance (in degree) of a point from the straight line between first and last sample
+  double Offset(double longitude, double latitude) const {
+    return ((longitude - lons[0]) * normal_lon + (latitude - lats[0]) * normal_lat);
+  }
+  // position of a point projected on the straight line, 0 for first sample, 1 for last one
+  double Position(double longitude, double latitude) const {
+    return ((longitude - lons[0]) * dir_lon + (latitude - lats[0]) * dir_lat) / len_sq;
+  }
+
+  const double (&lats)[AIRSPACE_SCANSIZE_X];
+  const double (&lons)[AIRSPACE_SCANSIZE_X];
+  rectObj bounds; // bounds of all samples
+  // false if samples can't be seen as a strip (line across 180 meridian, zero length...)
+  bool straight;
+  double dir_lon, dir_lat, len_sq; // last sample - first sample
+  double normal_lon, normal_lat; // unit normal vector of straight line
+  double max_offset; // all samples, and segments between them, are inside [-max_offset, max_offset]
+  double position[AIRSPACE_SCANSIZE_X]; // Position() of each sample, increasing
+};
+
 class CAirspace : public CAirspaceBase {
 public:
 
@@ -281,10 +319,15 @@ public:
 
     // Check if a point horizontally inside in this airspace
     virtual bool IsHorizontalInside(const double &longitude, const double &latitude) const = 0;
+    // Set @inside to IsHorizontalInside() of each sample of @line, this one test every sample.
+    virtual void ScanLine(const CAirspaceScanLine& line, bool (&inside)[AIRSPACE_SCANSIZE_X]) const;
     // Dump this airspace to runtime.log
     virtual void Dump() const = 0;
-    // Calculate drawing coordinates on screen
-    virtual void CalculateScreenPosition(const rectObj &screenbounds_latlon, const int iAirspaceMode[], const int iAirspaceBrush[], const RECT& rcDraw, const ScreenProjection& _Proj);
+    // Calculate drawing coordinates on screen, reuse previous ones if @cache generation is unchanged.
+    // @altitude_visible : result of CAirspaceManager::CheckAirspaceAltitude() for this airspace
+    virtual void CalculateScreenPosition(const rectObj &screenbounds_latlon, const int iAirspaceMode[], const int iAirspaceBrush[],
+                                         const RECT& rcDraw, const ScreenProjection& _Proj,
+                                         bool altitude_visible, CAirspaceScreenCache& cache);
     // Draw airspace on map
     virtual void Draw(LKSurface& Surface, bool fill) const;
     // Calculate nearest horizontal distance and bearing to the airspace from a given point
@@ -294,6 +337,9 @@ public:
       return Range(position.longitude, position.latitude, bearing);
     }
 
+    // polygon points, also used for circle
+    const CPoint2DArray& Points() const { return _geopoints; }
+
     // update hash with airspace common properties
     void Hash(MD5& md5) const;
 
@@ -321,6 +367,14 @@ protected:
     // this 2 array are modified by DrawThread, never use it in another thread !!
     ScreenPointList _screenpoints; // this is member for reduce memory alloc, but is used only by CalculateScreenPosition();
     RasterPointList _screenpoints_clipped;
+    unsigned _screen_generation = 0; // CAirspaceScreenCache::generation of _screenpoints_clipped, 0 if never calculated
+#ifdef ENABLE_OPENGL
+    TessellatedPolygon _tessellation; // triangles of _geopoints, built once by DrawThread
+    std::vector<FloatPoint> _screen_triangles; // _tessellation vertices on screen, valid for _screen_generation
+
+    // Fill _screen_triangles, tessellate polygon if needed.
+    void CalculateScreenTriangles(const ScreenProjection& _Proj);
+#endif
 
     ////////////////////////////////////////////////////////////////////////////////
     // Draw Picto methods
@@ -371,10 +425,14 @@ typedef struct
 class CAirspace_Area: public CAirspace {
 public:
   CAirspace_Area(CPoint2DArray &&Area_Points);
+  // restore from airspace cache, @Area_Points and @Bounds are result of CalcBounds()
+  CAirspace_Area(CPoint2DArray &&Area_Points, const rectObj &Bounds);
   ~CAirspace_Area() {};
 
   // Check if a point horizontally inside in this airspace
   bool IsHorizontalInside(const double &longitude, const double &latitude) const override ;
+  // Only test samples near polygon edges, result is same as CAirspace::ScanLine()
+  void ScanLine(const CAirspaceScanLine& line, bool (&inside)[AIRSPACE_SCANSIZE_X]) const override;
   // Dump this airspace to runtime.log
   void Dump() const override;
 
@@ -389,6 +447,18 @@ private:
   int wn_PnPoly( const double &longitude, const double &latitude ) const;
   // Calculate airspace bounds
   void CalcBounds();
+  // Fill vertex and edge buffers from _geopoints, must be called after CalcBounds()
+  void CalcEdgeTable();
+
+  // _geopoints copy as flat arrays for wn_PnPoly() and Range() loops.
+  std::vector<double> _vertex_lat;
+  std::vector<double> _vertex_lon;
+  // geocentric coordinates of vertex
+  std::vector<int> _vertex_x;
+  std::vector<int> _vertex_y;
+  std::vector<int> _vertex_z;
+  // 1 / squared geocentric length of each edge, 0 for null length edge
+  std::vector<double> _edge_inv_len_sq;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Draw Picto methods
@@ -406,10 +476,17 @@ class CAirspace_Circle: public CAirspace
 {
 public:
   CAirspace_Circle(const GeoPoint &Center, double Radius);
+  // restore from airspace cache, @Points and @Bounds are the ones computed by previous constructor
+  CAirspace_Circle(const GeoPoint &Center, double Radius, CPoint2DArray &&Points, const rectObj &Bounds);
   ~CAirspace_Circle() {}
 
+  const GeoPoint& Center() const { return _center; }
+  double Radius() const { return _radius; }
+
   // Check if a point horizontally inside in this airspace
   bool IsHorizontalInside(const double &longitude, const double &latitude) const override;
+  // Search entry and exit of circle, result is same as CAirspace::ScanLine()
+  void ScanLine(const CAirspaceScanLine& line, bool (&inside)[AIRSPACE_SCANSIZE_X]) const override;
   // Dump this airspace to runtime.log
   void Dump() const override;
 
@@ -465,6 +542,8 @@ public:
 
   //HELPER FUNCTIONS
   static bool CheckAirspaceAltitude(const AIRSPACE_ALT &Base, const AIRSPACE_ALT &Top);
+  // same as above, using given navigation altitude and terrain altitude instead of locking flight data.
+  static bool CheckAirspaceAltitude(const AIRSPACE_ALT &Base, const AIRSPACE_ALT &Top, double alt, double alt_agl);
   static const TCHAR* GetAirspaceTypeText(int type);
   static const TCHAR* GetAirspaceTypeShortText(int type);
   static void GetAirspaceAltText(TCHAR *buffer, int bufferlen, const AIRSPACE_ALT *alt);
@@ -472,7 +551,10 @@ public:
 
 
   // Upper level interfaces
-  void ReadAirspaces();
+  // @interactive : parse errors are shown in message box, false if not called by main thread
+  void ReadAirspaces(bool interactive = true);
+  // show parse errors delayed by non interactive ReadAirspaces, must be called by main thread
+  void ShowParseWarnings();
   void CloseAirspaces();
   #if ASPWAVEOFF
   void AirspaceDisableWaveSectors();
@@ -515,6 +597,8 @@ public:
   //Mapwindow drawing
   void SetFarVisible(const rectObj &bounds_active);
   void CalculateScreenPositionsAirspace(const rectObj &screenbounds_latlon, const int iAirspaceMode[], const int iAirspaceBrush[], const RECT& rcDraw, const ScreenProjection& _Proj);
+  // screen coordinate cache statistics, since startup
+  CAirspaceScreenCache GetScreenCacheStats() const { ScopeLock guard(_csairspaces); return _screen_cache; }
   const CAirspaceList& GetNearAirspacesRef() const;
 
   //Nearest page 2.4
@@ -550,11 +634,19 @@ private:
   // Airspaces data
   mutable Mutex _csairspaces; // recursive mutex is needed.
   CAirspaceList _airspaces;             // ALL
+  CAirspaceIndex _airspaces_index;      // Spatial index of ALL, must be rebuilt each time _airspaces change
+  CAirspaceList _airspaces_day_restricted; // ALL with ExceptSaturday or ExceptSunday
   CAirspaceList _airspaces_near;        // Near, in reachable range for warnings
   CAirspaceList _airspaces_page24;      // Airspaces for nearest 2.4 page
   CAirspace *_selected_airspace;         // Selected airspace
   CAirspace *_sideview_nearest;         // Neasrest asp instance for sideview
 
+  // screen coordinate cache, key of current generation
+  CAirspaceScreenCache _screen_cache;
+  std::optional<ScreenProjection> _screen_proj;
+  RECT _screen_rect = {};
+  rectObj _screen_bounds = {};
+
   unsigned last_day_of_week = ~0; // used for auto disable airspace SAT/SUN
 
   // Warning system data
@@ -566,6 +658,18 @@ private:
   CAirspace * _detail_current;
   CAirspaceList _detail_queue;
 
+  // parse state, protected by _csairspaces.
+  // number of parse error shown to user by current file loading, file with error are never cached
+  unsigned _parse_warnings = 0;
+  bool _parse_interactive = true;
+  // parse errors delayed by non interactive loading, shown by ShowParseWarnings()
+  std::vector<tstring> _parse_messages;
+  // show parse error to user, @return false if user cancel loading
+  bool ParseWarning(const TCHAR* text);
+
+  // load one airspace file using binary cache if valid, otherwise parse it and build the cache.
+  bool ReadAirspaceFile(const TCHAR* szFile);
+
   //Openair parsing functions, internal use
   bool FillAirspacesFromOpenAir(const TCHAR* szFile);
   
@@ -585,6 +689,9 @@ private:
   bool FillAirspacesFromOpenAIP(const TCHAR* szFile);
   bool ReadAltitudeOpenAIP(const xml_node* node, AIRSPACE_ALT *Alt) const;
 
+  // rebuild _airspaces_index & _airspaces_day_restricted, call with _csairspaces locked
+  void BuildAirspaceIndex();
+
   //Airspace setting save/restore functions
   void SaveSettings() const;
   void LoadSettings();
@@ -25,8 +25,11 @@ class ReplayLogger {
   static void SetFilename(const TCHAR *name);
   static bool IsEnabled(void);
   static double TimeScale;
+  // replay next @seconds of log without waiting for real time, used by ReplayBatch.
+  static bool UpdateFixedStep(double seconds);
  private:
   static bool UpdateInternal(void);
+  static bool Advance(double deltatime);
   static bool ReadLine(TCHAR *buffer);
   static bool Enabled;
   static bool ScanBuffer(TCHAR *buffer, double *Time, double *Latitude,
@@ -38,8 +41,29 @@ class ReplayLogger {
   static TCHAR FileName[MAX_PATH+1];
 };
 
+/**
+ * Headless replay, requested by "-replay=" command line option.
+ *
+ * IGC or NMEA log from _Logger directory is replayed as fast as possible,
+ * without map window, devices nor calculation thread. Each fix is processed
+ * by DoCalculations and DoCalculationsSlow as calculation thread would do,
+ * and derived values are written to a CSV file, also in _Logger directory.
+ */
+class ReplayBatch {
+ public:
+  static void SetInput(const TCHAR *name);
+  static void SetOutput(const TCHAR *name);
+  static bool IsRequested(void);
+  static bool Run(void);
+ private:
+  static TCHAR InputName[MAX_PATH+1];
+  static TCHAR OutputName[MAX_PATH+1];
+};
+
 bool LoggerClearFreeSpace();
 void StopLogger(void);
+// release igc file once logger is stopped, called by calculation thread even without valid fix.
+void LoggerCloseIfStopped();
 bool LoggerGActive();
 
 
@@ -211,23 +211,6 @@ struct WPCALC
   bool IsOutlanding;
 };
 
-typedef struct _SNAIL_POINT
-{
-  float Latitude;
-  float Longitude;
-  double Time;
-  unsigned short Colour;
-  BOOL Circling;
-  double DriftFactor;
-} SNAIL_POINT;
-
-typedef struct _LONG_SNAIL_POINT
-{
-  float Latitude;
-  float Longitude;
-  bool FarVisible;
-} LONG_SNAIL_POINT;
-
 typedef struct {
     bool Border;
     bool FillBackground;
@@ -543,6 +526,8 @@ class MapWindow {
 
   static void UpdateInfo(NMEA_INFO *nmea_info,
 			 DERIVED_INFO *derived_info);
+  // same using GPS_INFO_Snapshot & CALCULATED_INFO_Snapshot
+  static void UpdateInfo();
   static rectObj CalculateScreenBounds(double scale, const RECT& rc, const ScreenProjection& _Proj);
   static void ScanVisibility(rectObj *bounds_active);
 
@@ -698,8 +683,7 @@ protected:
 
 #endif
 private:
-  static int iSnailNext;
-  static int iLongSnailNext;
+  static size_t iSnailCount;
 
 #ifndef ENABLE_OPENGL
   static LKWindowSurface WindowSurface; // used as AttribDC for Bitmap Surface.
@@ -91,6 +91,11 @@ public:
   
   double Latitude() const    { return _lat; }
   double Longitude() const   { return _lon; }
+
+  // geocentric coordinates
+  int X() const { return _x; }
+  int Y() const { return _y; }
+  int Z() const { return _z; }
   
   unsigned Distance(double lat, double lon) const;
   unsigned Distance(const CPoint2D &ref) const;
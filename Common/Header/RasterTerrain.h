@@ -2,30 +2,22 @@
 #define RASTERTERRAIN_H
 
 #include "Library/cpp-mmf/memory_mapped_file.hpp"
-
-typedef struct _TERRAIN_INFO
-{
-  double Left;
-  double Right;
-  double Top;
-  double Bottom;
-  double StepSize;
-  uint32_t Rows;
-  uint32_t Columns;
-} TERRAIN_INFO;
+#include "Terrain/DEMFormat.h"
+#include "Terrain/TerrainTileCache.h"
 
 
 class RasterMap final {
  public:
   RasterMap() {
-    Interpolate = false;
-
     TerrainMem = nullptr;
+    TileMem = nullptr;
+    TileSlot = nullptr;
+    TilesX = 0;
   }
   ~RasterMap() { Close(); }
 
   inline bool isMapLoaded() const {
-    return (TerrainMem);
+    return (TerrainMem || TileMem || TileCache);
   }
 
   bool GetMapCenter(double *lat, double *lon) const;
@@ -40,33 +32,132 @@ class RasterMap final {
   int GetEffectivePixelSize(double *pixel_D,
                             double latitude, double longitude) const;
 
+  /**
+   * sampling parameters for a given field rounding, see SetFieldRounding()
+   */
+  struct rounding_t {
+    int xlleft;
+    int xlltop;
+    bool interpolate;
+    double fXrounding, fYrounding;
+    double fXroundingFine, fYroundingFine;
+    int Xrounding, Yrounding;
+  };
+
+  rounding_t GetRounding(double xr, double yr) const;
+
   void SetFieldRounding(double xr, double yr);
 
+  int GetXRounding() const {
+    return Rounding.Xrounding;
+  }
+  int GetYRounding() const {
+    return Rounding.Yrounding;
+  }
+
+  /**
+   * @return unique id of loaded terrain, changed each time terrain is opened.
+   */
+  unsigned GetSerial() const {
+    return Serial;
+  }
+
   inline short GetField(const double &Latitude, const double &Longitude) const;
 
+  /**
+   * same result as GetField() for each of @count points.
+   */
+  void GetFieldBatch(const double* Latitude, const double* Longitude, short* out, size_t count) const;
+
+  /**
+   * elevation of @count points evenly spaced (in lat/lon) from start to end, both included.
+   */
+  void GetFieldAlongLine(double start_lat, double start_lon,
+                         double end_lat, double end_lon, short* out, size_t count) const {
+    GetFieldAlongLine(Rounding, start_lat, start_lon, end_lat, end_lon, out, count);
+  }
+
+  /**
+   * same as GetFieldAlongLine() using @rounding instead of current field rounding,
+   * can be called concurrently by several threads.
+   */
+  void GetFieldAlongLine(const rounding_t& rounding, double start_lat, double start_lon,
+                         double end_lat, double end_lon, short* out, size_t count) const {
+    GetFieldAlongLine(rounding, start_lat, start_lon, end_lat, end_lon, count, 0, out, count);
+  }
+
+  /**
+   * elevation of points [@first, @first + @n) of the line sampled at @count points,
+   * used to sample a profile by chunks.
+   */
+  void GetFieldAlongLine(const rounding_t& rounding, double start_lat, double start_lon,
+                         double end_lat, double end_lon, size_t count,
+                         size_t first, short* out, size_t n) const;
+
+  const rounding_t& GetRounding() const {
+    return Rounding;
+  }
+
   bool Open(const TCHAR* filename);
+
+  /**
+   * use in memory DEM data (raw layout), mainly for tests.
+   */
+  bool Open(const TERRAIN_INFO& info, std::unique_ptr<short[]>&& data);
   void Close();
 
 protected:
   friend class TerrainRenderer;
 
-  inline bool interpolate() const { return Interpolate; }
-  inline short GetFieldInterpolate(const double &Latitude, const double &Longitude) const;
-  inline short GetFieldFine(const double &Latitude, const double &Longitude) const;
+  inline bool interpolate() const { return Rounding.interpolate; }
+  inline short GetFieldInterpolate(const double &Latitude, const double &Longitude) const {
+    return GetFieldInterpolate(Rounding, Latitude, Longitude);
+  }
+  inline short GetFieldFine(const double &Latitude, const double &Longitude) const {
+    return GetFieldFine(Rounding, Latitude, Longitude);
+  }
+
+  inline short GetFieldInterpolate(const rounding_t& r, const double &Latitude, const double &Longitude) const;
+  inline short GetFieldFine(const rounding_t& r, const double &Latitude, const double &Longitude) const;
 
  private:
 
-  int xlleft;
-  int xlltop;
+  bool OpenRaw(const TCHAR* filename);
+  bool OpenTiled(const TCHAR* filename, const TILED_DEM_HEADER& header);
+
+  /**
+   * @return interpolated elevation at (@lx, @ly) in 1/256 of DEM cell,
+   *   second step of GetFieldInterpolate().
+   */
+  inline short InterpolateAt(unsigned lx, unsigned ly) const;
 
-  bool Interpolate;
+  /**
+   * @return elevation of DEM cell (@lx, @ly) or TERRAIN_INVALID outside of DEM,
+   *   second step of GetFieldFine().
+   */
+  inline short FineAt(unsigned lx, unsigned ly) const;
 
-  double fXrounding, fYrounding;
-  double fXroundingFine, fYroundingFine;
-  int Xrounding, Yrounding;
+  /**
+   * @return raw elevation of DEM cell (@x, @y), caller must check bounds.
+   */
+  inline short GetHeight(unsigned x, unsigned y) const;
+  inline short GetTiledHeight(unsigned x, unsigned y) const;
+
+  template<typename Sample>
+  static short InterpolateCell(unsigned ix, unsigned iy, Sample&& h);
+
+  rounding_t Rounding = {};
 
   TERRAIN_INFO TerrainInfo;
-  const short* TerrainMem;
+  unsigned Serial = 0;
+  const short* TerrainMem; // raw layout, row major
+
+  // tiled layout, see DEMFormat.h
+  uint32_t TilesX;
+  const uint32_t* TileSlot; // slot of each tile, row major
+  const short* TileMem;     // first tile, nullptr if tiles are read through TileCache
+  std::vector<uint32_t> TileSlotTable;
+  std::unique_ptr<TerrainTileCache> TileCache;
 
   std::unique_ptr<short[]> pTerrainMem;
 #ifndef UNDER_CE
@@ -84,12 +175,15 @@ protected:
  * @optimization : return invalid terrain for right&bottom line.
  */
 inline
-short RasterMap::GetFieldInterpolate(const double &Latitude, const double &Longitude) const {
-    assert(Interpolate);
+short RasterMap::GetFieldInterpolate(const rounding_t& r, const double &Latitude, const double &Longitude) const {
+    assert(r.interpolate);
 
-    unsigned int lx = (int)(Longitude * fXroundingFine) - xlleft;
-    unsigned int ly = xlltop - (int) (Latitude * fYroundingFine);
+    return InterpolateAt((int)(Longitude * r.fXroundingFine) - r.xlleft,
+                         r.xlltop - (int) (Latitude * r.fYroundingFine));
+}
 
+inline
+short RasterMap::InterpolateAt(unsigned lx, unsigned ly) const {
     const unsigned ix = CombinedDivAndMod(lx);
     const unsigned iy = CombinedDivAndMod(ly);
 
@@ -97,14 +191,32 @@ short RasterMap::GetFieldInterpolate(const double &Latitude, const double &Longi
         return TERRAIN_INVALID;
     }
     assert(((ly+1) * TerrainInfo.Columns + (lx+1)) < (TerrainInfo.Columns*TerrainInfo.Rows));
-    const short *tm = TerrainMem + ly * TerrainInfo.Columns + lx;
 
+    if (gcc_likely(TerrainMem)) {
+        const short *tm = TerrainMem + ly * TerrainInfo.Columns + lx;
+        const unsigned columns = TerrainInfo.Columns;
+        return InterpolateCell(ix, iy, [&](unsigned dx, unsigned dy) {
+            return tm[dy * columns + dx];
+        });
+    }
+    return InterpolateCell(ix, iy, [&](unsigned dx, unsigned dy) {
+        return GetTiledHeight(lx + dx, ly + dy);
+    });
+}
+
+/**
+ * @param ix, iy : position inside cell in 1/256
+ * @param h : h(dx, dy) return elevation of cell (x+dx, y+dy)
+ */
+template<typename Sample>
+inline
+short RasterMap::InterpolateCell(unsigned ix, unsigned iy, Sample&& h) {
 #ifdef _BILINEAR_INTERP
     // load the four neighboring pixels
-    const short& h1 = tm[0];                        // (x  ,y)
-    const short& h2 = tm[1];                        // (x+1,y)
-    const short& h3 = tm[TerrainInfo.Columns];     // (x  ,y+1)
-    const short& h4 = tm[1 + TerrainInfo.Columns]; // (x+1,y+1)
+    const short h1 = h(0, 0); // (x  ,y)
+    const short h2 = h(1, 0); // (x+1,y)
+    const short h3 = h(0, 1); // (x  ,y+1)
+    const short h4 = h(1, 1); // (x+1,y+1)
 
     // Calculate the weights for each pixel
     const unsigned ix1 = 0x0ff - ix;
@@ -119,40 +231,61 @@ short RasterMap::GetFieldInterpolate(const double &Latitude, const double &Longi
     return (h1 * w1 + h2 * w2 + h3 * w3 + h4 * w4) >> 16;
 #else
     // perform piecewise linear interpolation
-    const short &h1 = tm[0]; // (x,y)
-    const short &h3 = tm[TerrainInfo.Columns+1]; // (x+1,y+1)
+    const short h1 = h(0, 0); // (x,y)
+    const short h3 = h(1, 1); // (x+1,y+1)
     if (ix > iy) {
         // lower triangle
-        const short &h2 = tm[1]; // (x+1,y)
+        const short h2 = h(1, 0); // (x+1,y)
         return (short) (h1 + ((ix * (h2 - h1) - iy * (h2 - h3)) >> 8));
     } else {
         // upper triangle
-        const short &h4 = tm[TerrainInfo.Columns]; // (x,y+1)
+        const short h4 = h(0, 1); // (x,y+1)
         return (short) (h1 + ((iy * (h4 - h1) - ix * (h4 - h3)) >> 8));
     }
 #endif
 }
 
+inline
+short RasterMap::GetTiledHeight(unsigned x, unsigned y) const {
+    const unsigned slot = TileSlot[(y >> DEM_TILE_SHIFT) * TilesX + (x >> DEM_TILE_SHIFT)];
+    const unsigned offset = ((y & DEM_TILE_MASK) << DEM_TILE_SHIFT) | (x & DEM_TILE_MASK);
+    if (gcc_likely(TileMem)) {
+        return TileMem[static_cast<size_t>(slot) * DEM_TILE_CELLS + offset];
+    }
+    return TileCache->Get(slot, offset);
+}
+
+inline
+short RasterMap::GetHeight(unsigned x, unsigned y) const {
+    if (gcc_likely(TerrainMem)) {
+        return TerrainMem[y * TerrainInfo.Columns + x];
+    }
+    return GetTiledHeight(x, y);
+}
+
 /**
  * @brief return terrain elevation without interpolation
  * @optimization : return invalid terrain for right&bottom line.
  */
 inline
-short RasterMap::GetFieldFine(const double &Latitude, const double &Longitude) const {
+short RasterMap::GetFieldFine(const rounding_t& r, const double &Latitude, const double &Longitude) const {
     if(gcc_unlikely(Longitude < TerrainInfo.Left || Latitude > TerrainInfo.Top)) {
         return TERRAIN_INVALID;
     }
 
-    const unsigned int lx = uround((Longitude - TerrainInfo.Left) * fXrounding) * Xrounding;
-    const unsigned int ly = uround((TerrainInfo.Top - Latitude) * fYrounding) * Yrounding;
+    return FineAt(uround((Longitude - TerrainInfo.Left) * r.fXrounding) * r.Xrounding,
+                  uround((TerrainInfo.Top - Latitude) * r.fYrounding) * r.Yrounding);
+}
 
+inline
+short RasterMap::FineAt(unsigned lx, unsigned ly) const {
     if (gcc_unlikely(lx >= (TerrainInfo.Columns) || ly >= (TerrainInfo.Rows))) {
         return TERRAIN_INVALID;
     }
 
     assert(((ly) * TerrainInfo.Columns + (lx)) < (TerrainInfo.Columns*TerrainInfo.Rows));
 
-    return *(TerrainMem + ly * TerrainInfo.Columns + lx);
+    return GetHeight(lx, ly);
 }
 
 inline
@@ -183,6 +316,9 @@ public:
   // RasterTerrain::Lock() Requiered
   static short GetTerrainHeight(const double &Latitude, const double &Longitude);
 
+  // RasterTerrain::Lock() Requiered
+  static void GetTerrainHeightBatch(const double* Latitude, const double* Longitude, short* out, size_t count);
+
   // RasterTerrain::Lock() Requiered
   static void SetTerrainRounding(double x, double y);
 
@@ -194,5 +330,71 @@ protected:
 
 };
 
+/**
+ * terrain elevation at @Count points evenly spaced (in lat/lon) from start to
+ * end, both included. Points are sampled by chunk on first access, callers
+ * stopping at first obstacle don't evaluate the whole line.
+ *
+ * RasterTerrain::Lock() Requiered while used.
+ */
+template<size_t Count>
+class TerrainLineProfile final {
+public:
+  // use current terrain rounding
+  TerrainLineProfile(double start_lat, double start_lon, double end_lat, double end_lon)
+      : _start_lat(start_lat), _start_lon(start_lon), _end_lat(end_lat), _end_lon(end_lon)
+  {
+    const RasterMap* map = RasterTerrain::TerrainMap;
+    if (map && map->isMapLoaded()) {
+      _map = map;
+      _rounding = map->GetRounding();
+    }
+  }
+
+  /**
+   * use rounding (@xr, @yr) without changing terrain rounding,
+   * can be used concurrently by threads working for lock owner.
+   */
+  TerrainLineProfile(double xr, double yr, double start_lat, double start_lon, double end_lat, double end_lon)
+      : _start_lat(start_lat), _start_lon(start_lon), _end_lat(end_lat), _end_lon(end_lon)
+  {
+    const RasterMap* map = RasterTerrain::TerrainMap;
+    if (map && map->isMapLoaded()) {
+      _map = map;
+      _rounding = map->GetRounding(xr, yr);
+    }
+  }
+
+  short operator[](size_t i) {
+    assert(i < Count);
+    while (i >= _size) {
+      Fill();
+    }
+    return _heights[i];
+  }
+
+private:
+  void Fill() {
+    const size_t n = std::min(chunk_size, Count - _size);
+    if (_map) {
+      _map->GetFieldAlongLine(_rounding, _start_lat, _start_lon, _end_lat, _end_lon,
+                              Count, _size, _heights + _size, n);
+    } else {
+      std::fill_n(_heights + _size, n, TERRAIN_INVALID);
+    }
+    _size += n;
+  }
+
+  static constexpr size_t chunk_size = 8;
+
+  const RasterMap* _map = nullptr;
+  RasterMap::rounding_t _rounding = {};
+  const double _start_lat, _start_lon;
+  const double _end_lat, _end_lon;
+
+  size_t _size = 0; // number of points already sampled
+  short _heights[Count];
+};
+
 
 #endif
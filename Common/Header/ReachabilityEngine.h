@@ -0,0 +1,104 @@
+/*
+   LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+   Released under GNU/GPL License v.2 or later
+   See CREDITS.TXT file for authors and copyrights
+
+   File: ReachabilityEngine.h
+*/
+
+#ifndef __REACHABILITYENGINE_H__
+#define __REACHABILITYENGINE_H__
+
+#include "NMEA/Info.h"
+#include "NMEA/Derived.h"
+#include "Thread/Mutex.hpp"
+#include "Time/PeriodClock.hpp"
+#include "Poco/Event.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief Background computation of waypoints arrival altitude and reachability
+ *
+ * Fill WayPointCalc[].Distance, Bearing, GR, AltReqd and WayPointList[].AltArivalAGL,
+ * Reachable for landables, thermals, task points and overtarget, including
+ * glide through terrain check.
+ *
+ * Draw thread only give its data to Update(), a new pass is started by
+ * worker thread when altitude, position, wind or MacCready have changed
+ * enough since previous one, or after REFRESH_TIME. Each pass process visible
+ * waypoints first, nearest first.
+ *
+ * Without running thread, Update() does a full pass on caller thread.
+ */
+class ReachabilityEngine final : private Poco::Runnable {
+public:
+  ReachabilityEngine();
+
+  ReachabilityEngine(const ReachabilityEngine&) = delete;
+  ReachabilityEngine& operator=(const ReachabilityEngine&) = delete;
+
+  void Start();
+  void Stop();
+
+  void Update(const NMEA_INFO& Basic, const DERIVED_INFO& Calculated);
+
+  /**
+   * @return true if at least one landable (other than current task point) is
+   *         reachable through terrain, result of last complete pass.
+   */
+  bool LandableReachable() const {
+    return _landable_reachable;
+  }
+
+private:
+  static constexpr unsigned REFRESH_TIME = 10000; // ms
+
+  struct input_t {
+    NMEA_INFO basic;
+    DERIVED_INFO calculated;
+    double mc;
+    size_t waypoints;
+  };
+
+  struct candidate_t {
+    int index;
+    bool visible;
+    double distance;
+    double bearing;
+  };
+
+  static bool Outdated(const input_t& last, const input_t& next);
+
+  /**
+   * @return false if pass was aborted
+   */
+  bool Process(const input_t& input);
+
+  bool ProcessNear(const input_t& input, const std::vector<candidate_t>& candidates, bool& reachable);
+  bool ProcessFar(const input_t& input, const std::vector<candidate_t>& candidates, bool& reachable);
+
+  void run() override;
+
+  Poco::Thread _thread;
+  Poco::Event _event;
+
+  Mutex _input_mutex; // protect _pending, _input, _last, _last_clock
+  bool _pending = false;
+  input_t _input = {}; // input of next pass
+  input_t _last = {}; // input of last requested pass
+  PeriodClock _last_clock;
+
+  input_t _current = {}; // input of running pass, only used by worker
+
+  std::atomic<bool> _running = {};
+  std::atomic<bool> _abort = {};
+  std::atomic<bool> _stop = {};
+  std::atomic<bool> _landable_reachable = {};
+};
+
+extern ReachabilityEngine ReachEngine;
+
+#endif // __REACHABILITYENGINE_H__
@@ -51,7 +51,6 @@
 #define MAXTASKPOINTS 50
 #define MAXSTARTPOINTS 20
 
-#define LONGTRAILSIZE 600
 // 1000 points at 3.6 seconds average = one hour
 #define TRAILSIZE 1000
 // short trail is 10 minutes approx
@@ -4,7 +4,7 @@
 #include "Topology.h"
 
 
-void SetTopologyBounds(const RECT& rcin, const ScreenProjection& _Proj,  const bool force=false);
+void SetTopologyBounds(const RECT& rcin, const ScreenProjection& _Proj, const NMEA_INFO& Basic, const bool force=false);
 
 void OpenTopology();
 void CloseTopology();
@@ -10,7 +10,15 @@
 #define TOPOLOGY_H
 
 #include "Poco/Thread.h"
+#include "Thread/Mutex.hpp"
 #include "Topology/shapelib/mapserver.h"
+#include "Topology/ShapeLodCache.h"
+#ifdef ENABLE_OPENGL
+#include "Screen/OpenGL/PolygonRenderer.h"
+#endif
+#include <atomic>
+#include <memory>
+#include <unordered_map>
 
 class ShapeSpecialRenderer;
 
@@ -34,6 +42,8 @@ class XShape {
   }
 
   virtual void load(shapefileObj* shpfile, int i);
+  // load simplified geometry instead of full resolution one
+  virtual void load(const ShapeLodCache& cache, unsigned level, int i);
   virtual void clear();
 
   virtual bool renderSpecial(ShapeSpecialRenderer& renderer, LKSurface& Surface, int x, int y, const RECT& ClipRect) const {
@@ -45,7 +55,11 @@ class XShape {
   }
 
   bool hide = false;
+  unsigned lod_level = 0; // level of detail of loaded geometry
   shapeObj shape;
+#ifdef ENABLE_OPENGL
+  TessellatedPolygon tessellation; // polygon triangles, cleared each time shape is loaded
+#endif
 };
 
 
@@ -93,6 +107,20 @@ class Topology final {
 
   bool CheckScale();
   void TriggerIfScaleNowVisible();
+  /**
+   * @pixel_size : in meter, used to select level of detail
+   * @return true if level of detail has changed, shapes at new level must be
+   *         prefetched.
+   */
+  bool TriggerIfLodChanged(double pixel_size);
+
+  /**
+   * true if some shapes in cache still have previous level of detail,
+   * updateCache() swap them as soon as they are prefetched.
+   */
+  bool LodPending() const {
+    return _lod_pending;
+  }
 
   bool triggerUpdateCache;
   int shapes_visible_count;
@@ -107,10 +135,48 @@ class Topology final {
   void removeShape(const int i);
   XShape* addShape(const int i);
 
+  /**
+   * true if Prefetch() can be used, only available with bounds array in memory.
+   */
+  bool CanPrefetch() const {
+    return shapefileopen && in_scale && cache_mode == 1;
+  }
+
+  /**
+   * Read shapes overlapping @bounds and not yet in cache, next updateCache()
+   * only have to move them to shpCache. Called by TopologyLoader thread.
+   *
+   * @cancel : checked after each shape, stop loading when true.
+   */
+  void Prefetch(const rectObj& bounds, const std::atomic<bool>& cancel);
+
+  /**
+   * Build next shapes of LOD cache. Called by TopologyLoader thread.
+   * @return true when build is finished.
+   */
+  bool BuildLod();
+
+  struct cache_stats_t {
+    unsigned updates; // updateCache() run
+    unsigned update_max_ms;
+    unsigned update_total_ms;
+    unsigned loaded; // shapes read by updateCache()
+    unsigned prefetched; // shapes read by Prefetch()
+    unsigned prefetch_used; // prefetched shapes moved to cache
+    unsigned prefetch_total_ms;
+  };
+
+  cache_stats_t GetCacheStats() const;
+
  protected:
 
   void flushCache();
 
+  // prefetched shape if available, otherwise read it from file.
+  XShape* takeShape(const int i);
+  // read geometry at current level of detail
+  void loadShape(XShape& theshape, const int i);
+
   bool in_scale;
   LKPen hPen;
   LKBrush hbBrush;
@@ -132,7 +198,19 @@ class Topology final {
   bool in_scale_last;
 
   char filename[MAX_PATH];
+  TCHAR lod_filename[MAX_PATH];
   int field;
+
+  // simplified geometry, only for line and polygon layer
+  std::unique_ptr<ShapeLodCache> _lod;
+  std::unique_ptr<ShapeLodCache::Builder> _lod_builder; // until cache file is built
+  unsigned _lod_level = 0; // level of detail to use
+  bool _lod_pending = false;
+
+  // protect shapefile access, shpCache update, prefetched shapes and LOD cache
+  mutable Mutex _cache_mutex;
+  std::unordered_map<int, std::unique_ptr<XShape>> _prefetched;
+  cache_stats_t _stats = {};
 };
 
 
@@ -10,18 +10,12 @@
 #define __TRACE_H__
 
 #include "PointGPS.h"
-#include <set>
+#include <memory>
+#include <new>
+#include <vector>
 
 class CContestMgr; 
 
-/** 
- * @brief Pointers compare object
- */
-template<class T>
-struct CPtrCmp {
-  bool operator()(const T &left, const T &right) const { return *left < *right; }
-};
-
 
 /** 
  * @brief GPS path trace
@@ -50,11 +44,25 @@ public:
 private:
   friend class CContestMgr; 
 
+  union CPointSlot;
+
+  /**
+   * @brief Points storage
+   *
+   * Points are allocated by chunks which are kept until the trace is destroyed,
+   * removed points are reused for next ones so no allocation is done once the
+   * trace reached its maximum size.
+   */
+  typedef std::vector<std::unique_ptr<CPointSlot[]> > CPointChunkArray;
+  static const unsigned POINT_CHUNK_SIZE = 64;    /**< @brief Number of points allocated at once */
+
   /**
-   * @brief A map of GPS points sorted from the most importand to the least important ones.
-   * 
+   * @brief Min-heap of GPS points, the least important point is on top.
+   *
+   * Each point stores its index inside the heap so it can be removed or
+   * updated without searching.
    */
-  typedef std::set<CPoint *, CPtrCmp<CPoint *> > CPointCostSet;
+  typedef std::vector<CPoint *> CPointCostHeap;
   
   unsigned _maxSize;                              /**< @brief Maximum number of GPS fixes to store inside a trace */
   const unsigned _timeLimit;                      /**< @brief Maximum time period of a trace */
@@ -62,14 +70,25 @@ private:
   bool _valid;                                    /**< @brief Informs that a trace is invalid */
   unsigned _size;                                 /**< @brief Current number of fixes stored in a trace */
   unsigned _analyzedPointCount;                   /**< @brief The number of analysed GPS fixes */
-  CPointCostSet _compressionCostSet;              /**< @brief The sorted set of GPS fixes */
+  CPointCostHeap _compressionCostHeap;            /**< @brief The heap of GPS fixes sorted by compression cost */
+  CPointChunkArray _chunks;                       /**< @brief Points storage */
+  CPointSlot *_freeSlot;                          /**< @brief First unused point storage */
   CPoint *_front;                                 /**< @brief The first GPS fix in a trace */
   CPoint *_back;                                  /**< @brief The last GPS fix in a trace */
   
   CTrace(const CTrace &);                         /**< @brief Disallowed */
   CTrace &operator=(const CTrace &);              /**< @brief Disallowed */
 
+  void *Allocate();
+  void Release(CPoint *point);
+
   void Push(CPoint *point);
+
+  bool HeapContains(const CPoint *point) const;
+  void HeapInsert(CPoint *point);
+  void HeapErase(CPoint *point);
+  void HeapSiftUp(unsigned index);
+  void HeapSiftDown(unsigned index);
   
 public:
   CTrace(unsigned maxSize, unsigned timeLimit, unsigned algorithm);
@@ -78,6 +97,7 @@ public:
   void Clear();
   
   void Push(const CPointGPSSmart &gps);
+  void Push(const CPoint &ref);
   void Compress(unsigned maxSize = 0);
   
   unsigned Size() const               { return _size; }
@@ -85,6 +105,8 @@ public:
   
   const CPoint *Front() const         { return _front; }
   const CPoint *Back() const          { return _back; }
+
+  size_t MemoryUsage() const;
 };
 
 
@@ -97,6 +119,8 @@ public:
 class CTrace::CPoint {
   friend class CTrace;
   friend class CTestContest;
+
+  static const unsigned NOT_IN_HEAP = static_cast<unsigned>(-1);
   
   const CTrace &_trace;                           /**< @brief Parent trace */
   CPointGPSSmart _gps;                            /**< @brief Contained GPS fix */
@@ -106,6 +130,7 @@ class CTrace::CPoint {
   //  float _inheritedCost;                           /**< @brief The cost inherited from compressed (removed) GPS fixes */
   unsigned _distanceCost;                         /**< @brief The distance related compression cost */
   unsigned _timeCost;                             /**< @brief Time related compression cost */
+  unsigned _heapIndex;                            /**< @brief Index inside compression heap, NOT_IN_HEAP if not */
   
   // list iterators
   CPoint *_prev;                                  /**< @brief Previous point in time domain */
@@ -132,6 +157,15 @@ public:
 };
 
 
+/**
+ * @brief Storage of one point, linked to next unused one when free.
+ */
+union CTrace::CPointSlot {
+  CPointSlot *next;
+  alignas(CPoint) unsigned char storage[sizeof(CPoint)];
+};
+
+
 /** 
  * @brief Adds a new GPS fix to a trace
  * 
@@ -140,7 +174,27 @@ public:
 inline void CTrace::Push(const CPointGPSSmart &gps)
 {
   // add new point
-  Push(new CPoint(*this, gps, _back));
+  Push(new(Allocate()) CPoint(*this, gps, _back));
+}
+
+
+/** 
+ * @brief Adds a copy of a point from another trace
+ * 
+ * @param ref Point to copy
+ */
+inline void CTrace::Push(const CPoint &ref)
+{
+  Push(new(Allocate()) CPoint(*this, ref, _back));
+}
+
+
+/** 
+ * @brief Checks if a point is stored in compression heap
+ */
+inline bool CTrace::HeapContains(const CPoint *point) const
+{
+  return point->_heapIndex < _compressionCostHeap.size() && _compressionCostHeap[point->_heapIndex] == point;
 }
 
 
@@ -157,7 +211,7 @@ inline CTrace::CPoint::CPoint(const CTrace &trace, const CPointGPSSmart &gps, CP
   _gps(gps),
   _prevDistance(prev ? prev->_gps->DistanceXYZ(*this->_gps) : 0),
   //  _inheritedCost(0),
-  _distanceCost(0), _timeCost(0),
+  _distanceCost(0), _timeCost(0), _heapIndex(NOT_IN_HEAP),
   _prev(prev), _next(0)
 {
   if(_prev) {
@@ -180,7 +234,7 @@ inline CTrace::CPoint::CPoint(const CTrace &trace, const CPoint &ref, CPoint *pr
   _gps(ref._gps),
   _prevDistance(ref._prevDistance),
   // _inheritedCost(ref._inheritedCost),
-  _distanceCost(ref._distanceCost), _timeCost(ref._timeCost),
+  _distanceCost(ref._distanceCost), _timeCost(ref._timeCost), _heapIndex(NOT_IN_HEAP),
   _prev(prev), _next(0)
 {
   if(_prev) {
@@ -59,6 +59,7 @@ int GetUTCOffset();
 
 #if !defined(UNDER_CE) || defined(__linux__)
 bool LK8000GetOpts(const TCHAR *MyCommandLine);
+bool LK8000GetReplayOpt(const TCHAR *MyCommandLine);
 #endif
 
 bool CheckRectOverlap(const RECT *rc1, const RECT *rc2);
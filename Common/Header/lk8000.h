@@ -12,6 +12,7 @@
 #include "Sizes.h"
 #include <stdint.h>
 #include "Thread/Mutex.hpp"
+#include "Thread/StatMutex.hpp"
 #include "Modeltype.h"
 
 typedef struct _DATAOPTIONS
@@ -22,10 +23,13 @@ typedef struct _DATAOPTIONS
 } DATAOPTIONS;
 
 
-extern Mutex  CritSec_FlightData;
+extern StatMutex  CritSec_FlightData;
 extern void UnlockFlightData();
 extern void LockFlightData();
 
+// copy GPS_INFO to GPS_INFO_Snapshot, CritSec_FlightData must be locked.
+extern void PublishGPSInfo();
+
 extern Mutex  CritSec_TaskData;
 extern void UnlockTaskData();
 extern void LockTaskData();
@@ -0,0 +1,476 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   AirspaceCache.cpp
+ */
+
+#include "externs.h"
+#include "LKAirspace.h"
+#include "AirspaceCache.h"
+#include "md5.h"
+#include "utils/zzip_stream.h"
+#include "utils/filesystem.h"
+#include "Library/cpp-mmf/memory_mapped_file.hpp"
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+  constexpr uint32_t cache_magic = 0x5341544C; // "LTAS"
+  constexpr uint32_t cache_version = 2;
+
+  struct header_t {
+    uint32_t magic;
+    uint32_t version;
+    CAirspaceCache::key_t key;
+    uint32_t count;
+    uint32_t reserved;
+  };
+
+  // record flags
+  enum : uint32_t {
+    flag_circle = 1U << 0,
+    flag_flyzone = 1U << 1,
+    flag_enabled = 1U << 2,
+    flag_except_saturday = 1U << 3,
+    flag_except_sunday = 1U << 4,
+  };
+
+  /*
+   * airspace record, not aligned :
+   *   uint32_t flags;
+   *   int32_t type;
+   *   alt_t base, top;        // 3 double + int32_t
+   *   rectObj bounds;
+   *   string name, comment;   // uint32_t size + utf8 char
+   *   if circle : double latitude, longitude, radius;
+   *   uint32_t numpoints;
+   *   double points[2 * numpoints]; // latitude, longitude
+   */
+
+  bool SourceMD5(const TCHAR* source, char (&md5)[32]) {
+    zzip_stream file(source, "rb");
+    if (!file) {
+      return false;
+    }
+
+    MD5 hash;
+    char buffer[4096];
+    std::streamsize size;
+    while ((size = file.sgetn(buffer, sizeof(buffer))) > 0) {
+      hash.Update(buffer, size);
+    }
+    const std::string digest = hash.Final();
+
+    memset(md5, 0, sizeof(md5));
+    memcpy(md5, digest.data(), std::min(digest.size(), sizeof(md5)));
+    return true;
+  }
+
+  bool HasMD5(const CAirspaceCache::key_t& key) {
+    return key.md5[0] != '\0';
+  }
+
+  // rewrite key of valid cache file, so next startup don't need to compute MD5 again.
+  void UpdateKey(const TCHAR* path, const CAirspaceCache::key_t& key) {
+    FILE* file = _tfopen(path, _T("r+b"));
+    if (file) {
+      if (fseek(file, offsetof(header_t, key), SEEK_SET) == 0) {
+        fwrite(&key, sizeof(key), 1, file);
+      }
+      fclose(file);
+    }
+  }
+
+  class writer_t {
+  public:
+    template<typename T>
+    void Put(const T& value) {
+      static_assert(std::is_trivially_copyable_v<T>, "incompatible type");
+      const char* p = reinterpret_cast<const char*>(&value);
+      _data.insert(_data.end(), p, p + sizeof(T));
+    }
+
+    void Put(const std::string& value) {
+      Put<uint32_t>(value.size());
+      _data.insert(_data.end(), value.begin(), value.end());
+    }
+
+    void Put(const AIRSPACE_ALT& value) {
+      Put(value.Altitude);
+      Put(value.FL);
+      Put(value.AGL);
+      Put<int32_t>(value.Base);
+    }
+
+    const std::vector<char>& data() const {
+      return _data;
+    }
+
+  private:
+    std::vector<char> _data;
+  };
+
+  class reader_t {
+  public:
+    reader_t(const char* data, size_t size) : _data(data), _end(data + size) { }
+
+    template<typename T>
+    bool Get(T& value) {
+      static_assert(std::is_trivially_copyable_v<T>, "incompatible type");
+      if (Remain() < sizeof(T)) {
+        return false;
+      }
+      memcpy(&value, _data, sizeof(T));
+      _data += sizeof(T);
+      return true;
+    }
+
+    bool Get(std::string& value) {
+      uint32_t size;
+      if (!Get(size) || Remain() < size) {
+        return false;
+      }
+      value.assign(_data, size);
+      _data += size;
+      return true;
+    }
+
+    bool Get(AIRSPACE_ALT& value) {
+      int32_t base;
+      if (!Get(value.Altitude) || !Get(value.FL) || !Get(value.AGL) || !Get(base)) {
+        return false;
+      }
+      if (base < abUndef || base > abFL) {
+        return false;
+      }
+      value.Base = static_cast<AirspaceAltBase_t>(base);
+      return true;
+    }
+
+    size_t Remain() const {
+      return _end - _data;
+    }
+
+  private:
+    const char* _data;
+    const char* _end;
+  };
+
+  void Write(writer_t& writer, const CAirspace& airspace) {
+    const CAirspace_Circle* circle = dynamic_cast<const CAirspace_Circle*>(&airspace);
+
+    uint32_t flags = 0;
+    if (circle) flags |= flag_circle;
+    if (airspace.Flyzone()) flags |= flag_flyzone;
+    if (airspace.Enabled()) flags |= flag_enabled;
+    if (airspace.ExceptSaturday()) flags |= flag_except_saturday;
+    if (airspace.ExceptSunday()) flags |= flag_except_sunday;
+
+    writer.Put(flags);
+    writer.Put<int32_t>(airspace.Type());
+    writer.Put(*airspace.Base());
+    writer.Put(*airspace.Top());
+    writer.Put(airspace.Bounds());
+    writer.Put(to_utf8(airspace.Name()));
+    writer.Put(to_utf8(airspace.Comment() ? airspace.Comment() : _T("")));
+    if (circle) {
+      writer.Put(circle->Center().latitude);
+      writer.Put(circle->Center().longitude);
+      writer.Put(circle->Radius());
+    }
+
+    const CPoint2DArray& points = airspace.Points();
+    writer.Put<uint32_t>(points.size());
+    for (const CPoint2D& pt : points) {
+      writer.Put(pt.Latitude());
+      writer.Put(pt.Longitude());
+    }
+  }
+
+  std::unique_ptr<CAirspace> Read(reader_t& reader) {
+    uint32_t flags;
+    int32_t type;
+    AIRSPACE_ALT base, top;
+    rectObj bounds;
+    std::string name, comment;
+    if (!reader.Get(flags) || !reader.Get(type) || !reader.Get(base) || !reader.Get(top)
+            || !reader.Get(bounds) || !reader.Get(name) || !reader.Get(comment)) {
+      return nullptr;
+    }
+    if (type < 0 || type >= AIRSPACECLASSCOUNT) {
+      return nullptr;
+    }
+
+    GeoPoint center;
+    double radius = 0;
+    if (flags & flag_circle) {
+      if (!reader.Get(center.latitude) || !reader.Get(center.longitude) || !reader.Get(radius)) {
+        return nullptr;
+      }
+    }
+
+    uint32_t numpoints;
+    if (!reader.Get(numpoints) || reader.Remain() / (2 * sizeof(double)) < numpoints) {
+      return nullptr;
+    }
+    if (numpoints < 3) {
+      return nullptr; // parser never build airspace with less than 3 points
+    }
+
+    CPoint2DArray points;
+    points.reserve(numpoints);
+    for (uint32_t i = 0; i < numpoints; ++i) {
+      double lat, lon;
+      reader.Get(lat);
+      reader.Get(lon);
+      points.emplace_back(lat, lon);
+    }
+
+    std::unique_ptr<CAirspace> airspace;
+    if (flags & flag_circle) {
+      airspace.reset(new (std::nothrow) CAirspace_Circle(center, radius, std::move(points), bounds));
+    } else {
+      airspace.reset(new (std::nothrow) CAirspace_Area(std::move(points), bounds));
+    }
+    if (airspace) {
+      airspace->Init(utf8_to_tstring(name).c_str(), type, base, top, (flags & flag_flyzone), utf8_to_tstring(comment).c_str());
+      airspace->Enabled(flags & flag_enabled);
+      airspace->ExceptSaturday(flags & flag_except_saturday);
+      airspace->ExceptSunday(flags & flag_except_sunday);
+    }
+    return airspace;
+  }
+
+} // namespace
+
+
+bool CAirspaceCache::Key(const TCHAR* source, key_t& key) {
+  key = {};
+#ifdef _WGS84
+  key.wgs84 = earth_model_wgs84;
+#endif
+  key.size = lk::filesystem::getFileSize(source);
+  key.mtime = lk::filesystem::getLastWriteTime(source);
+  if (key.size == 0 || key.mtime == 0) {
+    // not a regular file (e.g. inside zip archive) : only content can identify it.
+    key.size = 0;
+    key.mtime = 0;
+    return SourceMD5(source, key.md5);
+  }
+  return true;
+}
+
+
+bool CAirspaceCache::Load(const TCHAR* path, const TCHAR* source, key_t& key, CAirspaceList& airspaces) {
+  memory_mapped_file::read_only_mmf file(path);
+  if (!file.is_open() || !file.data()) {
+    return false;
+  }
+
+  reader_t reader(file.data(), file.mapped_size());
+
+  header_t header;
+  if (!reader.Get(header)) {
+    return false;
+  }
+  if (header.magic != cache_magic || header.version != cache_version
+          || header.key.wgs84 != key.wgs84 || header.key.size != key.size) {
+    return false;
+  }
+
+  // same size but different or unknown write time : file can be a copy or only touched, compare content.
+  const bool check_md5 = (key.mtime == 0 || header.key.mtime != key.mtime);
+  if (check_md5) {
+    if (!HasMD5(key) && !SourceMD5(source, key.md5)) {
+      return false;
+    }
+    if (memcmp(header.key.md5, key.md5, sizeof(key.md5)) != 0) {
+      return false;
+    }
+  }
+
+  std::vector<std::unique_ptr<CAirspace>> loaded;
+  loaded.reserve(std::min<size_t>(header.count, reader.Remain() / 64)); // count is not trusted
+  for (uint32_t i = 0; i < header.count; ++i) {
+    std::unique_ptr<CAirspace> airspace = Read(reader);
+    if (!airspace) {
+      StartupStore(_T("... Invalid airspace cache <%s>%s"), path, NEWLINE);
+      return false;
+    }
+    loaded.push_back(std::move(airspace));
+  }
+
+  for (auto& airspace : loaded) {
+    airspaces.push_back(airspace.release());
+  }
+
+  if (check_md5 && key.mtime != 0) {
+    file.close();
+    UpdateKey(path, key);
+  }
+  return true;
+}
+
+
+bool CAirspaceCache::Save(const TCHAR* path, const TCHAR* source, key_t& key,
+                          CAirspaceList::const_iterator begin, CAirspaceList::const_iterator end) {
+  if (!HasMD5(key) && !SourceMD5(source, key.md5)) {
+    return false;
+  }
+
+  writer_t writer;
+  writer.Put<header_t>({ cache_magic, cache_version, key, static_cast<uint32_t>(std::distance(begin, end)), 0 });
+  for (auto it = begin; it != end; ++it) {
+    Write(writer, *(*it));
+  }
+
+  TCHAR tmp_path[MAX_PATH];
+  _sntprintf(tmp_path, MAX_PATH, _T("%s.tmp"), path);
+  tmp_path[MAX_PATH - 1] = _T('\0');
+
+  FILE* file = _tfopen(tmp_path, _T("wb"));
+  if (!file) {
+    return false;
+  }
+
+  const std::vector<char>& data = writer.data();
+  bool success = (fwrite(data.data(), 1, data.size(), file) == data.size());
+  success = (fclose(file) == 0) && success;
+
+  if (success) {
+    lk::filesystem::deleteFile(path);
+    success = lk::filesystem::moveFile(tmp_path, path);
+  }
+  if (!success) {
+    lk::filesystem::deleteFile(tmp_path);
+  }
+  return success;
+}
+
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+namespace {
+  bool write_file(const TCHAR* path, const char* content) {
+    FILE* file = _tfopen(path, _T("wb"));
+    if (!file) {
+      return false;
+    }
+    const size_t size = strlen(content);
+    const bool success = (fwrite(content, 1, size, file) == size);
+    return (fclose(file) == 0) && success;
+  }
+}
+
+TEST_SUITE("CAirspaceCache") {
+
+  TEST_CASE("save and load") {
+    TCHAR path[MAX_PATH];
+    REQUIRE(lk::filesystem::getTempPath(path, MAX_PATH));
+    TCHAR source[MAX_PATH];
+    _tcscpy(source, path);
+    _tcscat(path, _T("AirspaceCache_test.bin"));
+    _tcscat(source, _T("AirspaceCache_test.txt"));
+    lk::filesystem::deleteFile(path);
+    REQUIRE(write_file(source, "AC D\nAN TMA TEST\n"));
+
+    const AIRSPACE_ALT base = { 500., 0., 0., abMSL };
+    const AIRSPACE_ALT top = { 0., 95., 0., abFL };
+
+    CAirspaceList airspaces;
+
+    CPoint2DArray points;
+    points.emplace_back(45.0, 6.0);
+    points.emplace_back(45.1, 6.0);
+    points.emplace_back(45.1, 6.2);
+    points.emplace_back(45.0, 6.0);
+    airspaces.push_back(new CAirspace_Area(std::move(points)));
+    airspaces.back()->Init(_T("TMA TEST"), CLASSD, base, top, false, _T("comment\nline 2"));
+    airspaces.back()->ExceptSunday(true);
+
+    airspaces.push_back(new CAirspace_Circle(GeoPoint(46., 7.), 5000.));
+    airspaces.back()->Init(_T("CTR TEST"), CTR, base, top, true);
+    airspaces.back()->Enabled(false);
+
+    CAirspaceCache::key_t key;
+    REQUIRE(CAirspaceCache::Key(source, key));
+    CHECK(key.size == 17);
+    CHECK(key.md5[0] == '\0');
+
+    REQUIRE(CAirspaceCache::Save(path, source, key, airspaces.begin(), airspaces.end()));
+    CHECK(key.md5[0] != '\0');
+
+    // unchanged source : md5 is not computed
+    REQUIRE(CAirspaceCache::Key(source, key));
+    CAirspaceList loaded;
+    REQUIRE(CAirspaceCache::Load(path, source, key, loaded));
+    CHECK(key.md5[0] == '\0');
+    REQUIRE(loaded.size() == airspaces.size());
+
+    for (size_t i = 0; i < loaded.size(); ++i) {
+      const CAirspace* a = airspaces[i];
+      const CAirspace* b = loaded[i];
+      CHECK(_tcscmp(a->Name(), b->Name()) == 0);
+      CHECK(_tcscmp(a->Comment(), b->Comment()) == 0);
+      CHECK(a->Type() == b->Type());
+      CHECK(a->Flyzone() == b->Flyzone());
+      CHECK(a->Enabled() == b->Enabled());
+      REQUIRE(a->Points().size() == b->Points().size());
+      for (size_t j = 0; j < a->Points().size(); ++j) {
+        // CAirspace::Hash() can't be used, it include CPoint2D padding.
+        CHECK(a->Points()[j].Latitude() == b->Points()[j].Latitude());
+        CHECK(a->Points()[j].Longitude() == b->Points()[j].Longitude());
+      }
+      CHECK(a->Bounds().minx == b->Bounds().minx);
+      CHECK(a->Bounds().maxy == b->Bounds().maxy);
+      CHECK(a->IsHorizontalInside(6.05, 45.05) == b->IsHorizontalInside(6.05, 45.05));
+      CHECK(a->IsHorizontalInside(7.01, 46.01) == b->IsHorizontalInside(7.01, 46.01));
+    }
+    CHECK(static_cast<CAirspace_Circle*>(loaded[1])->Radius() == 5000.);
+
+    // touched source : md5 is computed and new write time is stored in cache
+    // write time is in second, source can have the same write time than cache.
+    REQUIRE(CAirspaceCache::Key(source, key));
+    key.mtime += 1;
+    CAirspaceList touched;
+    CHECK(CAirspaceCache::Load(path, source, key, touched));
+    CHECK(key.md5[0] != '\0');
+    CHECK(touched.size() == airspaces.size());
+    std::for_each(touched.begin(), touched.end(), std::default_delete<CAirspace>());
+
+    memset(key.md5, 0, sizeof(key.md5));
+    touched.clear();
+    CHECK(CAirspaceCache::Load(path, source, key, touched));
+    CHECK(key.md5[0] == '\0');
+    std::for_each(touched.begin(), touched.end(), std::default_delete<CAirspace>());
+
+    // modified source with same size : outdated cache is rejected
+    REQUIRE(write_file(source, "AC C\nAN TMA TEST\n"));
+    REQUIRE(CAirspaceCache::Key(source, key));
+    key.mtime += 2;
+    CAirspaceList outdated;
+    CHECK_FALSE(CAirspaceCache::Load(path, source, key, outdated));
+    CHECK(outdated.empty());
+
+    // modified source with different size : md5 is not computed
+    REQUIRE(write_file(source, "AC C\nAN CTR\n"));
+    REQUIRE(CAirspaceCache::Key(source, key));
+    CHECK_FALSE(CAirspaceCache::Load(path, source, key, outdated));
+    CHECK(key.md5[0] == '\0');
+    CHECK(outdated.empty());
+
+    std::for_each(airspaces.begin(), airspaces.end(), std::default_delete<CAirspace>());
+    std::for_each(loaded.begin(), loaded.end(), std::default_delete<CAirspace>());
+    lk::filesystem::deleteFile(path);
+    lk::filesystem::deleteFile(source);
+  }
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   AirspaceCache.h
+ */
+
+#ifndef AIRSPACE_AIRSPACECACHE_H
+#define AIRSPACE_AIRSPACECACHE_H
+
+#include "tchar.h"
+#include <cstdint>
+#include <deque>
+
+class CAirspace;
+typedef std::deque<CAirspace*> CAirspaceList;
+
+/**
+ * Binary copy of airspaces loaded from one OpenAir or OpenAIP file, stored
+ * next to the source file.
+ *
+ * It contains the airspaces exactly as built by the parser : densified
+ * polygon points, bounds and attributes. Loading it only needs to memory map
+ * the file and create airspaces, without any text parsing nor geodesic
+ * calculation.
+ *
+ * Cache is identified by the size, the last write time and the MD5 of the
+ * source file, and by the earth model used for arcs and geodesic lines. MD5
+ * is only computed when size match but write time doesn't, or when write time
+ * is unknown (file inside zip archive), so an unchanged file is never read.
+ */
+class CAirspaceCache final {
+public:
+  struct key_t {
+    uint64_t size; // size of source file, 0 if unknown
+    uint64_t mtime; // last write time of source file, 0 if unknown
+    char md5[32]; // hex md5 digest of source file, empty until computed
+    uint32_t wgs84; // earth model
+    uint32_t reserved;
+  };
+
+  /**
+   * Compute the key of @source file.
+   * @return false if file can't be read.
+   */
+  static bool Key(const TCHAR* source, key_t& key);
+
+  /**
+   * Append to @airspaces all airspaces stored in cache file @path.
+   * MD5 of @source is computed and stored in @key if needed.
+   * @return false if cache is missing, outdated or invalid, @airspaces is
+   *         then unchanged.
+   */
+  static bool Load(const TCHAR* path, const TCHAR* source, key_t& key, CAirspaceList& airspaces);
+
+  /**
+   * Write airspaces [@begin, @end) to cache file @path.
+   * MD5 of @source is computed and stored in @key if needed.
+   */
+  static bool Save(const TCHAR* path, const TCHAR* source, key_t& key,
+                   CAirspaceList::const_iterator begin, CAirspaceList::const_iterator end);
+};
+
+#endif // AIRSPACE_AIRSPACECACHE_H
@@ -0,0 +1,402 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   AirspaceIndex.cpp
+ */
+
+#include "externs.h"
+#include "LKAirspace.h"
+#include "AirspaceIndex.h"
+#include "Topology/shapelib/mapserver.h"
+#include "Util/Clamp.hpp"
+#include <cmath>
+
+namespace {
+
+  // minimum length of one degree of latitude (at equator)
+  constexpr double min_meter_per_degree = 110574.;
+
+  constexpr int max_grid_size = 512;
+
+  bool IsWrapped(const rectObj& bounds) {
+    return bounds.minx > bounds.maxx;
+  }
+
+} // namespace
+
+void CAirspaceIndex::Clear() {
+  _items.clear();
+  _wrapped.clear();
+  _cell_offset.clear();
+  _cell_items.clear();
+  _candidates.clear();
+  _extent = {};
+  _nx = 0;
+  _ny = 0;
+}
+
+int CAirspaceIndex::CellX(double longitude) const {
+  return Clamp<int>((longitude - _extent.minx) / _cell_width, 0, _nx - 1);
+}
+
+int CAirspaceIndex::CellY(double latitude) const {
+  return Clamp<int>((latitude - _extent.miny) / _cell_height, 0, _ny - 1);
+}
+
+void CAirspaceIndex::Build(const CAirspaceList& airspaces) {
+  Clear();
+
+  _items.assign(airspaces.begin(), airspaces.end());
+
+  bool first = true;
+  for (unsigned i = 0; i < _items.size(); ++i) {
+    const rectObj& bounds = _items[i]->Bounds();
+    if (IsWrapped(bounds)) {
+      _wrapped.push_back(i);
+      continue;
+    }
+    if (first) {
+      _extent = bounds;
+      first = false;
+    } else {
+      _extent.minx = std::min(_extent.minx, bounds.minx);
+      _extent.miny = std::min(_extent.miny, bounds.miny);
+      _extent.maxx = std::max(_extent.maxx, bounds.maxx);
+      _extent.maxy = std::max(_extent.maxy, bounds.maxy);
+    }
+  }
+
+  const unsigned count = _items.size() - _wrapped.size();
+  if (count == 0) {
+    return;
+  }
+
+  // about one cell per airspace, keeping cells roughly square
+  const double width = std::max(_extent.maxx - _extent.minx, 1e-6);
+  const double height = std::max(_extent.maxy - _extent.miny, 1e-6);
+  const double cells = Clamp<double>(count, 16, max_grid_size * max_grid_size);
+
+  _nx = Clamp<int>(std::ceil(std::sqrt(cells * width / height)), 1, max_grid_size);
+  _ny = Clamp<int>(std::ceil(cells / _nx), 1, max_grid_size);
+  _cell_width = width / _nx;
+  _cell_height = height / _ny;
+
+  // first pass : count items per cell
+  _cell_offset.assign(_nx * _ny + 1, 0);
+  for (CAirspace* pAsp : _items) {
+    const rectObj& bounds = pAsp->Bounds();
+    if (IsWrapped(bounds)) {
+      continue;
+    }
+    const int x1 = CellX(bounds.maxx);
+    const int y1 = CellY(bounds.maxy);
+    for (int y = CellY(bounds.miny); y <= y1; ++y) {
+      for (int x = CellX(bounds.minx); x <= x1; ++x) {
+        ++_cell_offset[y * _nx + x + 1];
+      }
+    }
+  }
+  for (unsigned c = 1; c < _cell_offset.size(); ++c) {
+    _cell_offset[c] += _cell_offset[c - 1];
+  }
+
+  // second pass : fill cells, items stay sorted inside each cell.
+  std::vector<unsigned> fill(_cell_offset.begin(), std::prev(_cell_offset.end()));
+  _cell_items.resize(_cell_offset.back());
+  for (unsigned i = 0; i < _items.size(); ++i) {
+    const rectObj& bounds = _items[i]->Bounds();
+    if (IsWrapped(bounds)) {
+      continue;
+    }
+    const int x1 = CellX(bounds.maxx);
+    const int y1 = CellY(bounds.maxy);
+    for (int y = CellY(bounds.miny); y <= y1; ++y) {
+      for (int x = CellX(bounds.minx); x <= x1; ++x) {
+        _cell_items[fill[y * _nx + x]++] = i;
+      }
+    }
+  }
+}
+
+void CAirspaceIndex::Candidates(const rectObj& bounds, std::vector<unsigned>& candidates) const {
+  candidates.clear();
+  if (_items.empty()) {
+    return;
+  }
+
+  if (IsWrapped(bounds)) {
+    // seldom case, not worth to be optimized.
+    candidates.resize(_items.size());
+    for (unsigned i = 0; i < candidates.size(); ++i) {
+      candidates[i] = i;
+    }
+    return;
+  }
+
+  if (_nx > 0 && msRectOverlap(&bounds, &_extent) == MS_TRUE) {
+    const int x0 = CellX(bounds.minx);
+    const int x1 = CellX(bounds.maxx);
+    const int y1 = CellY(bounds.maxy);
+    for (int y = CellY(bounds.miny); y <= y1; ++y) {
+      const unsigned* begin = _cell_items.data() + _cell_offset[y * _nx + x0];
+      const unsigned* end = _cell_items.data() + _cell_offset[y * _nx + x1 + 1];
+      candidates.insert(candidates.end(), begin, end);
+    }
+  }
+  candidates.insert(candidates.end(), _wrapped.begin(), _wrapped.end());
+
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+rectObj CAirspaceIndex::RangeBounds(double latitude, double longitude, double radius) {
+  // 1% margin to be safe with ellipsoid and rounding
+  const double dlat = 1.01 * radius / min_meter_per_degree;
+  const double max_lat = std::abs(latitude) + dlat;
+  if (max_lat >= 89.) {
+    return { -180., -90., 180., 90. };
+  }
+
+  const double dlon = dlat / std::cos(max_lat * DEG_TO_RAD);
+  if (dlon >= 180.) {
+    return { -180., -90., 180., 90. };
+  }
+
+  rectObj bounds = {
+    longitude - dlon,
+    latitude - dlat,
+    longitude + dlon,
+    latitude + dlat
+  };
+
+  // rect crossing the 180 meridian
+  if (bounds.minx < -180.) {
+    bounds.minx += 360.;
+  }
+  if (bounds.maxx > 180.) {
+    bounds.maxx -= 360.;
+  }
+  return bounds;
+}
+
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <chrono>
+#include <random>
+
+namespace {
+
+  struct SyntheticAirspaces {
+
+    explicit SyntheticAirspaces(unsigned count) {
+      // deterministic set of polygons and circles over central Europe.
+      std::mt19937 rand(count);
+      std::uniform_real_distribution<double> lat_dist(43., 55.);
+      std::uniform_real_distribution<double> lon_dist(-2., 18.);
+      std::uniform_real_distribution<double> size_dist(0.01, 0.3);
+
+      for (unsigned i = 0; i < count; ++i) {
+        const double lat = lat_dist(rand);
+        const double lon = lon_dist(rand);
+        const double size = size_dist(rand);
+        if (i % 8) {
+          CPoint2DArray points;
+          points.emplace_back(lat, lon);
+          points.emplace_back(lat + size, lon + size / 3);
+          points.emplace_back(lat + size / 2, lon + size);
+          points.emplace_back(lat - size / 3, lon + size / 2);
+          points.emplace_back(lat, lon);
+          list.push_back(new CAirspace_Area(std::move(points)));
+        } else {
+          list.push_back(new CAirspace_Circle({lat, lon}, size * 20000.));
+        }
+      }
+      index.Build(list);
+    }
+
+    ~SyntheticAirspaces() {
+      std::for_each(list.begin(), list.end(), std::default_delete<CAirspace>());
+    }
+
+    CAirspaceList list;
+    CAirspaceIndex index;
+  };
+
+  CAirspaceList LinearOverlap(const CAirspaceList& list, const rectObj& bounds) {
+    CAirspaceList res;
+    for (CAirspace* pAsp : list) {
+      if (msRectOverlap(&bounds, &pAsp->Bounds()) == MS_TRUE) {
+        res.push_back(pAsp);
+      }
+    }
+    return res;
+  }
+
+  CAirspaceList IndexOverlap(const CAirspaceIndex& index, const rectObj& bounds) {
+    CAirspaceList res;
+    index.ForEach(bounds, [&](CAirspace* pAsp) {
+      if (msRectOverlap(&bounds, &pAsp->Bounds()) == MS_TRUE) {
+        res.push_back(pAsp);
+      }
+    });
+    return res;
+  }
+
+  template<typename Func>
+  double Measure(unsigned loop, Func&& func) {
+    using std::chrono::steady_clock;
+    const auto start = steady_clock::now();
+    for (unsigned i = 0; i < loop; ++i) {
+      func(i);
+    }
+    const std::chrono::duration<double, std::micro> elapsed = steady_clock::now() - start;
+    return elapsed.count() / loop;
+  }
+
+} // namespace
+
+TEST_SUITE("Airspace index") {
+
+  TEST_CASE("same result as linear scan") {
+    SyntheticAirspaces airspaces(2000);
+    std::mt19937 rand(0);
+    std::uniform_real_distribution<double> lat_dist(42., 56.);
+    std::uniform_real_distribution<double> lon_dist(-3., 19.);
+
+    SUBCASE("rect") {
+      for (unsigned i = 0; i < 200; ++i) {
+        const double lat = lat_dist(rand);
+        const double lon = lon_dist(rand);
+        const rectObj bounds = { lon, lat, lon + 0.5, lat + 0.3 };
+        CHECK(IndexOverlap(airspaces.index, bounds) == LinearOverlap(airspaces.list, bounds));
+      }
+    }
+
+    SUBCASE("point") {
+      for (unsigned i = 0; i < 200; ++i) {
+        const double lat = lat_dist(rand);
+        const double lon = lon_dist(rand);
+        const rectObj bounds = { lon, lat, lon, lat };
+        CHECK(IndexOverlap(airspaces.index, bounds) == LinearOverlap(airspaces.list, bounds));
+      }
+    }
+
+    SUBCASE("range") {
+      for (unsigned i = 0; i < 200; ++i) {
+        const double lat = lat_dist(rand);
+        const double lon = lon_dist(rand);
+        const rectObj bounds = CAirspaceIndex::RangeBounds(lat, lon, 100000);
+        CHECK(IndexOverlap(airspaces.index, bounds) == LinearOverlap(airspaces.list, bounds));
+      }
+    }
+  }
+
+  TEST_CASE("nested query") {
+    SyntheticAirspaces airspaces(2000);
+    const rectObj outer = { 5., 45., 6., 46. };
+    const rectObj inner = { 10., 50., 10.5, 50.5 };
+    const CAirspaceList expected = LinearOverlap(airspaces.list, inner);
+
+    CAirspaceList outer_list;
+    airspaces.index.ForEach(outer, [&](CAirspace* pAsp) {
+      if (msRectOverlap(&outer, &pAsp->Bounds()) == MS_TRUE) {
+        outer_list.push_back(pAsp);
+        CHECK(IndexOverlap(airspaces.index, inner) == expected);
+      }
+    });
+    CHECK(outer_list == LinearOverlap(airspaces.list, outer));
+  }
+
+  TEST_CASE("range bounds") {
+    SUBCASE("contains range") {
+      const rectObj bounds = CAirspaceIndex::RangeBounds(45., 5., 100000.);
+      double lat, lon;
+      for (double bearing = 0; bearing < 360; bearing += 5) {
+        FindLatitudeLongitude(45., 5., bearing, 100000., &lat, &lon);
+        CHECK(lat > bounds.miny);
+        CHECK(lat < bounds.maxy);
+        CHECK(lon > bounds.minx);
+        CHECK(lon < bounds.maxx);
+      }
+    }
+    SUBCASE("180 meridian") {
+      const rectObj bounds = CAirspaceIndex::RangeBounds(-40., 179.5, 100000.);
+      CHECK(bounds.minx > bounds.maxx);
+    }
+  }
+
+  TEST_CASE("benchmark" * doctest::skip()) {
+    SyntheticAirspaces airspaces(20000);
+    std::mt19937 rand(0);
+    std::uniform_real_distribution<double> lat_dist(43., 55.);
+    std::uniform_real_distribution<double> lon_dist(-2., 18.);
+
+    constexpr unsigned loop = 500;
+    std::vector<std::pair<double, double>> points;
+    for (unsigned i = 0; i < loop; ++i) {
+      points.emplace_back(lat_dist(rand), lon_dist(rand));
+    }
+
+    size_t found = 0;
+
+    // SetFarVisible / SelectAirspacesForPage24
+    const double rect_linear = Measure(loop, [&](unsigned i) {
+      const auto& p = points[i];
+      found += LinearOverlap(airspaces.list, { p.second - 1, p.first - 0.7, p.second + 1, p.first + 0.7 }).size();
+    });
+    const double rect_index = Measure(loop, [&](unsigned i) {
+      const auto& p = points[i];
+      found += IndexOverlap(airspaces.index, { p.second - 1, p.first - 0.7, p.second + 1, p.first + 0.7 }).size();
+    });
+    MESSAGE("rect overlap : linear ", rect_linear, "us, index ", rect_index, "us");
+
+    // GetVisibleAirspacesAtPoint
+    const double point_linear = Measure(loop, [&](unsigned i) {
+      const auto& p = points[i];
+      for (CAirspace* pAsp : airspaces.list) {
+        found += pAsp->IsHorizontalInside(p.second, p.first);
+      }
+    });
+    const double point_index = Measure(loop, [&](unsigned i) {
+      const auto& p = points[i];
+      airspaces.index.ForEach({ p.second, p.first, p.second, p.first }, [&](CAirspace* pAsp) {
+        found += pAsp->IsHorizontalInside(p.second, p.first);
+      });
+    });
+    MESSAGE("inside point : linear ", point_linear, "us, index ", point_index, "us");
+
+    // FindNearestAirspace
+    constexpr unsigned nearest_loop = 20;
+    auto nearest = [&](double lat, double lon, CAirspace* pAsp, double& nearestd) {
+      double bearing;
+      double dist = pAsp->Range(lon, lat, bearing);
+      if (dist < nearestd) {
+        nearestd = dist;
+      }
+    };
+    const double nearest_linear = Measure(nearest_loop, [&](unsigned i) {
+      const auto& p = points[i];
+      double nearestd = 100000;
+      for (CAirspace* pAsp : airspaces.list) {
+        nearest(p.first, p.second, pAsp, nearestd);
+      }
+      found += (nearestd < 100000);
+    });
+    const double nearest_index = Measure(nearest_loop, [&](unsigned i) {
+      const auto& p = points[i];
+      double nearestd = 100000;
+      airspaces.index.ForEach(CAirspaceIndex::RangeBounds(p.first, p.second, nearestd), [&](CAirspace* pAsp) {
+        nearest(p.first, p.second, pAsp, nearestd);
+      });
+      found += (nearestd < 100000);
+    });
+    MESSAGE("nearest : linear ", nearest_linear, "us, index ", nearest_index, "us");
+
+    CHECK(found > 0);
+  }
+}
+
+#endif
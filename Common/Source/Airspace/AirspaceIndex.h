@@ -0,0 +1,85 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   AirspaceIndex.h
+ */
+
+#ifndef AIRSPACE_AIRSPACEINDEX_H
+#define AIRSPACE_AIRSPACEINDEX_H
+
+#include "Topology/shapelib/mapprimitive.h"
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <utility>
+
+class CAirspace;
+typedef std::deque<CAirspace*> CAirspaceList;
+
+/**
+ * Uniform lat/lon grid of airspace bounding boxes.
+ *
+ * Built once when airspaces are loaded, it is used to select candidate
+ * airspaces for a geographic rectangle without walking the full list.
+ * Result is always a superset of airspaces whose bounds overlap the query,
+ * callers still have to do their own exact test.
+ *
+ * Candidates are returned in the order of the list given to Build().
+ * Not thread safe : caller must hold CAirspaceManager mutex.
+ */
+class CAirspaceIndex final {
+public:
+  void Build(const CAirspaceList& airspaces);
+  void Clear();
+
+  bool empty() const {
+    return _items.empty();
+  }
+
+  /**
+   * call @func for each airspace whose bounds can overlap @bounds
+   *  @bounds.minx > @bounds.maxx means rect cross the 180 meridian.
+   */
+  template<typename Func>
+  void ForEach(const rectObj& bounds, Func&& func) const {
+    // reuse buffer of previous query : no allocation in hot path.
+    // moved out while in use, so nested call still works.
+    std::vector<unsigned> candidates = std::move(_candidates);
+    Candidates(bounds, candidates);
+    for (unsigned idx : candidates) {
+      func(_items[idx]);
+    }
+    _candidates = std::move(candidates);
+  }
+
+  /**
+   * @return rect that contains circle of @radius meters around given point.
+   *   a bit larger than needed, never smaller.
+   */
+  static rectObj RangeBounds(double latitude, double longitude, double radius);
+
+private:
+  void Candidates(const rectObj& bounds, std::vector<unsigned>& candidates) const;
+
+  int CellX(double longitude) const;
+  int CellY(double latitude) const;
+
+  std::vector<CAirspace*> _items;   // in Build() order
+  std::vector<unsigned> _wrapped;   // index of items crossing the 180 meridian, always candidates.
+
+  rectObj _extent = {};             // union of all non wrapped airspace bounds
+  double _cell_width = 1;
+  double _cell_height = 1;
+  int _nx = 0;
+  int _ny = 0;
+
+  // compact cell storage : items of cell `c` are _cell_items[_cell_offset[c] ... _cell_offset[c+1]]
+  std::vector<unsigned> _cell_offset;
+  std::vector<unsigned> _cell_items;
+
+  mutable std::vector<unsigned> _candidates; // ForEach() buffer
+};
+
+#endif // AIRSPACE_AIRSPACEINDEX_H
@@ -23,6 +23,7 @@
 #include "Draw/ScreenProjection.h"
 #include "NavFunctions.h"
 #include "Util/TruncateString.hpp"
+#include "Util/Clamp.hpp"
 
 #include "Topology/shapelib/mapserver.h"
 #include "utils/zzip_stream.h"
@@ -32,6 +33,8 @@
 #include "utils/tokenizer.h"
 #include "utils/printf.h"
 #include "Library/TimeFunctions.h"
+#include "Airspace/AirspaceCache.h"
+#include "Time/PeriodClock.hpp"
 #include "Baro.h"
 
 using xml_document = rapidxml::xml_document<char>;
@@ -802,6 +805,13 @@ CAirspace_Circle::CAirspace_Circle(const GeoPoint &Center, const double Radius)
     AirspaceAGLLookup(Center.latitude, Center.longitude, &_base.Altitude, &_top.Altitude);
 }
 
+CAirspace_Circle::CAirspace_Circle(const GeoPoint &Center, double Radius, CPoint2DArray &&Points, const rectObj &Bounds)
+    : CAirspace(std::forward<CPoint2DArray>(Points)), _center(Center), _radius(Radius)
+{
+    _bounds = Bounds;
+    AirspaceAGLLookup(Center.latitude, Center.longitude, &_base.Altitude, &_top.Altitude);
+}
+
 // Dumps object instance to Runtime.log
 
 void CAirspace_Circle::Dump() const {
@@ -850,18 +860,104 @@ double CAirspace_Circle::Range(const double &longitude, const double &latitude,
     return distance;
 }
 
+// Distance to center is unimodal along scan line (samples are on a geodesic),
+// so nearest sample, entry and exit are found by dichotomy. Samples far enough
+// inside circle are also inside bounds, IsHorizontalInside() is only called
+// for samples near the border.
+void CAirspace_Circle::ScanLine(const CAirspaceScanLine& line, bool (&inside)[AIRSPACE_SCANSIZE_X]) const {
+    if (_bounds.minx > _bounds.maxx || (_bounds.maxx - _bounds.minx) > 180) {
+        // across 180 meridian
+        CAirspace::ScanLine(line, inside);
+        return;
+    }
 
-template<typename ScreenPointList>
-static void CalculateScreenPolygon(const ScreenProjection &_Proj, const CPoint2DArray& geopoints, ScreenPointList& screenpoints) {
-    using ScreenPoint = typename ScreenPointList::value_type;
+    std::fill(std::begin(inside), std::end(inside), false);
+    if (msRectOverlap(&line.bounds, &_bounds) != MS_TRUE) {
+        return;
+    }
 
-    const GeoToScreen<ScreenPoint> ToScreen(_Proj);
+    auto range = [&](int i) {
+        double bearing;
+        return Range(line.lons[i], line.lats[i], bearing);
+    };
+
+    // ternary search of nearest sample
+    int lo = 0, hi = AIRSPACE_SCANSIZE_X - 1;
+    while ((hi - lo) > 2) {
+        const int m1 = lo + (hi - lo) / 3;
+        const int m2 = hi - (hi - lo) / 3;
+        if (range(m1) < range(m2)) {
+            hi = m2;
+        } else {
+            lo = m1;
+        }
+    }
+    int nearest = lo;
+    double nearest_range = range(lo);
+    for (int i = lo + 1; i <= hi; ++i) {
+        const double r = range(i);
+        if (r < nearest_range) {
+            nearest = i;
+            nearest_range = r;
+        }
+    }
+    if (nearest_range >= 0) {
+        return; // no sample inside circle
+    }
+
+    // first sample of [@begin, nearest] with range below @limit, range(nearest) must be below.
+    auto first_below = [&](int begin, double limit) {
+        int end = nearest;
+        while (begin < end) {
+            const int m = (begin + end) / 2;
+            if (range(m) < limit) {
+                end = m;
+            } else {
+                begin = m + 1;
+            }
+        }
+        return begin;
+    };
+    // last sample of [nearest, @end] with range below @limit, range(nearest) must be below.
+    auto last_below = [&](int end, double limit) {
+        int begin = nearest;
+        while (begin < end) {
+            const int m = (begin + end + 1) / 2;
+            if (range(m) < limit) {
+                begin = m;
+            } else {
+                end = m - 1;
+            }
+        }
+        return end;
+    };
+
+    const int entry = first_below(0, 0);
+    const int exit = last_below(AIRSPACE_SCANSIZE_X - 1, 0);
+
+    // bounds are computed from 90 points on circle, they contain all points
+    // closer than 0.999 * radius, with 2% margin for geodesic approximation.
+    const double deep_limit = -0.02 * _radius;
+    int deep_entry = nearest + 1;
+    int deep_exit = nearest;
+    if (nearest_range < deep_limit) {
+        deep_entry = first_below(entry, deep_limit);
+        deep_exit = last_below(exit, deep_limit);
+        std::fill(inside + deep_entry, inside + deep_exit + 1, true);
+    }
+    for (int i = entry; i < deep_entry; ++i) {
+        inside[i] = IsHorizontalInside(line.lons[i], line.lats[i]);
+    }
+    for (int i = std::max(deep_exit + 1, deep_entry); i <= exit; ++i) {
+        inside[i] = IsHorizontalInside(line.lons[i], line.lats[i]);
+    }
+}
 
-    screenpoints.reserve(geopoints.size());
-    std::transform(
-            std::begin(geopoints), std::end(geopoints),
-            std::back_inserter(screenpoints),
-            std::ref(ToScreen));
+
+template<typename ScreenPointList>
+static void CalculateScreenPolygon(const ScreenProjection &_Proj, const CPoint2DArray& geopoints, ScreenPointList& screenpoints) {
+    screenpoints.resize(geopoints.size());
+    _Proj.ToScreen(std::begin(geopoints), std::end(geopoints), screenpoints.data());
 
     // close polygon if needed
     if(screenpoints.front() != screenpoints.back()) {
@@ -871,63 +967,52 @@ static void CalculateScreenPolygon(const ScreenProjection &_Proj, const CPoint2D
 
 
 // Calculate screen coordinates for drawing
-void CAirspace::CalculateScreenPosition(const rectObj &screenbounds_latlon, const int iAirspaceMode[], const int iAirspaceBrush[], const RECT& rcDraw, const ScreenProjection& _Proj) {
-
-    /** TODO 
-     *   check map projection change
-     *   move CAirspaceManager::Instance().CheckAirspaceAltitude() outside draw function
-     */
-    
-    
-    /** optimized pseudo code
-     * 
-     * if ( Map projection has Changed ) {
-     *    - clear screen coordinate cache.
-     * }
-     * 
-     * if (airspace is visible and _screenpoints is empty ) {
-     *    - calculate screen position
-     *    if ( screen bounds does not include aispace bounds ) {
-     *      - clip screen coordinate to rcDraw
-     *    }
-     *    - set drawing style
-     * }
-     */
+void CAirspace::CalculateScreenPosition(const rectObj &screenbounds_latlon, const int iAirspaceMode[], const int iAirspaceBrush[],
+                                        const RECT& rcDraw, const ScreenProjection& _Proj,
+                                        bool altitude_visible, CAirspaceScreenCache& cache) {
 
     _drawstyle = adsHidden;        
 
     // Check Visibility : faster first
-    bool is_visible =(iAirspaceMode[_type] % 2 == 1); // airspace class disabled ?
+    bool is_visible = altitude_visible && (iAirspaceMode[_type] % 2 == 1); // airspace class disabled ?
     if(is_visible) {
         is_visible = !((_top.Base == abMSL) && (_top.Altitude <= 0));
     }
     if(is_visible) { // no need to msRectOverlap if airspace is not visible
         is_visible = msRectOverlap(&_bounds, &screenbounds_latlon);
     }
-    if(is_visible) { // no need to check Altitude if airspace is not visible
-        // TODO : "CheckAirspaceAltitude() lock Flight data for altitude : to slow, need to change"
-        is_visible = CAirspaceManager::CheckAirspaceAltitude(_base, _top);
-    }
     
     if(is_visible) { 
-        // we need to calculate new screen position
-        _screenpoints.clear();
-        _screenpoints_clipped.clear();
-        bool need_clipping = !msRectContained(&_bounds, &screenbounds_latlon);
-
-        if(!need_clipping) {
-            // clipping is not needed : calculate screen position directly into _screenpoints_clipped
-            CalculateScreenPolygon(_Proj, _geopoints, _screenpoints_clipped);
+        if (_screen_generation == cache.generation) {
+            // projection unchanged since last calculation
+            ++cache.hits;
         } else {
-            // clipping is needed : calculate screen position into temp array
-            CalculateScreenPolygon(_Proj, _geopoints, _screenpoints);
+            // we need to calculate new screen position
+            ++cache.misses;
+            _screen_generation = cache.generation;
+            _screenpoints.clear();
+            _screenpoints_clipped.clear();
+            bool need_clipping = !msRectContained(&_bounds, &screenbounds_latlon);
+
+            if(!need_clipping) {
+                // clipping is not needed : calculate screen position directly into _screenpoints_clipped
+                CalculateScreenPolygon(_Proj, _geopoints, _screenpoints_clipped);
+            } else {
+                // clipping is needed : calculate screen position into temp array
+                CalculateScreenPolygon(_Proj, _geopoints, _screenpoints);
 
-            PixelRect MaxRect(rcDraw);
-            MaxRect.Grow(300); // add space for inner airspace border, avoid artefact on screen border.
+                PixelRect MaxRect(rcDraw);
+                MaxRect.Grow(300); // add space for inner airspace border, avoid artefact on screen border.
 
-            _screenpoints_clipped.reserve(_screenpoints.size());
+                _screenpoints_clipped.reserve(_screenpoints.size());
 
-            LKGeom::ClipPolygon(MaxRect, _screenpoints, _screenpoints_clipped);
+                LKGeom::ClipPolygon(MaxRect, _screenpoints, _screenpoints_clipped);
+            }
+#ifdef ENABLE_OPENGL
+            if (_screenpoints_clipped.size() > 2) {
+                CalculateScreenTriangles(_Proj);
+            }
+#endif
         }
 
         // airspace is visible only if clipped polygon have more than 2 point.
@@ -945,6 +1030,33 @@ void CAirspace::CalculateScreenPosition(const rectObj &screenbounds_latlon, cons
     }
 }
 
+#ifdef ENABLE_OPENGL
+// Tessellate polygon in geographic coordinate the first time, then only
+// convert triangle vertices to screen coordinate.
+void CAirspace::CalculateScreenTriangles(const ScreenProjection& _Proj) {
+    if (!_tessellation.Valid()) {
+        static PolygonRenderer renderer; // only used by DrawThread
+        renderer.BeginPolygon(_tessellation);
+        renderer.BeginContour();
+        const CPoint2D* prev = nullptr;
+        for (const CPoint2D& pt : _geopoints) {
+            if (!prev || pt.Latitude() != prev->Latitude() || pt.Longitude() != prev->Longitude()) {
+                renderer.AddVertex(pt.Longitude(), pt.Latitude());
+                prev = &pt;
+            }
+        }
+        renderer.EndContour();
+        renderer.EndPolygon();
+    }
+
+    const auto& vertices = _tessellation.Vertices();
+    _screen_triangles.resize(vertices.size());
+    _Proj.ToScreen(vertices.size(), [&](size_t i) {
+        return GeoPoint(vertices[i].y, vertices[i].x);
+    }, _screen_triangles.data());
+}
+#endif
+
 // Draw airspace
 
 void CAirspace::Draw(LKSurface& Surface, bool fill) const {
@@ -953,6 +1065,12 @@ void CAirspace::Draw(LKSurface& Surface, bool fill) const {
 
     if (fill) {
         if (outLength > 2) {
+#ifdef ENABLE_OPENGL
+            if (_tessellation.Valid()) {
+                Surface.Polygon(_tessellation, _screen_triangles.data(), clip_ptout, outLength);
+                return;
+            }
+#endif
             Surface.Polygon(clip_ptout, outLength);
         }
     } else {
@@ -985,6 +1103,51 @@ void CAirspace::Hash(MD5& md5) const {
     }
 }
 
+void CAirspace::ScanLine(const CAirspaceScanLine& line, bool (&inside)[AIRSPACE_SCANSIZE_X]) const {
+    for (unsigned i = 0; i < AIRSPACE_SCANSIZE_X; ++i) {
+        inside[i] = IsHorizontalInside(line.lons[i], line.lats[i]);
+    }
+}
+
+CAirspaceScanLine::CAirspaceScanLine(const double (&Lats)[AIRSPACE_SCANSIZE_X], const double (&Lons)[AIRSPACE_SCANSIZE_X])
+        : lats(Lats), lons(Lons), bounds({Lons[0], Lats[0], Lons[0], Lats[0]}), straight(true), max_offset(0) {
+
+    for (unsigned i = 1; i < AIRSPACE_SCANSIZE_X; ++i) {
+        bounds.minx = std::min(bounds.minx, lons[i]);
+        bounds.maxx = std::max(bounds.maxx, lons[i]);
+        bounds.miny = std::min(bounds.miny, lats[i]);
+        bounds.maxy = std::max(bounds.maxy, lats[i]);
+        if (std::abs(lons[i] - lons[i - 1]) > 180) {
+            straight = false; // across 180 meridian
+        }
+    }
+
+    dir_lon = lons[AIRSPACE_SCANSIZE_X - 1] - lons[0];
+    dir_lat = lats[AIRSPACE_SCANSIZE_X - 1] - lats[0];
+    len_sq = dir_lon * dir_lon + dir_lat * dir_lat;
+    if (!straight || len_sq <= 0) {
+        straight = false;
+        len_sq = 1;
+        normal_lon = normal_lat = 0;
+        std::fill(std::begin(position), std::end(position), 0.);
+        return;
+    }
+    const double len = std::sqrt(len_sq);
+    normal_lon = -dir_lat / len;
+    normal_lat = dir_lon / len;
+
+    // samples are on a geodesic, not on the straight line between first and last one.
+    for (unsigned i = 0; i < AIRSPACE_SCANSIZE_X; ++i) {
+        position[i] = Position(lons[i], lats[i]);
+        max_offset = std::max(max_offset, std::abs(Offset(lons[i], lats[i])));
+        if (i > 0 && position[i] < position[i - 1]) {
+            straight = false;
+        }
+    }
+    // margin for rounding error
+    max_offset = max_offset * 1.01 + 1e-9;
+}
+
 //
 // CAIRSPACE AREA CLASS
 //
@@ -992,6 +1155,15 @@ CAirspace_Area::CAirspace_Area(CPoint2DArray &&Area_Points)
     : CAirspace(std::forward<CPoint2DArray>(Area_Points))
 {
     CalcBounds();
+    CalcEdgeTable();
+    AirspaceAGLLookup((_bounds.miny + _bounds.maxy) / 2.0, (_bounds.minx + _bounds.maxx) / 2.0, &_base.Altitude, &_top.Altitude);
+}
+
+CAirspace_Area::CAirspace_Area(CPoint2DArray &&Area_Points, const rectObj &Bounds)
+    : CAirspace(std::forward<CPoint2DArray>(Area_Points))
+{
+    _bounds = Bounds;
+    CalcEdgeTable();
     AirspaceAGLLookup((_bounds.miny + _bounds.maxy) / 2.0, (_bounds.minx + _bounds.maxx) / 2.0, &_base.Altitude, &_top.Altitude);
 }
 
@@ -1037,34 +1209,34 @@ std::string CAirspace_Area::Hash() const {
 //            <0 for P2 right of the line
 //    See: the January 2001 Algorithm "Area of 2D and 3D Triangles and Polygons"
 
-inline static float
-isLeft(const CPoint2D &P0, const CPoint2D &P1, const double &longitude, const double &latitude) {
-    return ( (P1.Longitude() - P0.Longitude()) * (latitude - P0.Latitude())
-            - (longitude - P0.Longitude()) * (P1.Latitude() - P0.Latitude()));
+inline static double
+isLeft(const double &lon0, const double &lat0, const double &lon1, const double &lat1, const double &longitude, const double &latitude) {
+    return ( (lon1 - lon0) * (latitude - lat0)
+            - (longitude - lon0) * (lat1 - lat0));
 }
 
 // wn_PnPoly(): winding number test for a point in a polygon
 //      Input:   P = a point,
 //               V[] = vertex points of a polygon V[n+1] with V[n]=V[0]
 //      Return:  wn = the winding number (=0 only if P is outside V[])
+//
+// branch free version, using flat vertex arrays, compiler can vectorize this loop.
 
 int CAirspace_Area::wn_PnPoly(const double &longitude, const double &latitude) const {
+    if (_vertex_lat.size() < 2) return 0; // no edge
     int wn = 0; // the winding number counter
 
+    const double* lat = _vertex_lat.data();
+    const double* lon = _vertex_lon.data();
+    const size_t edges = _vertex_lat.size() - 1;
+
     // loop through all edges of the polygon
-    CPoint2DArray::const_iterator it = _geopoints.begin();
-    CPoint2DArray::const_iterator itnext = it;
-    ++itnext;
-    for (int i = 0; i < ((int) _geopoints.size() - 1); ++i, ++it, ++itnext) {
-        if (it->Latitude() <= latitude) { // start y <= P.Latitude
-            if (itnext->Latitude() > latitude) // an upward crossing
-                if (isLeft(*it, *itnext, longitude, latitude) > 0) // P left of edge
-                    ++wn; // have a valid up intersect
-        } else { // start y > P.Latitude (no test needed)
-            if (itnext->Latitude() <= latitude) // a downward crossing
-                if (isLeft(*it, *itnext, longitude, latitude) < 0) // P right of edge
-                    --wn; // have a valid down intersect
-        }
+    for (size_t i = 0; i < edges; ++i) {
+        const double side = isLeft(lon[i], lat[i], lon[i + 1], lat[i + 1], longitude, latitude);
+        const bool up = (lat[i] <= latitude) && (lat[i + 1] > latitude); // an upward crossing
+        const bool down = (lat[i] > latitude) && (lat[i + 1] <= latitude); // a downward crossing
+        wn += (up && (side > 0)); // P left of edge : have a valid up intersect
+        wn -= (down && (side < 0)); // P right of edge : have a valid down intersect
     }
     return wn;
 }
@@ -1089,44 +1261,130 @@ bool CAirspace_Area::IsHorizontalInside(const double &longitude, const double &l
     return false;
 }
 
+// Winding number only change when scan line cross an edge : each edge is
+// clipped to the strip containing all samples and IsHorizontalInside() is
+// called only for samples around it. Other samples have same state than their
+// neighbour.
+void CAirspace_Area::ScanLine(const CAirspaceScanLine& line, bool (&inside)[AIRSPACE_SCANSIZE_X]) const {
+    const size_t size = _vertex_lat.size();
+    if (!line.straight || _bounds.minx > _bounds.maxx || size < 4
+            || _vertex_lat[0] != _vertex_lat[size - 1] || _vertex_lon[0] != _vertex_lon[size - 1]) {
+        // across 180 meridian or unclosed polygon
+        CAirspace::ScanLine(line, inside);
+        return;
+    }
+
+    std::fill(std::begin(inside), std::end(inside), false);
+    if (msRectOverlap(&line.bounds, &_bounds) != MS_TRUE) {
+        return;
+    }
+
+    bool check[AIRSPACE_SCANSIZE_X] = {};
+    const double* lat = _vertex_lat.data();
+    const double* lon = _vertex_lon.data();
+    const double* position_begin = std::begin(line.position);
+    const double* position_end = std::end(line.position);
+    const double w = line.max_offset;
+
+    double offset_next = line.Offset(lon[0], lat[0]);
+    for (size_t i = 0; i < size - 1; ++i) {
+        const double offset = offset_next;
+        offset_next = line.Offset(lon[i + 1], lat[i + 1]);
+        if ((offset > w && offset_next > w) || (offset < -w && offset_next < -w)) {
+            continue; // edge outside of strip
+        }
+        // part of edge inside strip
+        double s0 = 0, s1 = 1;
+        if (offset != offset_next) {
+            double sa = (-w - offset) / (offset_next - offset);
+            double sb = (w - offset) / (offset_next - offset);
+            if (sa > sb) {
+                std::swap(sa, sb);
+            }
+            s0 = std::max(s0, sa);
+            s1 = std::min(s1, sb);
+        }
+        const double dlon = lon[i + 1] - lon[i];
+        const double dlat = lat[i + 1] - lat[i];
+        double t0 = line.Position(lon[i] + s0 * dlon, lat[i] + s0 * dlat);
+        double t1 = line.Position(lon[i] + s1 * dlon, lat[i] + s1 * dlat);
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        // both ends of each scan line segment which can cross this edge
+        const ptrdiff_t first = std::lower_bound(position_begin, position_end, t0) - position_begin - 1;
+        const ptrdiff_t last = std::upper_bound(position_begin, position_end, t1) - position_begin;
+        std::fill(check + Clamp<ptrdiff_t>(first, 0, AIRSPACE_SCANSIZE_X - 1),
+                  check + Clamp<ptrdiff_t>(last, 0, AIRSPACE_SCANSIZE_X - 1) + 1, true);
+    }
+
+    int known = -1; // first tested sample
+    for (int i = 0; i < AIRSPACE_SCANSIZE_X; ++i) {
+        if (check[i]) {
+            inside[i] = IsHorizontalInside(line.lons[i], line.lats[i]);
+            if (known < 0) {
+                known = i;
+            }
+        } else if (known >= 0) {
+            inside[i] = inside[i - 1];
+        }
+    }
+    if (known < 0) {
+        // no edge near scan line
+        known = 0;
+        inside[0] = IsHorizontalInside(line.lons[0], line.lats[0]);
+    }
+    std::fill(inside, inside + known, inside[known]);
+}
+
 // Calculate horizontal distance from a given point
 
 double CAirspace_Area::Range(const double &longitude, const double &latitude, double &bearing) const {
     // find nearest distance to line segment
-    unsigned int i;
-    unsigned int dist = 0;
-    unsigned int dist_candidate = 0;
-    CPoint2D p3(latitude, longitude);
-    int x = 0, y = 0, z = 0;
+    const CPoint2D p3(latitude, longitude);
+
+    const int* x = _vertex_x.data();
+    const int* y = _vertex_y.data();
+    const int* z = _vertex_z.data();
+    const double* inv_len_sq = _edge_inv_len_sq.data();
+    const size_t edges = _edge_inv_len_sq.size();
+
+    double dist_candidate = 0;
     int xc = 0, yc = 0, zc = 0;
 
-    int wn = 0; // the winding number counter
+    for (size_t i = 0; i < edges; ++i) {
+        const double X1 = p3.X() - x[i];
+        const double Y1 = p3.Y() - y[i];
+        const double Z1 = p3.Z() - z[i];
+        const double DX = x[i + 1] - x[i];
+        const double DY = y[i + 1] - y[i];
+        const double DZ = z[i + 1] - z[i];
 
-    CPoint2DArray::const_iterator it = _geopoints.begin();
-    CPoint2DArray::const_iterator itnext = it;
-    ++itnext;
+        // nearest point position on segment
+        const double param = Clamp((X1 * DX + Y1 * DY + Z1 * DZ) * inv_len_sq[i], 0., 1.);
 
-    for (i = 0; i < _geopoints.size() - 1; ++i) {
-        dist = p3.DistanceXYZ(*it, *itnext, &x, &y, &z);
+        const int nx = static_cast<int>(x[i] + param * DX);
+        const int ny = static_cast<int>(y[i] + param * DY);
+        const int nz = static_cast<int>(z[i] + param * DZ);
 
-        if (it->Latitude() <= latitude) { // start y <= P.Latitude
-            if (itnext->Latitude() > latitude) // an upward crossing
-                if (isLeft(*it, *itnext, longitude, latitude) > 0) // P left of edge
-                    ++wn; // have a valid up intersect
-        } else { // start y > P.Latitude (no test needed)
-            if (itnext->Latitude() <= latitude) // a downward crossing
-                if (isLeft(*it, *itnext, longitude, latitude) < 0) // P right of edge
-                    --wn; // have a valid down intersect
-        }
+        const double dx = p3.X() - nx;
+        const double dy = p3.Y() - ny;
+        const double dz = p3.Z() - nz;
+        const double dist = dx * dx + dy * dy + dz * dz; // no need to sqrt for comparison
 
         if ((dist < dist_candidate) || (i == 0)) {
             dist_candidate = dist;
-            xc = x;
-            yc = y;
-            zc = z;
+            xc = nx;
+            yc = ny;
+            zc = nz;
         }
-        ++it;
-        ++itnext;
+    }
+
+    // winding number is always 0 outside bounding box
+    int wn = 0;
+    if ((latitude >= _bounds.miny) && (latitude <= _bounds.maxy)
+            && CheckInsideLongitude(longitude, _bounds.minx, _bounds.maxx)) {
+        wn = wn_PnPoly(longitude, latitude);
     }
 
     CPoint2D p4(xc, yc, zc);
@@ -1171,6 +1429,35 @@ void CAirspace_Area::CalcBounds() {
     }
 }
 
+// Fill flat vertex & edge arrays used by wn_PnPoly() and Range()
+
+void CAirspace_Area::CalcEdgeTable() {
+    const size_t size = _geopoints.size();
+
+    _vertex_lat.resize(size);
+    _vertex_lon.resize(size);
+    _vertex_x.resize(size);
+    _vertex_y.resize(size);
+    _vertex_z.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        const CPoint2D& pt = _geopoints[i];
+        _vertex_lat[i] = pt.Latitude();
+        _vertex_lon[i] = pt.Longitude();
+        _vertex_x[i] = pt.X();
+        _vertex_y[i] = pt.Y();
+        _vertex_z[i] = pt.Z();
+    }
+
+    _edge_inv_len_sq.resize(size ? size - 1 : 0);
+    for (size_t i = 0; i < _edge_inv_len_sq.size(); ++i) {
+        const double DX = _vertex_x[i + 1] - _vertex_x[i];
+        const double DY = _vertex_y[i + 1] - _vertex_y[i];
+        const double DZ = _vertex_z[i + 1] - _vertex_z[i];
+        const double len_sq = DX * DX + DY * DY + DZ * DZ;
+        _edge_inv_len_sq[i] = (len_sq > 0) ? 1. / len_sq : 0.;
+    }
+}
+
 //
 // CAIRSPACEMANAGER CLASS
 //
@@ -1194,15 +1481,25 @@ bool CAirspaceManager::CheckAirspaceAltitude(const AIRSPACE_ALT &Base, const AIR
         return false;
     }
 
-    double basealt;
-    double topalt;
-    bool base_is_sfc = false;
-
     LockFlightData();
     double alt = CALCULATED_INFO.NavAltitude;
     double alt_agl = CALCULATED_INFO.TerrainAlt;
     UnlockFlightData();
 
+    return CheckAirspaceAltitude(Base, Top, alt, alt_agl);
+}
+
+bool CAirspaceManager::CheckAirspaceAltitude(const AIRSPACE_ALT &Base, const AIRSPACE_ALT &Top, double alt, double alt_agl) {
+    if (AltitudeMode == ALLON) {
+        return true;
+    } else if (AltitudeMode == ALLOFF) {
+        return false;
+    }
+
+    double basealt;
+    double topalt;
+    bool base_is_sfc = false;
+
     if (Base.Base != abAGL) {
         basealt = Base.Altitude;
     } else {
@@ -1877,7 +2174,7 @@ bool CAirspaceManager::FillAirspacesFromOpenAir(const TCHAR* szFile) {
                             }
                             maxwarning--;
                             // LKTOKEN  _@M68_ = "Airspace"
-                            if (MessageBoxX(sTmp, MsgToken(68), mbOkCancel) == IdCancel) {
+                            if (!ParseWarning(sTmp)) {
                                 return false;
                             }
                         }
@@ -1899,7 +2196,7 @@ bool CAirspaceManager::FillAirspacesFromOpenAir(const TCHAR* szFile) {
                                 InsideMap = true;
                               }
                             }
-                            if (MessageBoxX(sTmp, MsgToken(68), mbOkCancel) == IdCancel) return false;
+                            if (!ParseWarning(sTmp)) return false;
                         }
                         break;
 
@@ -1914,7 +2211,7 @@ bool CAirspaceManager::FillAirspacesFromOpenAir(const TCHAR* szFile) {
                                 InsideMap = true;
                               }
                             }
-                            if (MessageBoxX(sTmp, MsgToken(68), mbOkCancel) == IdCancel) return false;
+                            if (!ParseWarning(sTmp)) return false;
                         }
                         break;
 
@@ -1944,7 +2241,7 @@ bool CAirspaceManager::FillAirspacesFromOpenAir(const TCHAR* szFile) {
                         } else {
                             _sntprintf(sTmp, READLINE_LENGTH, TEXT("Parse error 3 at line %d\r\n\"%s\"\r\nLine skipped."), linecount, p);
                             // LKTOKEN  _@M68_ = "Airspace"
-                            if (MessageBoxX(sTmp, MsgToken(68), mbOkCancel) == IdCancel) return false;
+                            if (!ParseWarning(sTmp)) return false;
                         }
                         break;
 
@@ -1960,7 +2257,7 @@ bool CAirspaceManager::FillAirspacesFromOpenAir(const TCHAR* szFile) {
                             maxwarning--;
 
                             // LKTOKEN  _@M68_ = "Airspace"
-                            if (MessageBoxX(sTmp, MsgToken(68), mbOkCancel) == IdCancel) {
+                            if (!ParseWarning(sTmp)) {
                                 return false;
                             }
                         }
@@ -1994,7 +2291,7 @@ bool CAirspaceManager::FillAirspacesFromOpenAir(const TCHAR* szFile) {
 
                 _sntprintf(sTmp,READLINE_LENGTH, TEXT("Parse error 6 at line %d\r\n\"%s\"\r\nLine skipped."), linecount, p);
                 // LKTOKEN  _@M68_ = "Airspace"
-                if (MessageBoxX(sTmp, MsgToken(68), mbOkCancel) == IdCancel) return false;
+                if (!ParseWarning(sTmp)) return false;
                 break;
 
             case _T('S'): // ignore the SB,SP ...
@@ -2012,7 +2309,7 @@ bool CAirspaceManager::FillAirspacesFromOpenAir(const TCHAR* szFile) {
                     }
                     maxwarning--;
                     // LKTOKEN  _@M68_ = "Airspace"
-                    if (MessageBoxX(sTmp, MsgToken(68), mbOkCancel) == IdCancel) {
+                    if (!ParseWarning(sTmp)) {
                         return false;
                     }
                 }
@@ -2398,7 +2695,92 @@ bool CAirspaceManager::FillAirspacesFromOpenAIP(const TCHAR* szFile) {
     return true;
 }
 
-void CAirspaceManager::ReadAirspaces() {
+bool CAirspaceManager::ParseWarning(const TCHAR* text) {
+    { // Begin Lock
+        ScopeLock guard(_csairspaces);
+        ++_parse_warnings;
+        if (!_parse_interactive) {
+            // no message box outside of main thread, keep message for ShowParseWarnings()
+            StartupStore(TEXT("... %s%s"), text, NEWLINE);
+            _parse_messages.emplace_back(text);
+            return true;
+        }
+    } // End Lock
+    // LKTOKEN  _@M68_ = "Airspace"
+    return (MessageBoxX(text, MsgToken(68), mbOkCancel) != IdCancel);
+}
+
+void CAirspaceManager::ShowParseWarnings() {
+    std::vector<tstring> messages;
+    { // Begin Lock
+        ScopeLock guard(_csairspaces);
+        messages.swap(_parse_messages);
+    } // End Lock
+
+    // loading is already done, Cancel only skip remaining messages.
+    for (const tstring& text : messages) {
+        // LKTOKEN  _@M68_ = "Airspace"
+        if (MessageBoxX(text.c_str(), MsgToken(68), mbOkCancel) == IdCancel) {
+            break;
+        }
+    }
+}
+
+bool CAirspaceManager::ReadAirspaceFile(const TCHAR* szFile) {
+    // airspaces outside terrain are excluded by parser, result then depends on terrain, don't use cache.
+    const bool use_cache = !(WaypointsOutOfRange > 1);
+
+    TCHAR szCacheFile[MAX_PATH];
+    _sntprintf(szCacheFile, MAX_PATH, _T("%s.cache"), szFile);
+    szCacheFile[MAX_PATH - 1] = _T('\0');
+
+    CAirspaceCache::key_t key;
+    const bool valid_key = use_cache && CAirspaceCache::Key(szFile, key);
+
+    PeriodClock starttick;
+    starttick.Update();
+
+    if (valid_key) {
+        ScopeLock guard(_csairspaces);
+        const size_t count = _airspaces.size();
+        if (CAirspaceCache::Load(szCacheFile, szFile, key, _airspaces)) {
+            StartupStore(TEXT(". %u airspaces loaded from cache <%s> in %dms%s"),
+                         static_cast<unsigned>(_airspaces.size() - count), szCacheFile, starttick.Elapsed(), NEWLINE);
+            return true;
+        }
+    }
+
+    size_t count = 0;
+    { // Begin Lock
+        ScopeLock guard(_csairspaces);
+        count = _airspaces.size();
+        _parse_warnings = 0;
+    } // End Lock
+
+    LPCTSTR wextension = _tcsrchr(szFile, _T('.'));
+    bool readOk = false;
+    if (_tcsicmp(wextension, _T(".txt")) == 0) { // TXT file: should be an OpenAir
+        readOk = FillAirspacesFromOpenAir(szFile);
+    } else { // AIP file: should be an OpenAIP
+        readOk = FillAirspacesFromOpenAIP(szFile);
+    }
+    StartupStore(TEXT(". Airspace file parsed in %dms%s"), starttick.Elapsed(), NEWLINE);
+
+    // file with parse error are not cached, so user still get warnings on next startup.
+    if (readOk && valid_key) {
+        ScopeLock guard(_csairspaces);
+        if (_parse_warnings == 0 && !CAirspaceCache::Save(szCacheFile, szFile, key, std::next(_airspaces.cbegin(), count), _airspaces.cend())) {
+            StartupStore(TEXT("... Failed to write airspace cache <%s>%s"), szCacheFile, NEWLINE);
+        }
+    }
+    return readOk;
+}
+
+void CAirspaceManager::ReadAirspaces(bool interactive) {
+    { // Begin Lock
+        ScopeLock guard(_csairspaces);
+        _parse_interactive = interactive;
+    } // End Lock
     int fileCounter=0;
   //  for (TCHAR* airSpaceFile : {szAirspaceFile, szAdditionalAirspaceFile}) {
     for(unsigned int i = 0; i < NO_AS_FILES; i++) {
@@ -2412,10 +2794,8 @@ void CAirspaceManager::ReadAirspaces() {
             bool readOk=false;
 
             if(wextension != nullptr) { // Check if we have a file extension
-                if(_tcsicmp(wextension,_T(".txt"))==0) { // TXT file: should be an OpenAir
-                    readOk = FillAirspacesFromOpenAir(szFile);
-                } else if(_tcsicmp(wextension,_T(".aip"))==0) { // AIP file: should be an OpenAIP
-                    readOk=FillAirspacesFromOpenAIP(szFile);
+                if(_tcsicmp(wextension,_T(".txt"))==0 || _tcsicmp(wextension,_T(".aip"))==0) {
+                    readOk = ReadAirspaceFile(szFile);
                 }  else {
                     StartupStore(TEXT("... Unknown airspace file %d extension: %s%s"), fileCounter, wextension, NEWLINE);
                 }
@@ -2440,6 +2820,8 @@ void CAirspaceManager::ReadAirspaces() {
         ScopeLock guard(_csairspaces);
         last_day_of_week = ~0;
         airspaces_count = _airspaces.size();
+        BuildAirspaceIndex();
+        _parse_interactive = true; // default for next loading
     } //
 
     if((OutsideAirspaceCnt > 0) && ( WaypointsOutOfRange > 1) )
@@ -2484,6 +2866,8 @@ void CAirspaceManager::CloseAirspaces() {
     _airspaces_near.clear();
     _airspaces_of_interest.clear();
     _airspaces_page24.clear();
+    _airspaces_day_restricted.clear();
+    _airspaces_index.Clear();
     std::for_each(_airspaces.begin(), _airspaces.end(), std::default_delete<CAirspace>());
     _airspaces.clear();
     StartupStore(TEXT(". CloseLKAirspace%s"), NEWLINE);
@@ -2496,6 +2880,114 @@ void CAirspaceManager::QnhChangeNotify() {
     }
 }
 
+// Add to @airspacetype all sections of @airspace where @inside is true.
+static void ScanAirspaceLine(CAirspace* airspace, const bool (&inside)[AIRSPACE_SCANSIZE_X],
+        const double (&terrain_heights)[AIRSPACE_SCANSIZE_X],
+        AirSpaceSideViewSTRUCT (&airspacetype)[MAX_NO_SIDE_AS], int& iNoFoundAS) {
+
+    unsigned int iSelAS = 0; // current selected airspace for processing
+    for (unsigned int i = 0; i < AIRSPACE_SCANSIZE_X; i++) {
+        if (inside[i]) {
+            const bool bPrevIn = (i > 0) && inside[i - 1];
+
+            if (!bPrevIn)/* new AS section in this view*/ {
+                /*********************************************************************
+                 * switch to next airspace section
+                 *********************************************************************/
+                iSelAS = iNoFoundAS;
+                BUGSTOP_LKASSERT(iNoFoundAS < MAX_NO_SIDE_AS);
+                if (iNoFoundAS < MAX_NO_SIDE_AS - 1) iNoFoundAS++;
+                airspacetype[iNoFoundAS].psAS = NULL; // increment and reset head
+                /*********************************************************************/
+                airspacetype[iSelAS].psAS = airspace;
+                airspacetype[iSelAS].iType = airspace->Type();
+
+                LK_tcsncpy(airspacetype[iSelAS].szAS_Name, airspace->Name(), NAME_SIZE - 1);
+
+                airspacetype[iSelAS].iIdx = iSelAS;
+                airspacetype[iSelAS].bRectAllowed = true;
+                airspacetype[iSelAS].bEnabled = airspace->Enabled();
+                /**********************************************************************
+                 * allow rectangular shape if no AGL reference
+                 **********************************************************************/
+                if ((airspace->Top()->Base == abAGL) || ((airspace->Base()->Base == abAGL)))
+                    airspacetype[iSelAS].bRectAllowed = false;
+                /**********************************************************************
+                 * init with minium rectangle right side may be extended
+                 **********************************************************************/
+                airspacetype[iSelAS].rc.left = i;
+                airspacetype[iSelAS].rc.right = i + 1;
+                airspacetype[iSelAS].rc.bottom = (unsigned int) airspace->Base()->Altitude;
+                airspacetype[iSelAS].rc.top = (unsigned int) airspace->Top()->Altitude;
+                airspacetype[iSelAS].iNoPolyPts = 0;
+
+            }
+            int iHeight;
+            airspacetype[iSelAS].rc.right = i + 1;
+            if (i == AIRSPACE_SCANSIZE_X - 1)
+                airspacetype[iSelAS].rc.right = i + 3;
+
+            if ((airspacetype[iSelAS].psAS) && (!airspacetype[iSelAS].bRectAllowed)) {
+
+                if (airspacetype[iSelAS].psAS->Base()->Base == abAGL)
+                    iHeight = (unsigned int) (airspacetype[iSelAS].psAS->Base()->AGL + terrain_heights[i]);
+                else
+                    iHeight = (unsigned int) airspacetype[iSelAS].psAS->Base()->Altitude;
+                LKASSERT((airspacetype[iSelAS].iNoPolyPts) < GC_MAX_POLYGON_PTS);
+                airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts++] = (POINT){(LONG) i, (LONG) iHeight};
+
+                /************************************************************
+                 *  resort and copy polygon array
+                 **************************************************************/
+                const bool bLast = (i == AIRSPACE_SCANSIZE_X - 1) || !inside[i + 1];
+
+                if (bLast) {
+                    airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts].x = i + 1;
+                    if (i == AIRSPACE_SCANSIZE_X - 1)
+                        airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts].x = i + 3;
+
+                    LKASSERT((airspacetype[iSelAS].iNoPolyPts) < GC_MAX_POLYGON_PTS);
+                    airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts].y = airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts - 1].y;
+                    airspacetype[iSelAS].iNoPolyPts++;
+                    LKASSERT((airspacetype[iSelAS].iNoPolyPts) < GC_MAX_POLYGON_PTS);
+                    int iN = airspacetype[iSelAS].iNoPolyPts;
+                    int iCnt = airspacetype[iSelAS].iNoPolyPts;
+
+
+                    for (int iPt = 0; iPt < iN; iPt++) {
+                        LKASSERT(iCnt >= 0);
+                        LKASSERT(iCnt < GC_MAX_POLYGON_PTS);
+
+                        airspacetype[iSelAS].apPolygon[iCnt] = airspacetype[iSelAS].apPolygon[iN - iPt - 1];
+                        if (airspacetype[iSelAS].psAS->Top()->Base == abAGL)
+                            airspacetype[iSelAS].apPolygon[iCnt].y = (unsigned int) (airspacetype[iSelAS].psAS->Top()->AGL + terrain_heights[airspacetype[iSelAS].apPolygon[iCnt].x]);
+                        else
+                            airspacetype[iSelAS].apPolygon[iCnt].y = (unsigned int) airspacetype[iSelAS].psAS->Top()->Altitude;
+                        LKASSERT(iCnt >= iPt);
+
+                        LKASSERT(iPt >= 0);
+                        LKASSERT(iPt < GC_MAX_POLYGON_PTS);
+                        if (iCnt == 0) {
+                            airspacetype[iSelAS].rc.bottom = airspacetype[iSelAS].apPolygon[0].y;
+                            airspacetype[iSelAS].rc.top = airspacetype[iSelAS].apPolygon[0].y;
+                        } else {
+                            airspacetype[iSelAS].rc.bottom = min(airspacetype[iSelAS].rc.bottom, airspacetype[iSelAS].apPolygon[iCnt].y);
+                            airspacetype[iSelAS].rc.top = max(airspacetype[iSelAS].rc.top, airspacetype[iSelAS].apPolygon[iCnt].y);
+                        }
+                        if (iCnt < GC_MAX_POLYGON_PTS - 1)
+                            iCnt++;
+                    }
+                    LKASSERT(iCnt < GC_MAX_POLYGON_PTS);
+                    airspacetype[iSelAS].apPolygon[iCnt++] = airspacetype[iSelAS].apPolygon[0];
+                    airspacetype[iSelAS].iNoPolyPts = iCnt;
+                }
+            }
+            RECT rcs = airspacetype[iSelAS].rc;
+            airspacetype[iSelAS].iAreaSize = abs(rcs.right - rcs.left) * abs(rcs.top - rcs.bottom);
+        } // inside
+    } // finished scanning range
+}
+
 int CAirspaceManager::ScanAirspaceLineList(const double (&lats)[AIRSPACE_SCANSIZE_X], const double (&lons)[AIRSPACE_SCANSIZE_X],
         const double (&terrain_heights)[AIRSPACE_SCANSIZE_X],
         AirSpaceSideViewSTRUCT (&airspacetype)[MAX_NO_SIDE_AS]) const {
@@ -2503,8 +2995,8 @@ int CAirspaceManager::ScanAirspaceLineList(const double (&lats)[AIRSPACE_SCANSIZ
     const int iMaxNoAs = std::size(airspacetype);
 
     int iNoFoundAS = 0; // number of found airspaces in scan line
-    unsigned int iSelAS = 0; // current selected airspace for processing
-    unsigned int i; // loop variable
+    const CAirspaceScanLine line(lats, lons);
+    bool inside[AIRSPACE_SCANSIZE_X];
     CAirspaceList::const_iterator it;
     ScopeLock guard(_csairspaces);
 
@@ -2515,117 +3007,8 @@ int CAirspaceManager::ScanAirspaceLineList(const double (&lats)[AIRSPACE_SCANSIZ
 
         if ((CheckAirspaceAltitude(*(*it)->Base(), *(*it)->Top()) == TRUE)&& (iNoFoundAS < iMaxNoAs - 1) &&
                 ((MapWindow::iAirspaceMode[(*it)->Type()] % 2) > 0)) {
-            for (i = 0; i < AIRSPACE_SCANSIZE_X; i++) {
-                if ((*it)->IsHorizontalInside(lons[i], lats[i])) {
-                    BOOL bPrevIn = false;
-                    if (i > 0)
-                        if ((*it)->IsHorizontalInside(lons[i - 1], lats[i - 1]))
-                            bPrevIn = true;
-
-                    if (!bPrevIn)/* new AS section in this view*/ {
-                        /*********************************************************************
-                         * switch to next airspace section
-                         *********************************************************************/
-                        iSelAS = iNoFoundAS;
-                        BUGSTOP_LKASSERT(iNoFoundAS < MAX_NO_SIDE_AS);
-                        if (iNoFoundAS < MAX_NO_SIDE_AS - 1) iNoFoundAS++;
-                        airspacetype[iNoFoundAS].psAS = NULL; // increment and reset head
-                        /*********************************************************************/
-                        airspacetype[iSelAS].psAS = (*it);
-                        airspacetype[iSelAS].iType = (*it)->Type();
-
-                        LK_tcsncpy(airspacetype[iSelAS].szAS_Name, (*it)->Name(), NAME_SIZE - 1);
-
-                        airspacetype[iSelAS].iIdx = iSelAS;
-                        airspacetype[iSelAS].bRectAllowed = true;
-                        airspacetype[iSelAS].bEnabled = (*it)->Enabled();
-                        /**********************************************************************
-                         * allow rectangular shape if no AGL reference
-                         **********************************************************************/
-                        if (((*it)->Top()->Base == abAGL) || (((*it)->Base()->Base == abAGL)))
-                            airspacetype[iSelAS].bRectAllowed = false;
-                        /**********************************************************************
-                         * init with minium rectangle right side may be extended
-                         **********************************************************************/
-                        airspacetype[iSelAS].rc.left = i;
-                        airspacetype[iSelAS].rc.right = i + 1;
-                        airspacetype[iSelAS].rc.bottom = (unsigned int) (*it)->Base()->Altitude;
-                        airspacetype[iSelAS].rc.top = (unsigned int) (*it)->Top()->Altitude;
-                        airspacetype[iSelAS].iNoPolyPts = 0;
-
-                    }
-                    int iHeight;
-                    airspacetype[iSelAS].rc.right = i + 1;
-                    if (i == AIRSPACE_SCANSIZE_X - 1)
-                        airspacetype[iSelAS].rc.right = i + 3;
-
-                    if ((airspacetype[iSelAS].psAS) && (!airspacetype[iSelAS].bRectAllowed)) {
-
-                        if (airspacetype[iSelAS].psAS->Base()->Base == abAGL)
-                            iHeight = (unsigned int) (airspacetype[iSelAS].psAS->Base()->AGL + terrain_heights[i]);
-                        else
-                            iHeight = (unsigned int) airspacetype[iSelAS].psAS->Base()->Altitude;
-                        LKASSERT((airspacetype[iSelAS].iNoPolyPts) < GC_MAX_POLYGON_PTS);
-                        airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts++] = (POINT){(LONG) i, (LONG) iHeight};
-
-                        /************************************************************
-                         *  resort and copy polygon array
-                         **************************************************************/
-                        bool bLast = false;
-                        if (i == AIRSPACE_SCANSIZE_X - 1)
-                            bLast = true;
-                        else {
-                            if (airspacetype[iSelAS].psAS->IsHorizontalInside(lons[i + 1], lats[i + 1]))
-                                bLast = false;
-                            else
-                                bLast = true;
-                        }
-
-                        if (bLast) {
-                            airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts].x = i + 1;
-                            if (i == AIRSPACE_SCANSIZE_X - 1)
-                                airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts].x = i + 3;
-
-                            LKASSERT((airspacetype[iSelAS].iNoPolyPts) < GC_MAX_POLYGON_PTS);
-                            airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts].y = airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts - 1].y;
-                            airspacetype[iSelAS].iNoPolyPts++;
-                            LKASSERT((airspacetype[iSelAS].iNoPolyPts) < GC_MAX_POLYGON_PTS);
-                            int iN = airspacetype[iSelAS].iNoPolyPts;
-                            int iCnt = airspacetype[iSelAS].iNoPolyPts;
-
-
-                            for (int iPt = 0; iPt < iN; iPt++) {
-                                LKASSERT(iCnt >= 0);
-                                LKASSERT(iCnt < GC_MAX_POLYGON_PTS);
-
-                                airspacetype[iSelAS].apPolygon[iCnt] = airspacetype[iSelAS].apPolygon[iN - iPt - 1];
-                                if (airspacetype[iSelAS].psAS->Top()->Base == abAGL)
-                                    airspacetype[iSelAS].apPolygon[iCnt].y = (unsigned int) (airspacetype[iSelAS].psAS->Top()->AGL + terrain_heights[airspacetype[iSelAS].apPolygon[iCnt].x]);
-                                else
-                                    airspacetype[iSelAS].apPolygon[iCnt].y = (unsigned int) airspacetype[iSelAS].psAS->Top()->Altitude;
-                                LKASSERT(iCnt >= iPt);
-
-                                LKASSERT(iPt >= 0);
-                                LKASSERT(iPt < GC_MAX_POLYGON_PTS);
-                                if (iCnt == 0) {
-                                    airspacetype[iSelAS].rc.bottom = airspacetype[iSelAS].apPolygon[0].y;
-                                    airspacetype[iSelAS].rc.top = airspacetype[iSelAS].apPolygon[0].y;
-                                } else {
-                                    airspacetype[iSelAS].rc.bottom = min(airspacetype[iSelAS].rc.bottom, airspacetype[iSelAS].apPolygon[iCnt].y);
-                                    airspacetype[iSelAS].rc.top = max(airspacetype[iSelAS].rc.top, airspacetype[iSelAS].apPolygon[iCnt].y);
-                                }
-                                if (iCnt < GC_MAX_POLYGON_PTS - 1)
-                                    iCnt++;
-                            }
-                            LKASSERT(iCnt < GC_MAX_POLYGON_PTS);
-                            airspacetype[iSelAS].apPolygon[iCnt++] = airspacetype[iSelAS].apPolygon[0];
-                            airspacetype[iSelAS].iNoPolyPts = iCnt;
-                        }
-                    }
-                    RECT rcs = airspacetype[iSelAS].rc;
-                    airspacetype[iSelAS].iAreaSize = abs(rcs.right - rcs.left) * abs(rcs.top - rcs.bottom);
-                } // inside
-            } // finished scanning range
+            (*it)->ScanLine(line, inside);
+            ScanAirspaceLine((*it), inside, terrain_heights, airspacetype, iNoFoundAS);
         } // if overlaps bounds
     } // for iterator
 
@@ -2664,10 +3047,15 @@ CAirspace* CAirspaceManager::FindNearestAirspace(const double &longitude, const
     calc_terrainalt = CALCULATED_INFO.TerrainAlt;
     UnlockFlightData();
 
-    CAirspaceList::const_iterator it;
     ScopeLock guard(_csairspaces);
 
-    for (it = _airspaces.begin(); it != _airspaces.end(); ++it) {
+    // only airspaces with bounds inside search range can be found.
+    std::vector<CAirspace*> candidates;
+    _airspaces_index.ForEach(CAirspaceIndex::RangeBounds(latitude, longitude, nearestd), [&](CAirspace* pAsp) {
+        candidates.push_back(pAsp);
+    });
+
+    for (auto it = candidates.begin(); it != candidates.end(); ++it) {
         if ((*it)->Enabled()) {
             type = (*it)->Type();
             //TODO check index
@@ -2737,6 +3125,17 @@ void CAirspaceManager::SortAirspaces(void) {
     // Sort by top altitude for drawing
     ScopeLock guard(_csairspaces);
     std::sort(_airspaces.begin(), _airspaces.end(), airspace_sorter);
+    // index keep airspace order, need to be rebuilt
+    BuildAirspaceIndex();
+}
+
+void CAirspaceManager::BuildAirspaceIndex() {
+    _airspaces_index.Build(_airspaces);
+
+    _airspaces_day_restricted.clear();
+    std::copy_if(_airspaces.begin(), _airspaces.end(), std::back_inserter(_airspaces_day_restricted), [](CAirspace* pAsp) {
+        return pAsp->ExceptSaturday() || pAsp->ExceptSunday();
+    });
 }
 
 bool CAirspaceManager::ValidAirspaces(void) const {
@@ -2932,61 +3331,85 @@ void CAirspaceManager::AirspaceWarning(NMEA_INFO *Basic, DERIVED_INFO *Calculate
 
 CAirspaceList CAirspaceManager::GetVisibleAirspacesAtPoint(const double &lon, const double &lat) const {
     CAirspaceList res;
-    CAirspaceList::const_iterator it;
+    const rectObj bounds = { lon, lat, lon, lat };
     ScopeLock guard(_csairspaces);
-    for (it = _airspaces.begin(); it != _airspaces.end(); ++it) {
-        if ((*it)->DrawStyle()) {
-            if ((*it)->IsHorizontalInside(lon, lat)) res.push_back(*it);
+    _airspaces_index.ForEach(bounds, [&](CAirspace* pAsp) {
+        if (pAsp->DrawStyle()) {
+            if (pAsp->IsHorizontalInside(lon, lat)) res.push_back(pAsp);
         }
-    }
+    });
     return res;
 }
 
 CAirspaceList CAirspaceManager::GetNearAirspacesAtPoint(const double &lon, const double &lat, long searchrange) const {
     int HorDist, Bearing, VertDist;
     CAirspaceList res;
-    CAirspaceList::const_iterator it;
+    const rectObj bounds = CAirspaceIndex::RangeBounds(lat, lon, searchrange);
     ScopeLock guard(_csairspaces);
-    for (it = _airspaces.begin(); it != _airspaces.end(); ++it) {
-        if ((*it)->DrawStyle() || (((*it)->Top()->Base == abMSL) && ((*it)->Top()->Altitude <= 0))) 
+    _airspaces_index.ForEach(bounds, [&](CAirspace* pAsp) {
+        if (pAsp->DrawStyle() || ((pAsp->Top()->Base == abMSL) && (pAsp->Top()->Altitude <= 0))) 
         {
-            (*it)->CalculateDistance(&HorDist, &Bearing, &VertDist, lon, lat);
+            pAsp->CalculateDistance(&HorDist, &Bearing, &VertDist, lon, lat);
             if (HorDist < searchrange) {
-                res.push_back(*it);
+                res.push_back(pAsp);
             }
         }
-    }
+    });
     return res;
 }
 
 void CAirspaceManager::SetFarVisible(const rectObj &bounds_active) {
-    CAirspaceList::iterator it;
 #if DEBUG_NEAR_POINTS
     int iCnt = 0;
     StartupStore(_T("... enter SetFarVisible\n"));
 #endif
     ScopeLock guard(_csairspaces);
     _airspaces_near.clear();
-    for (it = _airspaces.begin(); it != _airspaces.end(); ++it) {
+    _airspaces_index.ForEach(bounds_active, [&](CAirspace* pAsp) {
         // Check if airspace overlaps given bounds
-        if ((msRectOverlap(&bounds_active, &((*it)->Bounds())) == MS_TRUE)
+        if ((msRectOverlap(&bounds_active, &(pAsp->Bounds())) == MS_TRUE)
                 ) {
-            _airspaces_near.push_back(*it);
+            _airspaces_near.push_back(pAsp);
 #if DEBUG_NEAR_POINTS
             iCnt++;
 #endif
         }
-    }
+    });
 #if DEBUG_NEAR_POINTS
     StartupStore(_T("... leaving SetFarVisible %i airspaces\n"), iCnt);
 #endif
 }
 
 void CAirspaceManager::CalculateScreenPositionsAirspace(const rectObj &screenbounds_latlon, const int iAirspaceMode[], const int iAirspaceBrush[], const RECT& rcDraw, const ScreenProjection& _Proj) {
+    LockFlightData();
+    const double alt = CALCULATED_INFO.NavAltitude;
+    const double alt_agl = CALCULATED_INFO.TerrainAlt;
+    UnlockFlightData();
+
     ScopeLock guard(_csairspaces);
+
+    // cached screen coordinate of all airspaces are invalid if projection change.
+    if (!_screen_proj || !_screen_proj->IsSame(_Proj) || !EqualRect(&_screen_rect, &rcDraw)
+            || memcmp(&_screen_bounds, &screenbounds_latlon, sizeof(rectObj)) != 0) {
+        _screen_proj = _Proj;
+        _screen_rect = rcDraw;
+        _screen_bounds = screenbounds_latlon;
+        if (++_screen_cache.generation == 0) {
+            ++_screen_cache.generation; // 0 is for never calculated airspace
+        }
+    }
+
     for (auto asp : _airspaces_near) {
-        asp->CalculateScreenPosition(screenbounds_latlon, iAirspaceMode, iAirspaceBrush, rcDraw, _Proj);
+        const bool altitude_visible = CheckAirspaceAltitude(*asp->Base(), *asp->Top(), alt, alt_agl);
+        asp->CalculateScreenPosition(screenbounds_latlon, iAirspaceMode, iAirspaceBrush, rcDraw, _Proj, altitude_visible, _screen_cache);
     }
+
+#if TESTBENCH
+    static unsigned frames = 0;
+    if ((++frames % 500) == 0) {
+        StartupStore(_T(". Airspace screen cache : %u hits, %u misses" NEWLINE), _screen_cache.hits, _screen_cache.misses);
+    }
+#endif
 }
 
 const CAirspaceList& CAirspaceManager::GetNearAirspacesRef() const {
@@ -3441,9 +3864,9 @@ void CAirspaceManager::SelectAirspacesForPage24(const double latitude, const dou
 
     // Select nearest ones (based on bounds)
     _airspaces_page24.clear();
-    for (CAirspaceList::iterator it = _airspaces.begin(); it != _airspaces.end(); ++it) {
-        if (msRectOverlap(&bounds, &(*it)->Bounds()) == MS_TRUE) _airspaces_page24.push_back(*it);
-    }
+    _airspaces_index.ForEach(bounds, [&](CAirspace* pAsp) {
+        if (msRectOverlap(&bounds, &pAsp->Bounds()) == MS_TRUE) _airspaces_page24.push_back(pAsp);
+    });
 }
 
 void CAirspaceManager::CalculateDistancesForPage24() {
@@ -3616,7 +4039,7 @@ void CAirspaceManager::AutoDisable(const NMEA_INFO& info) {
     if (last_day_of_week != current) {
         last_day_of_week = current;
 
-        for (auto asp : _airspaces) {
+        for (auto asp : _airspaces_day_restricted) {
             if (asp->ExceptSaturday()) {
                 asp->Enabled(current != 5); // Saturday
             }
@@ -3710,3 +4133,314 @@ void CAirspace_Area::CalculatePictPosition(const RECT& rcDraw, double zoom, Rast
     }
 }
 ////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <chrono>
+#include <memory>
+#include <random>
+
+namespace {
+
+  struct SyntheticScan {
+
+    explicit SyntheticScan(unsigned seed) : rand(seed) {
+      std::uniform_real_distribution<double> lat_dist(44., 46.);
+      std::uniform_real_distribution<double> lon_dist(5., 8.);
+      std::uniform_real_distribution<double> size_dist(0.005, 0.4);
+      std::uniform_real_distribution<double> unit_dist(0., 1.);
+
+      const AIRSPACE_ALT base_msl = { 1000., 0., 0., abMSL };
+      const AIRSPACE_ALT base_agl = { 0., 0., 300., abAGL };
+      const AIRSPACE_ALT top = { 3000., 0., 0., abMSL };
+
+      for (unsigned i = 0; i < 200; ++i) {
+        const double lat = lat_dist(rand);
+        const double lon = lon_dist(rand);
+        const double size = size_dist(rand);
+        CAirspace* pAsp;
+        if (i % 4) {
+          // concave star polygon
+          const unsigned count = 5 + i % 60;
+          CPoint2DArray points;
+          for (unsigned j = 0; j < count; ++j) {
+            const double angle = 2 * PI * j / count;
+            const double r = size * (0.2 + 0.8 * unit_dist(rand));
+            points.emplace_back(lat + r * std::sin(angle), lon + r * std::cos(angle) * 1.4);
+          }
+          points.push_back(points.front());
+          pAsp = new CAirspace_Area(std::move(points));
+        } else {
+          pAsp = new CAirspace_Circle({lat, lon}, size * 50000.);
+        }
+        pAsp->Init(_T("test"), 0, (i % 2) ? base_agl : base_msl, top, false);
+        list.push_back(pAsp);
+      }
+    }
+
+    ~SyntheticScan() {
+      std::for_each(list.begin(), list.end(), std::default_delete<CAirspace>());
+    }
+
+    // samples along a geodesic, like sideview does.
+    void NextLine() {
+      std::uniform_real_distribution<double> lat_dist(44., 46.);
+      std::uniform_real_distribution<double> lon_dist(5., 8.);
+      std::uniform_real_distribution<double> bearing_dist(0., 360.);
+      std::uniform_real_distribution<double> range_dist(5000., 200000.);
+      std::uniform_real_distribution<double> height_dist(0., 3000.);
+
+      const double lat = lat_dist(rand);
+      const double lon = lon_dist(rand);
+      const double bearing = bearing_dist(rand);
+      const double range = range_dist(rand);
+      for (unsigned i = 0; i < AIRSPACE_SCANSIZE_X; ++i) {
+        FindLatitudeLongitude(lat, lon, bearing, range * i / (AIRSPACE_SCANSIZE_X - 1), &lats[i], &lons[i]);
+        heights[i] = height_dist(rand);
+      }
+    }
+
+    std::mt19937 rand;
+    CAirspaceList list;
+    double lats[AIRSPACE_SCANSIZE_X];
+    double lons[AIRSPACE_SCANSIZE_X];
+    double heights[AIRSPACE_SCANSIZE_X];
+  };
+
+  struct SideView {
+    AirSpaceSideViewSTRUCT data[MAX_NO_SIDE_AS];
+  };
+
+  // ScanAirspaceLineList() loop before CAirspace::ScanLine(), used as reference.
+  void ReferenceScanAirspaceLine(CAirspace* airspace, const double (&lats)[AIRSPACE_SCANSIZE_X],
+          const double (&lons)[AIRSPACE_SCANSIZE_X], const double (&terrain_heights)[AIRSPACE_SCANSIZE_X],
+          AirSpaceSideViewSTRUCT (&airspacetype)[MAX_NO_SIDE_AS], int& iNoFoundAS) {
+
+    unsigned int iSelAS = 0; // current selected airspace for processing
+    unsigned int i; // loop variable
+    for (i = 0; i < AIRSPACE_SCANSIZE_X; i++) {
+        if (airspace->IsHorizontalInside(lons[i], lats[i])) {
+            BOOL bPrevIn = false;
+            if (i > 0)
+                if (airspace->IsHorizontalInside(lons[i - 1], lats[i - 1]))
+                    bPrevIn = true;
+
+            if (!bPrevIn)/* new AS section in this view*/ {
+                /*********************************************************************
+                 * switch to next airspace section
+                 *********************************************************************/
+                iSelAS = iNoFoundAS;
+                BUGSTOP_LKASSERT(iNoFoundAS < MAX_NO_SIDE_AS);
+                if (iNoFoundAS < MAX_NO_SIDE_AS - 1) iNoFoundAS++;
+                airspacetype[iNoFoundAS].psAS = NULL; // increment and reset head
+                /*********************************************************************/
+                airspacetype[iSelAS].psAS = airspace;
+                airspacetype[iSelAS].iType = airspace->Type();
+
+                LK_tcsncpy(airspacetype[iSelAS].szAS_Name, airspace->Name(), NAME_SIZE - 1);
+
+                airspacetype[iSelAS].iIdx = iSelAS;
+                airspacetype[iSelAS].bRectAllowed = true;
+                airspacetype[iSelAS].bEnabled = airspace->Enabled();
+                /**********************************************************************
+                 * allow rectangular shape if no AGL reference
+                 **********************************************************************/
+                if ((airspace->Top()->Base == abAGL) || ((airspace->Base()->Base == abAGL)))
+                    airspacetype[iSelAS].bRectAllowed = false;
+                /**********************************************************************
+                 * init with minium rectangle right side may be extended
+                 **********************************************************************/
+                airspacetype[iSelAS].rc.left = i;
+                airspacetype[iSelAS].rc.right = i + 1;
+                airspacetype[iSelAS].rc.bottom = (unsigned int) airspace->Base()->Altitude;
+                airspacetype[iSelAS].rc.top = (unsigned int) airspace->Top()->Altitude;
+                airspacetype[iSelAS].iNoPolyPts = 0;
+
+            }
+            int iHeight;
+            airspacetype[iSelAS].rc.right = i + 1;
+            if (i == AIRSPACE_SCANSIZE_X - 1)
+                airspacetype[iSelAS].rc.right = i + 3;
+
+            if ((airspacetype[iSelAS].psAS) && (!airspacetype[iSelAS].bRectAllowed)) {
+
+                if (airspacetype[iSelAS].psAS->Base()->Base == abAGL)
+                    iHeight = (unsigned int) (airspacetype[iSelAS].psAS->Base()->AGL + terrain_heights[i]);
+                else
+                    iHeight = (unsigned int) airspacetype[iSelAS].psAS->Base()->Altitude;
+                LKASSERT((airspacetype[iSelAS].iNoPolyPts) < GC_MAX_POLYGON_PTS);
+                airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts++] = (POINT){(LONG) i, (LONG) iHeight};
+
+                /************************************************************
+                 *  resort and copy polygon array
+                 **************************************************************/
+                bool bLast = false;
+                if (i == AIRSPACE_SCANSIZE_X - 1)
+                    bLast = true;
+                else {
+                    if (airspacetype[iSelAS].psAS->IsHorizontalInside(lons[i + 1], lats[i + 1]))
+                        bLast = false;
+                    else
+                        bLast = true;
+                }
+
+                if (bLast) {
+                    airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts].x = i + 1;
+                    if (i == AIRSPACE_SCANSIZE_X - 1)
+                        airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts].x = i + 3;
+
+                    LKASSERT((airspacetype[iSelAS].iNoPolyPts) < GC_MAX_POLYGON_PTS);
+                    airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts].y = airspacetype[iSelAS].apPolygon[airspacetype[iSelAS].iNoPolyPts - 1].y;
+                    airspacetype[iSelAS].iNoPolyPts++;
+                    LKASSERT((airspacetype[iSelAS].iNoPolyPts) < GC_MAX_POLYGON_PTS);
+                    int iN = airspacetype[iSelAS].iNoPolyPts;
+                    int iCnt = airspacetype[iSelAS].iNoPolyPts;
+
+
+                    for (int iPt = 0; iPt < iN; iPt++) {
+                        LKASSERT(iCnt >= 0);
+                        LKASSERT(iCnt < GC_MAX_POLYGON_PTS);
+
+                        airspacetype[iSelAS].apPolygon[iCnt] = airspacetype[iSelAS].apPolygon[iN - iPt - 1];
+                        if (airspacetype[iSelAS].psAS->Top()->Base == abAGL)
+                            airspacetype[iSelAS].apPolygon[iCnt].y = (unsigned int) (airspacetype[iSelAS].psAS->Top()->AGL + terrain_heights[airspacetype[iSelAS].apPolygon[iCnt].x]);
+                        else
+                            airspacetype[iSelAS].apPolygon[iCnt].y = (unsigned int) airspacetype[iSelAS].psAS->Top()->Altitude;
+                        LKASSERT(iCnt >= iPt);
+
+                        LKASSERT(iPt >= 0);
+                        LKASSERT(iPt < GC_MAX_POLYGON_PTS);
+                        if (iCnt == 0) {
+                            airspacetype[iSelAS].rc.bottom = airspacetype[iSelAS].apPolygon[0].y;
+                            airspacetype[iSelAS].rc.top = airspacetype[iSelAS].apPolygon[0].y;
+                        } else {
+                            airspacetype[iSelAS].rc.bottom = min(airspacetype[iSelAS].rc.bottom, airspacetype[iSelAS].apPolygon[iCnt].y);
+                            airspacetype[iSelAS].rc.top = max(airspacetype[iSelAS].rc.top, airspacetype[iSelAS].apPolygon[iCnt].y);
+                        }
+                        if (iCnt < GC_MAX_POLYGON_PTS - 1)
+                            iCnt++;
+                    }
+                    LKASSERT(iCnt < GC_MAX_POLYGON_PTS);
+                    airspacetype[iSelAS].apPolygon[iCnt++] = airspacetype[iSelAS].apPolygon[0];
+                    airspacetype[iSelAS].iNoPolyPts = iCnt;
+                }
+            }
+            RECT rcs = airspacetype[iSelAS].rc;
+            airspacetype[iSelAS].iAreaSize = abs(rcs.right - rcs.left) * abs(rcs.top - rcs.bottom);
+        } // inside
+    } // finished scanning range
+  }
+
+  bool SameSideView(const SideView& side_a, const SideView& side_b, int count) {
+    const auto& a = side_a.data;
+    const auto& b = side_b.data;
+    for (int i = 0; i < count; ++i) {
+      if (a[i].psAS != b[i].psAS || a[i].iNoPolyPts != b[i].iNoPolyPts || a[i].iAreaSize != b[i].iAreaSize
+              || a[i].bRectAllowed != b[i].bRectAllowed || memcmp(&a[i].rc, &b[i].rc, sizeof(RECT)) != 0) {
+        return false;
+      }
+      if (!a[i].bRectAllowed) {
+        for (int j = 0; j < a[i].iNoPolyPts; ++j) {
+          if (a[i].apPolygon[j].x != b[i].apPolygon[j].x || a[i].apPolygon[j].y != b[i].apPolygon[j].y) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+} // namespace
+
+TEST_SUITE("Airspace sideview") {
+
+  TEST_CASE("scan line same result as sample test") {
+    SyntheticScan scan(1);
+    auto reference = std::make_unique<SideView>();
+    auto result = std::make_unique<SideView>();
+    unsigned inside_count = 0;
+
+    for (unsigned loop = 0; loop < 200; ++loop) {
+      scan.NextLine();
+      const CAirspaceScanLine line(scan.lats, scan.lons);
+      int reference_count = 0;
+      int result_count = 0;
+      reference->data[0].psAS = nullptr;
+      result->data[0].psAS = nullptr;
+      for (CAirspace* pAsp : scan.list) {
+        bool inside_ref[AIRSPACE_SCANSIZE_X];
+        bool inside[AIRSPACE_SCANSIZE_X];
+        pAsp->CAirspace::ScanLine(line, inside_ref);
+        pAsp->ScanLine(line, inside);
+        REQUIRE(std::equal(std::begin(inside), std::end(inside), std::begin(inside_ref)));
+        inside_count += std::count(std::begin(inside), std::end(inside), true);
+
+        if (reference_count < MAX_NO_SIDE_AS - 1) {
+          ReferenceScanAirspaceLine(pAsp, scan.lats, scan.lons, scan.heights, reference->data, reference_count);
+          ScanAirspaceLine(pAsp, inside, scan.heights, result->data, result_count);
+        }
+      }
+      REQUIRE(result_count == reference_count);
+      CHECK(SameSideView(*result, *reference, result_count));
+    }
+    CHECK(inside_count > 0);
+  }
+
+  TEST_CASE("edge along scan line") {
+    SyntheticScan scan(2);
+    scan.NextLine();
+    const CAirspaceScanLine line(scan.lats, scan.lons);
+    constexpr unsigned a = AIRSPACE_SCANSIZE_X / 4;
+    constexpr unsigned b = AIRSPACE_SCANSIZE_X * 3 / 4;
+
+    // edges go through samples, one is along line
+    CPoint2DArray points;
+    points.emplace_back(scan.lats[a], scan.lons[a]);
+    points.emplace_back(scan.lats[b], scan.lons[b]);
+    points.emplace_back(scan.lats[b] + 0.05, scan.lons[b] + 0.05);
+    points.emplace_back(scan.lats[a] + 0.05, scan.lons[a] - 0.05);
+    points.push_back(points.front());
+    CAirspace_Area area(std::move(points));
+
+    bool inside_ref[AIRSPACE_SCANSIZE_X];
+    bool inside[AIRSPACE_SCANSIZE_X];
+    area.CAirspace::ScanLine(line, inside_ref);
+    area.ScanLine(line, inside);
+    CHECK(std::equal(std::begin(inside), std::end(inside), std::begin(inside_ref)));
+  }
+
+  TEST_CASE("benchmark" * doctest::skip()) {
+    SyntheticScan scan(3);
+    constexpr unsigned loop = 200;
+    double reference_us = 0;
+    double result_us = 0;
+    size_t found = 0;
+
+    using std::chrono::steady_clock;
+    for (unsigned i = 0; i < loop; ++i) {
+      scan.NextLine();
+      const CAirspaceScanLine line(scan.lats, scan.lons);
+      bool inside[AIRSPACE_SCANSIZE_X];
+
+      auto start = steady_clock::now();
+      for (CAirspace* pAsp : scan.list) {
+        pAsp->CAirspace::ScanLine(line, inside);
+        found += inside[0];
+      }
+      std::chrono::duration<double, std::micro> elapsed = steady_clock::now() - start;
+      reference_us += elapsed.count();
+
+      start = steady_clock::now();
+      for (CAirspace* pAsp : scan.list) {
+        pAsp->ScanLine(line, inside);
+        found += inside[0];
+      }
+      elapsed = steady_clock::now() - start;
+      result_us += elapsed.count();
+    }
+    MESSAGE("scan ", scan.list.size(), " airspaces : sample test ", reference_us / loop,
+            "us, crossing ", result_us / loop, "us (", found, ")");
+  }
+}
+
+#endif
@@ -236,7 +236,7 @@ unsigned AndroidPort::RxThread() {
             ScopeUnlock unlock(mutex); // workaround to prevent deadlock on shutdown
 
             WithLock(CritSec_Comm, [&]() {
-                std::for_each(std::begin(rxthread_buffer), std::end(rxthread_buffer), GetProcessCharHandler());
+                ProcessData(reinterpret_cast<char*>(rxthread_buffer.data()), rxthread_buffer.size());
             });
         }
     }
@@ -80,6 +80,8 @@ CContestMgr::CContestMgr():
   _traceSprint(new CTrace(TRACE_SPRINT_FIX_LIMIT, TRACE_SPRINT_TIME_LIMIT, COMPRESSION_ALGORITHM)),
   _traceFreeTriangle(new CTrace(TRACE_TRIANGLE_FIX_LIMIT, 0, COMPRESSION_ALGORITHM)),
   _traceLoop(new CTrace(TRACE_TRIANGLE_FIX_LIMIT, 0, COMPRESSION_ALGORITHM)),
+  _traceResult(new CTrace(7, 0, CTrace::ALGORITHM_DISTANCE)),
+  _traceResultSprint(new CTrace(5, TRACE_SPRINT_TIME_LIMIT, CTrace::ALGORITHM_DISTANCE)),
   _prevFAIFront(), _prevFAIBack(),
   _prevFAIPredictedFront(), _prevFAIPredictedBack(),
   _prevFreeTriangleFront(),_prevFreeTriangleBack(),
@@ -100,12 +102,20 @@ CContestMgr::CContestMgr():
   _bFAI(false),
   _maxFAILeg(nullptr),
   _bLooksLikeAFAITriangle(false),
-  _dFAITriangleClockwise(0)
+  _dFAITriangleClockwise(0),
+  _dLastFAIDistance(std::numeric_limits<double>::max()),
+  _dLastFreeDistance(std::numeric_limits<double>::max()),
+  _lastFix(0, 0, 0, 0),
+  _step(0),
+  _droppedFixes(0),
+  _optimizerThread("ContestOptimizer"),
+  _optimizerRunning(false),
+  _optimizerStop(false)
 {
   _resultFREETriangle = CResult();
-  ScopeLock guard(_resultsCS);
   for(unsigned i=0; i<TYPE_NUM; i++)
     _resultArray.push_back(CResult());
+  PublishResults();
 }
 
 /** 
@@ -146,11 +156,14 @@ void CContestMgr::Reset(unsigned handicap) {
   _bLooksLikeAFAITriangle = false;
   _dFAITriangleClockwise = 0;
   _resultFREETriangle = CResult();
-  {
-    ScopeLock Resultguard(_resultsCS);
-    for (unsigned i = 0; i < TYPE_NUM; i++)
-      _resultArray[i] = CResult();
-  }
+  for (unsigned i = 0; i < TYPE_NUM; i++)
+    _resultArray[i] = CResult();
+
+  // discard fixes of previous flight not yet processed
+  CFix fix;
+  while (_fixQueue.Pop(fix)) { }
+
+  PublishResults();
 }
 
 /** 
@@ -224,7 +237,7 @@ bool CContestMgr::BiggestLoopFind(const CTrace &traceIn, CTrace &traceOut, bool
       // new valid loop found - copy the points to output trace
       const CTrace::CPoint *point = start;
       while(point) {
-        traceOut.Push(new CTrace::CPoint(traceOut, *point, traceOut._back));
+        traceOut.Push(*point);
         if(point == end)
           break;
         point = point->Next();
@@ -392,7 +405,6 @@ void CContestMgr::PointsResultOLC(TType type, const CTrace &traceResult)
       score = 0;
     }
     bool predicted = pointArray.back().TimeDelta(_trace->Back()->GPS()) > 0;
-    ScopeLock guard(_resultsCS);
     _resultArray[type] = CResult(type, predicted, distance, score, pointArray);
   }
 }
@@ -428,13 +440,14 @@ void CContestMgr::SolvePoints(const CTrace &trace, bool sprint, bool predicted)
     // no points matching heights constrain
     return;
   
-  // create result trace
-  CTrace traceResult(sprint ? 5 : 7, sprint ? TRACE_SPRINT_TIME_LIMIT : 0, CTrace::ALGORITHM_DISTANCE);
+  // reuse result trace storage
+  CTrace &traceResult = sprint ? *_traceResultSprint : *_traceResult;
+  traceResult.Clear();
   
   // add points to result trace
   point = first;
   while(point && point != last->Next()) {
-    traceResult.Push(new CTrace::CPoint(traceResult, *point, traceResult._back));
+    traceResult.Push(*point);
     point = point->Next();
   }
   
@@ -456,13 +469,12 @@ void CContestMgr::SolvePoints(const CTrace &trace, bool sprint, bool predicted)
   }
   
   // compress trace to obtain the result
-  traceResult.Compress();
+  traceResult.Compress(sprint ? 5 : 7);
   
   // store result
   TType type = sprint ? TYPE_OLC_LEAGUE : (predicted ? TYPE_OLC_CLASSIC_PREDICTED : TYPE_OLC_CLASSIC);
   if(predicted) {
     // do it just in a case if predicted trace is worst than the current one
-    ScopeLock guard(_resultsCS);
     _resultArray[TYPE_OLC_CLASSIC_PREDICTED] = CResult(TYPE_OLC_CLASSIC_PREDICTED, _resultArray[TYPE_OLC_CLASSIC]);
   }
   PointsResultOLC(type, traceResult);
@@ -477,7 +489,6 @@ else*/
     // store result
     if(predicted) {
       // do it just in a case if predicted trace is worst than the current one
-      ScopeLock guard(_resultsCS);
       _resultArray[TYPE_FAI_3_TPS_PREDICTED] = CResult(TYPE_FAI_3_TPS_PREDICTED, _resultArray[TYPE_FAI_3_TPS]);
     }
 
@@ -616,7 +627,6 @@ void CContestMgr::SolveFAITriangle(const CTrace &trace, const CPointGPS *prevFro
   }
 
   if (bestResult.Type() != TYPE_INVALID) {
-    ScopeLock guard(_resultsCS);
     _resultArray[type] = bestResult;
   }
 }
@@ -707,7 +717,6 @@ void CContestMgr::SolveFREETriangle(const CTrace &trace,const CPointGPS *prevFro
  */
 void CContestMgr::SolveOLCPlus(bool predicted)
 {
-  ScopeLock guard(_resultsCS);
   CResult &classic = _resultArray[predicted ? TYPE_OLC_CLASSIC_PREDICTED : TYPE_OLC_CLASSIC];
   CResult &fai = _resultArray[predicted ? TYPE_OLC_FAI_PREDICTED : TYPE_OLC_FAI];
   _resultArray[predicted ? TYPE_OLC_PLUS_PREDICTED : TYPE_OLC_PLUS] =
@@ -719,6 +728,9 @@ void CContestMgr::SolveOLCPlus(bool predicted)
 /** 
  * @brief Adds a new GPS fix to analysis
  * 
+ * Fix is only queued, contests are solved by optimizer thread; when that
+ * thread is not running (startup, tools), fix is processed immediately.
+ * 
  * @param gps New GPS fix to use in analysis
  */
 void CContestMgr::Add(unsigned time, double lat, double lon, int alt) {
@@ -727,19 +739,89 @@ void CContestMgr::Add(unsigned time, double lat, double lon, int alt) {
     return;
   }
 
-  static CPointGPS lastGps(0, 0, 0, 0);
-  static unsigned step = 0;
-  const unsigned STEPS_NUM = 9;
+  // filter out GPS fix repeats
+  const CPointGPS gps(time, lat, lon, alt);
+  if (_lastFix == gps)
+    return;
+  _lastFix = gps;
 
+  if (!_fixQueue.Push({ time, lat, lon, alt })) {
+    // optimizer is late by more than FIX_QUEUE_SIZE fixes
+    ++_droppedFixes;
+    return;
+  }
 
-  const CPointGPSSmart gps = make_CPointGPSSmart(time, lat, lon, alt);
+  if (_optimizerRunning) {
+    _fixEvent.set();
+  } else {
+    ProcessFixes();
+  }
+}
 
-  // filter out GPS fix repeats
-  if (lastGps == *gps)
-    return;
-  lastGps = *gps;
 
+/** 
+ * @brief Processes all queued GPS fixes and publishes new results
+ */
+void CContestMgr::ProcessFixes() {
   ScopeLock guard(_mainCS);
+  bool updated = false;
+  CFix fix;
+  while (_fixQueue.Pop(fix)) {
+    ProcessFix(fix);
+    updated = true;
+  }
+  if (updated) {
+    PublishResults();
+  }
+}
+
+
+/** 
+ * @brief Makes a copy of current results available to readers
+ * 
+ * _mainCS must be locked (or object under construction).
+ */
+void CContestMgr::PublishResults() {
+  std::atomic_store(&_publishedResults, std::make_shared<const CResultArray>(_resultArray));
+
+  auto status = std::make_shared<CXCStatus>();
+  status->bestXCType = _bestXCType;
+  status->bestXCTriangleType = _bestXCTriangleType;
+  status->FAIStatus = _XCFAIStatus;
+  status->FTStatus = _XCFTStatus;
+  status->triangleClosurePercentage = _XCTriangleClosurePercentage;
+  status->triangleClosureDistance = _XCTriangleClosureDistance;
+  status->triangleDistance = _XCTriangleDistance;
+  status->meanSpeed = _XCMeanSpeed;
+  status->freeTriangleClosePoint = _pgpsFreeTriangleClosePoint;
+  status->freeTriangleTogo = _fFreeTriangleTogo;
+  status->freeTriangleBestTogo = _fFreeTriangleBestTogo;
+  status->FAITriangleClosePoint = _pgpsFAITriangleClosePoint;
+  status->FAITriangleTogo = _fFAITriangleTogo;
+  status->FAITriangleBestTogo = _fFAITriangleBestTogo;
+  status->FAI = _bFAI;
+  status->FAIAssistantLegs = _faiAssistantTriangleLegs;
+  status->FAIAssistantMaxLeg = _maxFAILeg ? std::distance(_faiAssistantTriangleLegs.data(), _maxFAILeg) : -1;
+  status->looksLikeAFAITriangle = _bLooksLikeAFAITriangle;
+  status->FAITriangleClockwise = _dFAITriangleClockwise;
+  std::atomic_store(&_publishedXCStatus, std::shared_ptr<const CXCStatus>(std::move(status)));
+}
+
+
+/** 
+ * @brief Runs one solver step for a new GPS fix
+ * 
+ * _mainCS must be locked.
+ * 
+ * @param fix New GPS fix to use in analysis
+ */
+void CContestMgr::ProcessFix(const CFix &fix) {
+
+  const unsigned STEPS_NUM = 9;
+  const unsigned step = _step;
+
+  const CPointGPSSmart gps = make_CPointGPSSmart(fix.time, fix.lat, fix.lon, fix.alt);
+
   {
     // Update main trace
     ScopeLock Traceguard(_traceCS);
@@ -823,7 +905,50 @@ void CContestMgr::Add(unsigned time, double lat, double lon, int alt) {
     SolveXC();
   }
 
-  step++;
+  _step++;
+}
+
+
+void CContestMgr::run() {
+  while (!_optimizerStop) {
+    _fixEvent.tryWait(1000);
+    ProcessFixes();
+  }
+}
+
+
+/** 
+ * @brief Starts contest optimizer thread
+ * 
+ * From now, Add() never run solvers on caller thread.
+ */
+void CContestMgr::StartOptimizer() {
+  if (_optimizerThread.isRunning()) {
+    return;
+  }
+  _optimizerStop = false;
+  _optimizerThread.start(*this);
+  _optimizerRunning = true;
+  _fixEvent.set();
+}
+
+
+/** 
+ * @brief Stops contest optimizer thread, queued fixes are processed before exit
+ */
+void CContestMgr::StopOptimizer() {
+  if (!_optimizerThread.isRunning()) {
+    return;
+  }
+  _optimizerRunning = false;
+  _optimizerStop = true;
+  _fixEvent.set();
+  _optimizerThread.join();
+  ProcessFixes();
+
+  if (_droppedFixes) {
+    StartupStore(_T(". ContestMgr : %u fixes dropped by optimizer%s"), _droppedFixes.load(), NEWLINE);
+  }
 }
 
 
@@ -855,7 +980,6 @@ void CContestMgr::FindFAITriangleClosingPoint() {
 
   CResult &resfai = _resultArray[TYPE_OLC_FAI_PREDICTED];
 
-  static double dLastFAIDistance = std::numeric_limits<double>::max();
   double fFAITriangleBestTogo = std::numeric_limits<double>::max(); // 100e100; // PC does not compile  DBL_MAX;
   double fFAIAngle = 0;
   //CPointGPS pgpsFAIBestClose(0, 0, 0, 0);
@@ -884,10 +1008,10 @@ void CContestMgr::FindFAITriangleClosingPoint() {
 
     }
 
-    if (dLastFAIDistance == resfai.Distance()) {
+    if (_dLastFAIDistance == resfai.Distance()) {
       _fFAITriangleBestTogo = min(_fFAITriangleBestTogo, fFAITriangleBestTogo);
     } else {
-      dLastFAIDistance = resfai.Distance();
+      _dLastFAIDistance = resfai.Distance();
       _fFAITriangleBestTogo = fFAITriangleBestTogo;
     }
   }
@@ -900,7 +1024,6 @@ void CContestMgr::FindFAITriangleClosingPoint() {
  */
 void CContestMgr::FindFREETriangleClosingPoint() {
 
-  static double dLastFreeDistance = std::numeric_limits<double>::max();// 100e100;
   double fFreeTriangleBestTogo = std::numeric_limits<double>::max(); // 100e100; // PC does not compile  DBL_MAX;
   double fFreeAngle = 0;
   //CPointGPS pgpsFreeBestClose(0, 0, 0, 0);
@@ -928,10 +1051,10 @@ void CContestMgr::FindFREETriangleClosingPoint() {
       _pgpsFreeTriangleClosePoint = CPointGPS(pgpsFreeClose.Time(), pgpsFreeClose.Latitude(), pgpsFreeClose.Longitude(), Alt);
 
     }
-    if (dLastFreeDistance == _resultFREETriangle.PredictedDistance()) {
+    if (_dLastFreeDistance == _resultFREETriangle.PredictedDistance()) {
       _fFreeTriangleBestTogo = min(_fFreeTriangleBestTogo, fFreeTriangleBestTogo);
     } else {
-      dLastFreeDistance = _resultFREETriangle.PredictedDistance();
+      _dLastFreeDistance = _resultFREETriangle.PredictedDistance();
       _fFreeTriangleBestTogo = fFreeTriangleBestTogo;
     }
   }
@@ -948,8 +1071,6 @@ void CContestMgr::SolveXC() {
   FindFAITriangleClosingPoint();
   FindFREETriangleClosingPoint();
 
-  ScopeLock guard(_resultsCS);
-
   //
   // Calculate results for FAI Triangle.
   //
@@ -999,6 +1120,8 @@ void CContestMgr::SolveXC() {
   //
   // Best Triangle data
   //
+  // all "WayPointList" change need to be protected by "LockTaskData", we are not on calculation thread anymore.
+  ScopeLock lock(CritSec_TaskData);
   _bestXCTriangleType = XCFlightType::XC_INVALID;
   double predicted_score_fai = ScoreXC(predicted_distance_fai, predicted_distance_fai, XCFlightType::XC_FAI_TRIANGLE, false);
   double predicted_score_ft = ScoreXC(predicted_distance_ft, predicted_distance_ft, XCFlightType::XC_FREE_TRIANGLE, false);
@@ -1402,13 +1525,13 @@ double CContestMgr::ScoreUK_NATIONAL_LEAGUE(double current_distance, double tota
 }
 
 
-CPointGPS CContestMgr::GetXCTriangleClosingPoint() {
-  switch ( _bestXCTriangleType ) {
+CPointGPS CContestMgr::CXCStatus::XCTriangleClosingPoint() const {
+  switch ( bestXCTriangleType ) {
     case XCFlightType::XC_FREE_TRIANGLE:
-      return _pgpsFreeTriangleClosePoint;
+      return freeTriangleClosePoint;
       break;
     case XCFlightType::XC_FAI_TRIANGLE:
-      return _pgpsFAITriangleClosePoint;
+      return FAITriangleClosePoint;
       break;
     default:
       break;
@@ -1420,7 +1543,7 @@ CPointGPS CContestMgr::GetXCTriangleClosingPoint() {
 /*
  * Return the current distance from the best closing point to have a VALID triangle according to current rule
 */
- double CContestMgr::GetXCValidRadius() {
+ double CContestMgr::GetXCValidRadius(const CXCStatus &status) {
 
   double radius = 0;
   switch (AdditionalContestRule) {
@@ -1431,19 +1554,19 @@ CPointGPS CContestMgr::GetXCTriangleClosingPoint() {
       radius= 1000.0;
       break;
     case static_cast<int>(ContestRule::XContest2018):
-      radius = _XCTriangleDistance * 0.20;
+      radius = status.triangleDistance * 0.20;
       break;
     case static_cast<int>(ContestRule::XContest2019):
-      radius = _XCTriangleDistance * 0.20;
+      radius = status.triangleDistance * 0.20;
       break;
     case static_cast<int>(ContestRule::CFD):
-      radius = _XCTriangleDistance * 0.05;
+      radius = status.triangleDistance * 0.05;
       break;
     case static_cast<int>(ContestRule::LEONARDO_XC):
-      radius = _XCTriangleDistance * 0.20;
+      radius = status.triangleDistance * 0.20;
       break;
     case static_cast<int>(ContestRule::UK_NATIONAL_LEAGUE):
-      radius = _XCTriangleDistance * 0.20;
+      radius = status.triangleDistance * 0.20;
       break;
     default:
       break;
@@ -1454,7 +1577,7 @@ CPointGPS CContestMgr::GetXCTriangleClosingPoint() {
 /*
  * Return the current distance from the best closing point to have a CLOSED triangle according to current rule
 */
-double CContestMgr::GetXCClosedRadius() {
+double CContestMgr::GetXCClosedRadius(const CXCStatus &status) {
 
   double radius = 0;
   switch (AdditionalContestRule) {
@@ -1468,7 +1591,7 @@ double CContestMgr::GetXCClosedRadius() {
       radius = 0;
       break;
     case static_cast<int>(ContestRule::XContest2019):
-      radius =_XCTriangleDistance* 0.05;
+      radius =status.triangleDistance* 0.05;
       break;
     case static_cast<int>(ContestRule::CFD):
       radius = 3000.0;
@@ -1534,4 +1657,85 @@ void CContestMgr::UpdateFAIAssistantData() {
 };
 
 
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_SUITE("ContestMgr") {
+
+  TEST_CASE("spsc queue") {
+    SPSCQueue<unsigned, 4> queue;
+    unsigned value = 0;
+    CHECK(queue.Empty());
+    CHECK_FALSE(queue.Pop(value));
+
+    for (unsigned i = 0; i < 4; ++i) {
+      CHECK(queue.Push(i));
+    }
+    CHECK_FALSE(queue.Push(4));
+
+    CHECK(queue.Pop(value));
+    CHECK(value == 0);
+    CHECK(queue.Push(4));
+
+    for (unsigned i = 1; i <= 4; ++i) {
+      CHECK(queue.Pop(value));
+      CHECK(value == i);
+    }
+    CHECK(queue.Empty());
+  }
+
+  TEST_CASE("optimizer thread") {
+    const int rule = AdditionalContestRule;
+    AdditionalContestRule = static_cast<int>(CContestMgr::ContestRule::OLC);
+
+    // XC solver update RESWP_FAIOPTIMIZED, reserved waypoints must exist.
+    std::vector<WAYPOINT> waypoints(NUMRESWP);
+    std::vector<WPCALC> calcs(NUMRESWP);
+    {
+      ScopeLock lock(CritSec_TaskData);
+      std::swap(WayPointList, waypoints);
+      std::swap(WayPointCalc, calcs);
+    }
+
+    // same track processed inline and by optimizer thread must give same results.
+    CContestMgr inline_mgr;
+    CContestMgr thread_mgr;
+    inline_mgr.Reset(100);
+    thread_mgr.Reset(100);
+    thread_mgr.StartOptimizer();
+
+    for (unsigned i = 0; i < 600; ++i) {
+      const double lat = 45. + 0.2 * sin(i / 50.);
+      const double lon = 6. + 0.2 * cos(i / 70.) + i * 0.0005;
+      const int alt = 1500 + (i % 100) * 5;
+      inline_mgr.Add(36000 + i * 4, lat, lon, alt);
+      thread_mgr.Add(36000 + i * 4, lat, lon, alt);
+    }
+    thread_mgr.StopOptimizer();
+
+    for (auto type : { CContestMgr::TYPE_OLC_CLASSIC, CContestMgr::TYPE_OLC_FAI,
+                       CContestMgr::TYPE_OLC_LEAGUE, CContestMgr::TYPE_FAI_3_TPS }) {
+      const CContestMgr::CResult expected = inline_mgr.Result(type, true);
+      const CContestMgr::CResult result = thread_mgr.Result(type, true);
+      CHECK(result.Distance() == expected.Distance());
+      CHECK(result.PointArray().size() == expected.PointArray().size());
+    }
+    CHECK(inline_mgr.Result(CContestMgr::TYPE_OLC_CLASSIC, false).Distance() > 0);
+
+    const auto expected_xc = inline_mgr.XCStatus();
+    const auto xc = thread_mgr.XCStatus();
+    CHECK(xc->FAI == expected_xc->FAI);
+    CHECK(xc->FAITriangleTogo == expected_xc->FAITriangleTogo);
+    CHECK(xc->FAITriangleBestTogo == expected_xc->FAITriangleBestTogo);
+    CHECK(xc->FAIAssistantMaxLeg == expected_xc->FAIAssistantMaxLeg);
+
+    {
+      ScopeLock lock(CritSec_TaskData);
+      std::swap(WayPointList, waypoints);
+      std::swap(WayPointCalc, calcs);
+    }
+    AdditionalContestRule = rule;
+  }
+}
 
+#endif
@@ -49,6 +49,9 @@ void DoLogging(NMEA_INFO *Basic, DERIVED_INFO *Calculated) {
 	DoInit[MDI_CALCLOGGING]=false;
   }
 
+  // don't wait next valid fix to close igc file after logger is stopped
+  LoggerCloseIfStopped();
+
   if (Basic->NAVWarning) return;
 
   // We do not want of course any duplicate timestamps, but in case something has gone wrong from gps,
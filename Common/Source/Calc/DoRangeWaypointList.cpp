@@ -9,9 +9,41 @@
 #include "externs.h"
 #include "DoInits.h"
 #include "NavFunctions.h"
+#include "Waypoints/WaypointIndex.h"
+#include <numeric>
 
 extern int CalculateWaypointApproxDistance(int scx_aircraft, int scy_aircraft, int i);
 
+// Fill @candidates with all waypoints that can be within @range of aircraft, using
+// same flat coordinates as CalculateWaypointApproxDistance, in ascending order.
+// Reserved waypoints are not indexed, they are always candidates.
+static void RangeCandidates(int scx_aircraft, int scy_aircraft, int range, std::vector<int>& candidates) {
+
+  // approx distance <= range implies |dx| <= range and |dy| <= range, +1 for int truncation
+  const double lat_min = (scy_aircraft - range - 1) / 100.;
+  const double lat_max = (scy_aircraft + range + 1) / 100.;
+  const double x_min = (scx_aircraft - range - 1) / 100.;
+  const double x_max = (scx_aircraft + range + 1) / 100.;
+
+  // x = lon * cos(lat), with cos(lat) inside [cos_min, cos_max], margin for fastcosine table resolution
+  const double abs_lat_min = (lat_min <= 0 && lat_max >= 0) ? 0 : std::min(fabs(lat_min), fabs(lat_max));
+  const double abs_lat_max = std::max(fabs(lat_min), fabs(lat_max));
+  const double cos_max = cos(abs_lat_min * DEG_TO_RAD) + 0.005;
+  const double cos_min = cos(std::min(90., abs_lat_max) * DEG_TO_RAD) - 0.005;
+
+  double lon_min = -180, lon_max = 180;
+  if (cos_min > 0.01) {
+    lon_min = std::max(lon_min, std::min(x_min / cos_min, x_min / cos_max));
+    lon_max = std::min(lon_max, std::max(x_max / cos_min, x_max / cos_max));
+  }
+
+  WayPointIndex.Box(lat_min, lat_max, lon_min, lon_max, candidates);
+
+  const size_t reserved = std::min<size_t>(NUMRESWP, WayPointList.size());
+  candidates.insert(candidates.begin(), reserved, 0);
+  std::iota(candidates.begin(), std::next(candidates.begin(), reserved), 0);
+}
+
 
 // This was introduced in december 2010, updated in october 2011
 // REDUCE WAYPOINTLIST TO THOSE IN RANGE, UNSORTED
@@ -97,6 +129,10 @@ bool DoRangeWaypointList(NMEA_INFO *Basic, DERIVED_INFO *Calculated) {
   bool retunedst_tps;
   bool retunedst_lnd;
 
+  // range can only be reduced by retune below, candidates are computed once.
+  std::vector<int> candidates;
+  RangeCandidates(scx_aircraft, scy_aircraft, std::max(dstrangeturnpoint, dstrangelandable), candidates);
+
 _retunedst:
 
   retunedst_tps=false;
@@ -118,7 +154,9 @@ _retunedst:
   StartupStore(_T(".... dstrangeturnpoint=%d  dstrangelandable=%d\n"),dstrangeturnpoint,dstrangelandable);
   #endif
 
-  for (i=0, kt=0, kl=0, ka=0; i<WayPointList.size(); i++) {
+  kt=0; kl=0; ka=0;
+  for (int candidate : candidates) {
+	i = candidate;
 
 	int approx_distance = CalculateWaypointApproxDistance(scx_aircraft, scy_aircraft, i);
 
@@ -70,22 +70,10 @@ double FarFinalGlideThroughTerrain(const double this_bearing,
   lat = last_lat = start_lat;
   lon = last_lon = start_lon;
 
-  altitude = myaltitude;
-  h =  max(0, (int)RasterTerrain::GetTerrainHeight(lat, lon)); 
-  if (h==TERRAIN_INVALID) h=0; //@ 101027 FIX
-  dh = altitude - h - SAFETYALTITUDETERRAIN/10;
-  last_dh = dh;
-  if (dh<0) {
-    start_under = true;
-    // already below safety terrain height
-    //    retval = 0;
-    //    goto OnExit;
-  }
-
   // find grid
   double dlat, dlon;
 
-  FindLatitudeLongitude(lat, lon, this_bearing, glide_max_range, &dlat, &dlon);
+  FindLatitudeLongitude(start_lat, start_lon, this_bearing, glide_max_range, &dlat, &dlon);
   dlat -= start_lat;
   dlon -= start_lon;
 
@@ -99,6 +87,23 @@ double FarFinalGlideThroughTerrain(const double this_bearing,
   dlat *= f_scale;
   dlon *= f_scale;
 
+  // terrain profile along glide path, point i is at start + i * (dlat, dlon)
+  TerrainLineProfile<NUMFINALGLIDETERRAIN + 1> profile(start_lat, start_lon,
+                                                       start_lat + NUMFINALGLIDETERRAIN * dlat,
+                                                       start_lon + NUMFINALGLIDETERRAIN * dlon);
+
+  altitude = myaltitude;
+  h =  max(0, (int)profile[0]); 
+  if (h==TERRAIN_INVALID) h=0; //@ 101027 FIX
+  dh = altitude - h - SAFETYALTITUDETERRAIN/10;
+  last_dh = dh;
+  if (dh<0) {
+    start_under = true;
+    // already below safety terrain height
+    //    retval = 0;
+    //    goto OnExit;
+  }
+
   for (i=1; i<=NUMFINALGLIDETERRAIN; i++) {
     double f;
     bool solution_found = false;
@@ -124,7 +129,7 @@ double FarFinalGlideThroughTerrain(const double this_bearing,
     lon += dlon;
 
     // find height over terrain
-    h =  max(0,(int)RasterTerrain::GetTerrainHeight(lat, lon)); 
+    h =  max(0,(int)profile[i]); 
     if (h==TERRAIN_INVALID) h=0;
 
     dh = altitude - h - SAFETYALTITUDETERRAIN/10;
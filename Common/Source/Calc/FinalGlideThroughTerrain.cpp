@@ -26,11 +26,34 @@ double FinalGlideThroughTerrain(const double this_bearing,
 				bool *out_of_range,
 				double *TerrainBase)
 {
-  double irange = GlidePolar::MacCreadyAltitude(MACCREADY,
+  const double irange = GlidePolar::MacCreadyAltitude(MACCREADY,
 						1.0, this_bearing,
 						Calculated->WindSpeed,
 						Calculated->WindBearing,
 						0, 0, true, 0);
+
+  // Warning: leave this part locked, RasterTerrain need no changes on the map position while working
+  ScopeLock lock(RasterTerrain::mutex);  //@ 101031 WE DO NEED IT!   BUG 101027:  no need, locking individually
+  return GlideRangeThroughTerrain(irange, this_bearing, start_lat, start_lon, start_alt,
+                                  retlat, retlon, max_range, out_of_range, TerrainBase);
+}
+
+/*
+ * irange : altitude lost per meter in @this_bearing direction.
+ *
+ * RasterTerrain::mutex must be locked by caller, but this don't use shared
+ * terrain rounding nor polar, so it can be called concurrently.
+ */
+double GlideRangeThroughTerrain(const double irange,
+                                const double this_bearing,
+                                const double start_lat,
+                                const double start_lon,
+                                const double start_alt,
+                                double *retlat, double *retlon,
+                                const double max_range,
+                                bool *out_of_range,
+                                double *TerrainBase)
+{
   double safetyterrain;
 
   if (retlat && retlon) {
@@ -57,8 +80,6 @@ double FinalGlideThroughTerrain(const double this_bearing,
   double last_dh=0;
   double altitude;
 
-  // Warning: leave this part locked, RasterTerrain need no changes on the map position while working
-  RasterTerrain::Lock();  //@ 101031 WE DO NEED IT!   BUG 101027:  no need, locking individually
   double retval = 0;
   int i=0;
   bool start_under = false;
@@ -70,27 +91,14 @@ double FinalGlideThroughTerrain(const double this_bearing,
 
   double Xrounding = fabs(lon-start_lon)/2;
   double Yrounding = fabs(lat-start_lat)/2;
-  RasterTerrain::SetTerrainRounding(Xrounding, Yrounding);
 
   lat = last_lat = start_lat;
   lon = last_lon = start_lon;
 
-  altitude = start_alt;
-  h =  max((short)0, RasterTerrain::GetTerrainHeight(lat, lon));
-  if (h==TERRAIN_INVALID) h=0; // @ 101027 FIX
-  dh = altitude - h - safetyterrain;
-  last_dh = dh;
-  if (dh<0) {
-    start_under = true;
-    // already below safety terrain height
-    //    retval = 0;
-    //    goto OnExit;
-  }
-
   // find grid
   double dlat, dlon;
 
-  FindLatitudeLongitude(lat, lon, this_bearing, glide_max_range, &dlat, &dlon);
+  FindLatitudeLongitude(start_lat, start_lon, this_bearing, glide_max_range, &dlat, &dlon);
   dlat -= start_lat;
   dlon -= start_lon;
 
@@ -104,6 +112,23 @@ double FinalGlideThroughTerrain(const double this_bearing,
   dlat *= f_scale;
   dlon *= f_scale;
 
+  // terrain profile along glide path, point i is at start + i * (dlat, dlon)
+  TerrainLineProfile<NUMFINALGLIDETERRAIN + 1> profile(Xrounding, Yrounding, start_lat, start_lon,
+                                                       start_lat + NUMFINALGLIDETERRAIN * dlat,
+                                                       start_lon + NUMFINALGLIDETERRAIN * dlon);
+
+  altitude = start_alt;
+  h =  max((short)0, profile[0]);
+  if (h==TERRAIN_INVALID) h=0; // @ 101027 FIX
+  dh = altitude - h - safetyterrain;
+  last_dh = dh;
+  if (dh<0) {
+    start_under = true;
+    // already below safety terrain height
+    //    retval = 0;
+    //    goto OnExit;
+  }
+
   for (i=1; i<=NUMFINALGLIDETERRAIN; i++) {
     double f;
     bool solution_found = false;
@@ -137,7 +162,7 @@ double FinalGlideThroughTerrain(const double this_bearing,
 
     // find height over terrain
 
-    h =  max((short)0, RasterTerrain::GetTerrainHeight(lat, lon));
+    h =  max((short)0, profile[i]);
     if (h==TERRAIN_INVALID) h=0; //@ 101027 FIX
 
 
@@ -191,6 +216,5 @@ double FinalGlideThroughTerrain(const double this_bearing,
   retval = glide_max_range;
 
  OnExit:
-  RasterTerrain::Unlock();
   return retval;
 }
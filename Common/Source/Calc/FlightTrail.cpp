@@ -0,0 +1,467 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   FlightTrail.cpp
+ */
+
+#include "options.h"
+#include "FlightTrail.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+  constexpr double coord_scale = 1e6; // 1e-6 degree unit
+  constexpr double meter_per_degree = 111195.;
+
+  const GeoPoint break_point = { 100., 0. };
+
+  bool Overlap(const rectObj& a, const rectObj& b) {
+    return a.minx <= b.maxx && a.maxx >= b.minx && a.miny <= b.maxy && a.maxy >= b.miny;
+  }
+
+  void Extend(rectObj& rect, const GeoPoint& pt) {
+    rect.minx = std::min(rect.minx, pt.longitude);
+    rect.maxx = std::max(rect.maxx, pt.longitude);
+    rect.miny = std::min(rect.miny, pt.latitude);
+    rect.maxy = std::max(rect.maxy, pt.latitude);
+  }
+
+  bool FitInt16(int32_t value) {
+    return value >= std::numeric_limits<int16_t>::min() && value <= std::numeric_limits<int16_t>::max();
+  }
+
+  constexpr double time_scale = 10; // 1/10 second unit
+
+  bool FitUInt16(double value) {
+    return value >= 0 && value <= std::numeric_limits<uint16_t>::max();
+  }
+
+  struct xy_t {
+    double x, y;
+  };
+
+  // square distance from @p to segment [@a, @b]
+  double SegmentDistance2(const xy_t& p, const xy_t& a, const xy_t& b) {
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double len2 = dx * dx + dy * dy;
+    double t = 0;
+    if (len2 > 0) {
+      t = std::clamp(((p.x - a.x) * dx + (p.y - a.y) * dy) / len2, 0., 1.);
+    }
+    const double ex = p.x - (a.x + t * dx);
+    const double ey = p.y - (a.y + t * dy);
+    return ex * ex + ey * ey;
+  }
+
+  /**
+   * Douglas-Peucker simplification of @points restricted to @index,
+   * @return kept index (first and last are always kept).
+   */
+  std::vector<uint8_t> Simplify(const xy_t* points, const std::vector<uint8_t>& index, double tolerance) {
+    std::vector<bool> keep(index.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+
+    const double tolerance2 = tolerance * tolerance;
+
+    std::vector<std::pair<size_t, size_t>> stack;
+    stack.emplace_back(0, index.size() - 1);
+    while (!stack.empty()) {
+      const auto [first, last] = stack.back();
+      stack.pop_back();
+
+      double max_dist2 = 0;
+      size_t farthest = first;
+      for (size_t i = first + 1; i < last; ++i) {
+        const double dist2 = SegmentDistance2(points[index[i]], points[index[first]], points[index[last]]);
+        if (dist2 > max_dist2) {
+          max_dist2 = dist2;
+          farthest = i;
+        }
+      }
+      if (max_dist2 > tolerance2) {
+        keep[farthest] = true;
+        stack.emplace_back(first, farthest);
+        stack.emplace_back(farthest, last);
+      }
+    }
+
+    std::vector<uint8_t> result;
+    for (size_t i = 0; i < index.size(); ++i) {
+      if (keep[i]) {
+        result.push_back(index[i]);
+      }
+    }
+    result.shrink_to_fit();
+    return result;
+  }
+
+} // namespace
+
+void FlightTrail::chunk_t::Decode(GeoPoint* out) const {
+  int32_t lat = latitude;
+  int32_t lon = longitude;
+  out[0] = { lat / coord_scale, lon / coord_scale };
+  for (unsigned i = 1; i < size; ++i) {
+    lat += deltas[i - 1].latitude;
+    lon += deltas[i - 1].longitude;
+    out[i] = { lat / coord_scale, lon / coord_scale };
+  }
+}
+
+void FlightTrail::chunk_t::Simplify() {
+  GeoPoint points[CHUNK_SIZE];
+  Decode(points);
+
+  // local flat projection is enough at chunk scale
+  const double cos_lat = std::cos(points[0].latitude * M_PI / 180.);
+  xy_t xy[CHUNK_SIZE];
+  for (unsigned i = 0; i < size; ++i) {
+    xy[i] = {
+      (points[i].longitude - points[0].longitude) * cos_lat * meter_per_degree,
+      (points[i].latitude - points[0].latitude) * meter_per_degree
+    };
+  }
+
+  std::vector<uint8_t> index(size);
+  for (unsigned i = 0; i < size; ++i) {
+    index[i] = i;
+  }
+
+  // each level is simplification of previous one
+  double tolerance = LOD_TOLERANCE;
+  for (auto& level : lod) {
+    level = ::Simplify(xy, index, tolerance);
+    index = level;
+    tolerance *= 4;
+  }
+}
+
+void FlightTrail::Append(double latitude, double longitude, double time, uint8_t colour, double drift_factor) {
+  const int32_t lat = lround(latitude * coord_scale);
+  const int32_t lon = lround(longitude * coord_scale);
+  const uint8_t drift = lround(std::clamp(drift_factor, 0., 1.) * 255);
+
+  ScopeLock lock(_mutex);
+
+  bool appended = false;
+  if (!_chunks.empty() && _chunks.back()->size < CHUNK_SIZE) {
+    chunk_t& chunk = *_chunks.back();
+    const int32_t delta_lat = lat - _last_latitude;
+    const int32_t delta_lon = lon - _last_longitude;
+    const double delta_time = lround((time - chunk.time) * time_scale);
+    if (FitInt16(delta_lat) && FitInt16(delta_lon) && FitUInt16(delta_time)) {
+      chunk.deltas[chunk.size - 1] = { static_cast<int16_t>(delta_lat), static_cast<int16_t>(delta_lon) };
+      (*chunk.attrs)[chunk.size] = { static_cast<uint16_t>(delta_time), colour, drift };
+      ++chunk.size;
+      Extend(chunk.bounds, { lat / coord_scale, lon / coord_scale });
+      if (chunk.size == CHUNK_SIZE) {
+        chunk.Simplify();
+      }
+      appended = true;
+    } else if (chunk.size > 1) {
+      // too far from previous point or time gap : close this chunk.
+      chunk.Simplify();
+    }
+  }
+
+  if (!appended) {
+    if (_chunks.size() >= MAX_CHUNKS) {
+      _chunks.pop_front();
+    }
+    auto chunk = std::make_unique<chunk_t>();
+    chunk->latitude = lat;
+    chunk->longitude = lon;
+    chunk->time = time;
+    chunk->size = 1;
+    chunk->first_index = _count;
+    chunk->bounds = { lon / coord_scale, lat / coord_scale, lon / coord_scale, lat / coord_scale };
+    chunk->attrs = std::make_unique<std::array<attr_t, CHUNK_SIZE>>();
+    (*chunk->attrs)[0] = { 0, colour, drift };
+    _chunks.push_back(std::move(chunk));
+  }
+
+  _last_latitude = lat;
+  _last_longitude = lon;
+  ++_count;
+
+  // attributes are only kept for recent points, released ones are at front.
+  for (auto it = _chunks.rbegin(); it != _chunks.rend() && (*it)->attrs; ++it) {
+    if ((*it)->first_index + (*it)->size + RECENT_SIZE <= _count) {
+      (*it)->attrs.reset();
+    }
+  }
+}
+
+void FlightTrail::Clear() {
+  ScopeLock lock(_mutex);
+  _chunks.clear();
+  _count = 0;
+}
+
+size_t FlightTrail::Count() const {
+  ScopeLock lock(_mutex);
+  return _count;
+}
+
+unsigned FlightTrail::Level(double pixel_size) {
+  unsigned level = 0;
+  double tolerance = LOD_TOLERANCE;
+  while (level < LOD_LEVELS && tolerance <= pixel_size) {
+    ++level;
+    tolerance *= 4;
+  }
+  return level;
+}
+
+void FlightTrail::Get(const rectObj& bounds, double pixel_size, size_t last, std::vector<GeoPoint>& points) const {
+  const unsigned level = Level(pixel_size);
+
+  points.clear();
+
+  ScopeLock lock(_mutex);
+
+  GeoPoint decoded[CHUNK_SIZE];
+  bool in_polyline = false;
+  const chunk_t* previous = nullptr;
+
+  for (const auto& chunk : _chunks) {
+    if (chunk->first_index > last) {
+      break;
+    }
+    if (!Overlap(chunk->bounds, bounds)) {
+      if (in_polyline) {
+        // first point of hidden chunk is needed to close previous polyline
+        points.push_back({ chunk->latitude / coord_scale, chunk->longitude / coord_scale });
+        points.push_back(break_point);
+        in_polyline = false;
+      }
+      previous = chunk.get();
+      continue;
+    }
+
+    if (!in_polyline && previous) {
+      // last point of hidden chunk is needed to open this polyline
+      previous->Decode(decoded);
+      points.push_back(decoded[previous->size - 1]);
+    }
+    previous = chunk.get();
+
+    chunk->Decode(decoded);
+
+    const size_t size = std::min<size_t>(chunk->size, last - chunk->first_index + 1);
+    if (level == 0 || size < chunk->size || chunk->lod[0].empty()) {
+      points.insert(points.end(), decoded, decoded + size);
+    } else {
+      for (uint8_t i : chunk->lod[level - 1]) {
+        points.push_back(decoded[i]);
+      }
+    }
+    in_polyline = true;
+  }
+
+  if (in_polyline) {
+    points.push_back(break_point);
+  }
+}
+
+void FlightTrail::GetRecent(size_t last, size_t count, std::vector<point_t>& points) const {
+  points.clear();
+
+  ScopeLock lock(_mutex);
+
+  last = std::min(last, _count);
+  const size_t first = last - std::min({ count, last, static_cast<size_t>(RECENT_SIZE) });
+
+  GeoPoint decoded[CHUNK_SIZE];
+
+  for (const auto& chunk : _chunks) {
+    if (chunk->first_index >= last) {
+      break;
+    }
+    if (chunk->first_index + chunk->size <= first || !chunk->attrs) {
+      continue;
+    }
+
+    chunk->Decode(decoded);
+
+    const size_t begin = (first > chunk->first_index) ? first - chunk->first_index : 0;
+    const size_t end = std::min<size_t>(chunk->size, last - chunk->first_index);
+    for (size_t i = begin; i < end; ++i) {
+      const attr_t& attr = (*chunk->attrs)[i];
+      points.push_back({ decoded[i], chunk->time + attr.time / time_scale, attr.drift / 255.f, attr.colour });
+    }
+  }
+}
+
+size_t FlightTrail::MemoryUsage() const {
+  ScopeLock lock(_mutex);
+  size_t size = sizeof(*this);
+  for (const auto& chunk : _chunks) {
+    size += sizeof(chunk_t);
+    if (chunk->attrs) {
+      size += sizeof(*chunk->attrs);
+    }
+    for (const auto& level : chunk->lod) {
+      size += level.capacity();
+    }
+  }
+  return size;
+}
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <chrono>
+
+namespace {
+
+  GeoPoint TrackPoint(size_t i) {
+    // 1 fix per second, 5 minutes cruise northward then 5 minutes thermal.
+    const double t = i;
+    const double cruise = (i / 600) * 300 + std::min<size_t>(i % 600, 300);
+    const double latitude = 45. + cruise * 0.05 / 300;
+    if ((i % 600) >= 300) {
+      return { latitude + 0.0003 * std::sin(t / 5.), 6. + 0.0004 * std::cos(t / 5.) };
+    }
+    return { latitude, 6. + 0.0001 * std::sin(t / 50.) };
+  }
+
+  const rectObj world = { -180., -90., 180., 90. };
+
+  size_t PointCount(const std::vector<GeoPoint>& points) {
+    return std::count_if(points.begin(), points.end(), [](const GeoPoint& pt) {
+      return !FlightTrail::IsBreak(pt);
+    });
+  }
+}
+
+TEST_SUITE("FlightTrail") {
+
+  TEST_CASE("full resolution") {
+    FlightTrail trail;
+    const size_t count = 1000;
+    for (size_t i = 0; i < count; ++i) {
+      const GeoPoint pt = TrackPoint(i);
+      trail.Append(pt.latitude, pt.longitude, i, 7, 1.);
+    }
+    // far point, can't be delta encoded
+    trail.Append(46.5, 7.5, count, 7, 1.);
+    CHECK(trail.Count() == count + 1);
+
+    std::vector<GeoPoint> points;
+    trail.Get(world, 0., count, points);
+    REQUIRE(points.size() == count + 2);
+    CHECK(FlightTrail::IsBreak(points.back()));
+    for (size_t i = 0; i < count; ++i) {
+      const GeoPoint pt = TrackPoint(i);
+      CHECK(std::abs(points[i].latitude - pt.latitude) < 1e-6); // 1e-6 degree unit
+      CHECK(std::abs(points[i].longitude - pt.longitude) < 1e-6); // 1e-6 degree unit
+    }
+    CHECK(points[count].latitude == doctest::Approx(46.5));
+
+    // only first chunk is visible : polyline is closed by first point of next chunk.
+    const rectObj first_chunk = { 5.9, 44.9, 6.1, 45. + 0.05 * 255 / 300 + 0.0001 };
+    trail.Get(first_chunk, 0., count, points);
+    CHECK(points.size() == FlightTrail::CHUNK_SIZE + 2);
+  }
+
+  TEST_CASE("level of detail") {
+    FlightTrail trail;
+    const size_t count = 36000;
+    for (size_t i = 0; i < count; ++i) {
+      const GeoPoint pt = TrackPoint(i);
+      trail.Append(pt.latitude, pt.longitude, i, 7, 1.);
+    }
+
+    std::vector<GeoPoint> points;
+    size_t previous = count + 1;
+    for (double pixel_size : { 1., 5., 50., 500., 5000. }) {
+      trail.Get(world, pixel_size, count, points);
+      const size_t size = PointCount(points);
+      CHECK(size <= previous);
+      CHECK(size >= count / FlightTrail::CHUNK_SIZE);
+      previous = size;
+    }
+    CHECK(previous < count / 20);
+
+    // 10 hours at one fix per second
+    CHECK(trail.MemoryUsage() < 256 * 1024);
+  }
+
+  TEST_CASE("recent points") {
+    FlightTrail trail;
+    const size_t count = 3000;
+    for (size_t i = 0; i < count; ++i) {
+      const GeoPoint pt = TrackPoint(i);
+      trail.Append(pt.latitude, pt.longitude, 36000. + i * 0.5, i % 15, (i % 256) / 255.);
+    }
+
+    std::vector<FlightTrail::point_t> points;
+    trail.GetRecent(count, 1000, points);
+    REQUIRE(points.size() == 1000);
+    for (size_t n = 0; n < points.size(); ++n) {
+      const size_t i = count - 1000 + n;
+      const GeoPoint pt = TrackPoint(i);
+      CHECK(std::abs(points[n].position.latitude - pt.latitude) < 1e-6); // 1e-6 degree unit
+      CHECK(points[n].time == doctest::Approx(36000. + i * 0.5));
+      CHECK(points[n].colour == i % 15);
+      CHECK(points[n].drift_factor == doctest::Approx((i % 256) / 255.).epsilon(1e-3));
+    }
+
+    // drawing snapshot can be a few points behind
+    trail.GetRecent(count - 10, 200, points);
+    REQUIRE(points.size() == 200);
+    CHECK(points.back().time == doctest::Approx(36000. + (count - 11) * 0.5));
+
+    // attributes of older points are released
+    trail.GetRecent(count - 2000, 100, points);
+    CHECK(points.empty());
+
+    // time going backward (replay restart) : new chunk
+    trail.Append(45., 6., 100., 7, 1.);
+    trail.GetRecent(count + 1, 2, points);
+    REQUIRE(points.size() == 2);
+    CHECK(points.back().time == 100.);
+  }
+
+  TEST_CASE("bounded memory") {
+    FlightTrail trail;
+    const size_t count = FlightTrail::CHUNK_SIZE * (FlightTrail::MAX_CHUNKS + 10);
+    for (size_t i = 0; i < count; ++i) {
+      const GeoPoint pt = TrackPoint(300 + i % 300); // thermal loop
+      trail.Append(pt.latitude, pt.longitude, i, 7, 1.);
+    }
+    CHECK(trail.Count() == count);
+
+    std::vector<GeoPoint> points;
+    trail.Get(world, 0., count, points);
+    CHECK(PointCount(points) == FlightTrail::CHUNK_SIZE * FlightTrail::MAX_CHUNKS);
+  }
+
+  TEST_CASE("get benchmark" * doctest::skip()) {
+    FlightTrail trail;
+    const size_t count = 36000;
+    for (size_t i = 0; i < count; ++i) {
+      const GeoPoint pt = TrackPoint(i);
+      trail.Append(pt.latitude, pt.longitude, i, 7, 1.);
+    }
+
+    std::vector<GeoPoint> points;
+    for (double pixel_size : { 0., 20., 200. }) {
+      using clock = std::chrono::steady_clock;
+      const auto start = clock::now();
+      for (unsigned n = 0; n < 100; ++n) {
+        trail.Get(world, pixel_size, count, points);
+      }
+      const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+      MESSAGE("pixel size " << pixel_size << "m : " << PointCount(points) << " points, " << elapsed / 100 << "us");
+    }
+  }
+}
+
+#endif
@@ -91,6 +91,8 @@ void CheckGlideThroughTerrain(NMEA_INFO *Basic, DERIVED_INFO *Calculated) {
 		// need to recalculate, init with first obstacle, forget old far obstacle
 		// new bearing reference
 
+		// lock terrain once for all altitude steps instead of once per step.
+		RasterTerrain::Lock();
 		for ( newaltitude=minaltitude; newaltitude<maxaltitude; newaltitude+=50) {
 
 			fardistance_soarable = FarFinalGlideThroughTerrain( Calculated->WaypointBearing, Basic, Calculated, 
@@ -102,6 +104,7 @@ void CheckGlideThroughTerrain(NMEA_INFO *Basic, DERIVED_INFO *Calculated) {
 				oldfardist=fardistance_soarable;
 			} else break;
 		}
+		RasterTerrain::Unlock();
 
 		oldstartaltitude=newaltitude;
 		Calculated->FarObstacle_Lat = oldfarlat;
@@ -0,0 +1,500 @@
+/*
+   LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+   Released under GNU/GPL License v.2 or later
+   See CREDITS.TXT file for authors and copyrights
+
+   File: ReachabilityEngine.cpp
+*/
+
+#include "externs.h"
+#include "McReady.h"
+#include "LKInterface.h"
+#include "LKStyle.h"
+#include "NavFunctions.h"
+#include "ReachabilityEngine.h"
+#include <algorithm>
+
+extern bool CheckLandableReachableTerrainNew(NMEA_INFO *Basic, DERIVED_INFO *Calculated,
+                                             double LegToGo, double LegBearing);
+
+ReachabilityEngine ReachEngine;
+
+ReachabilityEngine::ReachabilityEngine() : _thread("Reachability") {
+}
+
+void ReachabilityEngine::Start() {
+  if (_thread.isRunning()) {
+    return;
+  }
+  {
+    ScopeLock lock(_input_mutex);
+    _pending = false;
+    _last_clock.Reset(); // first Update() always start a pass
+  }
+  _stop = false;
+  _thread.start(*this);
+  _running = true;
+}
+
+void ReachabilityEngine::Stop() {
+  if (!_thread.isRunning()) {
+    return;
+  }
+  _running = false;
+  _stop = true;
+  _abort = true;
+  _event.set();
+  _thread.join();
+}
+
+// A new pass is worth only if one of these values has changed enough.
+bool ReachabilityEngine::Outdated(const input_t& last, const input_t& next) {
+  if (last.waypoints != next.waypoints || last.mc != next.mc) {
+    return true;
+  }
+  if (std::fabs(last.calculated.NavAltitude - next.calculated.NavAltitude) > 10.
+          || std::fabs(last.calculated.EnergyHeight - next.calculated.EnergyHeight) > 10.) {
+    return true;
+  }
+  if (std::fabs(last.calculated.WindSpeed - next.calculated.WindSpeed) > 1.
+          || std::fabs(AngleLimit180(last.calculated.WindBearing - next.calculated.WindBearing)) > 10.) {
+    return true;
+  }
+  double distance;
+  DistanceBearing(last.basic.Latitude, last.basic.Longitude,
+                  next.basic.Latitude, next.basic.Longitude, &distance, nullptr);
+  return (distance > 200.);
+}
+
+void ReachabilityEngine::Update(const NMEA_INFO& Basic, const DERIVED_INFO& Calculated) {
+  if (!_running) {
+    _current = { Basic, Calculated, MACCREADY, WayPointList.size() };
+    Process(_current);
+    return;
+  }
+
+  ScopeLock lock(_input_mutex);
+  _input = { Basic, Calculated, MACCREADY, WayPointList.size() };
+  if (!_last_clock.Check(REFRESH_TIME) && !Outdated(_last, _input)) {
+    return; // last results are still good enough
+  }
+  _last = _input;
+  _last_clock.Update();
+  _pending = true;
+  _event.set();
+}
+
+void ReachabilityEngine::run() {
+  while (!_stop) {
+    _event.wait();
+    {
+      ScopeLock lock(_input_mutex);
+      if (!_pending) {
+        continue;
+      }
+      _pending = false;
+      _current = _input;
+    }
+    _abort = false;
+    if (!_stop) {
+      Process(_current);
+    }
+  }
+}
+
+bool ReachabilityEngine::Process(const input_t& input) {
+
+  struct position_t {
+    int index;
+    bool visible;
+    double latitude;
+    double longitude;
+  };
+
+  // only select waypoints with TaskData locked, glide calculation is done later
+  std::vector<position_t> near_wp, far_wp;
+  {
+    ScopeLock lock(CritSec_TaskData);
+    if (WayPointList.size() != input.waypoints || WayPointList.empty()) {
+      return false;
+    }
+
+    const int overtarg = GetOvertargetIndex();
+    for (size_t i = 0; i < WayPointList.size(); ++i) {
+      const WAYPOINT& wp = WayPointList[i];
+      const WPCALC& calc = WayPointCalc[i];
+
+      if ((((calc.AltArriv[AltArrivMode] >= 0) || wp.Visible) && (calc.IsLandable || (wp.Style == STYLE_THERMAL)))
+              || wp.InTask || (static_cast<int>(i) == overtarg)) {
+        near_wp.push_back({ static_cast<int>(i), !!wp.Visible, wp.Latitude, wp.Longitude });
+      }
+      // visible but only at a distance (limit this to 100km radius)
+      if (!wp.Visible && wp.FarVisible && calc.IsLandable) {
+        far_wp.push_back({ static_cast<int>(i), false, wp.Latitude, wp.Longitude });
+      }
+    }
+  }
+
+  // visible first, then nearest first
+  auto sort = [&](const std::vector<position_t>& positions) {
+    std::vector<candidate_t> candidates;
+    candidates.reserve(positions.size());
+    for (const position_t& pos : positions) {
+      candidate_t c = { pos.index, pos.visible, 0., 0. };
+      DistanceBearing(input.basic.Latitude, input.basic.Longitude, pos.latitude, pos.longitude,
+                      &c.distance, &c.bearing);
+      candidates.push_back(c);
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const candidate_t& a, const candidate_t& b) {
+      if (a.visible != b.visible) {
+        return a.visible;
+      }
+      return a.distance < b.distance;
+    });
+    return candidates;
+  };
+
+  bool reachable = false;
+  if (!ProcessNear(input, sort(near_wp), reachable)) {
+    return false;
+  }
+  // As in previous draw thread version, far waypoints are only checked if no landable is reachable
+  if (!reachable) {
+    if (!ProcessFar(input, sort(far_wp), reachable)) {
+      return false;
+    }
+  }
+  _landable_reachable = reachable;
+  return true;
+}
+
+bool ReachabilityEngine::ProcessNear(const input_t& input, const std::vector<candidate_t>& candidates, bool& reachable) {
+
+  NMEA_INFO basic = input.basic;
+  DERIVED_INFO calculated = input.calculated;
+
+  for (const candidate_t& c : candidates) {
+    if (_abort) {
+      return false;
+    }
+
+    ScopeLock lock(CritSec_TaskData);
+    if (WayPointList.size() != input.waypoints) {
+      return false;
+    }
+
+    const int i = c.index;
+    WAYPOINT& wp = WayPointList[i];
+    WPCALC& calc = WayPointCalc[i];
+
+    calc.Distance = c.distance;
+    calc.Bearing = c.bearing;
+    calc.GR = CalculateGlideRatio(c.distance,
+            calculated.NavAltitude - wp.Altitude - GetSafetyAltitude(i));
+
+    const double altitudeRequired = GlidePolar::MacCreadyAltitude(GetMacCready(i, 0), c.distance, c.bearing,
+            calculated.WindSpeed, calculated.WindBearing, 0, 0, true, 0)
+        + wp.Altitude + GetSafetyAltitude(i) - calculated.EnergyHeight;
+
+    calc.AltReqd[AltArrivMode] = altitudeRequired;
+    wp.AltArivalAGL = calculated.NavAltitude - altitudeRequired;
+
+    if (wp.AltArivalAGL >= 0) {
+      wp.Reachable = TRUE;
+      if (CheckLandableReachableTerrainNew(&basic, &calculated, c.distance, c.bearing)) {
+        if (ValidTaskPoint(ActiveTaskPoint) && (i != TASKINDEX)) {
+          reachable = true;
+        }
+      } else {
+        wp.Reachable = FALSE;
+      }
+    } else {
+      wp.Reachable = FALSE;
+    }
+  }
+  return true;
+}
+
+bool ReachabilityEngine::ProcessFar(const input_t& input, const std::vector<candidate_t>& candidates, bool& reachable) {
+
+  NMEA_INFO basic = input.basic;
+  DERIVED_INFO calculated = input.calculated;
+
+  for (const candidate_t& c : candidates) {
+    if (_abort) {
+      return false;
+    }
+
+    ScopeLock lock(CritSec_TaskData);
+    if (WayPointList.size() != input.waypoints) {
+      return false;
+    }
+
+    const int i = c.index;
+    WAYPOINT& wp = WayPointList[i];
+    WPCALC& calc = WayPointCalc[i];
+
+    calc.Distance = c.distance;
+    calc.Bearing = c.bearing;
+
+    if (c.distance < 100000.0) {
+      const double altitudeRequired = GlidePolar::MacCreadyAltitude(GetMacCready(i, 0), c.distance, c.bearing,
+              calculated.WindSpeed, calculated.WindBearing, 0, 0, true, 0)
+          + wp.Altitude + GetSafetyAltitude(i);
+
+      const double altitudeDifference = calculated.NavAltitude + calculated.EnergyHeight - altitudeRequired;
+      wp.AltArivalAGL = altitudeDifference;
+      calc.AltReqd[AltArrivMode] = altitudeRequired;
+
+      if (altitudeDifference >= 0) {
+        wp.Reachable = TRUE;
+        if (CheckLandableReachableTerrainNew(&basic, &calculated, c.distance, c.bearing)) {
+          reachable = true;
+        } else {
+          wp.Reachable = FALSE;
+        }
+      } else {
+        wp.Reachable = FALSE;
+      }
+    } else {
+      wp.Reachable = FALSE;
+    }
+  }
+  return true;
+}
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include "RasterTerrain.h"
+#include <cmath>
+#include <memory>
+#include <random>
+
+namespace {
+
+  // 1° x 1° synthetic terrain, 30" step, hills from 0 to 1600m
+  void OpenReachabilityTerrain(RasterMap& map) {
+    TERRAIN_INFO info = {};
+    info.Left = 6.;
+    info.Right = 7.;
+    info.Top = 46.;
+    info.Bottom = 45.;
+    info.StepSize = 1. / 120.;
+    info.Columns = 121;
+    info.Rows = 121;
+
+    std::unique_ptr<short[]> data(new short[info.Columns * info.Rows]);
+    for (unsigned y = 0; y < info.Rows; ++y) {
+      for (unsigned x = 0; x < info.Columns; ++x) {
+        data[y * info.Columns + x] = 800 + 800 * std::sin(x / 7.) * std::cos(y / 5.);
+      }
+    }
+    map.Open(info, std::move(data));
+  }
+
+  // MapWindow::LKCalculateWaypointReachable() full scan before ReachabilityEngine, used as reference.
+  bool ReferenceWaypointReachable(NMEA_INFO& DrawInfo, DERIVED_INFO& DerivedDrawInfo) {
+    unsigned int i;
+    double waypointDistance, waypointBearing,altitudeRequired,altitudeDifference;
+
+    bool LandableReachable = false;
+
+    LockTaskData();
+
+    const unsigned int scanstart = 0;
+    const unsigned int scanend = WayPointList.size();
+
+    int overtarg=GetOvertargetIndex();
+    if (overtarg<0) overtarg=999999;
+
+    for(i=scanstart;i<scanend;i++) {
+      if ( ( ((WayPointCalc[i].AltArriv[AltArrivMode] >=0)||(WayPointList[i].Visible)) && (WayPointCalc[i].IsLandable || (WayPointList[i].Style==STYLE_THERMAL)))
+          || WayPointList[i].InTask || (i==(unsigned int)overtarg) ) {
+
+        DistanceBearing(DrawInfo.Latitude, DrawInfo.Longitude, WayPointList[i].Latitude, WayPointList[i].Longitude,
+                        &waypointDistance, &waypointBearing);
+
+        WayPointCalc[i].Distance=waypointDistance;
+        WayPointCalc[i].Bearing=waypointBearing;
+
+        WayPointCalc[i].GR = CalculateGlideRatio(waypointDistance,
+                 DerivedDrawInfo.NavAltitude - WayPointList[i].Altitude - GetSafetyAltitude(i));
+
+        altitudeRequired = GlidePolar::MacCreadyAltitude (GetMacCready(i,0), waypointDistance, waypointBearing,
+                                  DerivedDrawInfo.WindSpeed, DerivedDrawInfo.WindBearing, 0,0,true,0)
+                  + WayPointList[i].Altitude + GetSafetyAltitude(i) - DerivedDrawInfo.EnergyHeight;
+
+        WayPointCalc[i].AltReqd[AltArrivMode] = altitudeRequired;
+        WayPointList[i].AltArivalAGL = DerivedDrawInfo.NavAltitude - altitudeRequired;
+
+        if(WayPointList[i].AltArivalAGL >=0){
+          WayPointList[i].Reachable = TRUE;
+          if (CheckLandableReachableTerrainNew(&DrawInfo, &DerivedDrawInfo, waypointDistance, waypointBearing)) {
+            if(ValidTaskPoint(ActiveTaskPoint) && (i != (unsigned)TASKINDEX)) {
+              LandableReachable = true;
+            }
+          } else {
+            WayPointList[i].Reachable = FALSE;
+          }
+        } else {
+          WayPointList[i].Reachable = FALSE;
+        }
+      }
+    }
+
+    if (!LandableReachable)
+    for(i=scanstart;i<scanend;i++) {
+      if(!WayPointList[i].Visible && WayPointList[i].FarVisible)  {
+        if(  WayPointCalc[i].IsLandable ) {
+          DistanceBearing(DrawInfo.Latitude, DrawInfo.Longitude, WayPointList[i].Latitude, WayPointList[i].Longitude,
+                          &waypointDistance, &waypointBearing);
+
+          WayPointCalc[i].Distance=waypointDistance;
+          WayPointCalc[i].Bearing=waypointBearing;
+
+          if (waypointDistance<100000.0) {
+            altitudeRequired = GlidePolar::MacCreadyAltitude (GetMacCready(i,0), waypointDistance, waypointBearing,
+                        DerivedDrawInfo.WindSpeed, DerivedDrawInfo.WindBearing, 0,0,true,0)
+                        + WayPointList[i].Altitude + GetSafetyAltitude(i);
+
+            altitudeDifference = DerivedDrawInfo.NavAltitude + DerivedDrawInfo.EnergyHeight - altitudeRequired;
+            WayPointList[i].AltArivalAGL = altitudeDifference;
+
+            WayPointCalc[i].AltReqd[AltArrivMode] = altitudeRequired;
+
+            if(altitudeDifference >=0){
+              WayPointList[i].Reachable = TRUE;
+              if (CheckLandableReachableTerrainNew(&DrawInfo, &DerivedDrawInfo, waypointDistance, waypointBearing)) {
+                LandableReachable = true;
+              } else
+                WayPointList[i].Reachable = FALSE;
+            } else {
+              WayPointList[i].Reachable = FALSE;
+            }
+          } else {
+            WayPointList[i].Reachable = FALSE;
+          }
+        }
+      }
+    }
+
+    UnlockTaskData();
+    return LandableReachable;
+  }
+}
+
+TEST_SUITE("ReachabilityEngine") {
+
+  TEST_CASE("pass match serial reachability") {
+    double polar_v[3] = { 100., 130., 180. };
+    double polar_w[3] = { -0.69, -1.10, -2.07 };
+    double weights[2] = { 361., 0. };
+    REQUIRE(PolarWinPilot2XCSoar(polar_v, polar_w, weights));
+    BUGS = 1.; // tests run before globals initialisation
+    GlidePolar::SetBallast();
+
+    RasterMap map;
+    OpenReachabilityTerrain(map);
+    REQUIRE(map.isMapLoaded());
+
+    RasterMap* previous_map;
+    {
+      ScopeLock lock(RasterTerrain::mutex);
+      previous_map = RasterTerrain::TerrainMap;
+      RasterTerrain::TerrainMap = &map;
+    }
+
+    // waypoints around current position, some far visible landables up to 70km.
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> near_lat(45.3, 45.7), near_lon(6.3, 6.7);
+    std::uniform_real_distribution<double> far_lat(45.02, 45.98), far_lon(6.02, 6.98);
+    std::uniform_real_distribution<double> altitude(100., 1200.);
+
+    std::vector<WAYPOINT> waypoints(80);
+    std::vector<WPCALC> calcs(waypoints.size());
+    for (size_t i = 0; i < waypoints.size(); ++i) {
+      WAYPOINT& wp = waypoints[i];
+      WPCALC& calc = calcs[i];
+      wp = {};
+      calc = {};
+      wp.Visible = (i % 3 != 0);
+      wp.FarVisible = !wp.Visible && (i % 2 == 0);
+      wp.Latitude = wp.Visible ? near_lat(gen) : far_lat(gen);
+      wp.Longitude = wp.Visible ? near_lon(gen) : far_lon(gen);
+      wp.Altitude = altitude(gen);
+      wp.Style = (i % 7 == 0) ? STYLE_THERMAL : 0;
+      calc.IsLandable = (i % 4 != 3);
+      calc.AltArriv[AltArrivMode] = (i % 5 == 0) ? -100. : 100.;
+    }
+
+    NMEA_INFO basic = {};
+    basic.Latitude = 45.5;
+    basic.Longitude = 6.5;
+
+    const double previous_mc = MACCREADY;
+    MACCREADY = 1.;
+
+    std::vector<WAYPOINT> previous_wp;
+    std::vector<WPCALC> previous_calc;
+    {
+      ScopeLock lock(CritSec_TaskData);
+      std::swap(WayPointList, previous_wp);
+      std::swap(WayPointCalc, previous_calc);
+    }
+
+    ReachabilityEngine engine;
+
+    for (double nav_altitude : { 1000., 1800., 2600. }) {
+      CAPTURE(nav_altitude);
+
+      DERIVED_INFO calculated = {};
+      calculated.NavAltitude = nav_altitude;
+      calculated.EnergyHeight = 20.;
+      calculated.WindSpeed = 8.;
+      calculated.WindBearing = 250.;
+
+      std::vector<WAYPOINT> reference_wp;
+      std::vector<WPCALC> reference_calc;
+      bool reference_reachable;
+      {
+        ScopeLock lock(CritSec_TaskData);
+        WayPointList = waypoints;
+        WayPointCalc = calcs;
+        reference_reachable = ReferenceWaypointReachable(basic, calculated);
+        reference_wp = WayPointList;
+        reference_calc = WayPointCalc;
+
+        WayPointList = waypoints;
+        WayPointCalc = calcs;
+      }
+
+      engine.Update(basic, calculated); // not started, full pass on this thread
+
+      ScopeLock lock(CritSec_TaskData);
+      CHECK(engine.LandableReachable() == reference_reachable);
+
+      for (size_t i = 0; i < waypoints.size(); ++i) {
+        CAPTURE(i);
+        CHECK(WayPointCalc[i].Distance == reference_calc[i].Distance);
+        CHECK(WayPointCalc[i].Bearing == reference_calc[i].Bearing);
+        CHECK(WayPointCalc[i].GR == reference_calc[i].GR);
+        CHECK(WayPointCalc[i].AltReqd[AltArrivMode] == reference_calc[i].AltReqd[AltArrivMode]);
+        CHECK(WayPointList[i].AltArivalAGL == reference_wp[i].AltArivalAGL);
+        CHECK(WayPointList[i].Reachable == reference_wp[i].Reachable);
+      }
+    }
+
+    MACCREADY = previous_mc;
+    {
+      ScopeLock lock(CritSec_TaskData);
+      std::swap(WayPointList, previous_wp);
+      std::swap(WayPointCalc, previous_calc);
+    }
+    {
+      ScopeLock lock(RasterTerrain::mutex);
+      RasterTerrain::TerrainMap = previous_map;
+    }
+  }
+}
+
+#endif
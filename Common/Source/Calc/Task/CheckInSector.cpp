@@ -29,7 +29,7 @@ void AdvanceToNext(NMEA_INFO* Basic, DERIVED_INFO* Calculated) {
 
 bool IsCircle(const size_t& idx) {
   assert(gTaskType == TSK_GP);
-  ScopeLock lock(CritSec_FlightData);
+  StatScopeLock lock(CritSec_FlightData);
   if (idx > 0 && ValidTaskPointFast(idx + 1)) { 
     // Not Start or Finish
     switch (Task[idx].AATType) {
@@ -7,23 +7,78 @@
 */
 
 #include "externs.h"
+#include "McReady.h"
 #include "NavFunctions.h"
+#include "RasterTerrain.h"
+#include "OS/Clock.hpp"
+#include <vector>
+
+namespace {
+
+#if TESTBENCH
+// footprint cost, logged every STAT_COUNT update
+struct footprint_stat_t {
+  static constexpr unsigned STAT_COUNT = 60;
+
+  void Add(size_t count, unsigned us) {
+    total_us += us;
+    max_us = std::max(max_us, us);
+    if (++updates >= STAT_COUNT) {
+      StartupStore(_T(". GlideFootPrint : %u bearings, avg %u us, max %u us" NEWLINE),
+                   static_cast<unsigned>(count), total_us / updates, max_us);
+      *this = {};
+    }
+  }
+
+  unsigned updates = 0;
+  unsigned total_us = 0;
+  unsigned max_us = 0;
+};
+
+footprint_stat_t footprint_stat;
+#endif
+
+} // namespace
 
 void FillGlideFootPrint(double latitude, double longitude, double altitude, DERIVED_INFO *Calculated, double max_range,  pointObj* out, size_t count) {
 
-  const pointObj* first_out = out; // this is first polygon point (OpenGL or not), used for close polygon.
+#if TESTBENCH
+  const unsigned start_us = MonotonicClockUS();
+#endif
+
+  // GlidePolar::MacCreadyAltitude is not thread safe, compute glide ratio of all bearings first.
+  std::vector<double> irange(count);
   for (size_t i = 0; i < count; ++i) {
+    const double bearing = (i*360.0)/count;
+    irange[i] = GlidePolar::MacCreadyAltitude(MACCREADY, 1.0, bearing,
+                                              Calculated->WindSpeed, Calculated->WindBearing,
+                                              0, 0, true, 0);
+  }
+
+  // lock terrain once for all bearings instead of once per bearing,
+  // terrain tiles are then shared by all workers.
+  ScopeLock lock(RasterTerrain::mutex);
+
+  const int size = count;
+#if defined(_OPENMP)
+  #pragma omp parallel for
+#endif
+  for (int i = 0; i < size; ++i) {
     const double bearing = (i*360.0)/count;
     double lat, lon;
     bool out_of_range = false;
-    const double distance = FinalGlideThroughTerrain(bearing, latitude, longitude, altitude,
-                                        Calculated, &lat, &lon, max_range, &out_of_range, nullptr );
+    const double distance = GlideRangeThroughTerrain(irange[i], bearing, latitude, longitude, altitude,
+                                                     &lat, &lon, max_range, &out_of_range, nullptr);
     if (out_of_range) {
       FindLatitudeLongitude(latitude, longitude, bearing, distance, &lat, &lon);
     }
-    *(out++) = (pointObj){lon, lat};
+    out[i] = (pointObj){lon, lat};
   }
-  (*out) = (*first_out); // close polygon
+  out[count] = out[0]; // close polygon
+
+#if TESTBENCH
+  footprint_stat.Add(count, MonotonicClockUS() - start_us);
+#endif
 }
 
 
@@ -130,3 +185,104 @@ void TerrainFootprint(NMEA_INFO *Basic, DERIVED_INFO *Calculated) {
   UnlockTaskData();
 }
 
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <cmath>
+#include <memory>
+
+namespace {
+
+  // 1° x 1° synthetic terrain, 30" step, hills from 0 to 1600m
+  void OpenFootprintTerrain(RasterMap& map) {
+    TERRAIN_INFO info = {};
+    info.Left = 6.;
+    info.Right = 7.;
+    info.Top = 46.;
+    info.Bottom = 45.;
+    info.StepSize = 1. / 120.;
+    info.Columns = 121;
+    info.Rows = 121;
+
+    std::unique_ptr<short[]> data(new short[info.Columns * info.Rows]);
+    for (unsigned y = 0; y < info.Rows; ++y) {
+      for (unsigned x = 0; x < info.Columns; ++x) {
+        data[y * info.Columns + x] = 800 + 800 * std::sin(x / 7.) * std::cos(y / 5.);
+      }
+    }
+    map.Open(info, std::move(data));
+  }
+
+  // FillGlideFootPrint before parallel bearings, used as reference.
+  void ReferenceGlideFootPrint(double latitude, double longitude, double altitude, DERIVED_INFO *Calculated,
+                               double max_range, pointObj* out, size_t count) {
+    const pointObj* first_out = out;
+    for (size_t i = 0; i < count; ++i) {
+      const double bearing = (i*360.0)/count;
+      double lat, lon;
+      bool out_of_range = false;
+      const double distance = FinalGlideThroughTerrain(bearing, latitude, longitude, altitude,
+                                          Calculated, &lat, &lon, max_range, &out_of_range, nullptr );
+      if (out_of_range) {
+        FindLatitudeLongitude(latitude, longitude, bearing, distance, &lat, &lon);
+      }
+      *(out++) = (pointObj){lon, lat};
+    }
+    (*out) = (*first_out);
+  }
+}
+
+TEST_SUITE("Terrain footprint") {
+
+  TEST_CASE("parallel bearings match serial footprint") {
+    double polar_v[3] = { 100., 130., 180. };
+    double polar_w[3] = { -0.69, -1.10, -2.07 };
+    double weights[2] = { 361., 0. };
+    REQUIRE(PolarWinPilot2XCSoar(polar_v, polar_w, weights));
+    BUGS = 1.; // tests run before globals initialisation
+    GlidePolar::SetBallast();
+
+    RasterMap map;
+    OpenFootprintTerrain(map);
+    REQUIRE(map.isMapLoaded());
+
+    RasterMap* previous_map;
+    {
+      ScopeLock lock(RasterTerrain::mutex);
+      previous_map = RasterTerrain::TerrainMap;
+      RasterTerrain::TerrainMap = &map;
+    }
+
+    const double previous_mc = MACCREADY;
+    DERIVED_INFO calculated = {};
+    calculated.WindSpeed = 8.;
+    calculated.WindBearing = 250.;
+
+    for (double mc : { 0., 1.5 }) {
+      MACCREADY = mc;
+      for (double altitude : { 1200., 1800., 2600. }) {
+        CAPTURE(mc);
+        CAPTURE(altitude);
+
+        pointObj reference[NUMTERRAINSWEEPS + 1];
+        pointObj result[NUMTERRAINSWEEPS + 1];
+        ReferenceGlideFootPrint(45.5, 6.5, altitude, &calculated, 30000., reference, NUMTERRAINSWEEPS);
+        FillGlideFootPrint(45.5, 6.5, altitude, &calculated, 30000., result, NUMTERRAINSWEEPS);
+
+        for (size_t i = 0; i <= NUMTERRAINSWEEPS; ++i) {
+          CAPTURE(i);
+          CHECK(result[i].x == reference[i].x);
+          CHECK(result[i].y == reference[i].y);
+        }
+      }
+    }
+
+    MACCREADY = previous_mc;
+    {
+      ScopeLock lock(RasterTerrain::mutex);
+      RasterTerrain::TerrainMap = previous_map;
+    }
+  }
+}
+
+#endif
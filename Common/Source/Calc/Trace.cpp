@@ -19,7 +19,7 @@
  */
 CTrace::CTrace(unsigned maxSize, unsigned timeLimit, unsigned algorithm):
   _maxSize(maxSize), _timeLimit(timeLimit), _algorithm(algorithm),
-  _valid(true), _size(0), _analyzedPointCount(0), _front(0), _back(0)
+  _valid(true), _size(0), _analyzedPointCount(0), _freeSlot(0), _front(0), _back(0)
 {
 }
 
@@ -41,19 +41,140 @@ void CTrace::Clear()
   CPoint *point = _front;
   while(point) {
     CPoint *next = point->_next;
-    delete point;
+    Release(point);
     point = next;
   }
 
   _valid = true;
   _size = 0;
   _analyzedPointCount = 0;
-  _compressionCostSet.clear();
+  _compressionCostHeap.clear();
   _front = 0;
   _back = 0;
 }
 
 
+/** 
+ * @brief Gets storage for a new point
+ * 
+ * @return Uninitialized memory for one CPoint
+ */
+void *CTrace::Allocate()
+{
+  if(!_freeSlot) {
+    // all points are used, add a new chunk
+    _chunks.emplace_back(new CPointSlot[POINT_CHUNK_SIZE]);
+    CPointSlot *chunk = _chunks.back().get();
+    for(unsigned i=0; i<POINT_CHUNK_SIZE; i++)
+      chunk[i].next = (i + 1 < POINT_CHUNK_SIZE) ? &chunk[i + 1] : 0;
+    _freeSlot = chunk;
+  }
+  CPointSlot *slot = _freeSlot;
+  _freeSlot = slot->next;
+  return slot->storage;
+}
+
+
+/** 
+ * @brief Destroys a point and gives back its storage
+ * 
+ * @param point Point to release
+ */
+void CTrace::Release(CPoint *point)
+{
+  point->~CPoint();
+  CPointSlot *slot = reinterpret_cast<CPointSlot *>(point);
+  slot->next = _freeSlot;
+  _freeSlot = slot;
+}
+
+
+/** 
+ * @brief Returns memory used by the trace
+ */
+size_t CTrace::MemoryUsage() const
+{
+  return sizeof(*this)
+    + _chunks.size() * POINT_CHUNK_SIZE * sizeof(CPointSlot)
+    + _chunks.capacity() * sizeof(CPointChunkArray::value_type)
+    + _compressionCostHeap.capacity() * sizeof(CPointCostHeap::value_type);
+}
+
+
+/** 
+ * @brief Adds a point to the compression heap
+ */
+void CTrace::HeapInsert(CPoint *point)
+{
+  point->_heapIndex = _compressionCostHeap.size();
+  _compressionCostHeap.push_back(point);
+  HeapSiftUp(point->_heapIndex);
+}
+
+
+/** 
+ * @brief Removes a point from the compression heap
+ */
+void CTrace::HeapErase(CPoint *point)
+{
+  const unsigned index = point->_heapIndex;
+  CPoint *last = _compressionCostHeap.back();
+  _compressionCostHeap.pop_back();
+  point->_heapIndex = CPoint::NOT_IN_HEAP;
+  
+  if(last != point) {
+    // move the last point to the free place and restore heap order
+    _compressionCostHeap[index] = last;
+    last->_heapIndex = index;
+    HeapSiftUp(index);
+    HeapSiftDown(last->_heapIndex);
+  }
+}
+
+
+/** 
+ * @brief Moves a point toward the heap top while it is less important than its parent
+ */
+void CTrace::HeapSiftUp(unsigned index)
+{
+  CPoint *point = _compressionCostHeap[index];
+  while(index > 0) {
+    const unsigned parent = (index - 1) / 2;
+    if(!(*point < *_compressionCostHeap[parent]))
+      break;
+    _compressionCostHeap[index] = _compressionCostHeap[parent];
+    _compressionCostHeap[index]->_heapIndex = index;
+    index = parent;
+  }
+  _compressionCostHeap[index] = point;
+  point->_heapIndex = index;
+}
+
+
+/** 
+ * @brief Moves a point toward the heap bottom while it is more important than its children
+ */
+void CTrace::HeapSiftDown(unsigned index)
+{
+  const unsigned size = _compressionCostHeap.size();
+  CPoint *point = _compressionCostHeap[index];
+  for(;;) {
+    unsigned child = 2 * index + 1;
+    if(child >= size)
+      break;
+    if(child + 1 < size && *_compressionCostHeap[child + 1] < *_compressionCostHeap[child])
+      child++;
+    if(!(*_compressionCostHeap[child] < *point))
+      break;
+    _compressionCostHeap[index] = _compressionCostHeap[child];
+    _compressionCostHeap[index]->_heapIndex = index;
+    index = child;
+  }
+  _compressionCostHeap[index] = point;
+  point->_heapIndex = index;
+}
+
+
 /** 
  * @brief Adds a new point to a trace
  * 
@@ -65,7 +186,7 @@ void CTrace::Push(CPoint *point)
   _analyzedPointCount++;
   
   if(!_valid) {
-    delete point;
+    Release(point);
     return;
   }
   
@@ -79,13 +200,12 @@ void CTrace::Push(CPoint *point)
     // limit the trace to required time period
     while(_back && _front && (unsigned)_back->_gps->TimeDelta(*_front->_gps) > _timeLimit) {
       CPoint *next = _front->_next;
-      delete _front;
+      Release(_front);
       _size--;
       
       if(next != _back) {
-        // _back and _front are not stored in a _compressionCostSet so skip below actions when next == _back
-        CPointCostSet::iterator nextIt = _compressionCostSet.find(next);
-        if(nextIt == _compressionCostSet.end()) {
+        // _back and _front are not stored in a _compressionCostHeap so skip below actions when next == _back
+        if(!HeapContains(next)) {
 #ifndef TEST_CONTEST
           if (warnings>=0) {
             StartupStore(_T("%s:%u - ERROR: next not found!!\n"), _T(__FILE__), __LINE__);
@@ -95,7 +215,7 @@ void CTrace::Push(CPoint *point)
           _valid = false;
         }
         else {
-          _compressionCostSet.erase(nextIt);
+          HeapErase(next);
         }
       }
       
@@ -116,7 +236,7 @@ void CTrace::Push(CPoint *point)
     return;
   
   // add previous point to compression pool
-  _compressionCostSet.insert(_back->_prev);
+  HeapInsert(_back->_prev);
 }
 
 
@@ -139,18 +259,17 @@ void CTrace::Compress(unsigned maxSize /* = 0 */)
   
   while(_size > _maxSize) {
     // get the worst point
-    CPointCostSet::iterator worstIt = _compressionCostSet.begin();
-    if(worstIt == _compressionCostSet.end()) {
+    if(_compressionCostHeap.empty()) {
 #ifndef TEST_CONTEST
-      StartupStore(_T("%s:%u - ERROR: _compressionCostSet is empty !!\n"), _T(__FILE__), __LINE__);
+      StartupStore(_T("%s:%u - ERROR: _compressionCostHeap is empty !!\n"), _T(__FILE__), __LINE__);
 #endif
       BUGSTOP_LKASSERT(0);
 		  return;
     }
-    CPoint *worst = *worstIt;
+    CPoint *worst = _compressionCostHeap.front();
     
     // remove the worst point from optimization pool
-    _compressionCostSet.erase(worstIt);
+    HeapErase(worst);
     
     // find time neighbors
     CPoint *preWorst = worst->_prev;
@@ -160,8 +279,7 @@ void CTrace::Compress(unsigned maxSize /* = 0 */)
     CPoint *prepreWorst = preWorst->_prev;
     if(prepreWorst) { 
       // remove previous neighbor
-      CPointCostSet::iterator preWorstIt = _compressionCostSet.find(preWorst);
-      if(preWorstIt == _compressionCostSet.end()) {
+      if(!HeapContains(preWorst)) {
 #ifndef TEST_CONTEST
 	if (warnings>=0) {
           StartupStore(_T("%s:%u - ERROR: preWorst not found!!\n"), _T(__FILE__), __LINE__);
@@ -170,15 +288,14 @@ void CTrace::Compress(unsigned maxSize /* = 0 */)
 #endif
         return;
       }
-      _compressionCostSet.erase(preWorstIt);
+      HeapErase(preWorst);
     }
     
     // find next time neighbor
     CPoint *postpostWorst = postWorst->_next;
     if(postpostWorst) { 
       // remove next neighbor
-      CPointCostSet::iterator postWorstIt = _compressionCostSet.find(postWorst);
-      if(postWorstIt == _compressionCostSet.end()) {
+      if(!HeapContains(postWorst)) {
 #ifndef TEST_CONTEST
 	if (warnings>=0) {
           StartupStore(_T("%s:%u - ERROR: postWorst not found!!\n"), _T(__FILE__), __LINE__);
@@ -187,25 +304,130 @@ void CTrace::Compress(unsigned maxSize /* = 0 */)
 #endif
         return;
       }
-      _compressionCostSet.erase(postWorstIt);
+      HeapErase(postWorst);
     }
     
     // reduce and delete current point
     worst->Reduce();
-    delete worst;
+    Release(worst);
     _size--;
     
     if(prepreWorst) { 
       // insert next neighbor
       preWorst->AssesCost();
-      _compressionCostSet.insert(preWorst);
+      HeapInsert(preWorst);
     }
     if(postpostWorst) { 
       // insert previous neighbor
       postWorst->AssesCost();
-      _compressionCostSet.insert(postWorst);
+      HeapInsert(postWorst);
+    }
+  }
+}
+
+
+
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include "ContestMgr.h"
+#include <chrono>
+#include <fstream>
+#include <string>
+
+namespace {
+
+  /**
+   * @brief Reads B records of an IGC file
+   */
+  std::vector<CPointGPS> LoadIGC(const char *path)
+  {
+    std::vector<CPointGPS> fixes;
+    std::ifstream file(path);
+    std::string line;
+    while(std::getline(file, line)) {
+      // B HHMMSS DDMMmmmN DDDMMmmmE V PPPPP GGGGG
+      if(line.size() < 35 || line[0] != 'B')
+        continue;
+      unsigned time = std::stoi(line.substr(1, 2)) * 3600 + std::stoi(line.substr(3, 2)) * 60 + std::stoi(line.substr(5, 2));
+      double lat = std::stoi(line.substr(7, 2)) + std::stoi(line.substr(9, 5)) / 60000.0;
+      if(line[14] == 'S')
+        lat = -lat;
+      double lon = std::stoi(line.substr(15, 3)) + std::stoi(line.substr(18, 5)) / 60000.0;
+      if(line[23] == 'W')
+        lon = -lon;
+      fixes.emplace_back(time, lat, lon, std::stoi(line.substr(30, 5)));
     }
+    return fixes;
   }
+
 }
 
+TEST_SUITE("Trace") {
+
+  TEST_CASE("compression") {
+    CTrace trace(10, 0, CTrace::ALGORITHM_DISTANCE | CTrace::ALGORITHM_TIME_DELTA);
+    for(unsigned i=0; i<1000; i++) {
+      // zig-zag path
+      trace.Push(make_CPointGPSSmart(36000 + i, 45.0 + i * 0.0001, 6.0 + ((i / 50) % 2 ? 50 - i % 50 : i % 50) * 0.0001, 1000));
+      trace.Compress();
+      REQUIRE(trace.Size() <= 10);
+    }
+    CHECK(trace.Size() == 10);
+    CHECK(trace.AnalyzedPointCount() == 1000);
+    CHECK(trace.Front()->GPS().Time() == 36000);
+    CHECK(trace.Back()->GPS().Time() == 36999);
+
+    // points are still sorted in time
+    for(const CTrace::CPoint *point = trace.Front(); point->Next(); point = point->Next()) {
+      CHECK(point->GPS().Time() < point->Next()->GPS().Time());
+    }
+
+    // storage is reused once trace is full
+    const size_t memory = trace.MemoryUsage();
+    for(unsigned i=1000; i<2000; i++) {
+      trace.Push(make_CPointGPSSmart(36000 + i, 45.0 + i * 0.0001, 6.0, 1000));
+      trace.Compress();
+    }
+    CHECK(trace.MemoryUsage() == memory);
+  }
+
+  TEST_CASE("replay benchmark" * doctest::skip()) {
+    const std::vector<CPointGPS> flight = LoadIGC("Common/Distribution/LK8000/_Logger/DEMO.IGC");
+    REQUIRE(!flight.empty());
 
+    using clock = std::chrono::steady_clock;
+
+    // main trace only
+    CTrace trace(100, 0, CTrace::ALGORITHM_DISTANCE | CTrace::ALGORITHM_TIME_DELTA);
+    size_t peak_memory = 0;
+    auto t0 = clock::now();
+    for(const CPointGPS &fix : flight) {
+      trace.Push(std::make_shared<CPointGPS>(fix));
+      trace.Compress();
+      peak_memory = std::max(peak_memory, trace.MemoryUsage());
+    }
+    auto t1 = clock::now();
+
+    // full contest manager
+    const int rule = AdditionalContestRule;
+    AdditionalContestRule = static_cast<int>(CContestMgr::ContestRule::OLC);
+    CContestMgr::Instance().Reset(100);
+    auto t2 = clock::now();
+    for(const CPointGPS &fix : flight) {
+      CContestMgr::Instance().Add(fix.Time(), fix.Latitude(), fix.Longitude(), fix.Altitude());
+    }
+    auto t3 = clock::now();
+    CContestMgr::Instance().Reset(100);
+    AdditionalContestRule = rule;
+
+    auto ns_per_fix = [&](clock::duration d) {
+      return std::chrono::duration<double, std::nano>(d).count() / flight.size();
+    };
+    MESSAGE(flight.size(), " fixes");
+    MESSAGE("CTrace : ", ns_per_fix(t1 - t0), " ns/fix, peak memory ", peak_memory, " bytes");
+    MESSAGE("CContestMgr::Add : ", ns_per_fix(t3 - t2), " ns/fix");
+  }
+}
+
+#endif
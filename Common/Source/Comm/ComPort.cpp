@@ -22,7 +22,6 @@
 #include <sstream>
 
 ComPort::ComPort(int idx, const tstring& sName) : StopEvt(false), devIdx(idx), sPortName(sName) {
-    pLastNmea = std::begin(_NmeaString);
 }
 
 ComPort::~ComPort() {
@@ -150,35 +149,20 @@ void ComPort::run() {
     StartupStore(_T(". ComPort %u ReadThread : terminated"), (unsigned)(GetPortIndex() + 1));
 }
 
-void ComPort::ProcessChar(char c) {
+void ComPort::ProcessData(char* data, size_t size) {
     if (ComCheck_ActivePort>=0 && GetPortIndex()==(unsigned)ComCheck_ActivePort) {
-        ComCheck_AddChar(c);
+        std::for_each(data, data + size, ComCheck_AddChar);
     }
 
-    if (devParseStream(devIdx, &c, 1, &GPS_INFO)) {
+    if (devParseStream(devIdx, data, size, &GPS_INFO)) {
         // if this port is used for stream device, leave immediately.
         // don't return mayby more devices on one Port (shared Port)
     }
 
-    // last char need to be reserved for '\0' for avoid buffer overflow
-    // in theory this should never happen because NMEA sentence can't have more than 82 char and _NmeaString size is 160.
-    if (pLastNmea >= std::begin(_NmeaString) && (pLastNmea+1) < std::end(_NmeaString)) {
-
-        if (c == '\n' || c == '\r') {
-            // abcd\n , now closing the line also with \r
-            *(pLastNmea++) = _T('\n');
-            *(pLastNmea) = _T('\0'); // terminate string.
-            // process only meaningful sentences, avoid processing a single \n \r etc.
-            if (std::distance(std::begin(_NmeaString), pLastNmea) > 5) {
-                devParseNMEA(devIdx, _NmeaString, &GPS_INFO);
-            }
-        } else {
-            *(pLastNmea++) = c;
-            return;
-        }
-    }
-    // overflow, so reset buffer
-    pLastNmea = std::begin(_NmeaString);
+    // in theory overflow should never happen because NMEA sentence can't have more than 82 char and line buffer size is 160.
+    _NmeaSplitter.Append(data, size, [&](TCHAR* sentence) {
+        devParseNMEA(devIdx, sentence, &GPS_INFO);
+    });
 }
 
 void ComPort::AddStatRx(unsigned dwBytes) {
@@ -230,3 +214,106 @@ void ComPort::StatusMessage(MsgType_t type, const TCHAR *caption, const TCHAR *f
         DoStatusMessage(tmp);
     }
 }
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <chrono>
+#include <vector>
+
+namespace {
+
+  // sentences recorded from a Flarm device connected to a GPS.
+  constexpr char nmea_record[] =
+      "$GPRMC,102347.00,A,4551.69462,N,00610.66810,E,42.353,245.67,150721,,,A*5B\r\n"
+      "$GPGGA,102347.00,4551.69462,N,00610.66810,E,1,09,0.98,1856.3,M,47.6,M,,*6D\r\n"
+      "$PGRMZ,6095,F,2*00\r\n"
+      "$PFLAU,2,1,2,1,0,,0,,,*4F\r\n"
+      "$PFLAA,0,-1234,567,89,2,DD8F12,180,,30,-1.4,1*5A\r\n"
+      "$GPGSA,A,3,02,05,12,13,15,18,20,25,29,,,,1.75,0.98,1.45*0D\r\n"
+      "$LXWP0,Y,119.4,1717.6,0.02,0.02,0.02,0.02,0.02,0.02,,000,107.2*5B\r\n";
+
+  template<size_t size>
+  std::vector<std::string> Split(NmeaLineSplitter<char, size>& splitter, const char* data, size_t length, size_t chunk) {
+    std::vector<std::string> lines;
+    for (size_t i = 0; i < length; i += chunk) {
+      splitter.Append(data + i, std::min(chunk, length - i), [&](char* line) {
+        lines.emplace_back(line);
+      });
+    }
+    return lines;
+  }
+}
+
+TEST_SUITE("ComPort") {
+
+  TEST_CASE("nmea line splitter") {
+
+    SUBCASE("chunk size don't change result") {
+      NmeaLineSplitter<char, MAX_NMEA_LEN> ref;
+      const auto expected = Split(ref, nmea_record, strlen(nmea_record), 1);
+      REQUIRE(expected.size() == 7);
+      CHECK(expected[2] == "$PGRMZ,6095,F,2*00\n");
+
+      for (size_t chunk : { 2, 7, 64, 1024 }) {
+        NmeaLineSplitter<char, MAX_NMEA_LEN> splitter;
+        CHECK(Split(splitter, nmea_record, strlen(nmea_record), chunk) == expected);
+      }
+    }
+
+    SUBCASE("short lines are ignored") {
+      NmeaLineSplitter<char, MAX_NMEA_LEN> splitter;
+      const char data[] = "\r\n$A*0\n\r\n$ABCD\r\n";
+      const auto lines = Split(splitter, data, strlen(data), 3);
+      REQUIRE(lines.size() == 1);
+      CHECK(lines[0] == "$ABCD\n");
+    }
+
+    SUBCASE("overflow") {
+      // same as byte by byte processing : on overflow buffer is reset and overflowing byte is dropped.
+      NmeaLineSplitter<char, 8> splitter;
+      const char data[] = "0123456789ABCD\n$GPXYZ\n";
+      const auto lines = Split(splitter, data, strlen(data), 5);
+      REQUIRE(lines.size() == 2);
+      CHECK(lines[0] == "89ABCD\n");
+      CHECK(lines[1] == "$GPXYZ\n");
+
+      NmeaLineSplitter<char, 8> ref;
+      CHECK(Split(ref, data, strlen(data), 1) == lines);
+    }
+  }
+
+  TEST_CASE("nmea line splitter benchmark" * doctest::skip()) {
+    std::string record;
+    while (record.size() < (4 << 20)) {
+      record += nmea_record;
+    }
+
+    using clock = std::chrono::steady_clock;
+    size_t count = 0;
+    auto on_line = [&](char* line) {
+      count += line[1];
+    };
+
+    NmeaLineSplitter<char, MAX_NMEA_LEN> byte_splitter;
+    auto t0 = clock::now();
+    for (char c : record) {
+      byte_splitter.Append(&c, 1, on_line);
+    }
+    auto t1 = clock::now();
+
+    NmeaLineSplitter<char, MAX_NMEA_LEN> chunk_splitter;
+    for (size_t i = 0; i < record.size(); i += 1024) {
+      chunk_splitter.Append(record.data() + i, std::min<size_t>(1024, record.size() - i), on_line);
+    }
+    auto t2 = clock::now();
+
+    auto mb_per_s = [&](clock::duration d) {
+      return record.size() / std::chrono::duration<double>(d).count() / (1 << 20);
+    };
+    MESSAGE("byte by byte : ", mb_per_s(t1 - t0), " MB/s");
+    MESSAGE("1024 bytes chunk : ", mb_per_s(t2 - t1), " MB/s");
+    CHECK(count > 0);
+  }
+}
+
+#endif
@@ -339,6 +339,14 @@ BOOL NMEAParser::PFLAU(TCHAR *String, TCHAR **params, size_t nparams, NMEA_INFO
 		return false;
 	}
 
+	// parse fields before locking flight data
+	const unsigned flarm_rx = _tcstoul(params[0], nullptr, 10); // number of received FLARM devices
+	const unsigned flarm_tx = _tcstoul(params[1], nullptr, 10); // Transmit status
+	const unsigned flarm_gps = _tcstoul(params[2], nullptr, 10); // GPS status
+	const unsigned flarm_alarm_level = _tcstoul(params[4], nullptr, 10); // Alarm level of FLARM (0-3)
+
+	StatScopeLock lock(CritSec_FlightData);
+
 	static int old_flarm_rx = 0;
 	static bool conflict=false;
 
@@ -367,11 +375,11 @@ BOOL NMEAParser::PFLAU(TCHAR *String, TCHAR **params, size_t nparams, NMEA_INFO
 
 	setFlarmAvailable(pGPS);
 
-	pGPS->FLARM_RX = _tcstoul(params[0], nullptr, 10); // number of received FLARM devices
-	pGPS->FLARM_TX = _tcstoul(params[1], nullptr, 10); // Transmit status
-	pGPS->FLARM_GPS = _tcstoul(params[2], nullptr, 10); // GPS status
+	pGPS->FLARM_RX = flarm_rx;
+	pGPS->FLARM_TX = flarm_tx;
+	pGPS->FLARM_GPS = flarm_gps;
 
-	pGPS->FLARM_AlarmLevel = _tcstoul(params[4], nullptr, 10); // Alarm level of FLARM (0-3)
+	pGPS->FLARM_AlarmLevel = flarm_alarm_level;
 
 	// process flarm updates
 	if ((pGPS->FLARM_RX) && (old_flarm_rx==0)) {
@@ -574,10 +582,27 @@ BOOL NMEAParser::PFLAA(TCHAR *String, TCHAR **params, size_t nparams, NMEA_INFO
 		return FALSE;
 	}
 
-	setFlarmAvailable(pGPS);
-
+	// parse fields before locking flight data
 	// 5 id, 6 digit hex
-	uint32_t RadioId = _tcstoul(params[5], nullptr, 16);
+	const uint32_t RadioId = _tcstoul(params[5], nullptr, 16);
+
+	const auto AlarmLevel = _tcstoul(params[0], nullptr, 10);
+
+	const double RelativeNorth = _tcstod(params[1], nullptr);
+	const double RelativeEast = _tcstod(params[2], nullptr);
+	const double RelativeAltitude = _tcstod(params[3], nullptr);
+
+	const auto IDType = _tcstoul(params[4], nullptr, 10);
+
+	const double TrackBearing = _tcstod(params[6], nullptr);
+	const double TurnRate = _tcstod(params[7], nullptr);
+	const double Speed = _tcstod(params[8], nullptr);
+	const double ClimbRate = _tcstod(params[9], nullptr);
+	const auto Type = _tcstoul(params[4], nullptr, 10);
+
+	StatScopeLock lock(CritSec_FlightData);
+
+	setFlarmAvailable(pGPS);
 
 	int flarm_slot = FLARM_FindSlot(pGPS, RadioId);
 	if (flarm_slot < 0) {
@@ -594,19 +619,14 @@ BOOL NMEAParser::PFLAA(TCHAR *String, TCHAR **params, size_t nparams, NMEA_INFO
 	traffic.RadioId = RadioId;
 	traffic.Time_Fix = pGPS->Time;
 
-	traffic.AlarmLevel = _tcstoul(params[0], nullptr, 10);
-
-	double RelativeNorth = _tcstod(params[1], nullptr);
-	double RelativeEast = _tcstod(params[2], nullptr);
-	double RelativeAltitude = _tcstod(params[3], nullptr);
-
-	traffic.IDType = _tcstoul(params[4], nullptr, 10);
+	traffic.AlarmLevel = AlarmLevel;
+	traffic.IDType = IDType;
 
-	traffic.TrackBearing = _tcstod(params[6], nullptr);
-	traffic.TurnRate = _tcstod(params[7], nullptr);
-	traffic.Speed = _tcstod(params[8], nullptr);
-	traffic.ClimbRate = _tcstod(params[9], nullptr);
-	traffic.Type = _tcstoul(params[4], nullptr, 10);
+	traffic.TrackBearing = TrackBearing;
+	traffic.TurnRate = TurnRate;
+	traffic.Speed = Speed;
+	traffic.ClimbRate = ClimbRate;
+	traffic.Type = Type;
 
 	UpdateFlarmScale(pGPS);
 
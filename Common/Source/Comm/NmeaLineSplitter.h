@@ -0,0 +1,96 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   NmeaLineSplitter.h
+ */
+
+#ifndef COMM_NMEALINESPLITTER_H
+#define COMM_NMEALINESPLITTER_H
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+/**
+ * Assemble NMEA sentences from chunks of received bytes.
+ *
+ * Line ends ('\n' or '\r') are located with memchr instead of testing each
+ * byte, payload is copied to line buffer by block.
+ *
+ * Behaviour is the same as the former byte by byte ComPort::ProcessChar() :
+ *  - completed line is terminated by "\n\0" and given to handler only if it
+ *    has more than 5 char (including '\n').
+ *  - on overflow, line buffer is reset and the byte that don't fit is dropped.
+ */
+template<typename CharT, size_t size>
+class NmeaLineSplitter final {
+public:
+  NmeaLineSplitter() : _last(std::begin(_buffer)) {}
+
+  NmeaLineSplitter(const NmeaLineSplitter&) = delete;
+  NmeaLineSplitter& operator=(const NmeaLineSplitter&) = delete;
+
+  /**
+   * @handler : callable with signature `void(CharT* line)`
+   */
+  template<typename Handler>
+  void Append(const char* data, size_t length, Handler&& handler) {
+    const char* const end = data + length;
+    // next '\n' and '\r', only searched again once passed.
+    const char* next_lf = FindNext(data, end, '\n');
+    const char* next_cr = FindNext(data, end, '\r');
+
+    while (data < end) {
+      if (next_lf < data) {
+        next_lf = FindNext(data, end, '\n');
+      }
+      if (next_cr < data) {
+        next_cr = FindNext(data, end, '\r');
+      }
+      const char* eol = std::min(next_lf, next_cr);
+
+      // copy payload, last char need to be reserved for '\0'
+      while (data < eol) {
+        const size_t room = std::distance(_last, std::prev(std::end(_buffer)));
+        const size_t count = std::min<size_t>(room, std::distance(data, eol));
+        _last = std::copy_n(data, count, _last);
+        data += count;
+        if (data < eol) {
+          // overflow : reset buffer, drop current char
+          _last = std::begin(_buffer);
+          ++data;
+        }
+      }
+
+      if (eol < end) {
+        if (std::next(_last) < std::end(_buffer)) {
+          *(_last++) = '\n';
+          *(_last) = '\0';
+          // process only meaningful sentences, avoid processing a single \n \r etc.
+          if (std::distance(std::begin(_buffer), _last) > 5) {
+            handler(_buffer);
+          }
+        }
+        _last = std::begin(_buffer);
+        data = std::next(eol);
+      }
+    }
+  }
+
+  void Reset() {
+    _last = std::begin(_buffer);
+  }
+
+private:
+  static const char* FindNext(const char* begin, const char* end, char c) {
+    const void* p = memchr(begin, c, std::distance(begin, end));
+    return p ? static_cast<const char*>(p) : end;
+  }
+
+  CharT _buffer[size];
+  CharT* _last;
+};
+
+#endif // COMM_NMEALINESPLITTER_H
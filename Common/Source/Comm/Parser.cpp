@@ -37,6 +37,28 @@ double GetTrackBearingMinSpeed() {
   }
 }
 
+/**
+ * FNV-1a hash of sentence id.
+ * evaluated at compile time for `case` label, so duplicate label is a compile error
+ * if two known sentences have same hash.
+ */
+template<typename CharT>
+constexpr uint32_t SentenceId(const CharT* id) {
+  uint32_t hash = 2166136261U;
+  for (; *id; ++id) {
+    hash = (hash ^ static_cast<uint32_t>(*id)) * 16777619U;
+  }
+  return hash;
+}
+
+/**
+ * confirm hash match, unknown sentence can have the same hash than a known one.
+ */
+template<size_t size>
+bool IsSentence(const TCHAR* id, const char (&name)[size]) {
+  return std::equal(std::begin(name), std::end(name), id);
+}
+
 } // namespace
 
 GeoPoint GetCurrentPosition(const NMEA_INFO& Info) {
@@ -223,68 +245,100 @@ BOOL NMEAParser::ParseNMEAString_Internal(const DeviceDescriptor_t& d, TCHAR* St
     return FALSE;
   }
 
+  // all supported sentences are "$PXXXX" or "$XXYYY"
+  if (_tcslen(params[0]) != 6) {
+    return FALSE;
+  }
+
   if (params[0][1] == 'P') {
     // Proprietary String
-    if (_tcscmp(params[0] + 1, TEXT("PTAS1")) == 0) {
-      ScopeLock lock(CritSec_FlightData);
-      return PTAS1(d, &String[7], params + 1, n_params - 1, pGPS);
-    }
-    if (_tcscmp(params[0] + 1, TEXT("PFLAV")) == 0) {
-      ScopeLock lock(CritSec_FlightData);
-      return PFLAV(&String[7], params + 1, n_params - 1, pGPS);
-    }
-    if (_tcscmp(params[0] + 1, TEXT("PFLAA")) == 0) {
-      ScopeLock lock(CritSec_FlightData);
-      return PFLAA(&String[7], params + 1, n_params - 1, pGPS);
-    }
-    if (_tcscmp(params[0] + 1, TEXT("PFLAU")) == 0) {
-      ScopeLock lock(CritSec_FlightData);
-      return PFLAU(&String[7], params + 1, n_params - 1, pGPS);
-    }
-    if (_tcscmp(params[0] + 1, TEXT("PGRMZ")) == 0) {
-      ScopeLock lock(CritSec_FlightData);
-      return RMZ(d, &String[7], params + 1, n_params - 1, pGPS);
-    }
-    if (_tcscmp(params[0] + 1, TEXT("PLKAS")) == 0) {
-      ScopeLock lock(CritSec_FlightData);
-      return PLKAS(&String[7], params + 1, n_params - 1, pGPS);
+    const TCHAR* id = params[0] + 1;
+    switch (SentenceId(id)) {
+      case SentenceId("PTAS1"):
+        if (IsSentence(id, "PTAS1")) {
+          StatScopeLock lock(CritSec_FlightData);
+          return PTAS1(d, &String[7], params + 1, n_params - 1, pGPS);
+        }
+        break;
+      case SentenceId("PFLAV"):
+        if (IsSentence(id, "PFLAV")) {
+          StatScopeLock lock(CritSec_FlightData);
+          return PFLAV(&String[7], params + 1, n_params - 1, pGPS);
+        }
+        break;
+      case SentenceId("PFLAA"):
+        if (IsSentence(id, "PFLAA")) {
+          // CritSec_FlightData is locked by PFLAA only after fields are parsed.
+          return PFLAA(&String[7], params + 1, n_params - 1, pGPS);
+        }
+        break;
+      case SentenceId("PFLAU"):
+        if (IsSentence(id, "PFLAU")) {
+          // CritSec_FlightData is locked by PFLAU only after fields are parsed.
+          return PFLAU(&String[7], params + 1, n_params - 1, pGPS);
+        }
+        break;
+      case SentenceId("PGRMZ"):
+        if (IsSentence(id, "PGRMZ")) {
+          StatScopeLock lock(CritSec_FlightData);
+          return RMZ(d, &String[7], params + 1, n_params - 1, pGPS);
+        }
+        break;
+      case SentenceId("PLKAS"):
+        if (IsSentence(id, "PLKAS")) {
+          StatScopeLock lock(CritSec_FlightData);
+          return PLKAS(&String[7], params + 1, n_params - 1, pGPS);
+        }
+        break;
     }
     return FALSE;
   }
 
-  if (_tcscmp(params[0] + 3, TEXT("GSA")) == 0) {
-    ScopeLock lock(CritSec_FlightData);
-    return GSA(&String[7], params + 1, n_params - 1, pGPS);
-  }
-  if (_tcscmp(params[0] + 3, TEXT("GLL")) == 0) {
-    /*
-    ScopeLock lock(CritSec_FlightData);
-    return GLL(&String[7], params + 1, n_params-1, pGPS);
-    */
-    return FALSE;
-  }
-  if (_tcscmp(params[0] + 3, TEXT("RMB")) == 0) {
-    /*
-    ScopeLock lock(CritSec_FlightData);
-    return RMB(&String[7], params + 1, n_params-1, pGPS);
-    */
-    return FALSE;
-  }
-  if (_tcscmp(params[0] + 3, TEXT("RMC")) == 0) {
-    ScopeLock lock(CritSec_FlightData);
-    return RMC(&String[7], params + 1, n_params - 1, pGPS);
-  }
-  if (_tcscmp(params[0] + 3, TEXT("GGA")) == 0) {
-    ScopeLock lock(CritSec_FlightData);
-    return GGA(&String[7], params + 1, n_params - 1, pGPS);
-  }
-  if (_tcscmp(params[0] + 3, TEXT("VTG")) == 0) {
-    ScopeLock lock(CritSec_FlightData);
-    return VTG(&String[7], params + 1, n_params - 1, pGPS);
-  }
-  if (_tcscmp(params[0] + 1, TEXT("HCHDG")) == 0) {
-    ScopeLock lock(CritSec_FlightData);
-    return HCHDG(&String[7], params + 1, n_params - 1, pGPS);
+  // talker id is ignored, except for HCHDG.
+  const TCHAR* id = params[0] + 3;
+  switch (SentenceId(id)) {
+    case SentenceId("GSA"):
+      if (IsSentence(id, "GSA")) {
+        StatScopeLock lock(CritSec_FlightData);
+        return GSA(&String[7], params + 1, n_params - 1, pGPS);
+      }
+      break;
+    case SentenceId("GLL"):
+      /*
+      StatScopeLock lock(CritSec_FlightData);
+      return GLL(&String[7], params + 1, n_params-1, pGPS);
+      */
+      break;
+    case SentenceId("RMB"):
+      /*
+      StatScopeLock lock(CritSec_FlightData);
+      return RMB(&String[7], params + 1, n_params-1, pGPS);
+      */
+      break;
+    case SentenceId("RMC"):
+      if (IsSentence(id, "RMC")) {
+        StatScopeLock lock(CritSec_FlightData);
+        return RMC(&String[7], params + 1, n_params - 1, pGPS);
+      }
+      break;
+    case SentenceId("GGA"):
+      if (IsSentence(id, "GGA")) {
+        StatScopeLock lock(CritSec_FlightData);
+        return GGA(&String[7], params + 1, n_params - 1, pGPS);
+      }
+      break;
+    case SentenceId("VTG"):
+      if (IsSentence(id, "VTG")) {
+        StatScopeLock lock(CritSec_FlightData);
+        return VTG(&String[7], params + 1, n_params - 1, pGPS);
+      }
+      break;
+    case SentenceId("HDG"):
+      if (IsSentence(params[0] + 1, "HCHDG")) {
+        StatScopeLock lock(CritSec_FlightData);
+        return HCHDG(&String[7], params + 1, n_params - 1, pGPS);
+      }
+      break;
   }
   return FALSE;
 }
@@ -917,3 +971,17 @@ BOOL NMEAParser::HCHDG(TCHAR *String, TCHAR **params, size_t nparams, NMEA_INFO
 }
 
 
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_CASE("nmea sentence id") {
+  static_assert(SentenceId("RMC") != SentenceId("GGA"), "invalid sentence id");
+  CHECK(SentenceId(_T("PFLAA")) == SentenceId("PFLAA"));
+  CHECK(SentenceId(_T("PFLAU")) != SentenceId("PFLAA"));
+
+  CHECK(IsSentence(_T("PFLAA"), "PFLAA"));
+  CHECK_FALSE(IsSentence(_T("PFLA"), "PFLAA"));
+  CHECK_FALSE(IsSentence(_T("PFLAAX"), "PFLAA"));
+}
+#endif
@@ -188,7 +188,7 @@ unsigned SocketPort::RxThread() {
         UpdateStatus();
         int nRecv = ComPort::Read(szString);
         if (nRecv > 0) {
-            std::for_each(std::begin(szString), std::next(szString, nRecv), GetProcessCharHandler());
+            ProcessData(szString, nRecv);
         }
     }
 
@@ -130,7 +130,7 @@ DeviceDescriptor_t& get_active_gps() {
 }
 
 void reset_nmea_info_availability() {
-  ScopeLock lock(CritSec_FlightData);
+  StatScopeLock lock(CritSec_FlightData);
 
   ResetBaroAvailable(GPS_INFO);
   ResetVarioAvailable(GPS_INFO);
@@ -715,6 +715,10 @@ BOOL devParseStream(int portNum, char* stream, int length, NMEA_INFO *pGPS) {
       }
     }
   }
+  if (ret && pGPS == &GPS_INFO) {
+    // draw thread read GPS_INFO_Snapshot without locking flight data
+    WithLock(CritSec_FlightData, PublishGPSInfo);
+  }
   return ret;
 }
 
@@ -749,6 +753,11 @@ void devParseNMEA(int portNum, TCHAR *String, NMEA_INFO *pGPS){
       }
     }
 
+    if (pGPS == &GPS_INFO) {
+      // draw thread read GPS_INFO_Snapshot without locking flight data
+      WithLock(CritSec_FlightData, PublishGPSInfo);
+    }
+
     if(d->nmeaParser.activeGPS) {
 
       for(DeviceDescriptor_t& d2 : DeviceList) {
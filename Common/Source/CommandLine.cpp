@@ -7,6 +7,7 @@
 */
 
 #include "externs.h"
+#include "Logger.h"
 
 #if !defined(UNDER_CE) || defined(__linux__) && !defined(ANDROID)
 
@@ -17,6 +18,44 @@ extern unsigned short LcdSize, DpiSize;
 extern unsigned short ReferenceDpi;
 extern unsigned int CommandQuantization;
 
+//
+// copy into @value the value of @option ( "-option=value" or "-option="quoted value"" )
+// return false if option is missing or empty.
+//
+static bool GetOptString(const TCHAR *MyCommandLine, const TCHAR *option, TCHAR *value, size_t size) {
+  const TCHAR *pC = _tcsstr(MyCommandLine, option);
+  if (pC == NULL) {
+     return false;
+  }
+  pC += _tcslen(option);
+
+  const TCHAR *pCe;
+  if (*pC == '"'){
+     pC++;
+     pCe = pC;
+     while (*pCe != '"' && *pCe != '\0') pCe++;
+  } else{
+     pCe = pC;
+     while (*pCe != ' ' && *pCe != '\0') pCe++;
+  }
+  if (pCe <= pC) {
+     return false;
+  }
+  LK_tcsncpy(value, pC, std::min<size_t>(pCe-pC, size-1));
+  return true;
+}
+
+//
+// true if headless replay is requested, must be known before screen
+// initialisation, LK8000GetOpts() is called later.
+//
+bool LK8000GetReplayOpt(const TCHAR *MyCommandLine) {
+  if (MyCommandLine == NULL) return false;
+
+  TCHAR name[MAX_PATH];
+  return GetOptString(MyCommandLine, TEXT("-replay="), name, MAX_PATH);
+}
+
 //
 //  true,  continue normally
 //  false, no startup
@@ -60,6 +99,12 @@ bool LK8000GetOpts(const TCHAR *MyCommandLine) {
           force terrain quantization=n\n\
  -sysop\n\
           start with sysop mode active\n\
+ -replay=filename\n\
+          replay IGC or NMEA log from _Logger directory as fast as possible,\n\
+          without display, then exit. Derived values are written to CSV file\n\
+ -csv=filename\n\
+          CSV file written by -replay in _Logger directory, default to log\n\
+          file name followed by .csv\n\
 \n");
 
   return false; 
@@ -83,6 +128,14 @@ bool LK8000GetOpts(const TCHAR *MyCommandLine) {
      }
   }
 
+  TCHAR name[MAX_PATH];
+  if (GetOptString(MyCommandLine, TEXT("-replay="), name, MAX_PATH)) {
+     ReplayBatch::SetInput(name);
+  }
+  if (GetOptString(MyCommandLine, TEXT("-csv="), name, MAX_PATH)) {
+     ReplayBatch::SetOutput(name);
+  }
+
   //
   // custom resolution setup
   //
@@ -208,7 +208,8 @@ void Statistics::RenderFAIOptimizer(LKSurface &Surface, const RECT &rc) {
 
 
   const auto hfOldU = Surface.SelectObject(LK8PanelUnitFont);
-  BOOL bFAITri = CContestMgr::Instance().FAI();
+  const auto xc_status = CContestMgr::Instance().XCStatus();
+  BOOL bFAITri = xc_status->FAI;
   double fDist, fAngle;
   lat_c = (y_max + y_min) / 2;
   lon_c = (x_max + x_min) / 2;
@@ -238,16 +239,16 @@ void Statistics::RenderFAIOptimizer(LKSurface &Surface, const RECT &rc) {
 
 
   // Draw FAI sectors
-  const CContestMgr::TriangleLeg *max_leg = CContestMgr::Instance().GetFAIAssistantMaxLeg();
+  const CContestMgr::TriangleLeg *max_leg = xc_status->MaxFAILeg();
   if (max_leg != nullptr && max_leg->LegDist >= FAI_MIN_DISTANCE_THRESHOLD) {
 
-    const CContestMgr::TriangleLeg *leg0 = CContestMgr::Instance().GetFAIAssistantLeg(0);
-    const CContestMgr::TriangleLeg *leg1 = CContestMgr::Instance().GetFAIAssistantLeg(1);
-    const CContestMgr::TriangleLeg *leg2 = CContestMgr::Instance().GetFAIAssistantLeg(2);
+    const CContestMgr::TriangleLeg *leg0 = &xc_status->FAIAssistantLegs[0];
+    const CContestMgr::TriangleLeg *leg1 = &xc_status->FAIAssistantLegs[1];
+    const CContestMgr::TriangleLeg *leg2 = &xc_status->FAIAssistantLegs[2];
     //const double distance = leg0->LegDist + leg1->LegDist + leg2->LegDist;
 
     double fTic;
-    if (!CContestMgr::Instance().LooksLikeAFAITriangleAttempt()) {
+    if (!xc_status->looksLikeAFAITriangle) {
       // Does not look like a FAI attempt. Just draw both FAI sectors on longest leg.
       fTic = 10 / DISTANCEMODIFY;
       if (max_leg->LegDist > 5 / DISTANCEMODIFY) fTic = 20 / DISTANCEMODIFY;
@@ -266,7 +267,7 @@ void Statistics::RenderFAIOptimizer(LKSurface &Surface, const RECT &rc) {
         if (leg0->LegDist > 50 / DISTANCEMODIFY) fTic = 50 / DISTANCEMODIFY;
         if (leg0->LegDist > 100 / DISTANCEMODIFY) fTic = 100 / DISTANCEMODIFY;
         // Draw the yellow sector on the best current direction.
-        ContestFAISector[1].CalcSectorCache(leg0->Lat1, leg0->Lon1, leg0->Lat2, leg0->Lon2, fTic, CContestMgr::Instance().isFAITriangleClockwise());
+        ContestFAISector[1].CalcSectorCache(leg0->Lat1, leg0->Lon1, leg0->Lat2, leg0->Lon2, fTic, xc_status->FAITriangleClockwise);
         ContestFAISector[1].AnalysisDrawFAISector(Surface, rc, GeoPoint(lat_c, lon_c), RGB_YELLOW);
       }
       // If a valid second leg (or a leg that belong to the current best FAI triangle ) draw it in the correct direction
@@ -275,7 +276,7 @@ void Statistics::RenderFAIOptimizer(LKSurface &Surface, const RECT &rc) {
         if (leg1->LegDist > 5 / DISTANCEMODIFY) fTic = 20 / DISTANCEMODIFY;
         if (leg1->LegDist > 50 / DISTANCEMODIFY) fTic = 50 / DISTANCEMODIFY;
         if (leg1->LegDist > 100 / DISTANCEMODIFY) fTic = 100 / DISTANCEMODIFY;
-        ContestFAISector[3].CalcSectorCache(leg1->Lat1, leg1->Lon1, leg1->Lat2, leg1->Lon2, fTic, CContestMgr::Instance().isFAITriangleClockwise());
+        ContestFAISector[3].CalcSectorCache(leg1->Lat1, leg1->Lon1, leg1->Lat2, leg1->Lon2, fTic, xc_status->FAITriangleClockwise);
         ContestFAISector[3].AnalysisDrawFAISector(Surface, rc, GeoPoint(lat_c, lon_c), RGB_CYAN);
       }
       if (leg2->LegDist > FAI_MIN_DISTANCE_THRESHOLD) {
@@ -283,17 +284,17 @@ void Statistics::RenderFAIOptimizer(LKSurface &Surface, const RECT &rc) {
         if (leg2->LegDist > 5 / DISTANCEMODIFY) fTic = 20 / DISTANCEMODIFY;
         if (leg2->LegDist > 50 / DISTANCEMODIFY) fTic = 50 / DISTANCEMODIFY;
         if (leg2->LegDist > 100 / DISTANCEMODIFY) fTic = 100 / DISTANCEMODIFY;
-        ContestFAISector[3].CalcSectorCache(leg2->Lat1, leg2->Lon1, leg2->Lat2, leg2->Lon2, fTic, CContestMgr::Instance().isFAITriangleClockwise());
+        ContestFAISector[3].CalcSectorCache(leg2->Lat1, leg2->Lon1, leg2->Lat2, leg2->Lon2, fTic, xc_status->FAITriangleClockwise);
         ContestFAISector[3].AnalysisDrawFAISector(Surface, rc, GeoPoint(lat_c, lon_c), RGB_GREEN);
       }
     }
 
     // draw triangle
     for (ui = 0; ui < 3; ui++) {
-      lat1 = CContestMgr::Instance().GetFAIAssistantLeg(ui)->Lat1;
-      lon1 = CContestMgr::Instance().GetFAIAssistantLeg(ui)->Lon1;
-      lat2 = CContestMgr::Instance().GetFAIAssistantLeg(ui)->Lat2;
-      lon2 = CContestMgr::Instance().GetFAIAssistantLeg(ui)->Lon2;
+      lat1 = xc_status->FAIAssistantLegs[ui].Lat1;
+      lon1 = xc_status->FAIAssistantLegs[ui].Lon1;
+      lat2 = xc_status->FAIAssistantLegs[ui].Lat2;
+      lon2 = xc_status->FAIAssistantLegs[ui].Lon2;
       x1 = (lon1 - lon_c) * fastcosine(lat1);
       y1 = (lat1 - lat_c);
       x2 = (lon2 - lon_c) * fastcosine(lat2);
@@ -317,9 +318,9 @@ void Statistics::RenderFAIOptimizer(LKSurface &Surface, const RECT &rc) {
     }
 
     // Draw closing segment
-    if (CContestMgr::Instance().FAI()) {
-      lat1 = CContestMgr::Instance().GetFreeTriangleClosingPoint().Latitude();
-      lon1 = CContestMgr::Instance().GetFreeTriangleClosingPoint().Longitude();
+    if (xc_status->FAI) {
+      lat1 = xc_status->freeTriangleClosePoint.Latitude();
+      lon1 = xc_status->freeTriangleClosePoint.Longitude();
       x1 = (lon1 - lon_c) * fastcosine(lat1);
       y1 = (lat1 - lat_c);
       DrawLine(Surface, rc, x1, y1, xp, yp, STYLE_REDTHICK);
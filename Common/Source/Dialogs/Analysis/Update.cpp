@@ -262,26 +262,27 @@ void UpdateAnalysis(WndForm* pForm){
 
       if (result.PointArray().size() > 0) {
 
-        BOOL bFAI = CContestMgr::Instance().FAI();
+        const auto xc_status = CContestMgr::Instance().XCStatus();
+        BOOL bFAI = xc_status->FAI;
         double fDist = result.Distance();
 
         double fCPDist, fB_CPDist, fTotalDistance;
         if (contestType == CContestMgr::TYPE_XC_FREE_TRIANGLE) {
-          fCPDist = CContestMgr::Instance().GetFreeTriangleClosingPointDist();
-          fB_CPDist = CContestMgr::Instance().GetFreeTriangleBestClosingPointDist();
+          fCPDist = xc_status->freeTriangleTogo;
+          fB_CPDist = xc_status->freeTriangleBestTogo;
           fTotalDistance = result.PredictedDistance();
         } else if (contestType == CContestMgr::TYPE_XC_FAI_TRIANGLE) {
-          fCPDist = CContestMgr::Instance().GetFAITriangleClosingPointDist();
-          fB_CPDist = CContestMgr::Instance().GetFAITriangleBestClosingPointDist();
+          fCPDist = xc_status->FAITriangleTogo;
+          fB_CPDist = xc_status->FAITriangleBestTogo;
           fTotalDistance = result.PredictedDistance();;
         } else if (contestType == CContestMgr::TYPE_FAI_ASSISTANT) {
-          fCPDist = CContestMgr::Instance().GetFreeTriangleClosingPointDist();
-          fB_CPDist = CContestMgr::Instance().GetFreeTriangleBestClosingPointDist();
+          fCPDist = xc_status->freeTriangleTogo;
+          fB_CPDist = xc_status->freeTriangleBestTogo;
           fTotalDistance = result.PredictedDistance();;
           fDist = result.PredictedDistance() - fB_CPDist;
         } else {  // OLC FAI
-          fCPDist = CContestMgr::Instance().GetClosingPointDist();
-          fB_CPDist = CContestMgr::Instance().GetBestClosingPointDist();
+          fCPDist = xc_status->FAITriangleTogo;
+          fB_CPDist = xc_status->FAITriangleBestTogo;
           fTotalDistance = fDist;
         }
 
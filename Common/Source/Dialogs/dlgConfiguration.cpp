@@ -18,6 +18,7 @@
 
 #include "McReady.h"
 #include "Waypointparser.h"
+#include "Waypoints/WaypointIndex.h"
 #include "LKMapWindow.h"
 #include "LKProfiles.h"
 #include "Calculations2.h"
@@ -985,6 +986,7 @@ static void OnWaypointEditClicked(WndButton* pWnd) {
 
 
     dlgWaypointEditShowModal(&WayPointList[res]);
+    WayPointIndex.Invalidate(); // position may have changed
     waypointneedsave = true;
   }
 }
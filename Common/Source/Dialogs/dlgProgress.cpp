@@ -16,6 +16,7 @@
 #include "LKObjects.h"
 #include "resource.h"
 #include "Draw/LoadSplash.h"
+#include "Thread/Handle.hpp"
 
 class dlgProgress final {
 public:
@@ -124,6 +125,7 @@ void dlgProgress::OnProgressPaint(WindowControl * Sender, LKSurface& Surface) {
 }
 
 static dlgProgress* pWndProgress = nullptr;
+static ThreadHandle ProgressThread; // thread who has created the dialog
 
 void CloseProgressDialog() {
     delete pWndProgress;
@@ -131,9 +133,17 @@ void CloseProgressDialog() {
 }
 
 void CreateProgressDialog(const TCHAR* text) {
+    if(!main_window) {
+        // headless replay
+        return;
+    }
     if(!pWndProgress) {
         pWndProgress = new dlgProgress();
-    } 
+        ProgressThread = ThreadHandle::GetCurrent();
+    } else if(!ProgressThread.IsInside()) {
+        // startup files are loaded by worker threads, only the owner thread can update the dialog.
+        return;
+    }
     if(pWndProgress) {
         pWndProgress->SetProgressText(text);
     }
@@ -296,7 +296,7 @@ static void OnPassiveFreq(WndButton* pWnd){
 }
 
 static GeoPoint GetCurrentPos() {
-  ScopeLock lock(CritSec_FlightData);
+  StatScopeLock lock(CritSec_FlightData);
   return { GPS_INFO.Latitude, GPS_INFO.Longitude };
 }
 
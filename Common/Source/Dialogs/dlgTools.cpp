@@ -74,6 +74,22 @@ MsgReturn_t MessageBoxX(LPCTSTR lpText, LPCTSTR lpCaption, MsgType_t uType, bool
   int ButtonCount = 0;
   int i,x,y,d,w,h,dY;
   MsgReturn_t res;
+
+  if (!main_window) {
+    // headless run : no window, nobody to confirm, always decline and never retry.
+    StartupStore(_T("... %s%s"), lpText, NEWLINE);
+    switch (uType) {
+      case mbOk:
+        return IdOk;
+      case mbYesNo:
+        return IdNo;
+      case mbAbortRetryIgnore:
+        return IdAbort;
+      default:
+        return IdCancel;
+    }
+  }
+
   RECT rc = main_window->GetClientRect();
 
   if (wfullscreen) {
@@ -521,6 +537,11 @@ void LoadChildsFromXML(WindowControl *Parent,
 
 WndForm *dlgLoadFromXML(const CallBackTableEntry_t *LookUpTable, unsigned resID) {
 
+  if (!main_window) {
+    // headless run : dialogs can't be shown, callers already handle load failure.
+    return nullptr;
+  }
+
   WndForm* theForm = nullptr;
   std::string xml_string = xmlLoadFromResource(MAKEINTRESOURCE(resID));
 
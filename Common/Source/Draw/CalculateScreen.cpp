@@ -13,8 +13,7 @@
 #include <functional>
 using std::placeholders::_1;
 
-int MapWindow::iSnailNext=0;
-int MapWindow::iLongSnailNext=0;
+size_t MapWindow::iSnailCount=0;
 
 rectObj MapWindow::screenbounds_latlon;
 
@@ -198,8 +197,7 @@ ScreenProjection MapWindow::CalculateScreenPositions(const POINT& Orig, const RE
 
   if(TrailActive)
   {
-    iSnailNext = SnailNext; 
-    iLongSnailNext = LongSnailNext; 
+    iSnailCount = FullTrail.Count();
     // set this so that new data doesn't arrive between calculating
     // this and the screen updates
   }
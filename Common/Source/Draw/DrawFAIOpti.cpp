@@ -793,7 +793,8 @@ void MapWindow::DrawXC(LKSurface &Surface, const RECT &rc, const ScreenProjectio
 
   const GeoToScreen<ScreenPoint> ToScreen(_Proj);
 
-  CContestMgr::XCFlightType fType = CContestMgr::Instance().GetBestXCTriangleType();
+  const auto xc_status = CContestMgr::Instance().XCStatus();
+  CContestMgr::XCFlightType fType = xc_status->bestXCTriangleType;
   CContestMgr::XCTriangleStatus fStatus ;
   if (fType == CContestMgr::XCFlightType::XC_INVALID )
     return;
@@ -802,10 +803,10 @@ void MapWindow::DrawXC(LKSurface &Surface, const RECT &rc, const ScreenProjectio
   CContestMgr::TType type;
   if (fType == CContestMgr::XCFlightType::XC_FAI_TRIANGLE) {
     type = CContestMgr::TType::TYPE_XC_FAI_TRIANGLE;
-    fStatus = CContestMgr::Instance().GetFAITriangleStatus();
+    fStatus = xc_status->FAIStatus;
   } else {
     type = CContestMgr::TType::TYPE_XC_FREE_TRIANGLE;
-    fStatus = CContestMgr::Instance().GetFTTriangleStatus();
+    fStatus = xc_status->FTStatus;
   }
   CContestMgr::CResult result = CContestMgr::Instance().Result( type, true);
   const CPointGPSArray &points = result.PointArray();
@@ -826,7 +827,7 @@ void MapWindow::DrawXC(LKSurface &Surface, const RECT &rc, const ScreenProjectio
   double nextXCRadius = 0;   // the next circle radius to get a better XC scoring coefficient. 0 if we can not increase the scoring coefficient.
   LKColor nextXCRadiusColor = RGB_BLACK;
   if ( fStatus == CContestMgr::XCTriangleStatus::INVALID ) {
-    nextXCRadius = CContestMgr::Instance().GetXCValidRadius();
+    nextXCRadius = CContestMgr::GetXCValidRadius(*xc_status);
     nextXCRadiusColor = IsDithered()?RGB_BLACK:RGB_GREEN;
     LKPen hpPen_invalid(PEN_SOLID, IBLSCALE(2),  IsDithered()?RGB_BLACK:RGB_ORANGE);
     const auto hpOldPen = Surface.SelectObject(hpPen_invalid);
@@ -835,7 +836,7 @@ void MapWindow::DrawXC(LKSurface &Surface, const RECT &rc, const ScreenProjectio
     hpPen_invalid.Release();
   }
   else if ( fStatus == CContestMgr::XCTriangleStatus::VALID   ) {
-    nextXCRadius = CContestMgr::Instance().GetXCClosedRadius();
+    nextXCRadius = CContestMgr::GetXCClosedRadius(*xc_status);
     nextXCRadiusColor = IsDithered()?RGB_BLACK:RGB_RED;
     LKPen hpPen_valid(PEN_SOLID, IBLSCALE(2),  IsDithered()?RGB_BLACK:RGB_GREEN );
     const auto hpOldPen = Surface.SelectObject(hpPen_valid);
@@ -852,8 +853,9 @@ void MapWindow::DrawXC(LKSurface &Surface, const RECT &rc, const ScreenProjectio
   }
 
   if (  nextXCRadius > 0 ) {
-    const double lat_CP = CContestMgr::Instance().GetXCTriangleClosingPoint().Latitude();
-    const double lon_CP = CContestMgr::Instance().GetXCTriangleClosingPoint().Longitude();
+    const CPointGPS closing_point = xc_status->XCTriangleClosingPoint();
+    const double lat_CP = closing_point.Latitude();
+    const double lon_CP = closing_point.Longitude();
     if ( lat_CP !=0 && lon_CP!= 0) {
       const ScreenPoint Pos = ToScreen(lat_CP, lon_CP);
       int iRadius = (int) (nextXCRadius * zoom.ResScaleOverDistanceModify());
@@ -888,10 +890,11 @@ void MapWindow::DrawFAIOptimizer(LKSurface &Surface, const RECT &rc, const Scree
     return;
   }
 
-  const CContestMgr::TriangleLeg *max_leg = CContestMgr::Instance().GetFAIAssistantMaxLeg();
-  const CContestMgr::TriangleLeg *leg0 = CContestMgr::Instance().GetFAIAssistantLeg(0);
-  const CContestMgr::TriangleLeg *leg1 = CContestMgr::Instance().GetFAIAssistantLeg(1);
-  const CContestMgr::TriangleLeg *leg2 = CContestMgr::Instance().GetFAIAssistantLeg(2);
+  const auto xc_status = CContestMgr::Instance().XCStatus();
+  const CContestMgr::TriangleLeg *max_leg = xc_status->MaxFAILeg();
+  const CContestMgr::TriangleLeg *leg0 = &xc_status->FAIAssistantLegs[0];
+  const CContestMgr::TriangleLeg *leg1 = &xc_status->FAIAssistantLegs[1];
+  const CContestMgr::TriangleLeg *leg2 = &xc_status->FAIAssistantLegs[2];
   const double distance = leg0->LegDist + leg1->LegDist + leg2->LegDist;
 
   if (max_leg == nullptr || max_leg->LegDist < FAI_MIN_DISTANCE_THRESHOLD) {
@@ -911,7 +914,7 @@ void MapWindow::DrawFAIOptimizer(LKSurface &Surface, const RECT &rc, const Scree
   const auto oldpen = Surface.SelectObject(hpStartFinishThin);
   const auto oldbrush = Surface.SelectObject(LKBrush_Hollow);
 
-  if (!CContestMgr::Instance().LooksLikeAFAITriangleAttempt()) {
+  if (!xc_status->looksLikeAFAITriangle) {
     // Does not look like a FAI attempt. Just draw both FAI sectors on longest leg.
     FAI_SectorCache[0].CalcSectorCache(max_leg->Lat1, max_leg->Lon1, max_leg->Lat2, max_leg->Lon2, fTic, 0);
     FAI_SectorCache[0].DrawFAISector(Surface, rc, _Proj, IsDithered()?RGB_BLACK:RGB_YELLOW);
@@ -920,12 +923,12 @@ void MapWindow::DrawFAIOptimizer(LKSurface &Surface, const RECT &rc, const Scree
   } else {
     if (leg0->LegDist > FAI_MIN_DISTANCE_THRESHOLD) {
       // Draw the yellow sector on the best current direction.
-      FAI_SectorCache[2].CalcSectorCache(leg0->Lat1, leg0->Lon1, leg0->Lat2, leg0->Lon2, fTic, CContestMgr::Instance().isFAITriangleClockwise());
+      FAI_SectorCache[2].CalcSectorCache(leg0->Lat1, leg0->Lon1, leg0->Lat2, leg0->Lon2, fTic, xc_status->FAITriangleClockwise);
       FAI_SectorCache[2].DrawFAISector(Surface, rc, _Proj, IsDithered()?RGB_BLACK:RGB_YELLOW);
     }
     // Draw leg1 a bit before becoming a FAI one in the correct direction . We start drawing a bit before 28%
     if (leg1->LegDist > distance * 0.25) {
-      FAI_SectorCache[3].CalcSectorCache(leg1->Lat1, leg1->Lon1, leg1->Lat2, leg1->Lon2, fTic, CContestMgr::Instance().isFAITriangleClockwise());
+      FAI_SectorCache[3].CalcSectorCache(leg1->Lat1, leg1->Lon1, leg1->Lat2, leg1->Lon2, fTic, xc_status->FAITriangleClockwise);
       FAI_SectorCache[3].DrawFAISector(Surface, rc, _Proj, IsDithered()?RGB_BLACK:RGB_CYAN);
     }
   }
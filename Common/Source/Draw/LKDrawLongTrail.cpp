@@ -20,47 +20,51 @@ typedef RasterPoint ScreenPoint;
 #endif
 
 void MapWindow::LKDrawLongTrail( LKSurface& Surface, const RECT& rc, const ScreenProjection& _Proj) {
-    static ScreenPoint snail_polyline[std::size(LongSnailTrail)+1]; // +1 for last point of "normal" snail trail
+    static std::vector<GeoPoint> trail_points;
+    static std::vector<ScreenPoint> snail_polyline;
 
     if (TrailActive != 3) return; // only when full trail is selected
-    if (iLongSnailNext < 2) return; // no reason to draw a single point
 
     if (MapWindow::mode.Is(MapWindow::Mode::MODE_CIRCLING)) {
         return;
     }    
 
+    // only points older than "normal" snail trail, last one is the oldest
+    // point of snail trail, so both trail are connected.
+    const size_t count = iSnailCount;
+    if (count <= TRAILSIZE) return;
+
+    FullTrail.Get(screenbounds_latlon, _Proj.GetPixelSize(), count - TRAILSIZE, trail_points);
+    if (trail_points.empty()) return;
+
+    snail_polyline.resize(trail_points.size());
+
     // pixel manhattan distance
     // It is the sum of x and y differences between previous and next point on screen, in pixels.
     // below this distance, no painting
     const ScreenPoint::scalar_type nearby=10;
 
-    const LONG_SNAIL_POINT* end_iterator = std::begin(LongSnailTrail);
-    const LONG_SNAIL_POINT* cur_iterator = std::prev(std::next(LongSnailTrail,iLongSnailNext));
-    ScreenPoint* polyline_iterator = std::begin(snail_polyline);
-
-    const SNAIL_POINT* last_point = std::next(std::next(SnailTrail, iSnailNext));
-    if(last_point == std::end(SnailTrail)) {
-        last_point = std::begin(SnailTrail);
-    }
-
-    const GeoToScreen<ScreenPoint> ToScreen(_Proj);
-
-    (*polyline_iterator) = ToScreen(last_point->Latitude, last_point->Longitude);
-
-    polyline_iterator = std::next(polyline_iterator);
-
     const auto oldPen = Surface.SelectObject(hSnailPens[3]); // blue color
 
-    while(cur_iterator != end_iterator) {
+    auto first = trail_points.cbegin();
+    while (first != trail_points.cend()) {
+        const auto last = std::find_if(first, trail_points.cend(), FlightTrail::IsBreak);
 
-        (*polyline_iterator) = ToScreen(cur_iterator->Latitude, cur_iterator->Longitude);
+        ScreenPoint* const begin = snail_polyline.data();
+        ScreenPoint* const end = _Proj.ToScreen(first, last, begin);
 
-        if(ManhattanDistance(*std::prev(polyline_iterator),(*polyline_iterator)) > nearby) {
-            polyline_iterator = std::next(polyline_iterator);
+        ScreenPoint* polyline_iterator = begin;
+        for (ScreenPoint* it = std::next(begin); it < end; ++it) {
+            if (ManhattanDistance(*polyline_iterator, *it) > nearby) {
+                *(++polyline_iterator) = *it;
+            }
         }
-        cur_iterator = std::prev(cur_iterator);
+        if (polyline_iterator != begin) {
+            Surface.Polyline(begin, std::distance(begin, polyline_iterator) + 1, rc);
+        }
+
+        first = (last == trail_points.cend()) ? last : std::next(last);
     }
-    Surface.Polyline(snail_polyline, std::distance(snail_polyline, polyline_iterator) , rc);
 
     Surface.SelectObject(oldPen);
 }
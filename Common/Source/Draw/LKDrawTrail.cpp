@@ -22,14 +22,15 @@ typedef RasterPoint ScreenPoint;
 
 void MapWindow::LKDrawTrail(LKSurface& Surface, const RECT& rc, const ScreenProjection& _Proj) {
 
-    static ScreenPoint snail_polyline[std::size(SnailTrail)];
-    
+    static std::vector<FlightTrail::point_t> snail_points;
+    static std::vector<ScreenPoint> snail_polyline;
+
     if (!TrailActive) return;
 
     const double display_time = DrawInfo.Time;
     const bool use_colors = (MapWindow::zoom.RealScale() < 2); // 1.5 is also quite good;
 
-    static_assert(std::size(SnailTrail) == TRAILSIZE, "Invalid SnailTrail size");
+    static_assert(TRAILSIZE <= FlightTrail::RECENT_SIZE, "Invalid TRAILSIZE");
     //  Trail size
     int num_trail_max = TRAILSIZE;
     if (TrailActive == 2) {
@@ -40,25 +41,18 @@ void MapWindow::LKDrawTrail(LKSurface& Surface, const RECT& rc, const ScreenProj
         num_trail_max /= TRAILSHRINK; // ( 2 min for short track ? )
     }    
 
-    /**
-     * SnailTrail is circular buffer:
-     *  end_iterator : most recent point
-     *  cur_iterator : oldest point, ( last point of array if end_iterator is begin
-     *   we don't need to check if buffer is full here, empty point are check in drawing loop.
-     */
-    const SNAIL_POINT* end_iterator = std::next(SnailTrail,iSnailNext);
-    const SNAIL_POINT* cur_iterator = end_iterator;
-    if(cur_iterator != std::begin(SnailTrail)) {
-        cur_iterator = std::prev(cur_iterator);
-    } else {
-        cur_iterator = std::prev(std::end(SnailTrail));
+    // most recent points of the flight trail, oldest first.
+    FullTrail.GetRecent(iSnailCount, num_trail_max, snail_points);
+
+    const size_t snail_count = snail_points.size();
+    if (snail_count == 0) {
+        return;
     }
-        
-    ScreenPoint* polyline_iterator = &snail_polyline[0];
+    snail_polyline.resize(snail_count);
 
     unsigned short prev_color = 15; // fixed pen for low zoom snail trail
     if(use_colors) {
-        prev_color = cur_iterator->Colour;
+        prev_color = snail_points[0].colour;
     }
     Surface.SelectObject(hSnailPens[prev_color]);
     
@@ -76,39 +70,32 @@ void MapWindow::LKDrawTrail(LKSurface& Surface, const RECT& rc, const ScreenProj
         traildrift_lon = (DrawInfo.Longitude - tlon1);
     }
 
-    const GeoToScreen<ScreenPoint> ToScreen(_Proj);
-
-    while( (num_trail_max--) > 0 &&  cur_iterator->Time && cur_iterator != end_iterator) {
-        
-        double this_lat = cur_iterator->Latitude;
-        double this_lon = cur_iterator->Longitude;
+    _Proj.ToScreen(snail_count, [&](size_t i) {
+        const FlightTrail::point_t& point = snail_points[i];
+        GeoPoint position = point.position;
         if (trail_is_drifted) {
-            double dt = std::max(0.0, (display_time - cur_iterator->Time) * cur_iterator->DriftFactor);
-            this_lat += traildrift_lat * dt;
-            this_lon += traildrift_lon * dt;
+            double dt = std::max(0.0, (display_time - point.time) * point.drift_factor);
+            position.latitude += traildrift_lat * dt;
+            position.longitude += traildrift_lon * dt;
+        }
+        return position;
+    }, snail_polyline.data());
+
+    // one polyline for each color change, last point of a polyline is first point of next one.
+    size_t polyline_first = 0;
+    if(use_colors) {
+        for (size_t i = 0; i < snail_count; ++i) {
+            if(prev_color != snail_points[i].colour) {
+                // draw polyline before change color.
+                Surface.Polyline(&snail_polyline[polyline_first], i - polyline_first + 1, rc);
+                polyline_first = i;
+
+                // select new Color
+                prev_color = snail_points[i].colour;
+                Surface.SelectObject(hSnailPens[prev_color]);
+            }
         }
-        
-        (*polyline_iterator) = ToScreen(this_lat, this_lon);
-
-        if(use_colors && prev_color != cur_iterator->Colour) {
-            // draw polyline before change color.
-            Surface.Polyline(snail_polyline, std::distance(snail_polyline, polyline_iterator)+1 , rc);
-            // reset polyline
-            snail_polyline[0] = *polyline_iterator;
-            polyline_iterator = &snail_polyline[1];
-            
-            // select new Color
-            prev_color = cur_iterator->Colour;
-            Surface.SelectObject(hSnailPens[prev_color]);
-        } else {
-            polyline_iterator = std::next(polyline_iterator);
-        } 
-        
-        if(cur_iterator == std::begin(SnailTrail)) {
-            cur_iterator = std::end(SnailTrail);
-        } 
-        cur_iterator = std::prev(cur_iterator);
     }
-    Surface.Polyline(snail_polyline, std::distance(snail_polyline, polyline_iterator) , rc);
+    Surface.Polyline(&snail_polyline[polyline_first], snail_count - polyline_first, rc);
 }
 
@@ -2013,7 +2013,7 @@ void MapWindow::Render(LKSurface& Surface, const PixelRect& Rect ) {
     }
 
     if(ProgramStarted >= psNormalOp && THREADRUNNING) {
-        UpdateInfo(&GPS_INFO, &CALCULATED_INFO);
+        UpdateInfo();
         RenderMapWindow(Surface, Rect);
 
         const ScreenProjection _Proj;
@@ -47,19 +47,24 @@ void RenderAirspaceTerrain(LKSurface& Surface, double PosLat, double PosLon, dou
     double d_h[AIRSPACE_SCANSIZE_X] = {};
 
 #define   FRAMEWIDTH 2
-    RasterTerrain::Lock(); // want most accurate rounding here
-    RasterTerrain::SetTerrainRounding(0, 0);
     double fj;
     for (j = 0; j < AIRSPACE_SCANSIZE_X; j++) { // scan range
         fj = (double) j * 1.0 / (double) (AIRSPACE_SCANSIZE_X - 1);
         FindLatitudeLongitude(lat, lon, brg, range*fj, &d_lat[j], &d_lon[j]);
-        d_h[j] = RasterTerrain::GetTerrainHeight(d_lat[j], d_lon[j]);
-        if (d_h[j] == TERRAIN_INVALID) d_h[j] = 0; //@ 101027 BUGFIX
-        hmax = max(hmax, d_h[j]);
     }
 
+    short terrain_h[AIRSPACE_SCANSIZE_X];
+    RasterTerrain::Lock(); // want most accurate rounding here
+    RasterTerrain::SetTerrainRounding(0, 0);
+    RasterTerrain::GetTerrainHeightBatch(d_lat, d_lon, terrain_h, AIRSPACE_SCANSIZE_X);
     RasterTerrain::Unlock();
 
+    for (j = 0; j < AIRSPACE_SCANSIZE_X; j++) {
+        d_h[j] = terrain_h[j];
+        if (d_h[j] == TERRAIN_INVALID) d_h[j] = 0; //@ 101027 BUGFIX
+        hmax = max(hmax, d_h[j]);
+    }
+
 
     /********************************************************************************
      * scan line
@@ -42,9 +42,9 @@ void MapWindow::RenderMapWindowBg(LKSurface& Surface, const RECT& rc) {
     }
 
 
-    // Here we calculate arrival altitude, GD etc for map waypoints. Splitting with multicalc will result in delayed
-    // updating of visible landables, for example. The nearest pages do this separately, with their own sorting.
-    // Basically we assume -like for nearest- that values will not change that much in the multicalc split time.
+    // Here we request arrival altitude, GD etc for map waypoints. They are computed by a worker thread,
+    // visible landables first, so results of the map may be one pass late.
+    // The nearest pages do this separately, with their own sorting.
     // Target and tasks are recalculated in real time in any case. Nearest too.
     LKCalculateWaypointReachable(false);
 
@@ -14,13 +14,57 @@
 #include "ScreenProjection.h"
 #include "NavFunctions.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+#if defined(__SSE2__)
+
+  constexpr double round_magic = 6755399441055744.0; // 2^52 + 2^51
+
+  // std::trunc() for |v| < 2^51
+  inline __m128d trunc_pd(__m128d v) {
+    const __m128d sign_mask = _mm_set1_pd(-0.);
+    const __m128d a = _mm_andnot_pd(sign_mask, v);
+    // round to nearest, then fix if rounded up
+    __m128d r = _mm_sub_pd(_mm_add_pd(a, _mm_set1_pd(round_magic)), _mm_set1_pd(round_magic));
+    r = _mm_sub_pd(r, _mm_and_pd(_mm_cmpgt_pd(r, a), _mm_set1_pd(1.)));
+    return _mm_or_pd(r, _mm_and_pd(v, sign_mask));
+  }
+
+  // lround() for |v| < 2^51 : round half away from zero
+  inline __m128d lround_pd(__m128d v) {
+    const __m128d sign_mask = _mm_set1_pd(-0.);
+    const __m128d a = _mm_andnot_pd(sign_mask, v);
+    __m128d r = _mm_sub_pd(_mm_add_pd(a, _mm_set1_pd(round_magic)), _mm_set1_pd(round_magic));
+    r = _mm_sub_pd(r, _mm_and_pd(_mm_cmpgt_pd(r, a), _mm_set1_pd(1.)));
+    r = _mm_add_pd(r, _mm_and_pd(_mm_cmpge_pd(_mm_sub_pd(a, r), _mm_set1_pd(.5)), _mm_set1_pd(1.)));
+    return _mm_or_pd(r, _mm_and_pd(v, sign_mask));
+  }
+
+#endif
+
+} // namespace
+
 ScreenProjection::ScreenProjection() :
-    geo_origin(MapWindow::GetPanLatitude(), MapWindow::GetPanLongitude()),
-    screen_origin(MapWindow::GetOrigScreen()),
-    _Zoom(MapWindow::GetDrawScale()),
-    _Angle(MapWindow::GetDisplayAngle()),
-    _CosAngle(ifastcosine(MapWindow::GetDisplayAngle())),
-    _SinAngle(ifastsine(MapWindow::GetDisplayAngle()))
+    ScreenProjection({MapWindow::GetPanLatitude(), MapWindow::GetPanLongitude()},
+                     MapWindow::GetOrigScreen(),
+                     MapWindow::GetDrawScale(),
+                     MapWindow::GetDisplayAngle())
+{
+}
+
+ScreenProjection::ScreenProjection(const GeoPoint& geo_origin, const RasterPoint& screen_origin, double zoom, double angle) :
+    geo_origin(geo_origin),
+    screen_origin(screen_origin),
+    _Zoom(zoom),
+    _Angle(angle),
+    _CosAngle(ifastcosine(angle)),
+    _SinAngle(ifastsine(angle))
 {
 }
 
@@ -54,3 +98,216 @@ bool ScreenProjection::operator!=(const ScreenProjection& _Proj) const {
     double offset = geo_origin.Distance(_Proj.geo_origin);
     return (offset >= GetPixelSize());
 }
+
+/*
+ * integer coordinate : same as ToScreen<RasterPoint>(), X and Y are rounded,
+ * rotation and division are done in double, all intermediate values are
+ * integer lower than 2^53 so result is exact.
+ */
+void ScreenProjection::Rotate(const double* X, const double* Y, size_t size, RasterPoint* out) const {
+    using scalar_type = decltype(RasterPoint::x);
+
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128d cos_angle = _mm_set1_pd(_CosAngle);
+    const __m128d sin_angle = _mm_set1_pd(_SinAngle);
+    const __m128d half = _mm_set1_pd(512.);
+    const __m128d scale = _mm_set1_pd(1. / 1024.);
+    const __m128d origin_x = _mm_set1_pd(screen_origin.x);
+    const __m128d origin_y = _mm_set1_pd(screen_origin.y);
+
+    for (; i + 2 <= size; i += 2) {
+        const __m128d x = lround_pd(_mm_loadu_pd(X + i));
+        const __m128d y = lround_pd(_mm_loadu_pd(Y + i));
+
+        const __m128d rx = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(x, cos_angle), _mm_mul_pd(y, sin_angle)), half);
+        const __m128d ry = _mm_add_pd(_mm_add_pd(_mm_mul_pd(y, cos_angle), _mm_mul_pd(x, sin_angle)), half);
+
+        alignas(16) int32_t sx[4];
+        alignas(16) int32_t sy[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(sx), _mm_cvttpd_epi32(_mm_sub_pd(origin_x, trunc_pd(_mm_mul_pd(rx, scale)))));
+        _mm_store_si128(reinterpret_cast<__m128i*>(sy), _mm_cvttpd_epi32(_mm_add_pd(origin_y, trunc_pd(_mm_mul_pd(ry, scale)))));
+
+        out[i] = { static_cast<scalar_type>(sx[0]), static_cast<scalar_type>(sy[0]) };
+        out[i + 1] = { static_cast<scalar_type>(sx[1]), static_cast<scalar_type>(sy[1]) };
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float64x2_t cos_angle = vdupq_n_f64(_CosAngle);
+    const float64x2_t sin_angle = vdupq_n_f64(_SinAngle);
+    const float64x2_t half = vdupq_n_f64(512.);
+    const float64x2_t scale = vdupq_n_f64(1. / 1024.);
+    const float64x2_t origin_x = vdupq_n_f64(screen_origin.x);
+    const float64x2_t origin_y = vdupq_n_f64(screen_origin.y);
+
+    for (; i + 2 <= size; i += 2) {
+        const float64x2_t x = vrndaq_f64(vld1q_f64(X + i));
+        const float64x2_t y = vrndaq_f64(vld1q_f64(Y + i));
+
+        const float64x2_t rx = vaddq_f64(vsubq_f64(vmulq_f64(x, cos_angle), vmulq_f64(y, sin_angle)), half);
+        const float64x2_t ry = vaddq_f64(vaddq_f64(vmulq_f64(y, cos_angle), vmulq_f64(x, sin_angle)), half);
+
+        const int64x2_t sx = vcvtq_s64_f64(vsubq_f64(origin_x, vrndq_f64(vmulq_f64(rx, scale))));
+        const int64x2_t sy = vcvtq_s64_f64(vaddq_f64(origin_y, vrndq_f64(vmulq_f64(ry, scale))));
+
+        out[i] = { static_cast<scalar_type>(vgetq_lane_s64(sx, 0)), static_cast<scalar_type>(vgetq_lane_s64(sy, 0)) };
+        out[i + 1] = { static_cast<scalar_type>(vgetq_lane_s64(sx, 1)), static_cast<scalar_type>(vgetq_lane_s64(sy, 1)) };
+    }
+#endif
+
+    for (; i < size; ++i) {
+        const long x = lround(X[i]);
+        const long y = lround(Y[i]);
+        out[i] = {
+            static_cast<scalar_type>(screen_origin.x - (x * _CosAngle - y * _SinAngle + 512) / 1024),
+            static_cast<scalar_type>(screen_origin.y + (y * _CosAngle + x * _SinAngle + 512) / 1024)
+        };
+    }
+}
+
+/*
+ * floating point coordinate : same as ToScreen<FloatPoint>(), done in single precision.
+ */
+void ScreenProjection::Rotate(const double* X, const double* Y, size_t size, FloatPoint* out) const {
+    using scalar_type = decltype(FloatPoint::x);
+
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128 cos_angle = _mm_set1_ps(_CosAngle);
+    const __m128 sin_angle = _mm_set1_ps(_SinAngle);
+    const __m128 half = _mm_set1_ps(512.f);
+    const __m128 scale = _mm_set1_ps(1024.f);
+    const __m128 origin_x = _mm_set1_ps(screen_origin.x);
+    const __m128 origin_y = _mm_set1_ps(screen_origin.y);
+
+    for (; i + 4 <= size; i += 4) {
+        const __m128 x = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(X + i)), _mm_cvtpd_ps(_mm_loadu_pd(X + i + 2)));
+        const __m128 y = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(Y + i)), _mm_cvtpd_ps(_mm_loadu_pd(Y + i + 2)));
+
+        const __m128 rx = _mm_div_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, cos_angle), _mm_mul_ps(y, sin_angle)), half), scale);
+        const __m128 ry = _mm_div_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(y, cos_angle), _mm_mul_ps(x, sin_angle)), half), scale);
+
+        alignas(16) float sx[4];
+        alignas(16) float sy[4];
+        _mm_store_ps(sx, _mm_sub_ps(origin_x, rx));
+        _mm_store_ps(sy, _mm_add_ps(origin_y, ry));
+
+        for (size_t j = 0; j < 4; ++j) {
+            out[i + j] = { sx[j], sy[j] };
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t cos_angle = vdupq_n_f32(_CosAngle);
+    const float32x4_t sin_angle = vdupq_n_f32(_SinAngle);
+    const float32x4_t half = vdupq_n_f32(512.f);
+    const float32x4_t scale = vdupq_n_f32(1024.f);
+    const float32x4_t origin_x = vdupq_n_f32(screen_origin.x);
+    const float32x4_t origin_y = vdupq_n_f32(screen_origin.y);
+
+    for (; i + 4 <= size; i += 4) {
+        const float32x4_t x = vcombine_f32(vcvt_f32_f64(vld1q_f64(X + i)), vcvt_f32_f64(vld1q_f64(X + i + 2)));
+        const float32x4_t y = vcombine_f32(vcvt_f32_f64(vld1q_f64(Y + i)), vcvt_f32_f64(vld1q_f64(Y + i + 2)));
+
+        const float32x4_t rx = vdivq_f32(vaddq_f32(vsubq_f32(vmulq_f32(x, cos_angle), vmulq_f32(y, sin_angle)), half), scale);
+        const float32x4_t ry = vdivq_f32(vaddq_f32(vaddq_f32(vmulq_f32(y, cos_angle), vmulq_f32(x, sin_angle)), half), scale);
+
+        float sx[4];
+        float sy[4];
+        vst1q_f32(sx, vsubq_f32(origin_x, rx));
+        vst1q_f32(sy, vaddq_f32(origin_y, ry));
+
+        for (size_t j = 0; j < 4; ++j) {
+            out[i + j] = { sx[j], sy[j] };
+        }
+    }
+#endif
+
+    for (; i < size; ++i) {
+        const scalar_type x = X[i];
+        const scalar_type y = Y[i];
+        out[i] = {
+            static_cast<scalar_type>(screen_origin.x - (x * _CosAngle - y * _SinAngle + 512) / 1024),
+            static_cast<scalar_type>(screen_origin.y + (y * _CosAngle + x * _SinAngle + 512) / 1024)
+        };
+    }
+}
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace {
+
+  std::vector<GeoPoint> RandomPoints(const GeoPoint& center, double range, size_t count) {
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<double> dist(-range, range);
+    std::vector<GeoPoint> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      points.push_back({center.latitude + dist(gen), center.longitude + dist(gen)});
+    }
+    return points;
+  }
+
+} // namespace
+
+TEST_SUITE("ScreenProjection") {
+
+  TEST_CASE("batch ToScreen") {
+    InitSineTable();
+
+    const GeoPoint center = {45.5, 6.2};
+    const std::vector<GeoPoint> points = RandomPoints(center, 0.5, 1003);
+
+    for (double angle : {0., 17., 123.4, 271.}) {
+      const ScreenProjection proj(center, {400, 240}, 5000., angle);
+
+      std::vector<RasterPoint> raster(points.size());
+      CHECK(proj.ToScreen(points.begin(), points.end(), raster.data()) == raster.data() + raster.size());
+
+      std::vector<FloatPoint> floats(points.size());
+      proj.ToScreen(points.begin(), points.end(), floats.data());
+
+      for (size_t i = 0; i < points.size(); ++i) {
+        const RasterPoint expected = proj.ToScreen<RasterPoint>(points[i]);
+        CHECK(raster[i] == expected);
+
+        const FloatPoint expected_float = proj.ToScreen<FloatPoint>(points[i]);
+        CHECK(floats[i].x == doctest::Approx(expected_float.x));
+        CHECK(floats[i].y == doctest::Approx(expected_float.y));
+      }
+    }
+  }
+
+  TEST_CASE("batch ToScreen benchmark" * doctest::skip()) {
+    InitSineTable();
+
+    const GeoPoint center = {45.5, 6.2};
+    const std::vector<GeoPoint> points = RandomPoints(center, 0.5, 100000);
+    const ScreenProjection proj(center, {400, 240}, 5000., 33.);
+
+    std::vector<RasterPoint> raster(points.size());
+    using clock = std::chrono::steady_clock;
+
+    auto start = clock::now();
+    for (unsigned n = 0; n < 100; ++n) {
+      std::transform(points.begin(), points.end(), raster.begin(), [&](const GeoPoint& pt) {
+        return proj.ToScreen<RasterPoint>(pt);
+      });
+    }
+    const auto single = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+
+    start = clock::now();
+    for (unsigned n = 0; n < 100; ++n) {
+      proj.ToScreen(points.begin(), points.end(), raster.data());
+    }
+    const auto batch = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+
+    MESSAGE("100 x 100k points : ToScreen " << single << "us, batch ToScreen " << batch << "us");
+  }
+}
+
+#endif
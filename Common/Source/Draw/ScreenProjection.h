@@ -15,10 +15,14 @@
 #include "Screen/Point.hpp"
 #include "Math/Point2D.hpp"
 #include "Geographic/GeoPoint.h"
+#include "MathFunctions.h"
+#include <algorithm>
+#include <iterator>
 
 class ScreenProjection final {
 public:
     ScreenProjection();
+    ScreenProjection(const GeoPoint& geo_origin, const RasterPoint& screen_origin, double zoom, double angle);
 
     inline
     RasterPoint ToRasterPoint(double lat, double lon) const {
@@ -42,6 +46,45 @@ public:
         };
     }
 
+    /**
+     * Batch version of ToScreen(), used for polyline and polygon.
+     *
+     * @count : number of point to convert
+     * @get : callable with signature `GeoPoint(size_t index)`
+     * @out : array of at least @count ScreenPoint
+     *
+     * result is exactly the same than calling ToScreen() for each point, but
+     * only fastcosine lookup is done per point before the integer rotation and
+     * rounding are processed by block with SIMD instructions if available.
+     */
+    template <typename ScreenPoint, typename GetGeoPoint>
+    void ToScreen(size_t count, GetGeoPoint&& get, ScreenPoint* out) const {
+        double X[batch_size];
+        double Y[batch_size];
+
+        for (size_t first = 0; first < count; first += batch_size) {
+            const size_t size = std::min(batch_size, count - first);
+            for (size_t i = 0; i < size; ++i) {
+                const GeoPoint pt = get(first + i);
+                assert(!Overflow<decltype(ScreenPoint::x)>(pt)); // undefined result
+
+                const GeoPoint diff = (geo_origin - pt) * _Zoom;
+                Y[i] = diff.latitude;
+                X[i] = diff.longitude * fastcosine(pt.latitude);
+            }
+            Rotate(X, Y, size, out + first);
+        }
+    }
+
+    template <typename ScreenPoint, typename InputIt>
+    ScreenPoint* ToScreen(InputIt first, InputIt last, ScreenPoint* out) const {
+        const size_t count = std::distance(first, last);
+        ToScreen(count, [&](size_t i) {
+            return to_geo_point(first[i]);
+        }, out);
+        return out + count;
+    }
+
     inline
     GeoPoint ToGeoPoint(const RasterPoint& pt) const {
         GeoPoint geoPoint;
@@ -53,9 +96,24 @@ public:
 
     bool operator!=(const ScreenProjection& _Proj) const;
 
-protected:
+    /**
+     * @return true if both projection give exactly the same screen coordinate,
+     *   unlike operator!=() which ignore change smaller than one pixel.
+     */
+    bool IsSame(const ScreenProjection& _Proj) const {
+        return geo_origin == _Proj.geo_origin
+            && screen_origin == _Proj.screen_origin
+            && _Zoom == _Proj._Zoom
+            && _Angle == _Proj._Angle;
+    }
+
+    /**
+     * @return width of one pixel at projection center, in meter.
+     */
     double GetPixelSize() const;
 
+protected:
+
     /* geographic center of projection
      * usually aircraft position in wgs84 geographic coordinate
      */
@@ -74,6 +132,27 @@ protected:
 
 private:
 
+    static constexpr size_t batch_size = 64;
+
+    /**
+     * last step of batch ToScreen() :
+     *   @X, @Y are scaled (not rounded) projected coordinate.
+     */
+    void Rotate(const double* X, const double* Y, size_t size, RasterPoint* out) const;
+    void Rotate(const double* X, const double* Y, size_t size, FloatPoint* out) const;
+
+    static const GeoPoint& to_geo_point(const GeoPoint& pt) {
+        return pt;
+    }
+
+    static GeoPoint to_geo_point(const pointObj& pt) {
+        return {pt.y, pt.x};
+    }
+
+    static GeoPoint to_geo_point(const CPoint2D& pt) {
+        return {pt.Latitude(), pt.Longitude()};
+    }
+
     template<typename scalar_type>
     using integral_t = std::enable_if_t<std::is_integral_v<scalar_type>, scalar_type>;
 
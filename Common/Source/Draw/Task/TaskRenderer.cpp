@@ -36,22 +36,21 @@ void TaskRenderer::Draw(LKSurface& Surface, const RECT &rc, bool bFill) const {
 
 void TaskRenderer::CalculateScreenPosition(const rectObj &screenbounds, const ScreenProjection& _Proj) {
 
-    GeoToScreen<ScreenPoint> ToScreen(_Proj);
-
     _ScreenPoints.clear();
     _Visible = msRectOverlap(&_bounds, &screenbounds);
     if (_Visible) {
         _ScreenPoints.reserve(_GeoPoints.size() + 1); // +1 to close polygon
+        _ScreenPoints.resize(_GeoPoints.size());
+        _Proj.ToScreen(_GeoPoints.begin(), _GeoPoints.end(), _ScreenPoints.data());
 
-        const GeoPoint& first = _GeoPoints.front();
-        _ScreenPoints.push_back(ToScreen(first));
-
-        for (GeoPoints_t::const_iterator It = std::next(_GeoPoints.begin()); It != _GeoPoints.end(); ++It) {
-            const ScreenPoint pt = ToScreen(*It);
-            if (ManhattanDistance(pt, _ScreenPoints.back()) > 2) {
-                _ScreenPoints.push_back(pt);
+        // remove points too close from previous one
+        ScreenPoints_t::iterator last = _ScreenPoints.begin();
+        for (ScreenPoints_t::iterator It = std::next(_ScreenPoints.begin()); It != _ScreenPoints.end(); ++It) {
+            if (ManhattanDistance(*It, *last) > 2) {
+                *(++last) = *It;
             }
         }
+        _ScreenPoints.erase(std::next(last), _ScreenPoints.end());
         _ScreenPoints.push_back(_ScreenPoints.front());
     }
 }
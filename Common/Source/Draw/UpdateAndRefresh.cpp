@@ -46,6 +46,17 @@ void MapWindow::UpdateInfo(NMEA_INFO *nmea_info,
   UnlockFlightData();
 }
 
+void MapWindow::UpdateInfo() {
+  // use lock free snapshot published by calculation thread, once available.
+  if (!GPS_INFO_Snapshot.Read(DrawInfo) || !CALCULATED_INFO_Snapshot.Read(DerivedDrawInfo)) {
+    UpdateInfo(&GPS_INFO, &CALCULATED_INFO);
+    return;
+  }
+  LockFlightData();
+  zoom.UpdateMapScale();
+  UnlockFlightData();
+}
+
 
 
 void MapWindow::UpdateCaches(const ScreenProjection& _Proj, bool force) {
@@ -54,7 +65,7 @@ void MapWindow::UpdateCaches(const ScreenProjection& _Proj, bool force) {
 
   // have some time, do shape file cache update if necessary
   LockTerrainDataGraphics();
-  SetTopologyBounds(DrawRect, _Proj, force||MapWindow::ForceVisibilityScan);
+  SetTopologyBounds(DrawRect, _Proj, DrawInfo, force||MapWindow::ForceVisibilityScan);
   UnlockTerrainDataGraphics();
   //
   // ForceVisibilityScan is checked and actively used only here, and in ScanVisibility since v6
@@ -443,8 +443,7 @@ void Globals_Init(void) {
   AirspaceWarningMapLabels = 1;               // airspace warning map labels showed
   AirspaceAckAllSame = 0;
 
-  SnailNext = 0;
-  LongSnailNext = 0;
+  FullTrail.Clear();
 
   // OLC COOKED VALUES
   //CContestMgr::CResult OlcResults[CContestMgr::TYPE_NUM];
@@ -8,7 +8,7 @@
 #include "externs.h"
 
 
-Mutex  CritSec_FlightData;
+StatMutex  CritSec_FlightData;
 Mutex  CritSec_TerrainDataGraphics;
 Mutex  CritSec_TerrainDataCalculations;
 Mutex  CritSec_TaskData;
@@ -29,6 +29,14 @@ void LockFlightData() {
   CritSec_FlightData.lock();
 }
 
+/*
+ * GPS_INFO is updated in place by port threads and calc thread, all of them
+ * hold CritSec_FlightData : it also serialize writes to the snapshot.
+ */
+void PublishGPSInfo() {
+  GPS_INFO_Snapshot.Write(GPS_INFO);
+}
+
 void UnlockFlightData() {
   CritSec_FlightData.unlock();
 }
@@ -40,3 +48,75 @@ void LockTerrainDataGraphics() {
 void UnlockTerrainDataGraphics() {
   CritSec_TerrainDataGraphics.unlock();
 }
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <thread>
+
+TEST_CASE("SeqLock") {
+  struct data_t {
+    unsigned values[256];
+  };
+
+  SeqLock<data_t> seqlock;
+  data_t data = {};
+  CHECK_FALSE(seqlock.Read(data));
+
+  SUBCASE("reader always get consistent value") {
+    std::atomic<bool> stop = { false };
+    std::thread writer([&]() {
+      data_t value;
+      for (unsigned n = 1; !stop; ++n) {
+        std::fill(std::begin(value.values), std::end(value.values), n);
+        seqlock.Write(value);
+      }
+    });
+
+    while (!seqlock.Read(data)) {
+      std::this_thread::yield();
+    }
+
+    bool consistent = true;
+    unsigned last = 0;
+    for (unsigned i = 0; i < 10000; ++i) {
+      REQUIRE(seqlock.Read(data));
+      consistent &= std::all_of(std::begin(data.values), std::end(data.values), [&](unsigned v) {
+        return v == data.values[0];
+      });
+      consistent &= (data.values[0] >= last);
+      last = data.values[0];
+    }
+    stop = true;
+    writer.join();
+
+    CHECK(consistent);
+    CHECK(seqlock.Stats().reads == 10001);
+  }
+}
+
+TEST_CASE("StatMutex") {
+  StatMutex mutex;
+
+  mutex.lock();
+  mutex.unlock();
+  {
+    StatScopeLock lock(mutex);
+  }
+  WithLock(mutex, []() {});
+  CHECK(mutex.Stats().locks == 3);
+  CHECK(mutex.Stats().contended == 0);
+
+  mutex.lock();
+  std::thread other([&]() {
+    StatScopeLock lock(mutex);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  mutex.unlock();
+  other.join();
+
+  CHECK(mutex.Stats().locks == 5);
+  CHECK(mutex.Stats().contended == 1);
+  CHECK(mutex.Stats().wait_ms >= 10);
+}
+#endif
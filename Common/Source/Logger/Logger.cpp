@@ -79,11 +79,15 @@ namespace {
   constexpr size_t max_buffer = 60;
   std::deque<LoggerBuffer_t> LoggerBuffer;
 
-  // singleton instance of igc file writer
-  //  created by StartLogger
-  //  deleted by StopLogger
+  // singleton instance of igc file writer, only used by calculation thread.
+  //  created by LogPoint after StartLogger
+  //  deleted by LoggerCloseIfStopped after StopLogger
   std::unique_ptr<igc_file_writer> igc_writer_ptr;
 
+  // number of records between two sync of igc file to storage : with one
+  // B record each second, at most one minute of flight is lost on power failure.
+  constexpr unsigned igc_sync_interval = 60;
+
   using asset_id_t = std::array<char, 3>;
 
   template<size_t size>
@@ -102,6 +106,7 @@ void StartLogger() {
 }
 
 void StopLogger() {
+  // file is closed by calculation thread, sync to storage can be slow.
   LoggerActive = false;
 }
 
@@ -493,7 +498,7 @@ static void internal_StartLogger() {
     }
   }
 
-  igc_writer_ptr = std::make_unique<igc_file_writer>(szLoggerFilePath, LoggerGActive());
+  igc_writer_ptr = std::make_unique<igc_file_writer>(szLoggerFilePath, LoggerGActive(), igc_sync_interval);
 
   LoggerHeader(first_point, asset_id);
   LoggerTask();
@@ -511,9 +516,12 @@ static void internal_StartLogger() {
   StartupStore(_T(". Logger Started %s  File <%s>"), WhatTimeIsIt(), szLoggerFilePath);
 }
 
-static void internal_StopLogger() {
-  igc_writer_ptr = nullptr;
-  LoggerBuffer.clear();
+void LoggerCloseIfStopped() {
+  if(!LoggerActive && igc_writer_ptr) {
+    // stop Logger requested
+    igc_writer_ptr = nullptr;
+    LoggerBuffer.clear();
+  }
 }
 
 void LogPoint(const NMEA_INFO& info) {
@@ -539,10 +547,7 @@ void LogPoint(const NMEA_INFO& info) {
     }
   }
 
-  if(!LoggerActive && igc_writer_ptr) {
-    // stop Logger requested
-    internal_StopLogger();
-  }
+  LoggerCloseIfStopped();
 
   // BaroAltitude in this case is a QNE altitude (aka pressure altitude)
   // Some few instruments are sending only a cooked QNH altitude, without the relative QNH.
@@ -0,0 +1,270 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   ReplayBatch.cpp
+ */
+
+#include "externs.h"
+#include "Logger.h"
+#include "LKInterface.h"
+#include "Waypointparser.h"
+#include "AirfieldDetails.h"
+#include "McReady.h"
+#include "RasterTerrain.h"
+#include "Geoid.h"
+#include "Baro.h"
+#include "Calc/Vario.h"
+#include "Waypoints/SetHome.h"
+#include "utils/stringext.h"
+#include "utils/printf.h"
+#include "OS/Clock.hpp"
+#include <memory>
+
+extern void PreloadInitialisation(bool ask);
+extern void EnergyHeightNavAltitude(NMEA_INFO *Basic, DERIVED_INFO *Calculated);
+
+TCHAR ReplayBatch::InputName[MAX_PATH+1];
+TCHAR ReplayBatch::OutputName[MAX_PATH+1];
+
+namespace {
+
+  // same data as calculation thread, without anything related to display nor devices.
+  class replay_calculation final {
+  public:
+    replay_calculation(FILE *csv, bool replay_logger) : csv_file(csv), slow_always(replay_logger) {
+      _ftprintf(csv_file, _T("time,latitude,longitude,altitude,speed,track,"
+                             "flying,circling,final_glide,nav_altitude,altitude_agl,"
+                             "vario,netto_vario,average30s,thermal_average,"
+                             "wind_speed,wind_bearing,ld,cruise_ld,"
+                             "task_distance_to_go,task_speed,odometer,in_airspace\n"));
+    }
+
+    void Process() {
+      LockFlightData();
+      memcpy(&Basic, &GPS_INFO, sizeof(NMEA_INFO));
+      memcpy(&Calculated, &CALCULATED_INFO, sizeof(DERIVED_INFO));
+      PublishGPSInfo();
+      UnlockFlightData();
+
+      // timer is running at 2hz, emulate it from log time.
+      if (first_time < 0) {
+        first_time = Basic.Time;
+
+        // vario gain is computed from previous fix, seed it with this one,
+        // otherwise first gain is from 0m at time 0.
+        EnergyHeightNavAltitude(&Basic, &Calculated);
+        Vario(Basic, Calculated);
+        Calculated.GPSVario = 0;
+      }
+      if (Basic.Time > first_time) {
+        LKHearthBeats = std::max(LKHearthBeats, static_cast<unsigned>(2 * (Basic.Time - first_time)));
+      }
+
+      DoCalculationsVario(&Basic, &Calculated);
+      bool need_slow = DoCalculations(&Basic, &Calculated);
+      // IGC replay run in SIM mode, where calculation thread always run slow calculations.
+      if (need_slow || slow_always) {
+        DoCalculationsSlow(&Basic, &Calculated);
+      }
+
+      LockFlightData();
+      memcpy(&CALCULATED_INFO, &Calculated, sizeof(DERIVED_INFO));
+      UnlockFlightData();
+      CALCULATED_INFO_Snapshot.Write(Calculated);
+
+      // one row for each new fix, nothing before first one.
+      if (Basic.Time > last_time) {
+        last_time = Basic.Time;
+        Write();
+        ++count;
+      }
+    }
+
+    unsigned Count() const {
+      return count;
+    }
+
+  private:
+    void Write() {
+      _ftprintf(csv_file, _T("%.0f,%.6f,%.6f,%.1f,%.2f,%.1f,%d,%d,%d,%.1f,%.1f,%.2f,%.2f,%.2f,%.2f,"
+                             "%.2f,%.1f,%.1f,%.1f,%.0f,%.2f,%.0f,%d\n"),
+                Basic.Time, Basic.Latitude, Basic.Longitude, Basic.Altitude, Basic.Speed, Basic.TrackBearing,
+                Calculated.Flying, Calculated.Circling, Calculated.FinalGlide,
+                Calculated.NavAltitude, Calculated.AltitudeAGL,
+                Calculated.Vario, Calculated.NettoVario, Calculated.Average30s, Calculated.AverageThermal,
+                Calculated.WindSpeed, Calculated.WindBearing, Calculated.LD, Calculated.CruiseLD,
+                Calculated.TaskDistanceToGo, Calculated.TaskSpeed, Calculated.Odometer,
+                Calculated.IsInAirspace);
+    }
+
+    FILE *csv_file;
+    const bool slow_always;
+    double first_time = -1;
+    double last_time = 0;
+    unsigned count = 0;
+
+    NMEA_INFO Basic;
+    DERIVED_INFO Calculated;
+  };
+
+  bool IsIGCFile(const TCHAR *name) {
+    const TCHAR *ext = _tcsrchr(name, _T('.'));
+    return ext && _tcsicmp(ext, _T(".igc")) == 0;
+  }
+
+  // fixes are produced by ReplayLogger, one each second of log time like timer does.
+  void ReplayIGC(replay_calculation &calc) {
+    // as done by simulator in SIM mode, replayed fixes are always valid.
+    LockFlightData();
+    GPS_INFO.NAVWarning = false;
+    GPS_INFO.SatellitesUsed = 6;
+    UnlockFlightData();
+
+    while (ReplayLogger::UpdateFixedStep(1.0)) {
+      // integrator need a few log points before first fix, nothing to calculate before.
+      LockFlightData();
+      const bool fix = (GPS_INFO.Time > 0);
+      UnlockFlightData();
+      if (fix) {
+        calc.Process();
+      }
+    }
+  }
+
+  // sentences are parsed by generic device on port A, calculations are triggered
+  // like calculation thread, by fix update event.
+  bool ReplayNMEA(const TCHAR *name, replay_calculation &calc) {
+    TCHAR path[MAX_PATH];
+    LocalPath(path, _T(LKD_LOGS), name);
+    FILE *stream = _tfopen(path, _T("rt"));
+    if (!stream) {
+      return false;
+    }
+
+    DeviceDescriptor_t &dev = DeviceList[0];
+    dev.InitStruct(0);
+    dev.Disabled = false;
+    dev.nmeaParser.activeGPS = true;
+
+    dataTriggerEvent.reset();
+
+    char line[MAX_NMEA_LEN];
+    while (fgets(line, std::size(line), stream)) {
+      TCHAR nmea[MAX_NMEA_LEN];
+      from_utf8(line, nmea);
+      dev.nmeaParser.ParseNMEAString_Internal(dev, nmea, &GPS_INFO);
+
+      if (dataTriggerEvent.tryWait(0)) {
+        dataTriggerEvent.reset();
+        calc.Process();
+      }
+    }
+    fclose(stream);
+
+    dev.InitStruct(0);
+    return true;
+  }
+
+} // namespace
+
+
+void ReplayBatch::SetInput(const TCHAR *name) {
+  LK_tcsncpy(InputName, name, MAX_PATH);
+}
+
+void ReplayBatch::SetOutput(const TCHAR *name) {
+  LK_tcsncpy(OutputName, name, MAX_PATH);
+}
+
+bool ReplayBatch::IsRequested() {
+  return InputName[0] != _T('\0');
+}
+
+bool ReplayBatch::Run() {
+
+  const bool igc = IsIGCFile(InputName);
+  if (OutputName[0] == _T('\0')) {
+    lk::snprintf(OutputName, _T("%s.csv"), InputName);
+  }
+
+  StartupStore(_T(". Headless replay of <%s> to <%s>%s"), InputName, OutputName, NEWLINE);
+
+  CreateDirectoryIfAbsent(TEXT(LKD_LOGS));
+
+  memset(&(Task), 0, sizeof(Task_t));
+  memset(&(StartPoints), 0, sizeof(Start_t));
+  ClearTask();
+  memset(&(GPS_INFO), 0, sizeof(GPS_INFO));
+  memset(&(CALCULATED_INFO), 0, sizeof(CALCULATED_INFO));
+
+  FullTrail.Clear();
+
+  ResetBaroAvailable(GPS_INFO);
+  ResetVarioAvailable(GPS_INFO);
+  InitCalculations(&GPS_INFO, &CALCULATED_INFO);
+
+  OpenGeoid();
+
+  // profiles without startup dialog, IGC replay is only available in SIM mode.
+  PreloadInitialisation(true);
+  RUN_MODE = igc ? RUN_SIM : RUN_FLY;
+  EnableSoundModes = false;
+
+  GPS_INFO.NAVWarning = true;
+
+  // nobody to answer, waypoints out of terrain are included as with default settings.
+  if (WaypointsOutOfRange == 0) {
+    WaypointsOutOfRange = 1;
+  }
+
+  ReadWinPilotPolar();
+
+  RasterTerrain::OpenTerrain();
+
+  ReadWayPoints();
+  InitLDRotary(&rotaryLD);
+  InitWindRotary(&rotaryWind);
+  InitLK8000();
+  ReadAirfieldFile();
+  SetHome(false);
+
+  CAirspaceManager::Instance().ReadAirspaces(false);
+  CAirspaceManager::Instance().SortAirspaces();
+
+  GlidePolar::SetBallast();
+
+  TCHAR csv_path[MAX_PATH];
+  LocalPath(csv_path, _T(LKD_LOGS), OutputName);
+  FILE *csv = _tfopen(csv_path, _T("wt"));
+  if (!csv) {
+    StartupStore(_T("... Headless replay, failed to create <%s>%s"), csv_path, NEWLINE);
+    return false;
+  }
+
+  // too big for stack
+  auto calc_ptr = std::make_unique<replay_calculation>(csv, igc);
+  replay_calculation& calc = *calc_ptr;
+
+  const unsigned start_ms = MonotonicClockMS();
+  bool success = true;
+  if (igc) {
+    ReplayLogger::SetFilename(InputName);
+    ReplayIGC(calc);
+  } else {
+    success = ReplayNMEA(InputName, calc);
+  }
+  const unsigned elapsed_ms = MonotonicClockMS() - start_ms;
+
+  fclose(csv);
+
+  if (!success || calc.Count() == 0) {
+    StartupStore(_T("... Headless replay, no fix found in <%s>%s"), InputName, NEWLINE);
+    return false;
+  }
+
+  StartupStore(_T(". Headless replay done, %u fixes in %u ms (%.0f fixes/s)%s"), calc.Count(), elapsed_ms,
+               calc.Count() * 1000. / std::max(elapsed_ms, 1U), NEWLINE);
+  return true;
+}
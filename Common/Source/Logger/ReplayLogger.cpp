@@ -299,8 +299,12 @@ private:
 // IGC time of replay running log
 double ReplayTime=0;
 
+// true until first point of replay is processed
+static bool init=true;
+
+static CatmullRomInterpolator cli;
+
 bool ReplayLogger::UpdateInternal(void) {
-  static bool init=true;
 
   if (!Enabled) {
     init = true;
@@ -308,8 +312,6 @@ bool ReplayLogger::UpdateInternal(void) {
     Enabled = true;
   }
 
-  static CatmullRomInterpolator cli;
-
   time_t rawtime;
   struct tm tm_temp= {};
   struct tm * timeinfo;
@@ -324,25 +326,34 @@ bool ReplayLogger::UpdateInternal(void) {
   static double time=0;
   double deltatimereal;
 
-  bool finished = false;
-
   double timelast = time;
 
   time = (timeinfo->tm_hour*3600+timeinfo->tm_min*60+timeinfo->tm_sec-time_lstart);
   deltatimereal = time-timelast;
 
   if (init) {
-#if DEBUG_REPLAY
-    StartupStore(_T("........ REPLAY: UpdateInternal init\n"));
-#endif
     time_lstart = time;
     time = 0;
     deltatimereal = 0;
+  }
+
+  return Advance(TimeScale*deltatimereal);
+}
+
+bool ReplayLogger::Advance(double deltatime) {
+
+  bool finished = false;
+
+  if (init) {
+#if DEBUG_REPLAY
+    StartupStore(_T("........ REPLAY: UpdateInternal init\n"));
+#endif
+    deltatime = 0;
     ReplayTime = 0;
     cli.Reset();
   }
 
-  ReplayTime += TimeScale*deltatimereal;
+  ReplayTime += deltatime;
 
 #if DEBUG_REPLAY
   TCHAR tutc[20];
@@ -461,3 +472,14 @@ bool ReplayLogger::Update(void) {
   Enabled = UpdateInternal();
   return Enabled;
 }
+
+bool ReplayLogger::UpdateFixedStep(double seconds) {
+  if (!Enabled) {
+    init = true;
+    ReadLine(NULL); // close file
+    Enabled = true;
+  }
+
+  Enabled = Advance(seconds);
+  return Enabled;
+}
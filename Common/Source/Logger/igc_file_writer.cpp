@@ -9,9 +9,15 @@
  * Created on 16 january 2018
  */
 
+#include "options.h"
 #include "igc_file_writer.h"
 #include <cstdio>
 #include <cassert>
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#elif !defined(_WIN32_WCE)
+#include <io.h>
+#endif
 
 namespace {
   // return c if valid char for IGC files
@@ -25,62 +31,287 @@ namespace {
     return ' ';
   }
 
-  void write_g_record(FILE *stream, const MD5_Base &md5) {
-    // we made copy to allow to continue to update hash after Final call.
-    MD5 md5_tmp(md5);
-    std::string digest = md5_tmp.Final();
-    if (digest.size() >= 32) {
-      fwrite("G", 1, 1, stream);
-      fwrite(digest.data(), 1, 16, stream);
-      fwrite("\r\nG", 1, 3, stream);
-      fwrite(digest.data() + 16, 1, 16, stream);
-      fwrite("\r\n", 1, 2, stream);
+  // write stream buffer to file and ask OS to write file to storage.
+  bool sync_stream(FILE *stream) {
+    if (fflush(stream) != 0) {
+      return false;
     }
+#ifdef HAVE_POSIX
+    return fsync(fileno(stream)) == 0;
+#elif !defined(_WIN32_WCE)
+    return _commit(_fileno(stream)) == 0;
+#else
+    return true;
+#endif
   }
 } // namespace
 
-igc_file_writer::igc_file_writer(const TCHAR *file, bool grecord)
-    : file_path(file), add_grecord(grecord) {
+igc_file_writer::igc_file_writer(const TCHAR *file, bool grecord, unsigned sync)
+    : file_path(file), add_grecord(grecord), sync_interval(sync) {
+
+}
 
+igc_file_writer::~igc_file_writer() {
+  if (stream && unsynced_records) {
+    sync_stream(stream.get());
+  }
 }
 
+void igc_file_writer::append_g_record(const MD5_Base &md5) {
+  // we made copy to allow to continue to update hash after Final call.
+  MD5 md5_tmp(md5);
+  std::string digest = md5_tmp.Final();
+  if (digest.size() >= 32) {
+    buffer += 'G';
+    buffer.append(digest.data(), 16);
+    buffer += "\r\nG";
+    buffer.append(digest.data() + 16, 16);
+    buffer += "\r\n";
+  }
+}
 
 bool igc_file_writer::append(const char *data, size_t size) {
 
-  FILE *stream = _tfopen(file_path.c_str(), _T("rb+"));
   if (!stream) {
-    stream = _tfopen(file_path.c_str(), _T("wb"));
+    stream.reset(_tfopen(file_path.c_str(), _T("rb+")));
+    if (!stream) {
+      stream.reset(_tfopen(file_path.c_str(), _T("wb")));
+    }
   }
   assert(stream); // invalid file path or missing right on target directory ?
-  if (stream) {
-    fseek(stream, next_record_position, SEEK_SET);
-
-    for (; *(data) && size > 1; ++data, --size) {
-      if ((*data) != 0x0D && (*data) != 0x0A) {
-        char c = clean_igc_char(*data);
-
-        if (add_grecord) {
-          md5_a.Update(c);
-          md5_b.Update(c);
-          md5_c.Update(c);
-          md5_d.Update(c);
+  if (!stream) {
+    return false;
+  }
+
+  buffer.clear();
+
+  // CR and LF are not part of G record hash, hash is updated once for each
+  // run of chars between them.
+  size_t hash_start = 0;
+  auto update_hash = [&]() {
+    if (add_grecord && buffer.size() > hash_start) {
+      const char *begin = buffer.data() + hash_start;
+      const size_t length = buffer.size() - hash_start;
+      md5_a.Update(begin, length);
+      md5_b.Update(begin, length);
+      md5_c.Update(begin, length);
+      md5_d.Update(begin, length);
+    }
+  };
+
+  for (; *(data) && size > 1; ++data, --size) {
+    if ((*data) != 0x0D && (*data) != 0x0A) {
+      buffer += clean_igc_char(*data);
+    } else {
+      update_hash();
+      buffer += (*data);
+      hash_start = buffer.size();
+    }
+  }
+  update_hash();
+
+  // previous G record is overwritten by this record.
+  const long record_position = next_record_position;
+  next_record_position += buffer.size();
+
+  if (add_grecord) {
+    append_g_record(md5_a);
+    append_g_record(md5_b);
+    append_g_record(md5_c);
+    append_g_record(md5_d);
+  }
+
+  fseek(stream.get(), record_position, SEEK_SET);
+  bool success = (fwrite(buffer.data(), 1, buffer.size(), stream.get()) == buffer.size());
+
+  ++unsynced_records;
+  if (sync_interval && unsynced_records >= sync_interval) {
+    success = sync_stream(stream.get()) && success;
+    unsynced_records = 0;
+  } else {
+    // file stays complete for any reader and if app is killed, only
+    // storage sync is delayed.
+    success = (fflush(stream.get()) == 0) && success;
+  }
+  return success;
+}
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include "utils/filesystem.h"
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+  // writer used before file was kept open, used as reference.
+  class legacy_igc_writer {
+  public:
+    legacy_igc_writer(const TCHAR *file, bool grecord) : file_path(file), add_grecord(grecord) { }
+
+    template <size_t size>
+    bool append(const char (&data)[size]) {
+      return append(data, size);
+    }
+
+  private:
+    void write_g_record(FILE *stream, const MD5_Base &md5) {
+      MD5 md5_tmp(md5);
+      std::string digest = md5_tmp.Final();
+      if (digest.size() >= 32) {
+        fwrite("G", 1, 1, stream);
+        fwrite(digest.data(), 1, 16, stream);
+        fwrite("\r\nG", 1, 3, stream);
+        fwrite(digest.data() + 16, 1, 16, stream);
+        fwrite("\r\n", 1, 2, stream);
+      }
+    }
+
+    bool append(const char *data, size_t size) {
+      FILE *stream = _tfopen(file_path.c_str(), _T("rb+"));
+      if (!stream) {
+        stream = _tfopen(file_path.c_str(), _T("wb"));
+      }
+      if (!stream) {
+        return false;
+      }
+      fseek(stream, next_record_position, SEEK_SET);
+      for (; *(data) && size > 1; ++data, --size) {
+        if ((*data) != 0x0D && (*data) != 0x0A) {
+          char c = clean_igc_char(*data);
+          if (add_grecord) {
+            for (auto& md5 : md5_list) {
+              md5.Update(c);
+            }
+          }
+          fwrite(&c, 1, 1, stream);
+        } else {
+          fwrite(data, 1, 1, stream);
+        }
+      }
+      next_record_position = ftell(stream);
+      if (add_grecord) {
+        for (auto& md5 : md5_list) {
+          write_g_record(stream, md5);
         }
-        fwrite(&c, 1, 1, stream);
-      } else {
-        fwrite(data, 1, 1, stream);
       }
+      fclose(stream);
+      return true;
     }
 
-    next_record_position = ftell(stream);
+    const tstring file_path;
+    const bool add_grecord;
+    long next_record_position = 0;
 
-    if (add_grecord) {
-      write_g_record(stream, md5_a);
-      write_g_record(stream, md5_b);
-      write_g_record(stream, md5_c);
-      write_g_record(stream, md5_d);
+    MD5_Base md5_list[4] = {
+      {0x63e54c01, 0x25adab89, 0x44baecfe, 0x60f25476},
+      {0x41e24d03, 0x23b8ebea, 0x4a4bfc9e, 0x640ed89a},
+      {0x61e54e01, 0x22cdab89, 0x48b20cfe, 0x62125476},
+      {0xc1e84fe8, 0x21d1c28a, 0x438e1a12, 0x6c250aee}
+    };
+  };
+
+  // test files are written in temporary directory
+  tstring temp_path(const TCHAR *name) {
+    TCHAR path[256];
+    if (!lk::filesystem::getTempPath(path, std::size(path))) {
+      path[0] = _T('\0');
     }
-    fclose(stream);
-    return true;
+    return tstring(path) + name;
+  }
+
+  std::string read_file(const TCHAR *path) {
+    std::ifstream file(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+  }
+
+  template<typename Writer>
+  void write_test_records(Writer &writer, unsigned index) {
+    char record[80];
+    snprintf(record, std::size(record), "B%02u%02u%02u4553%03uN00612%03uEA%05u%05u\r\n",
+             10 + (index / 3600) % 10, (index / 60) % 60, index % 60,
+             index % 1000, (index * 7) % 1000, 1000 + index % 2000, 1020 + index % 2000);
+    writer.append(record);
+  }
+
+} // namespace
+
+TEST_SUITE("igc_file_writer") {
+
+  TEST_CASE("same file as legacy writer") {
+    const tstring legacy_file = temp_path(_T("igc_file_writer_legacy.igc"));
+    const tstring file = temp_path(_T("igc_file_writer_test.igc"));
+    const TCHAR *legacy_path = legacy_file.c_str();
+    const TCHAR *path = file.c_str();
+
+    for (bool grecord : { true, false }) {
+      CAPTURE(grecord);
+      lk::filesystem::deleteFile(legacy_path);
+      lk::filesystem::deleteFile(path);
+      {
+        legacy_igc_writer legacy(legacy_path, grecord);
+        igc_file_writer writer(path, grecord, 7);
+
+        // invalid chars, line break inside record and data after nul char.
+        const char header[] = "HFPLTPILOTINCHARGE: Jo*hn, D$oe!\r\nHFGTYGLIDERTYPE:\nLS 4\r\n\0LXXX";
+        const char empty[] = "";
+        legacy.append(header);
+        writer.append(header);
+        legacy.append(empty);
+        writer.append(empty);
+
+        for (unsigned i = 0; i < 100; ++i) {
+          write_test_records(legacy, i);
+          write_test_records(writer, i);
+          if (i % 10 == 0) {
+            // file must be valid while writer is still open.
+            CHECK(read_file(path) == read_file(legacy_path));
+          }
+        }
+      }
+      const std::string expected = read_file(legacy_path);
+      CHECK(expected.size() > 100 * 37);
+      CHECK(read_file(path) == expected);
+    }
+
+    lk::filesystem::deleteFile(legacy_path);
+    lk::filesystem::deleteFile(path);
+  }
+
+  TEST_CASE("benchmark" * doctest::skip()) {
+    const tstring file = temp_path(_T("igc_file_writer_bench.igc"));
+    const TCHAR *path = file.c_str();
+    constexpr unsigned count = 3600;
+
+    using clock = std::chrono::steady_clock;
+
+    lk::filesystem::deleteFile(path);
+    auto t0 = clock::now();
+    {
+      legacy_igc_writer legacy(path, true);
+      for (unsigned i = 0; i < count; ++i) {
+        write_test_records(legacy, i);
+      }
+    }
+    auto t1 = clock::now();
+    lk::filesystem::deleteFile(path);
+    auto t2 = clock::now();
+    {
+      igc_file_writer writer(path, true, 60);
+      for (unsigned i = 0; i < count; ++i) {
+        write_test_records(writer, i);
+      }
+    }
+    auto t3 = clock::now();
+    lk::filesystem::deleteFile(path);
+
+    auto records_per_second = [&](clock::duration d) {
+      return count / std::chrono::duration<double>(d).count();
+    };
+    MESSAGE("legacy writer : " << records_per_second(t1 - t0) << " records/s");
+    MESSAGE("igc_file_writer : " << records_per_second(t3 - t2) << " records/s");
   }
-  return false;
 }
+
+#endif
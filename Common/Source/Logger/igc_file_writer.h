@@ -16,6 +16,9 @@
 #include "tchar.h"
 #include "Util/tstring.hpp"
 #include "md5.h"
+#include <cstdio>
+#include <memory>
+#include <string>
 
 class igc_file_writer final {
 
@@ -28,7 +31,15 @@ class igc_file_writer final {
 
 public:
 
-  igc_file_writer(const TCHAR *file, bool grecord);
+  /**
+   * @file : full path of target igc file
+   * @grecord : true if G record must be added to file
+   * @sync_interval : number of records between two flush of file to storage,
+   *                  0 to sync only when file is closed.
+   */
+  igc_file_writer(const TCHAR *file, bool grecord, unsigned sync_interval);
+
+  ~igc_file_writer();
 
   template <size_t size> 
   bool append(const char (&data)[size]) {
@@ -39,8 +50,17 @@ public:
 private:
   bool append(const char *data, size_t size);
 
+  void append_g_record(const MD5_Base &md5);
+
   const tstring file_path; /** full path of target igc file */
   const bool add_grecord; /** true if G record must be added to file */
+  const unsigned sync_interval; /** number of records between two sync */
+
+  /** file is opened by first append and kept open until writer is destroyed */
+  std::unique_ptr<FILE, decltype(&fclose)> stream = { nullptr, &fclose };
+
+  std::string buffer; /** record and G record to write */
+  unsigned unsynced_records = 0;
 
   long next_record_position = 0; /** position of G record */
 
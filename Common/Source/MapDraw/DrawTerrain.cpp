@@ -35,6 +35,13 @@
    */
   #warning "too old compiler, optimized terrain drawing disabled"
  #endif
+#elif defined(__SSE2__) && (defined(__x86_64__) || defined(__SSE2_MATH__))
+ /*
+  * SSE2 slope shading give same result than scalar code only if scalar
+  * float math also use SSE (not x87 extended precision).
+  */
+ #define HAVE_TERRAIN_SSE2
+ #include <emmintrin.h>
 #endif
 
 extern bool FastZoom;
@@ -151,6 +158,198 @@ inline T TerrainShading(const int16_t illum, const T& color) {
   return color;
 }
 
+/**
+ * input of slope shading for one row of height buffer.
+ */
+struct SlopeShadingRow {
+  const int16_t* prev_row;
+  const int16_t* curr_row;
+  const int16_t* next_row;
+  size_t ixs;
+  unsigned epx;
+  float p31;
+  float p31s;
+  int sx, sy, sz;
+  int16_t height_min;
+  unsigned height_scale;
+};
+
+/**
+ * slope shading of pixels [begin, end) of @row,
+ *  @put(x, h, mag) is called for each pixel.
+ */
+template<typename Put>
+inline void SlopeShadingScalar(const SlopeShadingRow& row, size_t begin, size_t end, Put&& put) {
+    for (size_t x = begin; x < end; ++x) {
+        const size_t prev_col_index =  (x < row.epx) ? 0 : x - row.epx;
+        const size_t next_col_index =  (x + row.epx >= row.ixs) ? row.ixs - 1 : x + row.epx;
+
+        const int16_t& up =     row.prev_row[x];
+        const int16_t& bottom = row.next_row[x];
+        const int16_t& left =   row.curr_row[prev_col_index];
+        const int16_t& right =  row.curr_row[next_col_index];
+
+        const int32_t p20 = next_col_index - prev_col_index;
+        const int32_t p22 = right - left;
+        const int32_t p32 = bottom - up;
+
+        int32_t dd0 = p22 * row.p31;
+        int32_t dd1 = p20 * p32;
+        int32_t dd2 = p20 * row.p31s;
+
+        // prevent overflow of magnitude calculation
+        const int32_t scale = (dd2 / 512) + 1;
+        dd0 /= scale;
+        dd1 /= scale;
+        dd2 /= scale;
+
+        // unsigned math : invalid terrain can overflow int32, wrap around instead of undefined behavior
+        const uint32_t udd0 = dd0, udd1 = dd1, udd2 = dd2;
+        const uint32_t sqr_mag = (udd0 * udd0 + udd1 * udd1 + udd2 * udd2);
+        int32_t mag = (udd2 * row.sz + udd0 * row.sx + udd1 * row.sy) / (isqrt4(sqr_mag)|1);
+        mag = Clamp<int32_t>((mag - row.sz), -64, 63);
+
+        // when h is invalid, result is clamped to 255 so we have invalid terrain color
+        int16_t h =  *(row.curr_row + x);
+        h = ((h - row.height_min) >> row.height_scale);
+        h = Clamp<int16_t>(h, 0, 255);
+
+        put(x, h, mag);
+    }
+}
+
+#ifdef HAVE_TERRAIN_SSE2
+
+// load 4 int16 and sign extend to int32
+inline __m128i load_epi16_epi32(const int16_t* p) {
+    const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+    return _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+}
+
+// low 32 bits of a * b, same result as int32 overflow (_mm_mullo_epi32 is SSE4.1)
+inline __m128i mullo_epi32(__m128i a, __m128i b) {
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// a / b rounded toward zero, double division is exact enough for all int32 values
+inline __m128i div_epi32(__m128i a, __m128d b) {
+    const __m128d lo = _mm_div_pd(_mm_cvtepi32_pd(a), b);
+    const __m128d hi = _mm_div_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2))), b);
+    return _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+}
+
+// convert lanes 0 & 1 of unsigned int32 to double
+inline __m128d cvtepu32_pd(__m128i v) {
+    const __m128d d = _mm_cvtepi32_pd(v);
+    return _mm_add_pd(d, _mm_and_pd(_mm_cmplt_pd(d, _mm_setzero_pd()), _mm_set1_pd(4294967296.)));
+}
+
+/**
+ * unsigned a / b, result truncated to int32 like scalar code.
+ *  b must be in [1, 0x7FFFFFFF] range.
+ */
+inline __m128i udiv_epu32(__m128i a, __m128i b) {
+    const __m128i a_hi = _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2));
+    const __m128i b_hi = _mm_shuffle_epi32(b, _MM_SHUFFLE(1, 0, 3, 2));
+    const __m128d lo = _mm_div_pd(cvtepu32_pd(a), _mm_cvtepi32_pd(b));
+    const __m128d hi = _mm_div_pd(cvtepu32_pd(a_hi), _mm_cvtepi32_pd(b_hi));
+    // for b > 1, quotient is always less than 2^31
+    const __m128i q = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+    const __m128i one = _mm_cmpeq_epi32(b, _mm_set1_epi32(1));
+    return _mm_or_si128(_mm_and_si128(one, a), _mm_andnot_si128(one, q));
+}
+
+// unsigned int32 to float, rounded once like scalar conversion
+inline __m128 cvtepu32_ps(__m128i v) {
+    const __m128 hi = _mm_cvtepi32_ps(_mm_srli_epi32(v, 16));
+    const __m128 lo = _mm_cvtepi32_ps(_mm_and_si128(v, _mm_set1_epi32(0xFFFF)));
+    return _mm_add_ps(_mm_mul_ps(hi, _mm_set1_ps(65536.f)), lo);
+}
+
+/**
+ * same as SlopeShadingScalar(row, 0, row.ixs, put), 4 pixels at once.
+ *  left and right border (epx pixels) use scalar code.
+ */
+template<typename Put>
+inline void SlopeShadingSSE2(const SlopeShadingRow& row, Put&& put) {
+    const size_t epx = row.epx;
+
+    size_t x = std::min<size_t>(epx, row.ixs);
+    SlopeShadingScalar(row, 0, x, put);
+
+    // inside border, p20 is constant so dd2 and scale also.
+    const int32_t p20 = epx + epx;
+    int32_t dd2 = p20 * row.p31s;
+    const int32_t scale = (dd2 / 512) + 1;
+    dd2 /= scale;
+
+    const __m128d v_scale = _mm_set1_pd(scale);
+    const __m128 v_p31 = _mm_set1_ps(row.p31);
+    const __m128i v_p20 = _mm_set1_epi32(p20);
+    const __m128i v_sqr_dd2 = _mm_set1_epi32(dd2 * dd2);
+    const __m128i v_dd2_sz = _mm_set1_epi32(dd2 * row.sz);
+    const __m128i v_sx = _mm_set1_epi32(row.sx);
+    const __m128i v_sy = _mm_set1_epi32(row.sy);
+    const __m128i v_sz = _mm_set1_epi32(row.sz);
+    const __m128i v_one = _mm_set1_epi32(1);
+
+    const __m128i v_height_min = _mm_set1_epi32(row.height_min);
+    const __m128i v_height_scale = _mm_cvtsi32_si128(row.height_scale);
+
+    const __m128i mag_min = _mm_set1_epi16(-64);
+    const __m128i mag_max = _mm_set1_epi16(63);
+    const __m128i height_0 = _mm_setzero_si128();
+    const __m128i height_255 = _mm_set1_epi16(255);
+
+    for (; x + epx + 4 <= row.ixs; x += 4) {
+        const __m128i up = load_epi16_epi32(row.prev_row + x);
+        const __m128i bottom = load_epi16_epi32(row.next_row + x);
+        const __m128i left = load_epi16_epi32(row.curr_row + x - epx);
+        const __m128i right = load_epi16_epi32(row.curr_row + x + epx);
+
+        const __m128i p22 = _mm_sub_epi32(right, left);
+        const __m128i p32 = _mm_sub_epi32(bottom, up);
+
+        __m128i dd0 = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(p22), v_p31));
+        __m128i dd1 = mullo_epi32(v_p20, p32);
+
+        dd0 = div_epi32(dd0, v_scale);
+        dd1 = div_epi32(dd1, v_scale);
+
+        const __m128i sqr_mag = _mm_add_epi32(_mm_add_epi32(mullo_epi32(dd0, dd0), mullo_epi32(dd1, dd1)), v_sqr_dd2);
+        const __m128i root = _mm_or_si128(_mm_cvttps_epi32(_mm_sqrt_ps(cvtepu32_ps(sqr_mag))), v_one);
+
+        const __m128i dot = _mm_add_epi32(_mm_add_epi32(v_dd2_sz, mullo_epi32(dd0, v_sx)), mullo_epi32(dd1, v_sy));
+        const __m128i mag32 = _mm_sub_epi32(udiv_epu32(dot, root), v_sz);
+
+        __m128i mag = _mm_packs_epi32(mag32, mag32);
+        mag = _mm_min_epi16(_mm_max_epi16(mag, mag_min), mag_max);
+
+        // (h - height_min) >> height_scale, truncated to int16
+        __m128i h = _mm_sra_epi32(_mm_sub_epi32(load_epi16_epi32(row.curr_row + x), v_height_min), v_height_scale);
+        h = _mm_srai_epi32(_mm_slli_epi32(h, 16), 16);
+        h = _mm_packs_epi32(h, h);
+        h = _mm_min_epi16(_mm_max_epi16(h, height_0), height_255);
+
+        alignas(16) int16_t h_out[8];
+        alignas(16) int16_t mag_out[8];
+        _mm_store_si128(reinterpret_cast<__m128i*>(h_out), h);
+        _mm_store_si128(reinterpret_cast<__m128i*>(mag_out), mag);
+
+        put(x,     h_out[0], mag_out[0]);
+        put(x + 1, h_out[1], mag_out[1]);
+        put(x + 2, h_out[2], mag_out[2]);
+        put(x + 3, h_out[3], mag_out[3]);
+    }
+
+    SlopeShadingScalar(row, x, row.ixs, put);
+}
+
+#endif // HAVE_TERRAIN_SSE2
+
 } // namespace
 
 // map scale is approximately 2 points on the grid
@@ -342,73 +541,193 @@ public:
                                      std::abs(GeoCenter.latitude - GeoNearby.latitude)/3);
 
         epx = DisplayMap->GetEffectivePixelSize(&pixelsize_d, GeoCenter.latitude, GeoCenter.longitude);
-        epx = std::max(4u, (epx / 4u ) * 4u); // "epx" must be divisible by 4 for compatibility with ARM NEON vectorized shadding algorithm
+        epx = std::max(4u, (epx / 4u ) * 4u); // "epx" must be divisible by 4 for compatibility with ARM NEON & SSE2 vectorized shadding algorithm
 
         RasterPoint orig = RasterPoint(MapWindow::GetOrigScreen()) - offset;
 
+        const HeightProjection projection = {
+                MapWindow::GetPanLatitude(),
+                MapWindow::GetPanLongitude(),
+                MapWindow::GetInvDrawScale() / 1024.0,
+                ifastcosine(MapWindow::GetDisplayAngle()),
+                ifastsine(MapWindow::GetDisplayAngle()),
+                X0 - orig.x,
+                Y0 - orig.y,
+                DisplayMap->GetSerial(),
+                DisplayMap->GetXRounding(),
+                DisplayMap->GetYRounding()
+        };
+
         if(DisplayMap->interpolate()) {
 
-            FillHeightBuffer(X0 - orig.x, Y0 - orig.y, X1 - orig.x, Y1 - orig.y,
+            FillHeightBuffer(projection,
                     [DisplayMap](const double &lat, const double &lon) {
                         return DisplayMap->GetFieldInterpolate(lat,lon);
                     });
         } else {
 
-            FillHeightBuffer(X0 - orig.x, Y0 - orig.y, X1 - orig.x, Y1 - orig.y,
+            FillHeightBuffer(projection,
                     [DisplayMap](const double &lat, const double &lon) {
                           return DisplayMap->GetFieldFine(lat,lon);
                     });
         }
     }
 
+private:
+
+    /**
+     * parameters used to convert height buffer cell to geographic coordinate.
+     */
+    struct HeightProjection {
+        double PanLatitude;
+        double PanLongitude;
+        double InvDrawScale;
+        int cost;
+        int sint;
+        int X0; // screen position of first cell, relative to projection origin
+        int Y0;
+        unsigned serial;  // terrain and rounding used to fill buffer
+        int xrounding;
+        int yrounding;
+
+        // true if buffer filled with @other can be scrolled to match this.
+        bool CanScroll(const HeightProjection& other) const {
+            return InvDrawScale == other.InvDrawScale
+                && cost == other.cost && sint == other.sint
+                && serial == other.serial
+                && xrounding == other.xrounding && yrounding == other.yrounding;
+        }
+    };
+
+    /**
+     * projection used for last full refill of height buffer, and current
+     * shift (in cells) of buffer content relative to it.
+     */
+    HeightProjection height_anchor = {};
+    int height_shift_x = 0;
+    int height_shift_y = 0;
+    bool height_anchor_valid = false;
+
+    /**
+     * on pure translation (same scale, rotation and terrain rounding), keep
+     * overlapping part of height buffer and sample only newly exposed cells.
+     *
+     * All cells are sampled on the grid of the last full refill, so content is
+     * consistent, and shifted to nearest cell of current projection.
+     *
+     * @return false if full refill is required.
+     */
+    bool ScrollHeightBuffer(const HeightProjection& proj, int& dx, int& dy) {
+        if (!height_anchor_valid || !proj.CanScroll(height_anchor)) {
+            return false;
+        }
+
+        const HeightProjection& anchor = height_anchor;
+
+        // position of current projection origin in anchor screen coordinate
+        const double ac2 = anchor.sint * anchor.InvDrawScale;
+        const double ac3 = anchor.cost * anchor.InvDrawScale;
+        const double u = (proj.PanLongitude - anchor.PanLongitude) / invfastcosine(proj.PanLatitude);
+        const double v = anchor.PanLatitude - proj.PanLatitude;
+        const double det = ac2 * ac2 + ac3 * ac3;
+        if (det <= 0) {
+            return false;
+        }
+        const double px = (ac3 * u + ac2 * v) / det;
+        const double py = (ac3 * v - ac2 * u) / det;
+
+        const int shift_x = lround((proj.X0 + px - anchor.X0) / dtquant);
+        const int shift_y = lround((proj.Y0 + py - anchor.Y0) / dtquant);
+
+        // far from anchor, overlap is small and anchor grid drift from current projection.
+        const int col_count = height_buffer->GetWidth();
+        const int row_count = height_buffer->GetHeight();
+        if (std::abs(shift_x) > col_count / 2 || std::abs(shift_y) > row_count / 2) {
+            return false;
+        }
+
+        dx = shift_x - height_shift_x;
+        dy = shift_y - height_shift_y;
+
+        height_shift_x = shift_x;
+        height_shift_y = shift_y;
+
+        height_buffer->Scroll(dx, dy);
+        return true;
+    }
+
     /**
      * Attention ! never call this without check if map is loaded.
      *
      * template avoid to test if interpolation is needed for each pixel.
      */
     template<typename GetHeight_t>
-    void FillHeightBuffer(const int X0, const int Y0, const int X1, const int Y1, GetHeight_t GetHeight) {
+    void FillHeightBuffer(const HeightProjection& proj, GetHeight_t GetHeight) {
         // fill the buffer
         assert(height_buffer && height_buffer->GetBuffer());
 
-        const double PanLatitude = MapWindow::GetPanLatitude();
-        const double PanLongitude = MapWindow::GetPanLongitude();
-        const double InvDrawScale = MapWindow::GetInvDrawScale() / 1024.0;
-        const double DisplayAngle = MapWindow::GetDisplayAngle();
-
-        const int cost = ifastcosine(DisplayAngle);
-        const int sint = ifastsine(DisplayAngle);
+        const int col_count = height_buffer->GetWidth();
+        const int row_count = height_buffer->GetHeight();
+
+        int dx = 0, dy = 0;
+        if (ScrollHeightBuffer(proj, dx, dy)) {
+            // rows exposed by vertical scroll
+            const int row_begin = (dy > 0) ? std::max(0, row_count - dy) : 0;
+            const int row_end = (dy > 0) ? row_count : std::min(row_count, -dy);
+            FillHeightRect(0, row_begin, col_count, row_end, GetHeight);
+
+            // columns exposed by horizontal scroll, without rows already filled
+            const int col_begin = (dx > 0) ? std::max(0, col_count - dx) : 0;
+            const int col_end = (dx > 0) ? col_count : std::min(col_count, -dx);
+            const int first_row = (dy < 0) ? row_end : 0;
+            const int last_row = (dy > 0) ? row_begin : row_count;
+            FillHeightRect(col_begin, first_row, col_end, last_row, GetHeight);
+        } else {
+            height_anchor = proj;
+            height_anchor_valid = true;
+            height_shift_x = 0;
+            height_shift_y = 0;
+            FillHeightRect(0, 0, col_count, row_count, GetHeight);
+        }
 
-        const double ac2 = sint*InvDrawScale;
-        const double ac3 = cost*InvDrawScale;
+        UpdateHeightRange();
+    }
 
-        height_scale = 0;
+    /**
+     * sample cells [col_begin, col_end) x [row_begin, row_end) of height buffer,
+     * using #height_anchor projection and current shift.
+     */
+    template<typename GetHeight_t>
+    void FillHeightRect(int col_begin, int row_begin, int col_end, int row_end, GetHeight_t GetHeight) {
+        if (col_begin >= col_end || row_begin >= row_end) {
+            return;
+        }
 
-        // we need local variable for compatibility with all implementation of opemmp reduction
-        int16_t _height_min = std::numeric_limits<int16_t>::max();
-        int16_t _height_max = std::numeric_limits<int16_t>::min();
+        const HeightProjection& proj = height_anchor;
+        const double PanLatitude = proj.PanLatitude;
+        const double PanLongitude = proj.PanLongitude;
 
-        const size_t col_count = height_buffer->GetWidth();
-        const size_t row_count = height_buffer->GetHeight();
+        const double ac2 = proj.sint * proj.InvDrawScale;
+        const double ac3 = proj.cost * proj.InvDrawScale;
 
+        const int X0 = proj.X0 + height_shift_x * static_cast<int>(dtquant);
+        const int Y0 = proj.Y0 + height_shift_y * static_cast<int>(dtquant);
 
 #if defined(_OPENMP)
-        #pragma omp parallel for reduction(max : _height_max) reduction(min : _height_min)
+        #pragma omp parallel for
 #endif
-        for (size_t iy = 0; iy < row_count; ++iy) {
+        for (int iy = row_begin; iy < row_end; ++iy) {
             const int y = Y0 + (iy*dtquant);
             const double ac1 = PanLatitude - y*ac3;
             const double cc1 = y * ac2;
 
             int16_t *height_row = height_buffer->GetRow(iy);
 
-            for (size_t ix = 0; ix < col_count; ++ix) {
+            for (int ix = col_begin; ix < col_end; ++ix) {
                 const int x = X0 + (ix*dtquant);
                 const double Y = ac1 - x*ac2;
                 const double X = PanLongitude + (invfastcosine(Y) * ((x * ac3) - cc1));
 
-                int16_t& hDst = height_row[ix];
-
                 /*
                  * Terrain height can be negative.
                  * do not clip height to 0 here, otherwise all height below 0
@@ -416,11 +735,34 @@ public:
                  *
                  * all height will be sifted by #height_min in #TerrainRenderer::Slope method for ColorRamp lookup.
                  */
-                hDst = GetHeight(Y, X);
+                height_row[ix] = GetHeight(Y, X);
+            }
+        }
+    }
+
+    /**
+     * update #height_min, #height_max and #height_scale from height buffer content.
+     */
+    void UpdateHeightRange() {
+        height_scale = 0;
+
+        // we need local variable for compatibility with all implementation of opemmp reduction
+        int16_t _height_min = std::numeric_limits<int16_t>::max();
+        int16_t _height_max = std::numeric_limits<int16_t>::min();
 
-                if(hDst != TERRAIN_INVALID) {
-                  _height_min = std::min(_height_min, hDst);
-                  _height_max = std::max(_height_max, hDst);
+        const size_t col_count = height_buffer->GetWidth();
+        const size_t row_count = height_buffer->GetHeight();
+
+#if defined(_OPENMP)
+        #pragma omp parallel for reduction(max : _height_max) reduction(min : _height_min)
+#endif
+        for (size_t iy = 0; iy < row_count; ++iy) {
+            const int16_t *height_row = height_buffer->GetRow(iy);
+            for (size_t ix = 0; ix < col_count; ++ix) {
+                const int16_t h = height_row[ix];
+                if(h != TERRAIN_INVALID) {
+                  _height_min = std::min(_height_min, h);
+                  _height_max = std::max(_height_max, h);
                 }
             }
         }
@@ -450,6 +792,7 @@ public:
         }
     }
 
+public:
 
 #if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !GCC_OLDER_THAN(5,0)
 
@@ -704,47 +1047,26 @@ public:
             const unsigned prev_row_index =  (y < epx) ? 0 : y - epx;
             const unsigned next_row_index =  (y + epx >= iys) ? iys - 1 : y + epx;
 
-            const int16_t* prev_row = height_buffer->GetRow(prev_row_index);
-            const int16_t* curr_row = height_buffer->GetRow(y);
-            const int16_t* next_row = height_buffer->GetRow(next_row_index);
-
             const float p31 = next_row_index - prev_row_index;
-            const float p31s = p31 * hscale;
 
-            for (size_t x = 0; x < ixs; ++x) {
-                const size_t prev_col_index =  (x < epx) ? 0 : x - epx;
-                const size_t next_col_index =  (x + epx >= ixs) ? ixs - 1 : x + epx;
-
-                const int16_t& up =     prev_row[x];
-                const int16_t& bottom = next_row[x];
-                const int16_t& left =   curr_row[prev_col_index];
-                const int16_t& right =  curr_row[next_col_index];
-
-                const int32_t p20 = next_col_index - prev_col_index;
-                const int32_t p22 = right - left;
-                const int32_t p32 = bottom - up;
-
-                int32_t dd0 = p22 * p31;
-                int32_t dd1 = p20 * p32;
-                int32_t dd2 = p20 * p31s;
-
-                // prevent overflow of magnitude calculation
-                const int32_t scale = (dd2 / 512) + 1;
-                dd0 /= scale;
-                dd1 /= scale;
-                dd2 /= scale;
-
-                const uint32_t sqr_mag = (dd0 * dd0 + dd1 * dd1 + dd2 * dd2);
-                int32_t mag = (dd2 * sz + dd0 * sx + dd1 * sy) / (isqrt4(sqr_mag)|1);
-                mag = Clamp<int32_t>((mag - sz), -64, 63);
-
-                // when h is invalid, result is clamped to 255 so we have invalid terrain color
-                int16_t h =  *(curr_row + x);
-                h = ((h - height_min) >> height_scale);
-                h = Clamp<int16_t>(h, 0, 255);
+            const SlopeShadingRow row = {
+                height_buffer->GetRow(prev_row_index),
+                height_buffer->GetRow(y),
+                height_buffer->GetRow(next_row_index),
+                ixs, epx, p31, p31 * hscale,
+                sx, sy, sz,
+                height_min, height_scale
+            };
 
+            auto put = [&](size_t x, int16_t h, int32_t mag) {
                 screen_row[x] = GetColor(h, mag);
-            }
+            };
+
+#ifdef HAVE_TERRAIN_SSE2
+            SlopeShadingSSE2(row, put);
+#else
+            SlopeShadingScalar(row, 0, ixs, put);
+#endif
         }
     }
 
@@ -1202,6 +1524,42 @@ bool IsValidColorRamp(const COLORRAMP(&ramp_colors)[NUM_COLOR_RAMP_LEVELS]) {
     });
 }
 
+#ifdef HAVE_TERRAIN_SSE2
+
+#include <random>
+#include <chrono>
+
+namespace {
+
+    struct SlopeShadingResult {
+        std::vector<int16_t> h;
+        std::vector<int32_t> mag;
+
+        explicit SlopeShadingResult(size_t size) : h(size), mag(size) { }
+
+        void operator()(size_t x, int16_t _h, int32_t _mag) {
+            h[x] = _h;
+            mag[x] = _mag;
+        }
+    };
+
+    std::vector<int16_t> RandomHeightRow(std::mt19937& gen, size_t ixs) {
+        std::uniform_int_distribution<int> height(-100, 4800);
+        std::uniform_int_distribution<int> slope(-80, 80);
+        std::uniform_int_distribution<int> invalid(0, 50);
+
+        std::vector<int16_t> row(ixs);
+        int h = height(gen);
+        for (auto& v : row) {
+            h = Clamp(h + slope(gen), -100, 4800);
+            v = (invalid(gen) == 0) ? TERRAIN_INVALID : h;
+        }
+        return row;
+    }
+}
+
+#endif
+
 TEST_SUITE("Terrain renderer") {
 	TEST_CASE("color ramp") {
         SUBCASE("ramp height sorted") {
@@ -1211,6 +1569,78 @@ TEST_SUITE("Terrain renderer") {
             }
         }
     }
+
+#ifdef HAVE_TERRAIN_SSE2
+    TEST_CASE("slope shading sse2") {
+        std::mt19937 gen(1234);
+
+        for (size_t ixs : { 3, 17, 64, 203, 800 }) {
+            for (unsigned epx : { 4, 8, 12 }) {
+                for (int hscale : { 1, 25, 400 }) {
+                    const auto prev = RandomHeightRow(gen, ixs);
+                    const auto curr = RandomHeightRow(gen, ixs);
+                    const auto next = RandomHeightRow(gen, ixs);
+
+                    const float p31 = 2 * epx;
+                    const SlopeShadingRow row = {
+                        prev.data(), curr.data(), next.data(),
+                        ixs, epx, p31, p31 * hscale,
+                        -170, 98, 120,
+                        static_cast<int16_t>(hscale - 50), static_cast<unsigned>(hscale % 5)
+                    };
+
+                    SlopeShadingResult scalar(ixs);
+                    SlopeShadingScalar(row, 0, ixs, scalar);
+
+                    SlopeShadingResult sse2(ixs);
+                    SlopeShadingSSE2(row, sse2);
+
+                    CAPTURE(ixs);
+                    CAPTURE(epx);
+                    CAPTURE(hscale);
+                    CHECK(scalar.h == sse2.h);
+                    CHECK(scalar.mag == sse2.mag);
+                }
+            }
+        }
+    }
+
+    TEST_CASE("slope shading benchmark" * doctest::skip()) {
+        std::mt19937 gen(1234);
+        constexpr size_t ixs = 800;
+        constexpr unsigned loop = 2000;
+
+        const auto prev = RandomHeightRow(gen, ixs);
+        const auto curr = RandomHeightRow(gen, ixs);
+        const auto next = RandomHeightRow(gen, ixs);
+
+        const SlopeShadingRow row = {
+            prev.data(), curr.data(), next.data(),
+            ixs, 4, 8.f, 8.f * 25,
+            -170, 98, 120,
+            0, 4
+        };
+
+        SlopeShadingResult result(ixs);
+
+        using clock = std::chrono::steady_clock;
+        auto t0 = clock::now();
+        for (unsigned i = 0; i < loop; ++i) {
+            SlopeShadingScalar(row, 0, ixs, result);
+        }
+        auto t1 = clock::now();
+        for (unsigned i = 0; i < loop; ++i) {
+            SlopeShadingSSE2(row, result);
+        }
+        auto t2 = clock::now();
+
+        auto per_pixel = [&](clock::duration d) {
+            return std::chrono::duration<double, std::nano>(d).count() / (ixs * loop);
+        };
+        MESSAGE("scalar : " << per_pixel(t1 - t0) << " ns/pixel");
+        MESSAGE("sse2 : " << per_pixel(t2 - t1) << " ns/pixel");
+    }
+#endif
 }
 
 #endif
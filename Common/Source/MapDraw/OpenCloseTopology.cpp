@@ -13,6 +13,7 @@
 #include "LKProfiles.h"
 #include "Dialogs/dlgProgress.h"
 #include "utils/zzip_stream.h"
+#include "Topology/TopologyLoader.h"
 
 
 
@@ -276,6 +277,7 @@ void CloseTopology() {
   #endif
 
   LockTerrainDataGraphics();
+  TopoLoader.Cancel(); // loader must not use topology we are deleting
   std::for_each(std::begin(TopoStore), std::end(TopoStore), safe_delete());
   UnlockTerrainDataGraphics();
 }
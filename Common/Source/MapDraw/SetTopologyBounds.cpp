@@ -10,6 +10,8 @@
 #include "Terrain.h"
 #include "RGB.h"
 #include "Multimap.h"
+#include "Topology/TopologyLoader.h"
+#include "Draw/ScreenProjection.h"
 
 
 extern Topology* TopoStore[MAXTOPOLOGY];
@@ -29,10 +31,37 @@ bool RectangleIsInside(rectObj r_exterior, rectObj r_interior) {
     return false;
 }
 
+//
+// Bounds probably needed by next recompute : extended ahead along track, and
+// on each side if user is zooming out (scale change above 2 trigger recompute).
+//
+static rectObj PredictTopologyBounds(const rectObj& bounds, const NMEA_INFO& Basic, bool zoomout) {
+  const double width = bounds.maxx - bounds.minx;
+  const double height = bounds.maxy - bounds.miny;
+
+  rectObj predicted = bounds;
+  if (zoomout) {
+    predicted.minx -= width / 2;
+    predicted.maxx += width / 2;
+    predicted.miny -= height / 2;
+    predicted.maxy += height / 2;
+  }
+
+  if (Basic.Speed > 1) {
+    const double dx = width / 2 * fastsine(Basic.TrackBearing);
+    const double dy = height / 2 * fastcosine(Basic.TrackBearing);
+    predicted.minx = min(predicted.minx, bounds.minx + dx);
+    predicted.maxx = max(predicted.maxx, bounds.maxx + dx);
+    predicted.miny = min(predicted.miny, bounds.miny + dy);
+    predicted.maxy = max(predicted.maxy, bounds.maxy + dy);
+  }
+  return predicted;
+}
+
 //
 // This is called FORCED when changing multimap
 //
-void SetTopologyBounds(const RECT& rcin, const ScreenProjection& _Proj, const bool force) {
+void SetTopologyBounds(const RECT& rcin, const ScreenProjection& _Proj, const NMEA_INFO& Basic, const bool force) {
   static rectObj bounds_active;
   static double range_active = 1.0;
   bool unchanged=false;
@@ -98,11 +127,27 @@ void SetTopologyBounds(const RECT& rcin, const ScreenProjection& _Proj, const bo
     // now update visibility of objects in the map window
     MapWindow::ScanVisibility(&bounds_active);
 
+    // read in background shapes needed by next recompute
+    std::vector<Topology*> prefetch;
+    for (Topology* topo : TopoStore) {
+      if (topo && topo->CanPrefetch()) {
+        prefetch.push_back(topo);
+      }
+    }
+    if (!prefetch.empty()) {
+      TopoLoader.Request(PredictTopologyBounds(bounds_active, Basic, scale > 1), std::move(prefetch));
+    }
+
     runnext=NUMRUNS;
     unchanged=false;
 
   } else {
-	if (unchanged) { // nothing has changed, can we skip?
+	// shapes with previous level of detail must be swapped when prefetched
+	bool lod_pending = false;
+	for (const Topology* topo : TopoStore) {
+		lod_pending |= (topo && topo->LodPending());
+	}
+	if (unchanged && !lod_pending) { // nothing has changed, can we skip?
 		#if DEBUG_STB2
 		StartupStore(_T("... Nothing has changed\n"));
 		#endif
@@ -127,11 +172,22 @@ void SetTopologyBounds(const RECT& rcin, const ScreenProjection& _Proj, const bo
   #endif
 
   // check if things have come into or out of scale limit
+  // or if level of detail need to be changed
+  const double pixel_size = _Proj.GetPixelSize();
+  std::vector<Topology*> lod_changed;
   for (int z=0; z<MAXTOPOLOGY; z++) {
     if (TopoStore[z]) {
       TopoStore[z]->TriggerIfScaleNowVisible();
+      if (TopoStore[z]->TriggerIfLodChanged(pixel_size) && TopoStore[z]->CanPrefetch()) {
+        lod_changed.push_back(TopoStore[z]);
+      }
     }
   }
+  if (!lod_changed.empty()) {
+    // visible shapes at new level of detail are read in background, updateCache()
+    // keep previous ones until they are ready.
+    TopoLoader.Request(bounds_active, std::move(lod_changed));
+  }
 
     // check if any needs to have cache updates because wasnt
     // visible previously when bounds moved
@@ -20,10 +20,13 @@
 #define MAXAVERAGECLIMBRATESIZE  200
 
 // number of radials to do range footprint calculation on
-#ifndef UNDER_CE
-#define NUMTERRAINSWEEPS 40
-#else
+// all radials are computed concurrently with OpenMP, use finer resolution for same time.
+#if defined(UNDER_CE)
 #define NUMTERRAINSWEEPS 20
+#elif defined(_OPENMP)
+#define NUMTERRAINSWEEPS 80
+#else
+#define NUMTERRAINSWEEPS 40
 #endif
 
 struct THERMAL_SOURCE_INFO {
@@ -236,6 +236,14 @@ void LKSurface::Polygon(const POINT *apt, int cpt) {
 #endif    
 }
 
+#ifdef ENABLE_OPENGL
+void LKSurface::Polygon(const TessellatedPolygon& fill, const FloatPoint* fill_points, const RasterPoint *apt, int cpt) {
+    if(_pCanvas) {
+        _pCanvas->DrawPolygon(fill, fill_points, apt, cpt);
+    }
+}
+#endif
+
 void LKSurface::Polygon(const RasterPoint *apt, int cpt, const RECT& ClipRect) {
     assert(apt[0] == apt[cpt-1]);
     if(cpt>=3) {
@@ -143,6 +143,9 @@ public:
     void Polyline(const POINT *apt, int cpt, const RECT& ClipRect);
 
 #ifdef ENABLE_OPENGL
+    // fill @fill using its vertices already converted to screen coordinate @fill_points, and draw outline @apt
+    void Polygon(const TessellatedPolygon& fill, const FloatPoint* fill_points, const RasterPoint *apt, int cpt);
+
     void Polyline(const FloatPoint *apt, int cpt, const RECT& ClipRect);
 
     void DrawDashPoly(const int width, const LKColor& color, const FloatPoint* pt, const unsigned npoints, const RECT& rc);
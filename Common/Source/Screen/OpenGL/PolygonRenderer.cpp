@@ -9,6 +9,7 @@
  * Created on November 15, 2017, 8:42 PM
  */
 
+#include "options.h"
 #include "PolygonRenderer.h"
 #include <assert.h>
 #include <cstdio>
@@ -54,11 +55,19 @@ PolygonRenderer::~PolygonRenderer() {
 
 void PolygonRenderer::polygonBegin(GLenum type) {
   curr_type = type;
-  curr_polygon.clear();  
+  if (curr_output) {
+    curr_first = curr_output->vertices.size();
+  } else {
+    curr_polygon.clear();
+  }
 }
   
 void PolygonRenderer::polygonVertex(GLdouble *vertex) {
-  curr_polygon.emplace_back(vertex[0], vertex[1]);
+  if (curr_output) {
+    curr_output->vertices.push_back({vertex[0], vertex[1]});
+  } else {
+    curr_polygon.emplace_back(vertex[0], vertex[1]);
+  }
 }
 
 void PolygonRenderer::polygonCombine(GLdouble coords[3], GLdouble *vertex_data[4], GLfloat weight[4], void **outData) {  
@@ -67,6 +76,129 @@ void PolygonRenderer::polygonCombine(GLdouble coords[3], GLdouble *vertex_data[4
 }
 
 void PolygonRenderer::polygonEnd() {
-  ScopeVertexPointer vp(curr_polygon.data());
-  glDrawArrays(curr_type, 0, curr_polygon.size());
+  if (curr_output) {
+    const GLsizei count = curr_output->vertices.size() - curr_first;
+    curr_output->primitives.push_back({curr_type, curr_first, count});
+  } else {
+    ScopeVertexPointer vp(curr_polygon.data());
+    glDrawArrays(curr_type, 0, curr_polygon.size());
+  }
 }
+
+void TessellatedPolygon::Draw(const FloatPoint* points) const {
+  if (primitives.empty()) {
+    return;
+  }
+  ScopeVertexPointer vp(points);
+  for (const primitive_t& primitive : primitives) {
+    glDrawArrays(primitive.type, primitive.first, primitive.count);
+  }
+}
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+  // concave star polygon, @count branches
+  std::vector<TessellatedPolygon::point_t> StarPolygon(unsigned count) {
+    std::vector<TessellatedPolygon::point_t> points;
+    for (unsigned i = 0; i < 2 * count; ++i) {
+      const double angle = M_PI * i / count;
+      const double radius = (i % 2) ? 0.5 : 1.;
+      points.push_back({ 7. + radius * std::cos(angle), 45. + radius * std::sin(angle) });
+    }
+    return points;
+  }
+
+  void Tessellate(PolygonRenderer& renderer, TessellatedPolygon& tessellation,
+                  const std::vector<TessellatedPolygon::point_t>& points) {
+    renderer.BeginPolygon(tessellation);
+    renderer.BeginContour();
+    for (const auto& pt : points) {
+      renderer.AddVertex(pt.x, pt.y);
+    }
+    renderer.EndContour();
+    renderer.EndPolygon();
+  }
+
+  double TriangleArea(const TessellatedPolygon::point_t& a, const TessellatedPolygon::point_t& b,
+                      const TessellatedPolygon::point_t& c) {
+    return std::abs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) / 2.;
+  }
+
+} // namespace
+
+TEST_SUITE("PolygonRenderer") {
+
+  TEST_CASE("tessellation") {
+    PolygonRenderer renderer;
+    TessellatedPolygon tessellation;
+    CHECK_FALSE(tessellation.Valid());
+
+    const auto points = StarPolygon(10);
+    Tessellate(renderer, tessellation, points);
+    REQUIRE(tessellation.Valid());
+
+    // triangles must cover exactly the polygon
+    double polygon_area = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+      const auto& a = points[i];
+      const auto& b = points[(i + 1) % points.size()];
+      polygon_area += (a.x * b.y - b.x * a.y) / 2.;
+    }
+
+    const auto& vertices = tessellation.Vertices();
+    double triangles_area = 0;
+    unsigned triangles = 0;
+    tessellation.ForEachTriangle([&](GLint a, GLint b, GLint c) {
+      triangles_area += TriangleArea(vertices[a], vertices[b], vertices[c]);
+      ++triangles;
+    });
+    CHECK(triangles == points.size() - 2);
+    CHECK(triangles_area == doctest::Approx(std::abs(polygon_area)));
+
+    tessellation.clear();
+    CHECK_FALSE(tessellation.Valid());
+    CHECK(tessellation.Vertices().empty());
+  }
+
+  TEST_CASE("benchmark" * doctest::skip()) {
+    PolygonRenderer renderer;
+    constexpr unsigned loop = 200;
+
+    for (unsigned count : { 10U, 100U, 1000U }) {
+      const auto points = StarPolygon(count);
+      TessellatedPolygon tessellation;
+      std::vector<FloatPoint> screen_points;
+
+      using std::chrono::steady_clock;
+
+      // previous behaviour : tessellation on each frame
+      auto start = steady_clock::now();
+      for (unsigned i = 0; i < loop; ++i) {
+        Tessellate(renderer, tessellation, points);
+      }
+      const std::chrono::duration<double, std::micro> tessellate = steady_clock::now() - start;
+
+      // cached tessellation : only vertices are converted on each frame
+      start = steady_clock::now();
+      for (unsigned i = 0; i < loop; ++i) {
+        const auto& vertices = tessellation.Vertices();
+        screen_points.resize(vertices.size());
+        std::transform(vertices.begin(), vertices.end(), screen_points.begin(), [&](const auto& pt) {
+          return FloatPoint((pt.x - 7.) * 1000. + i, (pt.y - 45.) * 1000.);
+        });
+      }
+      const std::chrono::duration<double, std::micro> project = steady_clock::now() - start;
+
+      MESSAGE(2 * count << " vertices : tessellate " << tessellate.count() / loop
+              << "us/frame, cached " << project.count() / loop << "us/frame");
+    }
+  }
+}
+
+#endif
@@ -21,6 +21,80 @@
 
 class LKSurface;
 
+/**
+ * Triangles of one polygon, built once by PolygonRenderer in source coordinate
+ * (usually geographic, x = longitude, y = latitude).
+ *
+ * Drawing only need to project Vertices() in same order, no tessellation is
+ * done on each frame. Owner must clear it when source polygon change.
+ */
+class TessellatedPolygon final {
+public:
+  struct point_t {
+    GLdouble x;
+    GLdouble y;
+  };
+
+  void clear() {
+    primitives.clear();
+    vertices.clear();
+    valid = false;
+  }
+
+  // false if not yet tessellated (an empty result is valid)
+  bool Valid() const {
+    return valid;
+  }
+
+  const std::vector<point_t>& Vertices() const {
+    return vertices;
+  }
+
+  /**
+   * Draw all triangles, brush must be bound by caller.
+   * @points : Vertices() converted to screen coordinate.
+   */
+  void Draw(const FloatPoint* points) const;
+
+  /**
+   * call @func(a, b, c) for each triangle, with index of its vertices.
+   */
+  template<typename Func>
+  void ForEachTriangle(Func&& func) const {
+    for (const primitive_t& primitive : primitives) {
+      for (GLsizei i = 2; i < primitive.count; ++i) {
+        const GLint c = primitive.first + i;
+        switch (primitive.type) {
+          case GL_TRIANGLES:
+            if ((i % 3) == 2) {
+              func(c - 2, c - 1, c);
+            }
+            break;
+          case GL_TRIANGLE_FAN:
+            func(primitive.first, c - 1, c);
+            break;
+          case GL_TRIANGLE_STRIP:
+            func(c - 2, c - 1, c);
+            break;
+        }
+      }
+    }
+  }
+
+private:
+  struct primitive_t {
+    GLenum type; // GL_TRIANGLES, GL_TRIANGLE_FAN or GL_TRIANGLE_STRIP
+    GLint first;
+    GLsizei count;
+  };
+
+  std::vector<primitive_t> primitives;
+  std::vector<point_t> vertices;
+  bool valid = false;
+
+  friend class PolygonRenderer;
+};
+
 class PolygonRenderer {
 public:
   PolygonRenderer();
@@ -32,6 +106,16 @@ public:
   void BeginPolygon() {
     gluTessBeginPolygon(tess, this );
   }
+  /**
+   * Store tessellation result into @output instead of drawing it,
+   * until EndPolygon(). Vertex coordinate are not converted.
+   */
+  void BeginPolygon(TessellatedPolygon& output) {
+    output.clear();
+    output.valid = true;
+    curr_output = &output;
+    gluTessBeginPolygon(tess, this );
+  }
   void BeginContour() {
     gluTessBeginContour(tess);
   }
@@ -47,12 +131,15 @@ public:
   void EndPolygon() {
     gluTessEndPolygon(tess);
     pointers.clear();
+    curr_output = nullptr;
   }
 
 private:
   GLUtesselator* tess;
   GLenum curr_type;
   std::vector<FloatPoint> curr_polygon;
+  TessellatedPolygon* curr_output = nullptr; // not null while recording
+  GLint curr_first = 0; // first vertex of current primitive in curr_output
 
   typedef std::array<GLdouble,3> vertex_t;
   std::list<vertex_t> pointers;
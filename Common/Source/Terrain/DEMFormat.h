@@ -0,0 +1,130 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   DEMFormat.h
+ *
+ * On-disk layout of LK8000 .DEM terrain files.
+ *
+ * This header is shared with the `dem-tiler` converter (Common/Utils/dem-tiler),
+ * it must not depend on anything else than the standard library.
+ */
+
+#ifndef TERRAIN_DEMFORMAT_H
+#define TERRAIN_DEMFORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+/*
+ * Raw layout :
+ *   TERRAIN_INFO
+ *   short[Rows][Columns]     row major, north to south, west to east.
+ */
+typedef struct _TERRAIN_INFO
+{
+  double Left;
+  double Right;
+  double Top;
+  double Bottom;
+  double StepSize;
+  uint32_t Rows;
+  uint32_t Columns;
+} TERRAIN_INFO;
+
+/*
+ * Tiled layout :
+ *   TILED_DEM_HEADER
+ *   uint32_t[TilesY][TilesX] slot of each tile, row major.
+ *   padding up to a multiple of DataAlign
+ *   short[slot count][DEM_TILE_SIZE][DEM_TILE_SIZE]
+ *
+ * DataAlign is the memory page size of the system where the file was
+ * created, tiles are page aligned when the file is memory mapped on a
+ * system with same page size.
+ *
+ * Tiles are stored in Morton (Z-order) of their tile coordinates, so tiles
+ * close to each other on the map are also close to each other in the file.
+ * Cells of the last column and row of tiles beyond Columns/Rows are padding.
+ */
+constexpr unsigned DEM_TILE_SHIFT = 6;
+constexpr unsigned DEM_TILE_SIZE = 1U << DEM_TILE_SHIFT;
+constexpr unsigned DEM_TILE_MASK = DEM_TILE_SIZE - 1;
+constexpr unsigned DEM_TILE_CELLS = DEM_TILE_SIZE * DEM_TILE_SIZE;
+constexpr size_t DEM_TILE_BYTES = DEM_TILE_CELLS * sizeof(int16_t);
+
+constexpr uint32_t DEM_TILED_VERSION = 2;
+constexpr char DEM_TILED_MAGIC[8] = { 'L', 'K', 'D', 'E', 'M', 'T', 'I', 'L' };
+
+typedef struct _TILED_DEM_HEADER
+{
+  char Magic[8];
+  uint32_t Version;
+  uint32_t TileShift;
+  TERRAIN_INFO Info;
+  uint32_t TilesX;
+  uint32_t TilesY;
+  uint32_t DataAlign; // power of 2
+  uint32_t Reserved;
+} TILED_DEM_HEADER;
+
+static_assert(sizeof(TERRAIN_INFO) == 48, "invalid TERRAIN_INFO size");
+static_assert(sizeof(TILED_DEM_HEADER) == 80, "invalid TILED_DEM_HEADER size");
+
+inline bool IsTiledDEM(const TILED_DEM_HEADER& header) {
+  return memcmp(header.Magic, DEM_TILED_MAGIC, sizeof(DEM_TILED_MAGIC)) == 0;
+}
+
+inline uint32_t DEMTileCount(uint32_t cells) {
+  return (cells + DEM_TILE_MASK) >> DEM_TILE_SHIFT;
+}
+
+inline bool IsValidDEMAlign(uint32_t align) {
+  return align && (align & (align - 1)) == 0 && align <= (1U << 20);
+}
+
+/**
+ * @return file offset of the first tile.
+ */
+inline size_t DEMTiledDataOffset(uint32_t tiles_x, uint32_t tiles_y, uint32_t align) {
+  const size_t size = sizeof(TILED_DEM_HEADER) + sizeof(uint32_t) * tiles_x * tiles_y;
+  return (size + align - 1) / align * align;
+}
+
+/**
+ * interleave bits of @x and @y.
+ */
+inline uint32_t MortonCode(uint16_t x, uint16_t y) {
+  auto spread = [](uint32_t v) {
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+  };
+  return spread(x) | (spread(y) << 1);
+}
+
+/**
+ * @return slot of each tile (row major), slots are numbered in Morton order of tile coordinates.
+ */
+inline std::vector<uint32_t> DEMTileSlots(uint32_t tiles_x, uint32_t tiles_y) {
+  std::vector<uint32_t> order(tiles_x * tiles_y);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return MortonCode(a % tiles_x, a / tiles_x) < MortonCode(b % tiles_x, b / tiles_x);
+  });
+
+  std::vector<uint32_t> slots(order.size());
+  for (uint32_t slot = 0; slot < order.size(); ++slot) {
+    slots[order[slot]] = slot;
+  }
+  return slots;
+}
+
+#endif // TERRAIN_DEMFORMAT_H
@@ -11,18 +11,58 @@
 #include "OS/Memory.h"
 #include "OS/ByteOrder.hpp"
 #include <memory>
+#include <algorithm>
+#include <atomic>
 
 static_assert(IsLittleEndian(), "Big-Endian Arch is not supported");
 
 ////// Field access ////////////////////////////////////////////////////
 
 
+namespace {
+
+  /*
+   * number of tiles kept in memory when tiled terrain can't be loaded or mapped :
+   *  512 x 8KB = 4MB
+   */
+  constexpr unsigned tile_cache_capacity = 512;
+
+  unsigned NextSerial() {
+    static std::atomic<unsigned> serial = 0;
+    return ++serial;
+  }
+
+  template<typename T>
+  bool read_array(FILE* file, size_t offset, T* data, size_t count) {
+    return (fseek(file, offset, SEEK_SET) == 0)
+        && (fread(data, sizeof(T), count, file) == count);
+  }
+}
+
 bool RasterMap::Open(const TCHAR* zfilename) {
 
   if (_tcslen(zfilename)<=0) {
     return false;
   }
-  
+
+  TILED_DEM_HEADER header = {};
+  size_t read_size = 0;
+  FILE* file = _tfopen(zfilename, _T("rb"));
+  if(file) {
+    read_size = fread(&header, 1, sizeof(header), file);
+    fclose(file);
+  }
+  const bool success = (read_size == sizeof(header) && IsTiledDEM(header))
+                     ? OpenTiled(zfilename, header)
+                     : OpenRaw(zfilename);
+  if (success) {
+    Serial = NextSerial();
+  }
+  return success;
+}
+
+bool RasterMap::OpenRaw(const TCHAR* zfilename) {
+
   StartupStore(_T(". Terrain Open RasterMapRaw <%s>"),zfilename);
   FILE* file = _tfopen(zfilename, _T("rb"));
   if(file) {
@@ -113,6 +153,125 @@ bool RasterMap::Open(const TCHAR* zfilename) {
 }
 
 
+bool RasterMap::Open(const TERRAIN_INFO& info, std::unique_ptr<short[]>&& data) {
+  Close();
+  if (!info.StepSize || !data) {
+    return false;
+  }
+  TerrainInfo = info;
+  pTerrainMem = std::move(data);
+  TerrainMem = pTerrainMem.get();
+  Serial = NextSerial();
+  return true;
+}
+
+bool RasterMap::OpenTiled(const TCHAR* zfilename, const TILED_DEM_HEADER& header) {
+
+  StartupStore(_T(". Terrain Open RasterMapTiled <%s>"),zfilename);
+
+  TerrainInfo = header.Info;
+  TilesX = header.TilesX;
+
+  if (header.Version != DEM_TILED_VERSION || header.TileShift != DEM_TILE_SHIFT || !IsValidDEMAlign(header.DataAlign)) {
+    StartupStore(_T("... ERROR Terrain : unsupported tiled format"));
+    Close();
+    return false;
+  }
+  if (!TerrainInfo.StepSize) {
+    StartupStore(_T("... ERROR Terrain StepSize failure"));
+    Close();
+    return false;
+  }
+  if (header.TilesX != DEMTileCount(TerrainInfo.Columns) || header.TilesY != DEMTileCount(TerrainInfo.Rows)) {
+    StartupStore(_T("... ERROR Terrain : invalid tile count"));
+    Close();
+    return false;
+  }
+
+  const size_t tile_count = static_cast<size_t>(header.TilesX) * header.TilesY;
+  const size_t data_offset = DEMTiledDataOffset(header.TilesX, header.TilesY, header.DataAlign);
+  const size_t file_size = data_offset + tile_count * DEM_TILE_BYTES;
+
+  StartupStore(_T("... Terrain size is %u"), static_cast<unsigned>(file_size));
+  StartupStore(_T("... Available memory is %ukB"), static_cast<unsigned>(CheckFreeRam()/1024));
+
+  FILE* file = _tfopen(zfilename, _T("rb"));
+  if (!file) {
+    Close();
+    return false;
+  }
+
+  TileSlotTable.resize(tile_count);
+  if (!read_array(file, sizeof(TILED_DEM_HEADER), TileSlotTable.data(), tile_count)) {
+    StartupStore(_T("... ERROR Terrain : failed to read tile table"));
+    fclose(file);
+    Close();
+    return false;
+  }
+  // a corrupted table must not allow access outside of tile data
+  if (std::any_of(TileSlotTable.begin(), TileSlotTable.end(), [&](uint32_t slot) { return slot >= tile_count; })) {
+    StartupStore(_T("... ERROR Terrain : invalid tile table"));
+    fclose(file);
+    Close();
+    return false;
+  }
+  TileSlot = TileSlotTable.data();
+
+  // same policy than raw terrain : small file in heap memory
+  if (file_size < (10*1024*1024)) {
+    pTerrainMem.reset(new(std::nothrow) short[tile_count * DEM_TILE_CELLS]);
+    if( CheckFreeRam() < (5*1024*1024) ) {
+       pTerrainMem.reset();
+    }
+  }
+
+  if (pTerrainMem) {
+    StartupStore(_T("... Terrain : use heap memory"));
+    if (read_array(file, data_offset, pTerrainMem.get(), tile_count * DEM_TILE_CELLS)) {
+      TileMem = pTerrainMem.get();
+    } else {
+      pTerrainMem.reset();
+    }
+  }
+#ifndef UNDER_CE
+  else {
+    StartupStore(_T("... Terrain : use memory mapped file"));
+    TerrainFile.open(zfilename, false);
+    if(TerrainFile.is_open()) {
+      if (TerrainFile.file_size() == file_size) {
+        TerrainFile.map(data_offset, tile_count * DEM_TILE_BYTES);
+        if (TerrainFile.data()) {
+          TileMem = reinterpret_cast<const short*>(TerrainFile.data());
+        }
+      }
+      if (!TileMem) {
+        TerrainFile.close();
+      }
+    }
+  }
+#endif
+
+  if (TileMem) {
+    fclose(file);
+  }
+  else {
+    /*
+     * neither heap nor memory mapped file are available :
+     * read tiles on demand, memory usage is bounded by cache capacity.
+     */
+    StartupStore(_T("... Terrain : use tile cache"));
+    TileCache = std::make_unique<TerrainTileCache>(file, data_offset, tile_count, tile_cache_capacity);
+  }
+
+  if(!isMapLoaded()) {
+    Close();
+    StartupStore(_T("... Terrain RasterMapTiled load failed"));
+    return false;
+  }
+  return true;
+}
+
+
 void RasterMap::Close(void) {
   // this 2 line are needed for debug diagnostics
   TerrainInfo.Columns = 0;
@@ -120,6 +279,12 @@ void RasterMap::Close(void) {
 
   TerrainMem = nullptr;
 
+  TilesX = 0;
+  TileSlot = nullptr;
+  TileMem = nullptr;
+  TileSlotTable.clear();
+  TileCache.reset();
+
   pTerrainMem.reset();
 
 #ifndef UNDER_CE  
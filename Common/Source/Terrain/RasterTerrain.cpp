@@ -10,6 +10,7 @@
 #include "RasterTerrain.h"
 #include "Dialogs.h"
 #include "NavFunctions.h"
+#include <limits>
 
 bool RasterMap::GetMapCenter(double *lat, double *lon) const {
   if(!isMapLoaded())
@@ -81,25 +82,121 @@ int RasterMap::GetEffectivePixelSize(double dist) const {
   return grounding;
 }
 
+RasterMap::rounding_t RasterMap::GetRounding(double xr, double yr) const {
+  assert(TerrainInfo.StepSize > 0);
+
+  rounding_t r;
+  r.Xrounding = std::max(iround(xr/TerrainInfo.StepSize), 1);
+  r.fXrounding = 1.0/(r.Xrounding*TerrainInfo.StepSize);
+  r.fXroundingFine = r.fXrounding*256.0;
+
+  r.Yrounding = std::max(iround(yr/TerrainInfo.StepSize), 1);
+  r.fYrounding = 1.0/(r.Yrounding*TerrainInfo.StepSize);
+  r.fYroundingFine = r.fYrounding*256.0;
+
+  r.xlleft = (int)(TerrainInfo.Left*r.fXroundingFine)+128;
+  r.xlltop  = (int)(TerrainInfo.Top*r.fYroundingFine)-128;
+
+  r.interpolate = ((r.Xrounding==1)&&(r.Yrounding==1));
+  return r;
+}
+
 void RasterMap::SetFieldRounding(double xr, double yr) {
   if (!isMapLoaded()) {
     return;
   }
+  Rounding = GetRounding(xr, yr);
+}
 
-  assert(TerrainInfo.StepSize > 0);
+namespace {
+
+  constexpr size_t chunk_size = 16;
+
+  /**
+   * evaluate @n points by chunk : DEM coordinates of all points of a chunk are
+   * computed first, in a loop without dependency between iterations that
+   * compiler can vectorize, then DEM memory is read.
+   */
+  template<typename Coord, typename Lookup>
+  void SampleByChunk(size_t n, short* out, Coord&& coord, Lookup&& lookup) {
+    unsigned lx[chunk_size];
+    unsigned ly[chunk_size];
+    for (size_t base = 0; base < n; base += chunk_size) {
+      const size_t m = std::min(chunk_size, n - base);
+      for (size_t j = 0; j < m; ++j) {
+        coord(base + j, lx[j], ly[j]);
+      }
+      for (size_t j = 0; j < m; ++j) {
+        out[base + j] = lookup(lx[j], ly[j]);
+      }
+    }
+  }
 
-  Xrounding = std::max(iround(xr/TerrainInfo.StepSize), 1);
-  fXrounding = 1.0/(Xrounding*TerrainInfo.StepSize);
-  fXroundingFine = fXrounding*256.0;
+} // namespace
 
-  Yrounding = std::max(iround(yr/TerrainInfo.StepSize), 1);
-  fYrounding = 1.0/(Yrounding*TerrainInfo.StepSize);
-  fYroundingFine = fYrounding*256.0;
+void RasterMap::GetFieldBatch(const double* Latitude, const double* Longitude, short* out, size_t count) const {
+  if (!isMapLoaded()) {
+    std::fill_n(out, count, TERRAIN_INVALID);
+    return;
+  }
+  // rounding mode is checked once for all points
+  const rounding_t& r = Rounding;
+  if (r.interpolate) {
+    SampleByChunk(count, out, [&](size_t i, unsigned& lx, unsigned& ly) {
+      lx = (int)(Longitude[i] * r.fXroundingFine) - r.xlleft;
+      ly = r.xlltop - (int)(Latitude[i] * r.fYroundingFine);
+    }, [&](unsigned lx, unsigned ly) {
+      return InterpolateAt(lx, ly);
+    });
+  } else {
+    const double left = TerrainInfo.Left;
+    const double top = TerrainInfo.Top;
+    SampleByChunk(count, out, [&](size_t i, unsigned& lx, unsigned& ly) {
+      // negative offset are outside of terrain, like in GetFieldFine()
+      const double x = (Longitude[i] - left) * r.fXrounding;
+      const double y = (top - Latitude[i]) * r.fYrounding;
+      lx = (x < 0) ? std::numeric_limits<unsigned>::max() : uround(x) * r.Xrounding;
+      ly = (y < 0) ? std::numeric_limits<unsigned>::max() : uround(y) * r.Yrounding;
+    }, [&](unsigned lx, unsigned ly) {
+      return FineAt(lx, ly);
+    });
+  }
+}
 
-  xlleft = (int)(TerrainInfo.Left*fXroundingFine)+128;
-  xlltop  = (int)(TerrainInfo.Top*fYroundingFine)-128;
+void RasterMap::GetFieldAlongLine(const rounding_t& r, double start_lat, double start_lon,
+                                  double end_lat, double end_lon, size_t count,
+                                  size_t first, short* out, size_t n) const {
+  assert(first + n <= count);
+
+  if (!isMapLoaded()) {
+    std::fill_n(out, n, TERRAIN_INVALID);
+    return;
+  }
 
-  Interpolate = ((Xrounding==1)&&(Yrounding==1));
+  const double dlat = (count > 1) ? (end_lat - start_lat) / (count - 1) : 0.;
+  const double dlon = (count > 1) ? (end_lon - start_lon) / (count - 1) : 0.;
+
+  if (r.interpolate) {
+    SampleByChunk(n, out, [&](size_t i, unsigned& lx, unsigned& ly) {
+      const double k = first + i;
+      lx = (int)((start_lon + k * dlon) * r.fXroundingFine) - r.xlleft;
+      ly = r.xlltop - (int)((start_lat + k * dlat) * r.fYroundingFine);
+    }, [&](unsigned lx, unsigned ly) {
+      return InterpolateAt(lx, ly);
+    });
+  } else {
+    const double left = TerrainInfo.Left;
+    const double top = TerrainInfo.Top;
+    SampleByChunk(n, out, [&](size_t i, unsigned& lx, unsigned& ly) {
+      const double k = first + i;
+      const double x = (start_lon + k * dlon - left) * r.fXrounding;
+      const double y = (top - (start_lat + k * dlat)) * r.fYrounding;
+      lx = (x < 0) ? std::numeric_limits<unsigned>::max() : uround(x) * r.Xrounding;
+      ly = (y < 0) ? std::numeric_limits<unsigned>::max() : uround(y) * r.Yrounding;
+    }, [&](unsigned lx, unsigned ly) {
+      return FineAt(lx, ly);
+    });
+  }
 }
 
 
@@ -124,6 +221,14 @@ short RasterTerrain::GetTerrainHeight(const double &Latitude,
   }
 }
 
+void RasterTerrain::GetTerrainHeightBatch(const double* Latitude, const double* Longitude, short* out, size_t count) {
+  if (TerrainMap) {
+    TerrainMap->GetFieldBatch(Latitude, Longitude, out, count);
+  } else {
+    std::fill_n(out, count, TERRAIN_INVALID);
+  }
+}
+
 void RasterTerrain::SetTerrainRounding(double x, double y) {
   if (TerrainMap) {
     TerrainMap->SetFieldRounding(x, y);
@@ -151,3 +256,128 @@ bool RasterTerrain::GetTerrainCenter(double *latitude, double *longitude) {
     return false;
   }
 }
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <chrono>
+
+namespace {
+
+  // 1° x 1° synthetic terrain, 30" step
+  void OpenTestTerrain(RasterMap& map) {
+    TERRAIN_INFO info = {};
+    info.Left = 6.;
+    info.Right = 7.;
+    info.Top = 46.;
+    info.Bottom = 45.;
+    info.StepSize = 1. / 120.;
+    info.Columns = 121;
+    info.Rows = 121;
+
+    std::unique_ptr<short[]> data(new short[info.Columns * info.Rows]);
+    for (unsigned y = 0; y < info.Rows; ++y) {
+      for (unsigned x = 0; x < info.Columns; ++x) {
+        data[y * info.Columns + x] = (x * 37 + y * 91 + x * y) % 3000;
+      }
+    }
+    map.Open(info, std::move(data));
+  }
+}
+
+TEST_SUITE("Terrain") {
+
+  TEST_CASE("batch query") {
+    RasterMap map;
+    OpenTestTerrain(map);
+    REQUIRE(map.isMapLoaded());
+
+    constexpr size_t count = 200;
+    // line cross terrain border to check invalid points
+    const double start_lat = 45.95, start_lon = 5.9;
+    const double end_lat = 45.02, end_lon = 6.97;
+
+    double lat[count], lon[count];
+    for (size_t i = 0; i < count; ++i) {
+      lat[i] = start_lat + i * ((end_lat - start_lat) / (count - 1));
+      lon[i] = start_lon + i * ((end_lon - start_lon) / (count - 1));
+    }
+
+    for (double rounding : { 0., 4. / 120. }) {
+      map.SetFieldRounding(rounding, rounding);
+
+      short batch[count], line[count];
+      map.GetFieldBatch(lat, lon, batch, count);
+      map.GetFieldAlongLine(start_lat, start_lon, end_lat, end_lon, line, count);
+
+      for (size_t i = 0; i < count; ++i) {
+        CAPTURE(i);
+        CHECK(batch[i] == map.GetField(lat[i], lon[i]));
+        CHECK(line[i] == batch[i]);
+      }
+      CHECK(batch[0] == TERRAIN_INVALID);
+
+      // same line sampled by chunks of any size
+      for (size_t chunk : { 1, 7, 16, 33 }) {
+        short part[count];
+        for (size_t first = 0; first < count; first += chunk) {
+          const size_t n = std::min(chunk, count - first);
+          map.GetFieldAlongLine(map.GetRounding(), start_lat, start_lon, end_lat, end_lon, count, first, part + first, n);
+        }
+        CHECK(std::equal(part, part + count, line));
+      }
+    }
+  }
+
+  TEST_CASE("batch query benchmark" * doctest::skip()) {
+    RasterMap map;
+    OpenTestTerrain(map);
+    map.SetFieldRounding(0, 0);
+
+    constexpr size_t count = 1000;
+    constexpr unsigned loop = 1000;
+    std::unique_ptr<double[]> lat(new double[count]);
+    std::unique_ptr<double[]> lon(new double[count]);
+    std::unique_ptr<short[]> out(new short[count]);
+    for (size_t i = 0; i < count; ++i) {
+      lat[i] = 45.9 - i * 0.0008;
+      lon[i] = 6.1 + i * 0.0008;
+    }
+
+    using clock = std::chrono::steady_clock;
+    long sum = 0;
+
+    auto t0 = clock::now();
+    for (unsigned n = 0; n < loop; ++n) {
+      RasterTerrain::Lock();
+      for (size_t i = 0; i < count; ++i) {
+        sum += map.GetField(lat[i], lon[i]);
+      }
+      RasterTerrain::Unlock();
+    }
+    auto t1 = clock::now();
+    for (unsigned n = 0; n < loop; ++n) {
+      RasterTerrain::Lock();
+      map.GetFieldBatch(lat.get(), lon.get(), out.get(), count);
+      RasterTerrain::Unlock();
+      sum += out[n % count];
+    }
+    auto t2 = clock::now();
+    for (unsigned n = 0; n < loop; ++n) {
+      RasterTerrain::Lock();
+      map.GetFieldAlongLine(lat[0], lon[0], lat[count - 1], lon[count - 1], out.get(), count);
+      RasterTerrain::Unlock();
+      sum += out[n % count];
+    }
+    auto t3 = clock::now();
+
+    auto per_sample = [&](clock::duration d) {
+      return std::chrono::duration<double, std::nano>(d).count() / (count * loop);
+    };
+    MESSAGE("GetField : " << per_sample(t1 - t0) << " ns/sample");
+    MESSAGE("GetFieldBatch : " << per_sample(t2 - t1) << " ns/sample");
+    MESSAGE("GetFieldAlongLine : " << per_sample(t3 - t2) << " ns/sample");
+    CHECK(sum != 0);
+  }
+}
+
+#endif
@@ -6,8 +6,11 @@
  * Created by Bruno de Lacheisserie on 21/10/2019.
  */
 
+#include "options.h"
 #include "STHeightBuffer.h"
 #include <memory>
+#include <cstring>
+#include <cstdlib>
 
 CSTHeightBuffer::CSTHeightBuffer(size_t w, size_t h)
         : data(std::make_unique<int16_t[]>(w * h)),
@@ -24,3 +27,73 @@ void CSTHeightBuffer::Resize(size_t w, size_t h) {
     width = w;
     height = h;
 }
+
+void CSTHeightBuffer::Scroll(int dx, int dy) {
+    const size_t abs_dx = std::abs(dx);
+    const size_t abs_dy = std::abs(dy);
+    if (abs_dx >= width || abs_dy >= height) {
+        return; // nothing to keep
+    }
+
+    const size_t count = width - abs_dx;
+    const size_t dst_col = (dx < 0) ? abs_dx : 0;
+    const size_t src_col = (dx < 0) ? 0 : abs_dx;
+
+    auto move_row = [&](size_t y) {
+        int16_t* dst = GetRow(y) + dst_col;
+        const int16_t* src = GetRow(y + dy) + src_col;
+        memmove(dst, src, count * sizeof(int16_t));
+    };
+
+    // iterate so source rows are read before being overwritten
+    if (dy > 0) {
+        for (size_t y = 0; y < height - abs_dy; ++y) {
+            move_row(y);
+        }
+    } else {
+        for (size_t y = height; y-- > abs_dy; ) {
+            move_row(y);
+        }
+    }
+}
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+
+TEST_SUITE("Terrain renderer") {
+    TEST_CASE("height buffer scroll") {
+        constexpr size_t width = 7;
+        constexpr size_t height = 5;
+
+        auto value = [](int x, int y) {
+            return static_cast<int16_t>(y * 100 + x);
+        };
+
+        for (int dy = -3; dy <= 3; ++dy) {
+            for (int dx = -4; dx <= 4; ++dx) {
+                CSTHeightBuffer buffer(width, height);
+                for (size_t y = 0; y < height; ++y) {
+                    for (size_t x = 0; x < width; ++x) {
+                        buffer.GetRow(y)[x] = value(x, y);
+                    }
+                }
+
+                buffer.Scroll(dx, dy);
+
+                for (int y = 0; y < static_cast<int>(height); ++y) {
+                    for (int x = 0; x < static_cast<int>(width); ++x) {
+                        const int src_x = x + dx;
+                        const int src_y = y + dy;
+                        if (src_x >= 0 && src_x < static_cast<int>(width) && src_y >= 0 && src_y < static_cast<int>(height)) {
+                            CAPTURE(dx);
+                            CAPTURE(dy);
+                            CHECK(buffer.GetRow(y)[x] == value(src_x, src_y));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -20,6 +20,13 @@ public:
 
     void Resize(size_t width, size_t height);
 
+    /**
+     * move buffer content : after call, cell (x, y) contains previous cell (x + dx, y + dy).
+     *  cells without source are left unchanged and must be filled by caller.
+     *  rows stay contiguous, so content is moved instead of using ring indexing.
+     */
+    void Scroll(int dx, int dy);
+
     int16_t* GetRow(size_t row) const {
         assert(row * width < allocated);
         return &data[row * width];
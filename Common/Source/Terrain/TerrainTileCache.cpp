@@ -0,0 +1,205 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   TerrainTileCache.cpp
+ */
+
+#include "options.h"
+#include "TerrainTileCache.h"
+#include "Sizes.h"
+#include <algorithm>
+#include <cassert>
+#include <atomic>
+
+namespace {
+
+  std::atomic<unsigned> next_cache_id(1);
+
+  // per thread handles on last used tiles, a few are enough for interpolation
+  // across tile borders.
+  struct tile_handle_t {
+    unsigned cache_id = 0;
+    unsigned slot = 0;
+    TerrainTileCache::tile_ptr tile;
+  };
+
+  constexpr unsigned handle_count = 4;
+  thread_local tile_handle_t thread_handles[handle_count];
+  thread_local unsigned thread_next_handle = 0;
+
+} // namespace
+
+TerrainTileCache::TerrainTileCache(FILE* file, size_t data_offset, unsigned tile_count, unsigned capacity)
+    : _id(next_cache_id++),
+      _file(file),
+      _data_offset(data_offset),
+      _entry_of_slot(tile_count, -1),
+      _capacity(std::max(1U, std::min(capacity, tile_count)))
+{
+  _entries.reserve(_capacity);
+}
+
+TerrainTileCache::~TerrainTileCache() {
+  if (_file) {
+    fclose(_file);
+  }
+}
+
+short TerrainTileCache::Get(unsigned slot, unsigned offset) {
+  assert(slot < _entry_of_slot.size());
+  assert(offset < DEM_TILE_CELLS);
+
+  for (const tile_handle_t& handle : thread_handles) {
+    if (handle.cache_id == _id && handle.slot == slot) {
+      return handle.tile[offset];
+    }
+  }
+
+  tile_handle_t& handle = thread_handles[thread_next_handle++ % handle_count];
+  {
+    ScopeLock lock(_mutex);
+    handle.tile = Load(slot);
+  }
+  handle.cache_id = _id;
+  handle.slot = slot;
+  return handle.tile[offset];
+}
+
+TerrainTileCache::tile_ptr TerrainTileCache::Load(unsigned slot) {
+  int idx = _entry_of_slot[slot];
+  if (idx >= 0) {
+    ++_hits;
+    _entries[idx].last_use = ++_clock;
+    return _entries[idx].tile;
+  }
+
+  ++_misses;
+  if (_entries.size() < _capacity) {
+    idx = _entries.size();
+    _entries.push_back({ slot, 0, tile_ptr(new short[DEM_TILE_CELLS]) });
+  }
+  else {
+    // evict least recently used tile
+    auto it = std::min_element(_entries.begin(), _entries.end(), [](const entry_t& a, const entry_t& b) {
+      return a.last_use < b.last_use;
+    });
+    idx = std::distance(_entries.begin(), it);
+    _entry_of_slot[it->slot] = -1;
+    it->slot = slot;
+    // never reused : evicted tile can still be read through thread handles.
+    it->tile.reset(new short[DEM_TILE_CELLS]);
+  }
+  _entries[idx].last_use = ++_clock;
+  _entry_of_slot[slot] = idx;
+
+  short* tile = _entries[idx].tile.get();
+  const long offset = _data_offset + static_cast<size_t>(slot) * DEM_TILE_BYTES;
+  if (fseek(_file, offset, SEEK_SET) != 0 || fread(tile, sizeof(short), DEM_TILE_CELLS, _file) != DEM_TILE_CELLS) {
+    std::fill_n(tile, DEM_TILE_CELLS, TERRAIN_INVALID);
+  }
+  return _entries[idx].tile;
+}
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <random>
+#include <thread>
+
+TEST_SUITE("Terrain tiles") {
+
+  TEST_CASE("tile slots") {
+    CHECK(MortonCode(0, 0) == 0);
+    CHECK(MortonCode(1, 0) == 1);
+    CHECK(MortonCode(0, 1) == 2);
+    CHECK(MortonCode(3, 3) == 15);
+    CHECK(MortonCode(4, 0) == 16);
+
+    // 3x2 tiles : Morton order is (0,0) (1,0) (0,1) (1,1) (2,0) (2,1)
+    const std::vector<uint32_t> slots = DEMTileSlots(3, 2);
+    const std::vector<uint32_t> expected = { 0, 1, 4, 2, 3, 5 };
+    CHECK(slots == expected);
+
+    CHECK(DEMTileCount(1) == 1);
+    CHECK(DEMTileCount(DEM_TILE_SIZE) == 1);
+    CHECK(DEMTileCount(DEM_TILE_SIZE + 1) == 2);
+    CHECK(DEMTiledDataOffset(3, 2, 4096) == 4096);
+    CHECK(DEMTiledDataOffset(3, 2, 16384) == 16384);
+    // header and 6 tile offsets, rounded up to 8 bytes
+    CHECK(DEMTiledDataOffset(3, 2, 8) == (sizeof(TILED_DEM_HEADER) + 6 * sizeof(uint32_t) + 7) / 8 * 8);
+    CHECK(IsValidDEMAlign(4096));
+    CHECK_FALSE(IsValidDEMAlign(0));
+    CHECK_FALSE(IsValidDEMAlign(4000));
+  }
+
+  TEST_CASE("lru cache") {
+    FILE* file = tmpfile();
+    REQUIRE(file);
+
+    const size_t data_offset = 100;
+    const unsigned tile_count = 8;
+    std::vector<char> header(data_offset, 0);
+    fwrite(header.data(), 1, header.size(), file);
+    for (unsigned slot = 0; slot < tile_count; ++slot) {
+      std::vector<short> tile(DEM_TILE_CELLS);
+      for (unsigned i = 0; i < DEM_TILE_CELLS; ++i) {
+        tile[i] = slot * 1000 + i % 1000;
+      }
+      fwrite(tile.data(), sizeof(short), tile.size(), file);
+    }
+
+    auto expected = [](unsigned slot, unsigned offset) {
+      return static_cast<short>(slot * 1000 + offset % 1000);
+    };
+
+    TerrainTileCache cache(file, data_offset, tile_count, 2);
+
+    SUBCASE("thread handles") {
+      CHECK(cache.Get(0, 5) == 5);
+      CHECK(cache.Get(1, 1005) == 1005);
+      CHECK(cache.Get(0, 7) == 7); // thread handle, no lookup in cache
+      CHECK(cache.misses() == 2);
+      CHECK(cache.hits() == 0);
+
+      // tile 0 and 1 evicted from cache, but still used by this thread.
+      CHECK(cache.Get(2, DEM_TILE_CELLS - 1) == expected(2, DEM_TILE_CELLS - 1));
+      CHECK(cache.Get(3, 0) == 3000);
+      CHECK(cache.Get(0, 1) == 1);
+      CHECK(cache.Get(1, 2) == 1002);
+      CHECK(cache.misses() == 4);
+
+      // more tiles than thread handles
+      CHECK(cache.Get(4, 0) == 4000);
+      CHECK(cache.Get(0, 3) == 3);
+      CHECK(cache.misses() == 6);
+      CHECK(cache.Get(4, 1) == 4001);
+      CHECK(cache.misses() == 6);
+    }
+
+    SUBCASE("concurrent readers") {
+      std::atomic<unsigned> errors(0);
+      std::vector<std::thread> threads;
+      for (unsigned t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+          std::mt19937 rand(t);
+          std::uniform_int_distribution<unsigned> slot_dist(0, tile_count - 1);
+          std::uniform_int_distribution<unsigned> offset_dist(0, DEM_TILE_CELLS - 1);
+          for (unsigned i = 0; i < 20000; ++i) {
+            const unsigned slot = slot_dist(rand);
+            const unsigned offset = offset_dist(rand);
+            if (cache.Get(slot, offset) != expected(slot, offset)) {
+              ++errors;
+            }
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      CHECK(errors == 0);
+    }
+  }
+}
+
+#endif
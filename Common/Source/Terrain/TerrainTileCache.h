@@ -0,0 +1,89 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   TerrainTileCache.h
+ */
+
+#ifndef TERRAIN_TERRAINTILECACHE_H
+#define TERRAIN_TERRAINTILECACHE_H
+
+#include "DEMFormat.h"
+#include "Thread/Mutex.hpp"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+/**
+ * Bounded LRU cache of tiles read from a tiled .DEM file.
+ *
+ * Used when tiled terrain file can't be memory mapped and is too large
+ * for heap : memory usage is limited to `capacity` tiles whatever the
+ * terrain size.
+ *
+ * Thread safe, Get() can be called concurrently by terrain renderer threads :
+ * each thread keeps handles on last used tiles, the shared cache and its mutex
+ * are only used when sample is outside of these tiles.
+ * Tiles are reference counted, an evicted tile stay valid until no thread
+ * use it anymore.
+ */
+class TerrainTileCache final {
+public:
+  using tile_ptr = std::shared_ptr<short[]>;
+
+  /**
+   * @file : opened tiled .DEM file, owned by cache.
+   * @data_offset : file offset of first tile.
+   * @tile_count : number of tiles stored in file.
+   * @capacity : maximum number of tiles kept in shared cache.
+   */
+  TerrainTileCache(FILE* file, size_t data_offset, unsigned tile_count, unsigned capacity);
+  ~TerrainTileCache();
+
+  TerrainTileCache(const TerrainTileCache&) = delete;
+  TerrainTileCache& operator=(const TerrainTileCache&) = delete;
+
+  /**
+   * @return elevation of cell @offset in tile @slot,
+   *   TERRAIN_INVALID if tile can't be read.
+   */
+  short Get(unsigned slot, unsigned offset);
+
+  /**
+   * number of hits and misses in shared cache, samples read from
+   * thread tile handles are not counted.
+   */
+  unsigned hits() const {
+    return _hits;
+  }
+  unsigned misses() const {
+    return _misses;
+  }
+
+private:
+  // mutex must be locked
+  tile_ptr Load(unsigned slot);
+
+  struct entry_t {
+    unsigned slot;
+    unsigned last_use;
+    tile_ptr tile;
+  };
+
+  const unsigned _id; // unique for each cache instance, thread handles refer to it.
+
+  Mutex _mutex;
+  FILE* _file;
+  const size_t _data_offset;
+
+  std::vector<int> _entry_of_slot; // slot -> entry index, -1 if not loaded
+  std::vector<entry_t> _entries;
+
+  unsigned _capacity;
+  unsigned _clock = 0;
+  unsigned _hits = 0;
+  unsigned _misses = 0;
+};
+
+#endif // TERRAIN_TERRAINTILECACHE_H
@@ -0,0 +1,70 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   SPSCQueue.hpp
+ */
+
+#ifndef _THREAD_SPSCQUEUE_HPP_
+#define _THREAD_SPSCQUEUE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Bounded lock-free single producer / single consumer ring buffer.
+ *
+ * Push() must only be called by producer thread, Pop() by consumer thread;
+ * caller has to serialize access if more than one thread act as consumer.
+ * Neither side ever block : Push() fail if queue is full.
+ */
+template<typename T, size_t size>
+class SPSCQueue final {
+  static_assert(size >= 2 && (size & (size - 1)) == 0, "SPSCQueue size must be power of two");
+
+public:
+  SPSCQueue() = default;
+
+  SPSCQueue(const SPSCQueue&) = delete;
+  SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+  /**
+   * @return false if queue is full, @value is not queued in that case.
+   */
+  bool Push(const T& value) {
+    const size_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) >= size) {
+      return false;
+    }
+    _data[head & (size - 1)] = value;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @return false if queue is empty.
+   */
+  bool Pop(T& value) {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = _data[tail & (size - 1)];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Empty() const {
+    return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire);
+  }
+
+private:
+  std::array<T, size> _data = {};
+
+  std::atomic<size_t> _head = {}; // written by producer
+  std::atomic<size_t> _tail = {}; // written by consumer
+};
+
+#endif // _THREAD_SPSCQUEUE_HPP_
@@ -0,0 +1,99 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   SeqLock.hpp
+ */
+
+#ifndef _THREAD_SEQLOCK_HPP_
+#define _THREAD_SEQLOCK_HPP_
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+/**
+ * Sequence lock publication of a trivially copyable struct.
+ *
+ * Writer never wait : sequence is odd while a copy is in progress, readers
+ * retry their copy if sequence was odd or has changed during the copy.
+ *
+ * Write() calls must be serialized by caller, Read() can be called
+ * concurrently from any thread.
+ */
+template<typename T>
+class SeqLock final {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock require trivially copyable type");
+
+public:
+  struct stats_t {
+    unsigned writes;
+    unsigned reads;
+    unsigned retries; // number of copies discarded by readers.
+  };
+
+  SeqLock() = default;
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  void Write(const T& value) {
+    const unsigned seq = _seq.load(std::memory_order_relaxed);
+    _seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(&_data, &value, sizeof(T));
+
+    _seq.store(seq + 2, std::memory_order_release);
+    _writes.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * copy last published value to @value.
+   * @return false if nothing was published yet, @value is unchanged in that case.
+   */
+  bool Read(T& value) const {
+    unsigned retries = 0;
+    for (;;) {
+      const unsigned seq = _seq.load(std::memory_order_acquire);
+      if (seq == 0) {
+        return false;
+      }
+      if ((seq & 1) == 0) {
+        memcpy(&value, &_data, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_seq.load(std::memory_order_relaxed) == seq) {
+          break;
+        }
+      }
+      ++retries;
+      std::this_thread::yield();
+    }
+
+    _reads.fetch_add(1, std::memory_order_relaxed);
+    if (retries) {
+      _retries.fetch_add(retries, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  stats_t Stats() const {
+    return {
+      _writes.load(std::memory_order_relaxed),
+      _reads.load(std::memory_order_relaxed),
+      _retries.load(std::memory_order_relaxed)
+    };
+  }
+
+private:
+  std::atomic<unsigned> _seq = {};
+  T _data = {};
+
+  std::atomic<unsigned> _writes = {};
+  mutable std::atomic<unsigned> _reads = {};
+  mutable std::atomic<unsigned> _retries = {};
+};
+
+#endif // _THREAD_SEQLOCK_HPP_
@@ -0,0 +1,78 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   StatMutex.hpp
+ */
+
+#ifndef _THREAD_STATMUTEX_HPP_
+#define _THREAD_STATMUTEX_HPP_
+
+#include "Mutex.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Recursive mutex counting contended acquisitions and time spent waiting.
+ *
+ * Counters are updated by lock() itself, so every lock path is measured :
+ * direct call, StatScopeLock or WithLock().
+ */
+class StatMutex final {
+public:
+  struct stats_t {
+    unsigned locks;
+    unsigned contended; // number of lock() call that had to wait.
+    unsigned wait_ms;   // total time spent waiting.
+  };
+
+  StatMutex() = default;
+
+  StatMutex(const StatMutex&) = delete;
+  StatMutex& operator=(const StatMutex&) = delete;
+
+  void lock() {
+    if (!_mutex.try_lock()) {
+      using clock = std::chrono::steady_clock;
+      const auto start = clock::now();
+      _mutex.lock();
+      const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+      _wait_us.fetch_add(wait.count(), std::memory_order_relaxed);
+      _contended.fetch_add(1, std::memory_order_relaxed);
+    }
+    _locks.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  bool try_lock() {
+    if (_mutex.try_lock()) {
+      _locks.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    return false;
+  }
+
+  void unlock() {
+    _mutex.unlock();
+  }
+
+  stats_t Stats() const {
+    return {
+      _locks.load(std::memory_order_relaxed),
+      _contended.load(std::memory_order_relaxed),
+      static_cast<unsigned>(_wait_us.load(std::memory_order_relaxed) / 1000)
+    };
+  }
+
+private:
+  Mutex _mutex;
+
+  std::atomic<unsigned> _locks = {};
+  std::atomic<unsigned> _contended = {};
+  std::atomic<uint64_t> _wait_us = {};
+};
+
+using StatScopeLock = Poco::ScopedLock<StatMutex>;
+
+#endif // _THREAD_STATMUTEX_HPP_
@@ -0,0 +1,162 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   TaskGraph.cpp
+ */
+
+#include "externs.h"
+#include "TaskGraph.hpp"
+#include "Thread/Thread.hpp"
+#include "OS/Clock.hpp"
+#include <memory>
+
+namespace {
+
+  class worker_t final : public Thread {
+  public:
+    explicit worker_t(std::function<void()>&& run) : Thread("TaskGraph"), _run(std::move(run)) { }
+
+  protected:
+    void Run() override {
+      _run();
+    }
+
+  private:
+    std::function<void()> _run;
+  };
+
+} // namespace
+
+
+TaskGraph::id_t TaskGraph::Add(const TCHAR* name, function_t&& function, std::initializer_list<id_t> depends, bool main_thread) {
+  const id_t id = _tasks.size();
+  _tasks.push_back({ name, std::move(function), {}, 0, main_thread, 0, 0 });
+  for (id_t dep : depends) {
+    assert(dep < id); // no cycle possible
+    _tasks[dep].next.push_back(id);
+    ++_tasks[id].pending;
+  }
+  return id;
+}
+
+void TaskGraph::Ready(id_t id) {
+  if (_tasks[id].main_thread) {
+    _ready_main.push_back(id);
+  } else {
+    _ready.push_back(id);
+  }
+}
+
+void TaskGraph::Process(bool main_thread, bool workers) {
+  ScopeLock lock(_mutex);
+  while (_remaining > 0) {
+    std::deque<id_t>* queue = nullptr;
+    if (main_thread && !_ready_main.empty()) {
+      queue = &_ready_main;
+    } else if ((!main_thread || !workers) && !_ready.empty()) {
+      queue = &_ready;
+    }
+    if (!queue) {
+      _cond.Wait(_mutex);
+      continue;
+    }
+
+    const id_t id = queue->front();
+    queue->pop_front();
+    task_t& task = _tasks[id];
+
+    task.start_ms = MonotonicClockMS() - _start_ms;
+    {
+      ScopeUnlock unlock(_mutex);
+      task.function();
+    }
+    task.end_ms = MonotonicClockMS() - _start_ms;
+
+    for (id_t next : task.next) {
+      if (--_tasks[next].pending == 0) {
+        Ready(next);
+      }
+    }
+    --_remaining;
+    _cond.Broadcast();
+  }
+}
+
+void TaskGraph::Run(unsigned threads) {
+  {
+    ScopeLock lock(_mutex);
+    _start_ms = MonotonicClockMS();
+    _remaining = _tasks.size();
+    for (id_t id = 0; id < _tasks.size(); ++id) {
+      if (_tasks[id].pending == 0) {
+        Ready(id);
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<worker_t>> workers;
+  for (unsigned i = 0; i < threads; ++i) {
+    workers.push_back(std::make_unique<worker_t>([this]() {
+      Process(false, true);
+    }));
+    if (!workers.back()->Start()) {
+      workers.pop_back();
+      break;
+    }
+  }
+
+  Process(true, !workers.empty());
+
+  for (auto& worker : workers) {
+    worker->Join();
+  }
+
+  unsigned total_ms = 0;
+  for (const task_t& task : _tasks) {
+    StartupStore(_T(". %s : %u ms (from %u to %u ms, %s thread)%s"), task.name,
+                 task.end_ms - task.start_ms, task.start_ms, task.end_ms,
+                 ((task.main_thread || workers.empty()) ? _T("main") : _T("worker")), NEWLINE);
+    total_ms = std::max(total_ms, task.end_ms);
+  }
+  StartupStore(_T(". %u tasks done in %u ms using %u worker threads%s"),
+               static_cast<unsigned>(_tasks.size()), total_ms, static_cast<unsigned>(workers.size()), NEWLINE);
+}
+
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include "Poco/Thread.h"
+#include <atomic>
+
+TEST_SUITE("TaskGraph") {
+
+  TEST_CASE("dependencies") {
+    for (unsigned threads : { 0U, 1U, 3U }) {
+      TaskGraph graph;
+      std::atomic<unsigned> step = {};
+      unsigned a = 0, b = 0, c = 0, d = 0;
+      const Poco::Thread::TID caller = Poco::Thread::currentTid();
+      bool main_in_caller = false;
+
+      auto ta = graph.Add(_T("a"), [&]() { Poco::Thread::sleep(10); a = ++step; });
+      auto tb = graph.Add(_T("b"), [&]() { b = ++step; });
+      auto tc = graph.Add(_T("c"), [&]() {
+        main_in_caller = (Poco::Thread::currentTid() == caller);
+        c = ++step;
+      }, { ta }, true);
+      graph.Add(_T("d"), [&]() { d = ++step; }, { tb, tc });
+
+      graph.Run(threads);
+
+      CHECK(step == 4);
+      CHECK(a < c);
+      CHECK(b < d);
+      CHECK(c < d);
+      CHECK(main_in_caller);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   TaskGraph.hpp
+ */
+
+#ifndef _THREAD_TASKGRAPH_HPP_
+#define _THREAD_TASKGRAPH_HPP_
+
+#include "tchar.h"
+#include "Thread/Mutex.hpp"
+#include "Thread/Cond.hpp"
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+/**
+ * Set of jobs with explicit dependencies, run once by a small pool of
+ * threads.
+ *
+ * A task is started as soon as all tasks it depends on are done. Tasks
+ * flagged main_thread (those which can show a dialog) are always run by the
+ * thread calling Run(), others by worker threads.
+ *
+ * Duration of each task is logged to runtime.log at end of Run().
+ */
+class TaskGraph final {
+public:
+  using function_t = std::function<void()>;
+  using id_t = size_t;
+
+  /**
+   * @depends : tasks that must be done before this one, they must be added before.
+   * @return id of the new task
+   */
+  id_t Add(const TCHAR* name, function_t&& function, std::initializer_list<id_t> depends = {}, bool main_thread = false);
+
+  /**
+   * Run all tasks using @threads worker threads, return when all tasks are done.
+   * With 0 threads, all tasks are run by caller in dependency order.
+   */
+  void Run(unsigned threads);
+
+private:
+  struct task_t {
+    const TCHAR* name;
+    function_t function;
+    std::vector<id_t> next; // tasks depending on this one
+    unsigned pending; // number of tasks to wait before start
+    bool main_thread;
+    unsigned start_ms;
+    unsigned end_ms;
+  };
+
+  /**
+   * run ready tasks until all tasks are done.
+   * @main_thread : caller is the thread calling Run()
+   * @workers : worker threads are running, otherwise main thread run all tasks
+   */
+  void Process(bool main_thread, bool workers);
+
+  void Ready(id_t id);
+
+  std::vector<task_t> _tasks;
+
+  Mutex _mutex; // protect all bellow
+  Cond _cond;
+  std::deque<id_t> _ready; // ready tasks for workers
+  std::deque<id_t> _ready_main; // ready tasks for main thread
+  size_t _remaining = 0;
+  unsigned _start_ms = 0;
+};
+
+#endif // _THREAD_TASKGRAPH_HPP_
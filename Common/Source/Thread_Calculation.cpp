@@ -81,6 +81,8 @@ public:
             Fanet_RefreshSlots(&GPS_INFO); //refresh slots of FANET
             memcpy(&tmpGPS, &GPS_INFO, sizeof (NMEA_INFO));
             memcpy(&tmpCALCULATED, &CALCULATED_INFO, sizeof (DERIVED_INFO));
+            // FLARM slots are refreshed, draw thread read this without locking flight data
+            PublishGPSInfo();
             UnlockFlightData();
 
             DoCalculationsVario(&tmpGPS, &tmpCALCULATED);
@@ -115,6 +117,7 @@ public:
             LockFlightData();
             memcpy(&CALCULATED_INFO, &tmpCALCULATED, sizeof (DERIVED_INFO));
             UnlockFlightData();            
+            CALCULATED_INFO_Snapshot.Write(tmpCALCULATED);
 
             // This is activating another run for Thread Draw
             TriggerRedraws(&tmpGPS, &tmpCALCULATED);
@@ -141,6 +144,7 @@ public:
                 LockFlightData();
                 memcpy(&CALCULATED_INFO, &tmpCALCULATED, sizeof (DERIVED_INFO));
                 UnlockFlightData();            
+                CALCULATED_INFO_Snapshot.Write(tmpCALCULATED);
             }            
             
             if (MapWindow::CLOSETHREAD) break; // drop out on exit
@@ -154,6 +158,14 @@ public:
 
             ExternalDeviceSendTarget();
         }
+
+        const auto lock_stats = CritSec_FlightData.Stats();
+        StartupStore(_T(". FlightData lock : %u lock, %u contended, %u ms wait"),
+                     lock_stats.locks, lock_stats.contended, lock_stats.wait_ms);
+        const auto gps_stats = GPS_INFO_Snapshot.Stats();
+        const auto calc_stats = CALCULATED_INFO_Snapshot.Stats();
+        StartupStore(_T(". FlightData snapshot : %u/%u read, %u/%u retry"),
+                     gps_stats.reads, calc_stats.reads, gps_stats.retries, calc_stats.retries);
     }
 private:
     NMEA_INFO tmpGPS;
@@ -276,7 +276,7 @@ _dontbitblt:
 	} // MapDirty
 
 	lastdrawwasbitblitted=false;
-	MapWindow::UpdateInfo(&GPS_INFO, &CALCULATED_INFO);
+	MapWindow::UpdateInfo();
 	RenderMapWindow(DrawSurface, MapRect);
 
     {
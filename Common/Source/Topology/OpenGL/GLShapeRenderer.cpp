@@ -27,10 +27,34 @@
 #include "Screen/OpenGL/Program.hpp"
 #endif
 
-void GLShapeRenderer::renderPolygon(ShapeSpecialRenderer& renderer, LKSurface& Surface, const XShape& shape, const Brush& brush, const ScreenProjection& _Proj) {
+void GLShapeRenderer::Tessellate(XShape& shape) {
+  const shapeObj& shp = shape.shape;
+  BeginPolygon(shape.tessellation);
+  for( const lineObj& line : make_array(shp.line , shp.numlines)) {
+    BeginContour();
+    const pointObj* prev = nullptr;
+    for( const pointObj& pt : make_array(line.point, line.numpoints)) {
+      if (!prev || pt.x != prev->x || pt.y != prev->y) {
+        AddVertex(pt.x, pt.y);
+        prev = &pt;
+      }
+    }
+    EndContour();
+  }
+  EndPolygon();
+}
+
+void GLShapeRenderer::renderPolygon(ShapeSpecialRenderer& renderer, LKSurface& Surface, XShape& shape, const Brush& brush, const ScreenProjection& _Proj) {
   /*
    OpenGL cannot draw complex polygons so we need to use a Tessallator to draw the polygon using a GL_TRIANGLE_FAN
+   Tessellation is done in geographic coordinate and kept with shape until it's reloaded.
    */
+  const shapeObj& shp = shape.shape;
+
+  if (!shape.tessellation.Valid()) {
+    Tessellate(shape);
+  }
+
 #ifdef USE_GLSL
   OpenGL::solid_shader->Use();
 #endif
@@ -42,36 +66,34 @@ void GLShapeRenderer::renderPolygon(ShapeSpecialRenderer& renderer, LKSurface& S
     blend = std::make_unique<const ScopeAlphaBlend>();
   }
 
-  curr_LabelPos.x = clipRect.right;
-  curr_LabelPos.y = clipRect.bottom;
+  const auto& vertices = shape.tessellation.Vertices();
+  _screen_triangles.resize(vertices.size());
+  _Proj.ToScreen(vertices.size(), [&](size_t i) {
+    return GeoPoint(vertices[i].y, vertices[i].x);
+  }, _screen_triangles.data());
 
-  const shapeObj& shp = shape.shape;
+  shape.tessellation.Draw(_screen_triangles.data());
 
-  FloatPoint prev_pt = {
-          std::numeric_limits<FloatPoint::scalar_type>::max(),
-          std::numeric_limits<FloatPoint::scalar_type>::max()
-  };
+  if(noLabel || !shape.HasLabel()) {
+    return;
+  }
 
-  const GeoToScreen<FloatPoint> ToScreen(_Proj);
+  // label is drawn at left most point of shape
+  curr_LabelPos.x = clipRect.right;
+  curr_LabelPos.y = clipRect.bottom;
 
-  BeginPolygon();
   for( const lineObj& line : make_array(shp.line , shp.numlines)) {
-    BeginContour();
-    for( const pointObj &point : make_array(line.point, line.numpoints)) {
-      const FloatPoint pt = ToScreen(point);
-      if (!noLabel &&  (pt.x<=curr_LabelPos.x)) {
+    _screen_points.resize(line.numpoints);
+    _Proj.ToScreen(line.point, line.point + line.numpoints, _screen_points.data());
+
+    for( const FloatPoint &pt : _screen_points) {
+      if (pt.x<=curr_LabelPos.x) {
         curr_LabelPos = pt;
       }
-      if(ManhattanDistance(prev_pt, pt) > 1) {
-        AddVertex((GLdouble) pt.x, (GLdouble) pt.y);
-        prev_pt = pt;
-      }
     }
-    EndContour();
   }
-  EndPolygon();
 
-  if(shape.HasLabel() && clipRect.IsInside(curr_LabelPos)) {
+  if(clipRect.IsInside(curr_LabelPos)) {
     shape.renderSpecial(renderer, Surface, curr_LabelPos.x, curr_LabelPos.y, clipRect);
   }
 }
@@ -14,6 +14,7 @@
 
 #include "Screen/OpenGL/PolygonRenderer.h"
 #include "../ShapeSpecialRenderer.h"
+#include <vector>
 
 class Brush;
 class XShape;
@@ -31,13 +32,23 @@ public:
         noLabel = b;
     }
     
-    void renderPolygon(ShapeSpecialRenderer& renderer, LKSurface& Surface, const XShape& shape, const Brush& brush, const ScreenProjection& _Proj);
+    /**
+     * @shape is tessellated the first time it's drawn after loading,
+     * next frames only convert triangle vertices to screen coordinate.
+     */
+    void renderPolygon(ShapeSpecialRenderer& renderer, LKSurface& Surface, XShape& shape, const Brush& brush, const ScreenProjection& _Proj);
     
 private:
 
+    // fill @shape tessellation using its geographic coordinate.
+    void Tessellate(XShape& shape);
+
     bool noLabel;
     PixelRect clipRect;
     FloatPoint curr_LabelPos;
+
+    std::vector<FloatPoint> _screen_points; // member for reduce memory alloc, used only by renderPolygon()
+    std::vector<FloatPoint> _screen_triangles; // same for tessellation vertices
 };
 
 #endif	/* GLSHAPERENDERER_H */
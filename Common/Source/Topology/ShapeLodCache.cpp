@@ -0,0 +1,499 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   ShapeLodCache.cpp
+ */
+
+#include "externs.h"
+#include "ShapeLodCache.h"
+#include "utils/filesystem.h"
+#include <vector>
+
+namespace {
+
+  constexpr uint32_t cache_magic = 0x4C544B4C; // "LKTL"
+  constexpr uint32_t cache_version = 1;
+
+  constexpr double coord_scale = 1e7; // 1e-7 degree unit
+  constexpr double meter_per_degree = 111195.;
+
+  struct header_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t levels;
+    uint32_t reserved;
+    ShapeLodCache::key_t key;
+  };
+
+  /*
+   * shape record, 32 bits aligned :
+   *   int32_t type;
+   *   int32_t numlines;
+   *   int32_t numpoints[numlines];
+   *   int32_t coords[2 * total numpoints]; // x, y
+   */
+
+  bool operator==(const ShapeLodCache::key_t& a, const ShapeLodCache::key_t& b) {
+    return a.numshapes == b.numshapes && a.type == b.type && a.file_size == b.file_size
+        && a.bounds.minx == b.bounds.minx && a.bounds.miny == b.bounds.miny
+        && a.bounds.maxx == b.bounds.maxx && a.bounds.maxy == b.bounds.maxy;
+  }
+
+  // square distance from @p to segment [@a, @b], x is scaled by @xscale
+  double SegmentDistance2(const pointObj& p, const pointObj& a, const pointObj& b, double xscale) {
+    const double dx = (b.x - a.x) * xscale;
+    const double dy = b.y - a.y;
+    const double px = (p.x - a.x) * xscale;
+    const double py = p.y - a.y;
+    const double len2 = dx * dx + dy * dy;
+    double t = 0;
+    if (len2 > 0) {
+      t = std::clamp((px * dx + py * dy) / len2, 0., 1.);
+    }
+    const double ex = px - t * dx;
+    const double ey = py - t * dy;
+    return ex * ex + ey * ey;
+  }
+
+  /**
+   * Douglas-Peucker simplification of @line, restricted to @index.
+   * first and last point are always kept.
+   */
+  std::vector<int> Simplify(const lineObj& line, const std::vector<int>& index, double tolerance, double xscale) {
+    if (index.size() < 3) {
+      return index;
+    }
+
+    std::vector<bool> keep(index.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+
+    const double tolerance2 = tolerance * tolerance;
+
+    std::vector<std::pair<size_t, size_t>> stack;
+    stack.emplace_back(0, index.size() - 1);
+    while (!stack.empty()) {
+      const auto [first, last] = stack.back();
+      stack.pop_back();
+
+      double max_dist2 = 0;
+      size_t farthest = first;
+      for (size_t i = first + 1; i < last; ++i) {
+        const double dist2 = SegmentDistance2(line.point[index[i]], line.point[index[first]], line.point[index[last]], xscale);
+        if (dist2 > max_dist2) {
+          max_dist2 = dist2;
+          farthest = i;
+        }
+      }
+      if (max_dist2 > tolerance2) {
+        keep[farthest] = true;
+        stack.emplace_back(first, farthest);
+        stack.emplace_back(farthest, last);
+      }
+    }
+
+    std::vector<int> result;
+    for (size_t i = 0; i < index.size(); ++i) {
+      if (keep[i]) {
+        result.push_back(index[i]);
+      }
+    }
+    return result;
+  }
+
+  int32_t ToFixed(double value) {
+    return static_cast<int32_t>(lround(value * coord_scale));
+  }
+
+} // namespace
+
+
+unsigned ShapeLodCache::Level(double pixel_size) {
+  unsigned level = 0;
+  double tolerance = TOLERANCE;
+  while (level < LEVELS && tolerance <= pixel_size) {
+    ++level;
+    tolerance *= 4;
+  }
+  return level;
+}
+
+
+void ShapeLodCache::CachePath(const TCHAR* shape_path, TCHAR* cache_path, size_t size) {
+  _sntprintf(cache_path, size, _T("%s.lod"), shape_path);
+  cache_path[size - 1] = _T('\0');
+
+  // replace separators from the end, until parent is an existing directory.
+  for (TCHAR* p = cache_path + _tcslen(cache_path) - 1; p > cache_path; --p) {
+    if (*p != _T('/') && *p != _T('\\')) {
+      continue;
+    }
+    const TCHAR c = *p;
+    *p = _T('\0');
+    const bool directory = lk::filesystem::isDirectory(cache_path);
+    *p = directory ? c : _T('_');
+    if (directory) {
+      break;
+    }
+  }
+}
+
+
+ShapeLodCache::Builder::Builder(const TCHAR* path, const key_t& key) : _key(key) {
+  _sntprintf(_path, MAX_PATH, _T("%s"), path);
+  _path[MAX_PATH - 1] = _T('\0');
+  _sntprintf(_tmp_path, MAX_PATH, _T("%s.tmp"), path);
+  _tmp_path[MAX_PATH - 1] = _T('\0');
+
+  _file = _tfopen(_tmp_path, _T("wb"));
+  if (!_file) {
+    return;
+  }
+
+  const header_t header = { cache_magic, cache_version, LEVELS, 0, key };
+  _offsets.resize(LEVELS * key.numshapes);
+
+  _success = (fwrite(&header, sizeof(header), 1, _file) == 1);
+  _success = _success && (fwrite(_offsets.data(), sizeof(uint32_t), _offsets.size(), _file) == _offsets.size());
+
+  _position = sizeof(header) + sizeof(uint32_t) * _offsets.size();
+}
+
+
+ShapeLodCache::Builder::~Builder() {
+  if (_file) {
+    // unfinished build
+    fclose(_file);
+    lk::filesystem::deleteFile(_tmp_path);
+  }
+}
+
+
+bool ShapeLodCache::Builder::Step(const reader_t& reader, int count) {
+  if (!_file) {
+    return false;
+  }
+
+  PeriodClock starttick;
+  starttick.Update();
+
+  shapeObj shape;
+  msInitShape(&shape);
+
+  std::vector<int32_t> record;
+  std::vector<std::vector<int>> lines;
+
+  for (const int end = std::min(_key.numshapes, _next + count); _success && _next < end; ++_next) {
+    reader(_next, shape);
+
+    // x is scaled to get same unit on both axis
+    const double center = (shape.bounds.miny + shape.bounds.maxy) / 2;
+    const double xscale = std::max(0.01, cos(center * DEG_TO_RAD));
+
+    // each level is simplification of previous one
+    lines.resize(shape.numlines);
+    for (int l = 0; l < shape.numlines; ++l) {
+      lines[l].resize(shape.line[l].numpoints);
+      for (int p = 0; p < shape.line[l].numpoints; ++p) {
+        lines[l][p] = p;
+      }
+    }
+
+    double tolerance = TOLERANCE / meter_per_degree;
+    for (unsigned level = 0; _success && level < LEVELS; ++level, tolerance *= 4) {
+      record.clear();
+      record.push_back(shape.type);
+      record.push_back(shape.numlines);
+      for (int l = 0; l < shape.numlines; ++l) {
+        lines[l] = Simplify(shape.line[l], lines[l], tolerance, xscale);
+        record.push_back(lines[l].size());
+      }
+      for (int l = 0; l < shape.numlines; ++l) {
+        for (int p : lines[l]) {
+          record.push_back(ToFixed(shape.line[l].point[p].x));
+          record.push_back(ToFixed(shape.line[l].point[p].y));
+        }
+      }
+
+      if (_position > std::numeric_limits<uint32_t>::max()) {
+        _success = false;
+        break;
+      }
+      _offsets[level * _key.numshapes + _next] = _position;
+      _success = (fwrite(record.data(), sizeof(int32_t), record.size(), _file) == record.size());
+      _position += sizeof(int32_t) * record.size();
+    }
+
+    msFreeShape(&shape);
+  }
+
+  if (!_success || _next >= _key.numshapes) {
+    _success = Finish();
+  }
+
+  _elapsed += starttick.Elapsed();
+  return (_file != nullptr);
+}
+
+
+bool ShapeLodCache::Builder::Finish() {
+  bool success = _success;
+  success = success && (fseek(_file, sizeof(header_t), SEEK_SET) == 0);
+  success = success && (fwrite(_offsets.data(), sizeof(uint32_t), _offsets.size(), _file) == _offsets.size());
+  success = (fclose(_file) == 0) && success;
+  _file = nullptr;
+
+  if (success) {
+    lk::filesystem::deleteFile(_path);
+    success = lk::filesystem::moveFile(_tmp_path, _path);
+  }
+  if (!success) {
+    lk::filesystem::deleteFile(_tmp_path);
+  }
+  return success;
+}
+
+
+std::unique_ptr<ShapeLodCache> ShapeLodCache::Builder::Open() const {
+  if (_file || !_success) {
+    return nullptr;
+  }
+  return ShapeLodCache::Open(_path, _key);
+}
+
+
+bool ShapeLodCache::Map(const TCHAR* path, const key_t& key) {
+  _file.open(path);
+  if (!_file.is_open() || !_file.data()) {
+    return false;
+  }
+
+  const size_t offsets_size = sizeof(uint32_t) * LEVELS * key.numshapes;
+  if (_file.mapped_size() < sizeof(header_t) + offsets_size) {
+    return false;
+  }
+
+  const header_t* header = reinterpret_cast<const header_t*>(_file.data());
+  if (header->magic != cache_magic || header->version != cache_version
+          || header->levels != LEVELS || !(header->key == key)) {
+    return false;
+  }
+
+  _offsets = reinterpret_cast<const uint32_t*>(_file.data() + sizeof(header_t));
+  for (size_t i = 0; i < LEVELS * key.numshapes; ++i) {
+    if ((_offsets[i] % sizeof(int32_t)) || (_offsets[i] + 2 * sizeof(int32_t) > _file.mapped_size())) {
+      return false;
+    }
+  }
+
+  _numshapes = key.numshapes;
+  return true;
+}
+
+
+std::unique_ptr<ShapeLodCache> ShapeLodCache::Open(const TCHAR* path, const key_t& key) {
+  std::unique_ptr<ShapeLodCache> cache(new ShapeLodCache());
+  if (cache->Map(path, key)) {
+    return cache;
+  }
+  return nullptr;
+}
+
+
+bool ShapeLodCache::Read(unsigned level, int index, shapeObj& shape) const {
+  if (level < 1 || level > LEVELS || index < 0 || index >= _numshapes) {
+    return false;
+  }
+
+  const char* data = _file.data();
+  const size_t size = _file.mapped_size();
+
+  const uint32_t offset = _offsets[(level - 1) * _numshapes + index];
+  const int32_t* record = reinterpret_cast<const int32_t*>(data + offset);
+  const int32_t numlines = record[1];
+
+  if (numlines < 0 || offset + sizeof(int32_t) * (2 + static_cast<size_t>(numlines)) > size) {
+    return false;
+  }
+
+  const int32_t* numpoints = record + 2;
+  size_t total = 0;
+  for (int32_t l = 0; l < numlines; ++l) {
+    if (numpoints[l] < 0) {
+      return false;
+    }
+    total += numpoints[l];
+  }
+  const int32_t* coords = numpoints + numlines;
+  if (offset + sizeof(int32_t) * (2 + numlines + 2 * total) > size) {
+    return false;
+  }
+
+  // same allocation than msSHPReadShape(), shape is released by msFreeShape()
+  shape.type = record[0];
+  if (numlines > 0) {
+    shape.line = static_cast<lineObj*>(malloc(sizeof(lineObj) * numlines));
+    if (!shape.line) {
+      return false;
+    }
+  }
+  for (int32_t l = 0; l < numlines; ++l) {
+    lineObj& line = shape.line[l];
+    line.numpoints = numpoints[l];
+    line.point = static_cast<pointObj*>(malloc(sizeof(pointObj) * std::max(1, line.numpoints)));
+    if (!line.point) {
+      msFreeShape(&shape);
+      return false;
+    }
+    shape.numlines = l + 1;
+
+    for (int p = 0; p < line.numpoints; ++p, coords += 2) {
+      pointObj& pt = line.point[p];
+      pt = {};
+      pt.x = coords[0] / coord_scale;
+      pt.y = coords[1] / coord_scale;
+
+      if (l == 0 && p == 0) {
+        shape.bounds = { pt.x, pt.y, pt.x, pt.y };
+      } else {
+        shape.bounds.minx = std::min(shape.bounds.minx, pt.x);
+        shape.bounds.miny = std::min(shape.bounds.miny, pt.y);
+        shape.bounds.maxx = std::max(shape.bounds.maxx, pt.x);
+        shape.bounds.maxy = std::max(shape.bounds.maxy, pt.y);
+      }
+    }
+  }
+  return true;
+}
+
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include "Util/tstring.hpp"
+
+namespace {
+
+  // one closed ring, circle with small noise.
+  void ReadTestShape(int index, shapeObj& shape) {
+    const int count = 2000;
+    shape.line = static_cast<lineObj*>(malloc(sizeof(lineObj)));
+    shape.numlines = 1;
+
+    lineObj& line = shape.line[0];
+    line.numpoints = count + 1;
+    line.point = static_cast<pointObj*>(malloc(sizeof(pointObj) * line.numpoints));
+
+    const double center_x = 6. + index * 0.1;
+    for (int i = 0; i < count; ++i) {
+      const double angle = 2 * M_PI * i / count;
+      const double radius = 0.05 + ((i % 2) ? 1e-6 : -1e-6);
+      line.point[i] = {};
+      line.point[i].x = center_x + radius * cos(angle);
+      line.point[i].y = 45. + radius * sin(angle);
+    }
+    line.point[count] = line.point[0];
+
+    shape.type = MS_SHAPE_POLYGON;
+    shape.bounds = { center_x - 0.05, 45. - 0.05, center_x + 0.05, 45. + 0.05 };
+  }
+}
+
+TEST_SUITE("ShapeLodCache") {
+
+  TEST_CASE("level") {
+    CHECK(ShapeLodCache::Level(1.) == 0);
+    CHECK(ShapeLodCache::Level(ShapeLodCache::TOLERANCE) == 1);
+    CHECK(ShapeLodCache::Level(ShapeLodCache::TOLERANCE * 5) == 2);
+    CHECK(ShapeLodCache::Level(1e6) == ShapeLodCache::LEVELS);
+  }
+
+  TEST_CASE("cache path") {
+    TCHAR tmp[MAX_PATH];
+    REQUIRE(lk::filesystem::getTempPath(tmp, MAX_PATH));
+
+    TCHAR cache_path[MAX_PATH];
+
+    ShapeLodCache::CachePath((tstring(tmp) + _T("roads")).c_str(), cache_path, MAX_PATH);
+    CHECK(cache_path == tstring(tmp) + _T("roads.lod"));
+
+    // shapefile in zip subdirectory, "ShapeLodCache_test.LKM" is not a directory
+    ShapeLodCache::CachePath((tstring(tmp) + _T("ShapeLodCache_test.LKM/dir/roads")).c_str(), cache_path, MAX_PATH);
+    CHECK(cache_path == tstring(tmp) + _T("ShapeLodCache_test.LKM_dir_roads.lod"));
+  }
+
+  TEST_CASE("build and read") {
+    TCHAR path[MAX_PATH];
+    REQUIRE(lk::filesystem::getTempPath(path, MAX_PATH));
+    _tcscat(path, _T("ShapeLodCache_test.lod"));
+    lk::filesystem::deleteFile(path);
+
+    ShapeLodCache::key_t key = { 3, MS_SHAPEFILE_POLYGON, 123456, 0, { 5., 44., 7., 46. } };
+
+    int read_count = 0;
+    auto reader = [&](int index, shapeObj& shape) {
+      ++read_count;
+      ReadTestShape(index, shape);
+    };
+
+    CHECK_FALSE(ShapeLodCache::Open(path, key));
+
+    {
+      ShapeLodCache::Builder builder(path, key);
+      CHECK(builder.Step(reader, 2));
+      CHECK(read_count == 2);
+      CHECK_FALSE(builder.Open()); // not finished
+      CHECK_FALSE(ShapeLodCache::Open(path, key));
+      CHECK_FALSE(builder.Step(reader, 2));
+      CHECK(read_count == key.numshapes);
+
+      auto cache = builder.Open();
+      REQUIRE(cache);
+
+      int previous = 2001;
+      for (unsigned level = 1; level <= ShapeLodCache::LEVELS; ++level) {
+        shapeObj shape;
+        msInitShape(&shape);
+        REQUIRE(cache->Read(level, 2, shape));
+        CHECK(shape.type == MS_SHAPE_POLYGON);
+        REQUIRE(shape.numlines == 1);
+
+        const lineObj& line = shape.line[0];
+        CHECK(line.numpoints < previous);
+        previous = line.numpoints;
+
+        // ring is still closed and all points are on circle
+        CHECK(line.point[0].x == line.point[line.numpoints - 1].x);
+        CHECK(line.point[0].y == line.point[line.numpoints - 1].y);
+        for (int i = 0; i < line.numpoints; ++i) {
+          const double dx = line.point[i].x - 6.2;
+          const double dy = line.point[i].y - 45.;
+          CHECK(sqrt(dx * dx + dy * dy) == doctest::Approx(0.05).epsilon(1e-3));
+        }
+        CHECK(shape.bounds.maxx == doctest::Approx(6.25).epsilon(1e-6));
+        msFreeShape(&shape);
+      }
+    }
+
+    // existing cache is reused
+    CHECK(ShapeLodCache::Open(path, key));
+
+    // outdated cache is rejected
+    key.file_size++;
+    CHECK_FALSE(ShapeLodCache::Open(path, key));
+
+    // unfinished build don't replace existing file
+    {
+      ShapeLodCache::Builder builder(path, key);
+      CHECK(builder.Step(reader, 1));
+    }
+    CHECK_FALSE(ShapeLodCache::Open(path, key));
+    key.file_size--;
+    CHECK(ShapeLodCache::Open(path, key));
+
+    lk::filesystem::deleteFile(path);
+  }
+}
+
+#endif
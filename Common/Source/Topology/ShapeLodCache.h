@@ -0,0 +1,139 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   ShapeLodCache.h
+ */
+
+#ifndef TOPOLOGY_SHAPELODCACHE_H
+#define TOPOLOGY_SHAPELODCACHE_H
+
+#include "tchar.h"
+#include "Topology/shapelib/mapserver.h"
+#include "Library/cpp-mmf/memory_mapped_file.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * Simplified geometry of line and polygon shapefile, stored in a file next to
+ * the shapefile.
+ *
+ * File is built once from the shapefile and memory mapped. For each shape and
+ * each level of detail, it contains Douglas-Peucker simplification of every
+ * line (tolerance is multiplied by 4 from one level to the next), with
+ * coordinates stored as int32 1e-7 degree fixed point.
+ *
+ * Level 0 is full resolution, it's never stored and must be read from
+ * shapefile.
+ *
+ * Building can take several seconds for big layers, so it's done step by step
+ * by Builder, until it's finished shapefile must be used at full resolution.
+ */
+class ShapeLodCache final {
+public:
+  static constexpr unsigned LEVELS = 3; // not including full resolution
+  static constexpr double TOLERANCE = 20.; // meters, tolerance of level 1
+
+  // identify shapefile used to build cache
+  struct key_t {
+    int32_t numshapes;
+    int32_t type;
+    int32_t file_size;
+    int32_t reserved;
+    rectObj bounds;
+  };
+
+  // callable used to read full resolution shape from shapefile.
+  using reader_t = std::function<void(int index, shapeObj& shape)>;
+
+  class Builder;
+
+  /**
+   * Open existing cache file.
+   * @return nullptr if file is missing or outdated.
+   */
+  static std::unique_ptr<ShapeLodCache> Open(const TCHAR* path, const key_t& key);
+
+  /**
+   * Cache file path for shapefile @shape_path (without extension).
+   * if shapefile is inside zip archive, cache is next to archive :
+   *    "_Maps/MAP.LKM/dir/roads" => "_Maps/MAP.LKM_dir_roads.lod"
+   */
+  static void CachePath(const TCHAR* shape_path, TCHAR* cache_path, size_t size);
+
+  /**
+   * @return level of detail to use for @pixel_size (in meter), 0 if full
+   *         resolution is required.
+   */
+  static unsigned Level(double pixel_size);
+
+  /**
+   * Load into empty @shape geometry of shape @index for @level (1 to LEVELS)
+   */
+  bool Read(unsigned level, int index, shapeObj& shape) const;
+
+  size_t Size() const {
+    return _file.file_size();
+  }
+
+private:
+  ShapeLodCache() = default;
+
+  bool Map(const TCHAR* path, const key_t& key);
+
+  memory_mapped_file::read_only_mmf _file;
+  const uint32_t* _offsets = nullptr; // [LEVELS][numshapes], from begin of file
+  int32_t _numshapes = 0;
+};
+
+/**
+ * Write cache file, one shape at a time. Result is written in temporary file
+ * renamed to cache path when all shapes are done.
+ */
+class ShapeLodCache::Builder final {
+public:
+  Builder(const TCHAR* path, const key_t& key);
+  ~Builder();
+
+  Builder(const Builder&) = delete;
+  Builder& operator=(const Builder&) = delete;
+
+  /**
+   * build next @count shapes
+   * @return false when build is finished (or failed).
+   */
+  bool Step(const reader_t& reader, int count);
+
+  /**
+   * @return cache if build is finished successfully, nullptr otherwise.
+   */
+  std::unique_ptr<ShapeLodCache> Open() const;
+
+  const TCHAR* Path() const {
+    return _path;
+  }
+
+  unsigned Elapsed() const {
+    return _elapsed;
+  }
+
+private:
+  bool Finish();
+
+  TCHAR _path[MAX_PATH];
+  TCHAR _tmp_path[MAX_PATH];
+  key_t _key;
+
+  FILE* _file = nullptr;
+  std::vector<uint32_t> _offsets; // [LEVELS][numshapes], from begin of file
+  uint64_t _position = 0;
+  int _next = 0; // next shape to build
+  bool _success = false;
+  unsigned _elapsed = 0; // time spent in Step(), ms
+};
+
+#endif // TOPOLOGY_SHAPELODCACHE_H
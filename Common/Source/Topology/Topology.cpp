@@ -9,6 +9,7 @@
 #include "externs.h"
 #include <ctype.h> // needed for Wine
 #include "Topology.h"
+#include "TopologyLoader.h"
 #include "Multimap.h"
 #include "OS/Memory.h"
 #include "resource_data.h"
@@ -20,6 +21,7 @@
 #include "utils/charset_helper.h"
 #include <functional>
 #include "Utils.h"
+#include "utils/filesystem.h"
 
 #ifdef ENABLE_OPENGL
 #include "OpenGL/GLShapeRenderer.h"
@@ -40,11 +42,28 @@ XShape::~XShape() {
 
 void XShape::clear() {
   msFreeShape(&shape);
+#ifdef ENABLE_OPENGL
+  tessellation.clear();
+#endif
 }
 
 
 void XShape::load(shapefileObj* shpfile, int i) {
   msSHPReadShape(shpfile->hSHP, i, &shape);
+  lod_level = 0;
+#ifdef ENABLE_OPENGL
+  tessellation.clear();
+#endif
+}
+
+void XShape::load(const ShapeLodCache& cache, unsigned level, int i) {
+  if (!cache.Read(level, i, shape)) {
+    msFreeShape(&shape);
+  }
+  lod_level = level;
+#ifdef ENABLE_OPENGL
+  tessellation.clear();
+#endif
 }
 
 
@@ -161,6 +180,9 @@ Topology::Topology(const TCHAR* shpname, int field1) {
   // filename aleady points to _MAPS subdirectory!
   to_utf8(shpname, filename);
 
+  // LOD cache is next to shapefile, or next to map archive if shapefile is inside zip
+  ShapeLodCache::CachePath(shpname, lod_filename, MAX_PATH);
+
   Open();
 }
 
@@ -304,6 +326,21 @@ void Topology::Open() {
   if (shpCache) {
     initCache();
     shapefileopen = true;
+
+    // point layers have nothing to simplify, and mode 2 already have all shapes in memory.
+    if (cache_mode != 2 && (shpfile.type == MS_SHAPEFILE_ARC || shpfile.type == MS_SHAPEFILE_POLYGON)) {
+      const ShapeLodCache::key_t key = {
+        shpfile.numshapes, shpfile.type, shpfile.hSHP->nFileSize, 0, shpfile.bounds
+      };
+      _lod = ShapeLodCache::Open(lod_filename, key);
+      if (!_lod) {
+        // shapefile is used at full resolution until cache is built in background
+        _lod_builder = std::make_unique<ShapeLodCache::Builder>(lod_filename, key);
+        TopoLoader.RequestLodBuild(this);
+      }
+    }
+    _lod_level = 0;
+    _lod_pending = false;
   } else {
     StartupStore(_T("------ ERR Topology,  malloc failed shpCache%s"), NEWLINE);
   }
@@ -311,7 +348,15 @@ void Topology::Open() {
 
 
 void Topology::Close() {
+  ScopeLock lock(_cache_mutex);
   if (shapefileopen) {
+#if TESTBENCH
+    if (_stats.updates) {
+      StartupStore(_T(". Topology <%s> : %u cache update (max %ums, total %ums), %u shapes loaded, %u/%u prefetched shapes used (%ums)%s"),
+                   filename, _stats.updates, _stats.update_max_ms, _stats.update_total_ms, _stats.loaded,
+                   _stats.prefetch_used, _stats.prefetched, _stats.prefetch_total_ms, NEWLINE);
+    }
+#endif
     if (shpCache) {
       flushCache();
       free(shpCache); shpCache = NULL;
@@ -325,6 +370,8 @@ void Topology::Close() {
       }
       free(shps); shps = NULL;
     }
+    _lod.reset();
+    _lod_builder.reset();
     msShapefileClose(&shpfile);
     shapefileopen = false;  // added sgi
   }
@@ -347,6 +394,22 @@ void Topology::TriggerIfScaleNowVisible(void) {
   triggerUpdateCache |= (CheckScale() != in_scale);
 }
 
+bool Topology::TriggerIfLodChanged(double pixel_size) {
+  // swap shapes prefetched since last update
+  triggerUpdateCache |= _lod_pending;
+
+  ScopeLock lock(_cache_mutex);
+  const unsigned level = _lod ? ShapeLodCache::Level(pixel_size) : 0;
+  if (level == _lod_level) {
+    return false;
+  }
+  // shapes already in cache are kept until the new ones are ready.
+  _lod_level = level;
+  _prefetched.clear();
+  triggerUpdateCache = true;
+  return true;
+}
+
 //
 // Always check shpCache is not NULL before calling flushCache!
 //
@@ -369,6 +432,7 @@ void Topology::flushCache() {
 		}
 		break;
   }//sw
+  _prefetched.clear();
   shapes_visible_count = 0;
 #ifdef DEBUG_TFC
   StartupStore(TEXT("   flushCache() ends (%dms)%s"),starttick.Elapsed(),NEWLINE);
@@ -378,6 +442,8 @@ void Topology::flushCache() {
 void Topology::updateCache(rectObj thebounds, bool purgeonly) {
   if (!triggerUpdateCache) return;
 
+  ScopeLock lock(_cache_mutex);
+
   if (!shapefileopen || !shpCache) return;
 
   in_scale = CheckScale();
@@ -398,10 +464,10 @@ void Topology::updateCache(rectObj thebounds, bool purgeonly) {
 
   triggerUpdateCache = false;
 
-#ifdef DEBUG_TFC
-  StartupStore(TEXT("---UpdateCache() starts, mode%d%s"),cache_mode,NEWLINE);
   PeriodClock starttick;
   starttick.Update();
+#ifdef DEBUG_TFC
+  StartupStore(TEXT("---UpdateCache() starts, mode%d%s"),cache_mode,NEWLINE);
 #endif
 
   if(msRectOverlap(&shpfile.bounds, &thebounds) != MS_TRUE) {
@@ -439,7 +505,7 @@ void Topology::updateCache(rectObj thebounds, bool purgeonly) {
           if (msGetBit(shpfile.status, i)) {
             if (shpCache[i]==NULL) {
               // shape is now in range, and wasn't before
-              shpCache[i] = addShape(i);
+              shpCache[i] = takeShape(i);
               shapes_loaded++;
             }
             shapes_visible_count++;
@@ -458,7 +524,7 @@ void Topology::updateCache(rectObj thebounds, bool purgeonly) {
           if (shpCache[i]) continue;
           if(msRectOverlap(&shpBounds[i], &thebounds) == MS_TRUE) {
             // shape is now in range, and wasn't before
-            shpCache[i] = addShape(i);
+            shpCache[i] = takeShape(i);
             shapes_loaded++;
           }
         }//for
@@ -477,7 +543,7 @@ void Topology::updateCache(rectObj thebounds, bool purgeonly) {
           if(msRectOverlap(&shpBounds[i], &thebounds) == MS_TRUE) {
             if (shpCache[i]==NULL) {
               // shape is now in range, and wasn't before
-              shpCache[i] = addShape(i);
+              shpCache[i] = takeShape(i);
               shapes_loaded++;
             }
             shapes_visible_count++;
@@ -505,6 +571,34 @@ void Topology::updateCache(rectObj thebounds, bool purgeonly) {
 
     lastBounds = thebounds;
 
+  // shapes in cache with previous level of detail are replaced by prefetched
+  // ones, or reloaded now if loader thread can't do it.
+  _lod_pending = false;
+  if (cache_mode != 2) {
+    const bool reload = !CanPrefetch() || !TopoLoader.IsRunning();
+    for (int i=0; i<shpfile.numshapes; i++) {
+      if (!shpCache[i] || shpCache[i]->lod_level == _lod_level) continue;
+      auto it = _prefetched.find(i);
+      if (it != _prefetched.end()) {
+        removeShape(i);
+        shpCache[i] = it->second.release();
+        _prefetched.erase(it);
+        _stats.prefetch_used++;
+      } else if (reload) {
+        removeShape(i);
+        shpCache[i] = addShape(i);
+        _stats.loaded++;
+      } else {
+        _lod_pending = true;
+      }
+    }
+  }
+
+  const unsigned elapsed = starttick.Elapsed();
+  _stats.updates++;
+  _stats.update_total_ms += elapsed;
+  _stats.update_max_ms = std::max(_stats.update_max_ms, elapsed);
+
 #ifdef DEBUG_TFC
   long free_size = CheckFreeRam();
   StartupStore(TEXT("   UpdateCache() ends, shps_visible=%d ram=%luM (%dms)%s"),shapes_visible_count, free_size/(1024*1024), starttick.Elapsed(),NEWLINE);
@@ -516,13 +610,13 @@ XShape* Topology::addShape(const int i) {
   if(field < 0) {
     XShape* theshape = new(std::nothrow) XShape();
     if(theshape) {
-      theshape->load(&shpfile,i);
+      loadShape(*theshape, i);
     }
     return theshape;
   } else {  
     XShapeLabel* theshape = new(std::nothrow) XShapeLabel();
     if(theshape) {
-      theshape->load(&shpfile,i);
+      loadShape(*theshape, i);
       theshape->setLabel(msDBFReadStringAttribute( shpfile.hDBF, i, field));
     }
     return theshape;
@@ -530,6 +624,109 @@ XShape* Topology::addShape(const int i) {
 }
 
 
+void Topology::loadShape(XShape& theshape, const int i) {
+  if (_lod && _lod_level > 0) {
+    theshape.load(*_lod, _lod_level, i);
+  } else {
+    theshape.load(&shpfile, i);
+  }
+}
+
+
+XShape* Topology::takeShape(const int i) {
+  auto it = _prefetched.find(i);
+  if (it != _prefetched.end()) {
+    XShape* theshape = it->second.release();
+    _prefetched.erase(it);
+    _stats.prefetch_used++;
+    return theshape;
+  }
+  _stats.loaded++;
+  return addShape(i);
+}
+
+
+void Topology::Prefetch(const rectObj& bounds, const std::atomic<bool>& cancel) {
+  PeriodClock starttick;
+  starttick.Update();
+
+  std::vector<int> candidates;
+  {
+    ScopeLock lock(_cache_mutex);
+    if (!shapefileopen || !shpCache || !shpBounds) return;
+
+    // shapes prefetched for previous request are probably useless now.
+    for (auto it = _prefetched.begin(); it != _prefetched.end();) {
+      if (msRectOverlap(&shpBounds[it->first], &bounds) != MS_TRUE) {
+        it = _prefetched.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    // shapes in cache with previous level of detail are read again
+    for (int i=0; i<shpfile.numshapes; i++) {
+      if ((shpCache[i] && shpCache[i]->lod_level == _lod_level) || _prefetched.count(i)) continue;
+      if (msRectOverlap(&shpBounds[i], &bounds) == MS_TRUE) {
+        candidates.push_back(i);
+      }
+    }
+  }
+
+  // lock is released between each shape, so draw thread never wait more than
+  // one shape reading.
+  for (int i : candidates) {
+    if (cancel) break;
+
+    ScopeLock lock(_cache_mutex);
+    if (!shapefileopen || (shpCache[i] && shpCache[i]->lod_level == _lod_level) || _prefetched.count(i)) continue;
+
+    std::unique_ptr<XShape> theshape(addShape(i));
+    if (theshape) {
+      _prefetched.emplace(i, std::move(theshape));
+      _stats.prefetched++;
+    }
+  }
+
+  ScopeLock lock(_cache_mutex);
+  _stats.prefetch_total_ms += starttick.Elapsed();
+}
+
+
+bool Topology::BuildLod() {
+  auto reader = [&](int i, shapeObj& shape) {
+    msSHPReadShape(shpfile.hSHP, i, &shape);
+  };
+
+  // lock is released between each shape, so draw thread never wait more than
+  // one shape simplification.
+  for (int n = 0; n < 64; ++n) {
+    ScopeLock lock(_cache_mutex);
+    if (!shapefileopen || !_lod_builder) {
+      return true;
+    }
+    if (!_lod_builder->Step(reader, 1)) {
+      _lod = _lod_builder->Open();
+      if (_lod) {
+        StartupStore(_T(". Topology: LOD cache <%s> built in %ums (%u KB)%s"), lod_filename,
+                     _lod_builder->Elapsed(), static_cast<unsigned>(_lod->Size() / 1024), NEWLINE);
+      } else {
+        StartupStore(_T("------ Topology: failed to build LOD cache <%s>%s"), lod_filename, NEWLINE);
+      }
+      _lod_builder.reset();
+      return true;
+    }
+  }
+  return false;
+}
+
+
+Topology::cache_stats_t Topology::GetCacheStats() const {
+  ScopeLock lock(_cache_mutex);
+  return _stats;
+}
+
+
 // Be sure shpCache is not NULL before calling removeShape
 void Topology::removeShape(const int i) {
   if (shpCache[i]) {
@@ -556,30 +753,33 @@ static T shape2Screen(const lineObj& line, int iskip, const ScreenProjection& _P
     std::numeric_limits<scalar_type>::max()
   };
   const int last = line.numpoints-1;
-  points.clear();
-  points.reserve((line.numpoints/iskip)+1);
-
-
-  const GeoToScreen<T> ToScreen(_Proj);
 
-  // first point is inserted before loop for avoid to check "if(first)" inside loop
-  points.push_back(ToScreen(line.point[0]));
-
-  for(int i = 1; i < last; i+=iskip) {
-    const T pt = ToScreen(line.point[i]);
+  // projected points are : first, one every `iskip` points, last
+  const size_t count = (last > 1 ? (last - 2) / iskip + 1 : 0) + 2;
+  points.resize(count);
+  _Proj.ToScreen(count, [&](size_t i) {
+    const int index = (i == 0) ? 0 : (i == count - 1) ? last : 1 + (i - 1) * iskip;
+    const pointObj& pt = line.point[index];
+    return GeoPoint(pt.y, pt.x);
+  }, points.data());
+
+  // first point is always kept, intermediate points are removed in place if too close from previous one.
+  auto prev_pt = points.begin();
+  for(auto it = std::next(points.begin()); it != std::prev(points.end()); ++it) {
+    const T pt = *it;
     if (pt.x<=leftPoint.x) {
       leftPoint = pt;
     }
-    const T& prev_pt = points.back();
-    if(lround(std::abs((prev_pt.x - pt.x) + std::abs(prev_pt.y - pt.y))) > 2) {
-        points.push_back(std::move(pt));
+    if(lround(std::abs((prev_pt->x - pt.x) + std::abs(prev_pt->y - pt.y))) > 2) {
+        *(++prev_pt) = pt;
     }
   }
-  const T pt = ToScreen(line.point[last]);
+  const T pt = points.back();
   if (pt.x<=leftPoint.x) {
     leftPoint = pt;
   }
-  points.push_back(std::move(pt));
+  *(++prev_pt) = pt;
+  points.erase(std::next(prev_pt), points.end());
 
   return leftPoint;
 }
@@ -886,6 +1086,8 @@ void XShapeLabel::clear() {
 
 void Topology::SearchNearest(const rectObj& bounds) {
 
+  ScopeLock lock(_cache_mutex);
+
   if (!shapefileopen) return;
 
   if(msRectOverlap(&shpfile.bounds, &bounds) != MS_TRUE) {
@@ -0,0 +1,121 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   TopologyLoader.cpp
+ */
+
+#include "externs.h"
+#include "Topology.h"
+#include "TopologyLoader.h"
+
+TopologyLoader TopoLoader;
+
+TopologyLoader::TopologyLoader() : _thread("TopologyLoader") {
+}
+
+void TopologyLoader::Start() {
+  if (_thread.isRunning()) {
+    return;
+  }
+  _stop = false;
+  _thread.start(*this);
+  _running = true;
+}
+
+void TopologyLoader::Stop() {
+  if (!_thread.isRunning()) {
+    return;
+  }
+  _running = false;
+  _stop = true;
+  _cancel = true;
+  _event.set();
+  _thread.join();
+
+  ScopeLock lock(_request_mutex);
+  _pending = false;
+  _topologies.clear();
+  _lod_builds.clear();
+}
+
+void TopologyLoader::Request(const rectObj& bounds, std::vector<Topology*>&& topologies) {
+  if (!_running) {
+    return;
+  }
+  {
+    ScopeLock lock(_request_mutex);
+    _pending = true;
+    _bounds = bounds;
+    _topologies = std::move(topologies);
+    _cancel = true; // running request is outdated
+  }
+  _event.set();
+}
+
+void TopologyLoader::RequestLodBuild(Topology* topology) {
+  {
+    ScopeLock lock(_request_mutex);
+    _lod_builds.push_back(topology);
+  }
+  _event.set();
+}
+
+void TopologyLoader::Cancel() {
+  {
+    ScopeLock lock(_request_mutex);
+    _pending = false;
+    _topologies.clear();
+    _lod_builds.clear();
+    _cancel = true;
+  }
+  ScopeLock wait(_job_mutex);
+}
+
+void TopologyLoader::run() {
+  while (!_stop) {
+    bool idle;
+    {
+      ScopeLock lock(_request_mutex);
+      idle = !_pending && _lod_builds.empty();
+    }
+    if (idle) {
+      _event.wait();
+    }
+
+    ScopeLock job(_job_mutex);
+
+    rectObj bounds;
+    std::vector<Topology*> topologies;
+    Topology* lod_build = nullptr;
+    {
+      ScopeLock lock(_request_mutex);
+      if (_pending) {
+        _pending = false;
+        _cancel = false;
+        bounds = _bounds;
+        topologies.swap(_topologies);
+      } else if (!_lod_builds.empty()) {
+        lod_build = _lod_builds.front();
+      } else {
+        continue;
+      }
+    }
+
+    for (Topology* topo : topologies) {
+      if (_cancel) {
+        break;
+      }
+      topo->Prefetch(bounds, _cancel);
+    }
+
+    if (lod_build && lod_build->BuildLod()) {
+      ScopeLock lock(_request_mutex);
+      // queue can have been cleared by Cancel() while building
+      if (!_lod_builds.empty() && _lod_builds.front() == lod_build) {
+        _lod_builds.pop_front();
+      }
+    }
+  }
+}
@@ -0,0 +1,87 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   TopologyLoader.h
+ */
+
+#ifndef TOPOLOGY_TOPOLOGYLOADER_H
+#define TOPOLOGY_TOPOLOGYLOADER_H
+
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Thread/Mutex.hpp"
+#include "Topology/shapelib/mapprimitive.h"
+#include <atomic>
+#include <deque>
+#include <vector>
+
+class Topology;
+
+/**
+ * Background thread used to read topology shapes before they become visible.
+ *
+ * Draw thread call Request() with bounds predicted for next cache update,
+ * shapes are read by Topology::Prefetch() and moved to shape cache by next
+ * Topology::updateCache().
+ *
+ * Missing LOD cache files are built when there is no pending request, a few
+ * shapes at a time so requests are never delayed much.
+ *
+ * Request() and Cancel() must be called with TerrainDataGraphics locked, so
+ * Topology objects can't be deleted while a request is pending.
+ */
+class TopologyLoader final : private Poco::Runnable {
+public:
+  TopologyLoader();
+
+  TopologyLoader(const TopologyLoader&) = delete;
+  TopologyLoader& operator=(const TopologyLoader&) = delete;
+
+  void Start();
+  void Stop();
+
+  /**
+   * replace pending request, running one is aborted.
+   * does nothing if thread is not started.
+   */
+  void Request(const rectObj& bounds, std::vector<Topology*>&& topologies);
+
+  /**
+   * queue LOD cache build of @topology, processed by Topology::BuildLod()
+   * once thread is started.
+   */
+  void RequestLodBuild(Topology* topology);
+
+  /**
+   * drop pending request and wait end of running one.
+   */
+  void Cancel();
+
+  bool IsRunning() const {
+    return _running;
+  }
+
+private:
+  void run() override;
+
+  Poco::Thread _thread;
+  Poco::Event _event;
+
+  Mutex _request_mutex; // protect pending request and LOD builds
+  Mutex _job_mutex; // locked while a request is processed
+
+  bool _pending = false;
+  rectObj _bounds = {};
+  std::vector<Topology*> _topologies;
+  std::deque<Topology*> _lod_builds;
+
+  std::atomic<bool> _running = {};
+  std::atomic<bool> _cancel = {};
+  std::atomic<bool> _stop = {};
+};
+
+extern TopologyLoader TopoLoader;
+
+#endif // TOPOLOGY_TOPOLOGYLOADER_H
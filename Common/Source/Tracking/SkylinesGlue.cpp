@@ -12,9 +12,10 @@
 #include "Defines.h"
 #include "NavFunctions.h"
 #include "Util/TruncateString.hpp"
+#include "Thread/StatMutex.hpp"
 
 extern NMEA_INFO GPS_INFO;
-extern Mutex CritSec_FlightData;
+extern StatMutex CritSec_FlightData;
 extern double LastFlarmCommandTime;
 
 #ifdef HAVE_SKYLINES_TRACKING_HANDLER
@@ -28,7 +29,7 @@ void SkylinesGlue::OnTraffic(uint32_t pilot_id, unsigned time_of_day_ms,
 
     tstring pilote_name = WithLock(data.mutex, &SkyLinesTracking::Data::GetUserName, data, pilot_id);
 
-    const ScopeLock protect(CritSec_FlightData);
+    const StatScopeLock protect(CritSec_FlightData);
 
 	double Time_Fix = GPS_INFO.Time;
 
@@ -91,7 +92,7 @@ void SkylinesGlue::OnTraffic(uint32_t pilot_id, unsigned time_of_day_ms,
 void SkylinesGlue::OnUserName(uint32_t user_id, const TCHAR *name) {
     TrackingGlue::OnUserName(user_id, name);
 
-    const ScopeLock protect(CritSec_FlightData);
+    const StatScopeLock protect(CritSec_FlightData);
 
     int flarm_slot = FLARM_FindSlot(&GPS_INFO, user_id);
     if (flarm_slot < 0) {
@@ -9,11 +9,16 @@
 #include "externs.h"
 #include "Waypointparser.h"
 #include "LKStyle.h"
+#include "WaypointIndex.h"
 
 
 int FindMatchingWaypoint(WAYPOINT *waypoint) {
 
-    for (unsigned i=NUMRESWP; i<WayPointList.size(); ++i) {
+    std::vector<int> candidates;
+    WayPointIndex.Box(waypoint->Latitude-1.0e-6, waypoint->Latitude+1.0e-6,
+                      waypoint->Longitude-1.0e-6, waypoint->Longitude+1.0e-6, candidates);
+
+    for (int i : candidates) {
         if (_tcscmp(waypoint->Name, WayPointList[i].Name)!=0) continue; // if different name, no match
         // if same name, lat lon and flags must be the same in order to match a previously existing waypoint
         if ((fabs(waypoint->Latitude-WayPointList[i].Latitude)<1.0e-6) &&
@@ -28,7 +33,11 @@ int FindMatchingWaypoint(WAYPOINT *waypoint) {
 int FindMatchingAirfield(WAYPOINT *waypoint) {
 
     const double limit=0.00899928005; //1 Km expressed in deg
-    for (unsigned i=NUMRESWP; i<WayPointList.size(); ++i) {
+    std::vector<int> candidates;
+    WayPointIndex.Box(waypoint->Latitude-limit, waypoint->Latitude+limit,
+                      waypoint->Longitude-limit, waypoint->Longitude+limit, candidates);
+
+    for (int i : candidates) {
         if(WayPointList[i].Style>=STYLE_AIRFIELDGRASS && //if it is any kind of airport/airfield
                 WayPointList[i].Style<=STYLE_AIRFIELDSOLID &&
                 (fabs(waypoint->Latitude-WayPointList[i].Latitude)<limit) && //and if coordinates within 1 Km range
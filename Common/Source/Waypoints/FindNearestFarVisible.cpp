@@ -9,6 +9,7 @@
 #include "externs.h"
 #include "Waypointparser.h"
 #include "NavFunctions.h"
+#include "WaypointIndex.h"
 
 
 
@@ -17,7 +18,7 @@
 int FindNearestFarVisibleWayPoint(double X, double Y, double maxRange, short wpType)
 {
   int nearestIndex = -1;
-  double nearestDistance, dist;
+  double nearestDistance;
 
   #if TESTBENCH
   int farvisibles=0;
@@ -26,21 +27,19 @@ int FindNearestFarVisibleWayPoint(double X, double Y, double maxRange, short wpT
   if(WayPointList.size() <= NUMRESWP ) return -1;
   nearestDistance = maxRange;
 
-  for(unsigned i=NUMRESWP; i<WayPointList.size(); ++i) {
-
-	if (!WayPointList[i].FarVisible) continue;
-	if (wpType && (WayPointCalc[i].WpType != wpType)) continue;
+  const std::vector<int> nearest = WayPointIndex.Nearest(Y, X, 1, maxRange, [&](int i) {
+	if (!WayPointList[i].FarVisible) return false;
+	if (wpType && (WayPointCalc[i].WpType != wpType)) return false;
 
 	#if TESTBENCH
 	farvisibles++;
 	#endif
+	return true;
+  });
 
-	DistanceBearing(Y,X, WayPointList[i].Latitude, WayPointList[i].Longitude, &dist, NULL);
-
-	if(dist < nearestDistance) {
-		nearestIndex = i;
-		nearestDistance = dist;
-	}
+  if (!nearest.empty()) {
+	nearestIndex = nearest.front();
+	DistanceBearing(Y,X, WayPointList[nearestIndex].Latitude, WayPointList[nearestIndex].Longitude, &nearestDistance, NULL);
   }
 
   #if TESTBENCH
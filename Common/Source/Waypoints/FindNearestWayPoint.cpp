@@ -10,10 +10,10 @@
 #include "Waypointparser.h"
 #include "LKStyle.h"
 #include "NavFunctions.h"
+#include "WaypointIndex.h"
 
 
 
-// This is slow, careful!
 int FindNearestWayPoint(double X, double Y, double MaxRange)
 {
   int NearestIndex = -1;
@@ -21,10 +21,9 @@ int FindNearestWayPoint(double X, double Y, double MaxRange)
 
   NearestDistance = MaxRange;
 
-    for(unsigned i=RESWP_FIRST_MARKER;i<WayPointList.size(); ++i) {
-
-      // Consider only valid markers
-      if ( (i<NUMRESWP)  &&  (WayPointCalc[i].WpType!=WPT_TURNPOINT) ) continue;
+    // Consider only valid markers
+    for(unsigned i=RESWP_FIRST_MARKER;i<NUMRESWP && i<WayPointList.size(); ++i) {
+      if (WayPointCalc[i].WpType!=WPT_TURNPOINT) continue;
 
       // Ignore Thermal Hotspot
       if (WayPointList[i].Style == STYLE_THERMAL) {
@@ -39,6 +38,20 @@ int FindNearestWayPoint(double X, double Y, double MaxRange)
         NearestDistance = Dist;
       }
     }
+
+    const std::vector<int> nearest = WayPointIndex.Nearest(Y, X, 1, MaxRange, [](int i) {
+      // Ignore Thermal Hotspot
+      return WayPointList[i].Style != STYLE_THERMAL;
+    });
+    if (!nearest.empty()) {
+      DistanceBearing(Y,X,
+                      WayPointList[nearest.front()].Latitude,
+                      WayPointList[nearest.front()].Longitude, &Dist, NULL);
+      if(Dist < NearestDistance) {
+        NearestIndex = nearest.front();
+        NearestDistance = Dist;
+      }
+    }
    if(NearestIndex == -1) {
        return -1;
    }
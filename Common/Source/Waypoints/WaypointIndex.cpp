@@ -0,0 +1,352 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   WaypointIndex.cpp
+ */
+
+#include "externs.h"
+#include "NavFunctions.h"
+#include "WaypointIndex.h"
+#include "Util/Clamp.hpp"
+#include <algorithm>
+#include <cmath>
+
+WaypointIndex WayPointIndex(WayPointList);
+
+namespace {
+  constexpr double MIN_CELL = 0.05; // degree
+  constexpr double MAX_CELL = 5.; // degree
+  constexpr size_t ITEMS_PER_CELL = 4;
+  constexpr size_t MAX_CELLS = 1 << 20;
+
+  // lower bound of meters per degree on WGS84 ellipsoid, used to build
+  // search box large enough for any earth model.
+  constexpr double METER_PER_DEGREE = 110000.;
+}
+
+void WaypointIndex::Invalidate() {
+  ScopeLock lock(_mutex);
+  _valid = false;
+}
+
+void WaypointIndex::Update() {
+  if (_valid && _size == _list.size()) {
+    return;
+  }
+
+  _valid = true;
+  _size = _list.size();
+  _items.clear();
+  _cell_begin.clear();
+  _cols = 0;
+  _rows = 0;
+
+  if (_size <= NUMRESWP) {
+    return;
+  }
+
+  _items.reserve(_size - NUMRESWP);
+
+  double lat_max = -90, lon_max = -180;
+  _lat_min = 90;
+  _lon_min = 180;
+  for (size_t i = NUMRESWP; i < _size; ++i) {
+    const WAYPOINT& wp = _list[i];
+    _items.push_back({ static_cast<int>(i), wp.Latitude, wp.Longitude });
+    _lat_min = std::min(_lat_min, wp.Latitude);
+    _lon_min = std::min(_lon_min, wp.Longitude);
+    lat_max = std::max(lat_max, wp.Latitude);
+    lon_max = std::max(lon_max, wp.Longitude);
+  }
+
+  // cell size giving a few waypoints per cell if they were evenly distributed
+  const double width = std::max(lon_max - _lon_min, MIN_CELL);
+  const double height = std::max(lat_max - _lat_min, MIN_CELL);
+  const size_t cells = std::min(MAX_CELLS, std::max<size_t>(1, _items.size() / ITEMS_PER_CELL));
+  _cell = Clamp(std::sqrt(width * height / cells), MIN_CELL, MAX_CELL);
+
+  _cols = static_cast<int>(width / _cell) + 1;
+  _rows = static_cast<int>(height / _cell) + 1;
+  while (static_cast<size_t>(_cols) * _rows > MAX_CELLS) {
+    _cell *= 2;
+    _cols = static_cast<int>(width / _cell) + 1;
+    _rows = static_cast<int>(height / _cell) + 1;
+  }
+
+  auto cell_of = [&](const item_t& item) {
+    const int col = std::min(_cols - 1, static_cast<int>((item.longitude - _lon_min) / _cell));
+    const int row = std::min(_rows - 1, static_cast<int>((item.latitude - _lat_min) / _cell));
+    return row * _cols + col;
+  };
+
+  // counting sort, stable : items stay in ascending index order inside each cell.
+  _cell_begin.assign(_cols * _rows + 1, 0);
+  for (const item_t& item : _items) {
+    ++_cell_begin[cell_of(item) + 1];
+  }
+  for (size_t i = 1; i < _cell_begin.size(); ++i) {
+    _cell_begin[i] += _cell_begin[i - 1];
+  }
+  std::vector<item_t> sorted(_items.size());
+  std::vector<unsigned> next(_cell_begin.begin(), std::prev(_cell_begin.end()));
+  for (const item_t& item : _items) {
+    sorted[next[cell_of(item)]++] = item;
+  }
+  _items.swap(sorted);
+
+#if TESTBENCH
+  StartupStore(_T(". WaypointIndex : %u waypoints, %dx%d cells of %.2f deg" NEWLINE),
+               static_cast<unsigned>(_items.size()), _cols, _rows, _cell);
+#endif
+}
+
+template<typename Callback>
+void WaypointIndex::ForEach(double lat_min, double lat_max, double lon_min, double lon_max, Callback&& callback) const {
+  if (_items.empty()) {
+    return;
+  }
+
+  auto to_cell = [&](double value, double origin, int size) {
+    return Clamp(static_cast<int>(std::floor((value - origin) / _cell)), 0, size - 1);
+  };
+
+  const int col_min = to_cell(lon_min, _lon_min, _cols);
+  const int col_max = to_cell(lon_max, _lon_min, _cols);
+  const int row_min = to_cell(lat_min, _lat_min, _rows);
+  const int row_max = to_cell(lat_max, _lat_min, _rows);
+
+  for (int row = row_min; row <= row_max; ++row) {
+    // cells of one row are contiguous
+    const unsigned begin = _cell_begin[row * _cols + col_min];
+    const unsigned end = _cell_begin[row * _cols + col_max + 1];
+    for (unsigned i = begin; i < end; ++i) {
+      const item_t& item = _items[i];
+      if (item.latitude >= lat_min && item.latitude <= lat_max
+              && item.longitude >= lon_min && item.longitude <= lon_max) {
+        callback(item);
+      }
+    }
+  }
+}
+
+void WaypointIndex::Box(double lat_min, double lat_max, double lon_min, double lon_max, std::vector<int>& out) {
+  out.clear();
+  {
+    ScopeLock lock(_mutex);
+    Update();
+    ForEach(lat_min, lat_max, lon_min, lon_max, [&](const item_t& item) {
+      out.push_back(item.index);
+    });
+  }
+  std::sort(out.begin(), out.end());
+}
+
+void WaypointIndex::Candidates(double lat, double lon, double range, std::vector<std::pair<double, int>>& out) {
+  out.clear();
+
+  const double dlat = range / METER_PER_DEGREE;
+  const double lat_min = lat - dlat;
+  const double lat_max = lat + dlat;
+
+  double dlon = 180;
+  const double max_abs_lat = std::max(std::fabs(lat_min), std::fabs(lat_max));
+  if (max_abs_lat < 89) {
+    dlon = std::min(dlon, dlat / std::cos(max_abs_lat * DEG_TO_RAD));
+  }
+
+  auto add = [&](const item_t& item) {
+    double distance;
+    DistanceBearing(lat, lon, item.latitude, item.longitude, &distance, nullptr);
+    if (distance <= range) {
+      out.emplace_back(distance, item.index);
+    }
+  };
+
+  ScopeLock lock(_mutex);
+  Update();
+  if (dlon >= 180) {
+    ForEach(lat_min, lat_max, -180, 180, add);
+    return;
+  }
+  ForEach(lat_min, lat_max, std::max(-180., lon - dlon), std::min(180., lon + dlon), add);
+  // box crossing antimeridian
+  if (lon - dlon < -180) {
+    ForEach(lat_min, lat_max, lon - dlon + 360, 180, add);
+  }
+  if (lon + dlon > 180) {
+    ForEach(lat_min, lat_max, -180, lon + dlon - 360, add);
+  }
+}
+
+void WaypointIndex::Radius(double lat, double lon, double range, std::vector<int>& out) {
+  std::vector<std::pair<double, int>> candidates;
+  Candidates(lat, lon, range, candidates);
+
+  out.clear();
+  out.reserve(candidates.size());
+  for (const auto& c : candidates) {
+    out.push_back(c.second);
+  }
+  std::sort(out.begin(), out.end());
+}
+
+std::vector<int> WaypointIndex::Nearest(double lat, double lon, size_t count, double range, const filter_t& filter) {
+  std::vector<std::pair<double, int>> candidates;
+  Candidates(lat, lon, range, candidates);
+
+  if (filter) {
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](const std::pair<double, int>& c) {
+      return !filter(c.second);
+    }), candidates.end());
+  }
+
+  // sort by distance, then by index
+  count = std::min(count, candidates.size());
+  std::partial_sort(candidates.begin(), std::next(candidates.begin(), count), candidates.end());
+
+  std::vector<int> out;
+  out.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    out.push_back(candidates[i].second);
+  }
+  return out;
+}
+
+#ifndef DOCTEST_CONFIG_DISABLE
+#include <doctest/doctest.h>
+#include <chrono>
+#include <random>
+
+namespace {
+
+  // reserved waypoints followed by @count waypoints spread over central Europe.
+  std::vector<WAYPOINT> RandomWaypoints(size_t count) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> lat(42., 55.);
+    std::uniform_real_distribution<double> lon(-5., 25.);
+
+    std::vector<WAYPOINT> list(NUMRESWP + count, WAYPOINT{});
+    for (size_t i = NUMRESWP; i < list.size(); ++i) {
+      list[i].Latitude = lat(gen);
+      list[i].Longitude = lon(gen);
+    }
+    return list;
+  }
+
+  std::vector<std::pair<double, int>> BruteForce(const std::vector<WAYPOINT>& list, double lat, double lon, double range) {
+    std::vector<std::pair<double, int>> out;
+    for (size_t i = NUMRESWP; i < list.size(); ++i) {
+      double distance;
+      DistanceBearing(lat, lon, list[i].Latitude, list[i].Longitude, &distance, nullptr);
+      if (distance <= range) {
+        out.emplace_back(distance, i);
+      }
+    }
+    return out;
+  }
+}
+
+TEST_SUITE("WaypointIndex") {
+
+  TEST_CASE("radius") {
+    const std::vector<WAYPOINT> list = RandomWaypoints(5000);
+    WaypointIndex index(list);
+
+    std::vector<int> result;
+    for (double lat = 42.; lat < 56.; lat += 1.3) {
+      for (double lon = -6.; lon < 26.; lon += 2.1) {
+        for (double range : { 1000., 20000., 150000. }) {
+          index.Radius(lat, lon, range, result);
+
+          std::vector<int> expected;
+          for (const auto& c : BruteForce(list, lat, lon, range)) {
+            expected.push_back(c.second);
+          }
+          CHECK(result == expected);
+        }
+      }
+    }
+  }
+
+  TEST_CASE("nearest") {
+    const std::vector<WAYPOINT> list = RandomWaypoints(5000);
+    WaypointIndex index(list);
+
+    auto even = [](int i) { return (i % 2) == 0; };
+
+    std::vector<int> result = index.Nearest(48.5, 7.5, 5, 50000., even);
+    std::vector<std::pair<double, int>> expected = BruteForce(list, 48.5, 7.5, 50000.);
+    expected.erase(std::remove_if(expected.begin(), expected.end(), [&](const std::pair<double, int>& c) {
+      return !even(c.second);
+    }), expected.end());
+    std::sort(expected.begin(), expected.end());
+
+    REQUIRE(result.size() == 5);
+    for (size_t i = 0; i < result.size(); ++i) {
+      CHECK(result[i] == expected[i].second);
+    }
+
+    CHECK(index.Nearest(48.5, 7.5, 1, 1., nullptr).empty());
+  }
+
+  TEST_CASE("box and update") {
+    std::vector<WAYPOINT> list = RandomWaypoints(100);
+    WaypointIndex index(list);
+
+    std::vector<int> result;
+    index.Box(-90, 90, -180, 180, result);
+    CHECK(result.size() == 100);
+
+    // new waypoint is indexed on next query
+    WAYPOINT wp = {};
+    wp.Latitude = 60.;
+    wp.Longitude = 179.9;
+    list.push_back(wp);
+    index.Box(59.9, 60.1, 179.8, 180, result);
+    REQUIRE(result.size() == 1);
+    CHECK(result[0] == static_cast<int>(list.size() - 1));
+
+    // moved waypoint requires Invalidate()
+    list.back().Longitude = -179.9;
+    index.Invalidate();
+    index.Box(59.9, 60.1, 179.8, 180, result);
+    CHECK(result.empty());
+
+    // radius around antimeridian
+    index.Radius(60., 179.95, 10000., result);
+    REQUIRE(result.size() == 1);
+    CHECK(result[0] == static_cast<int>(list.size() - 1));
+  }
+
+  TEST_CASE("radius benchmark" * doctest::skip()) {
+    const std::vector<WAYPOINT> list = RandomWaypoints(50000);
+    WaypointIndex index(list);
+
+    using clock = std::chrono::steady_clock;
+    constexpr int loops = 1000;
+
+    size_t brute_count = 0;
+    auto start = clock::now();
+    for (int i = 0; i < loops; ++i) {
+      brute_count += BruteForce(list, 45. + i * 0.005, 2. + i * 0.01, 20000.).size();
+    }
+    const auto brute = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+
+    size_t index_count = 0;
+    std::vector<int> result;
+    index.Radius(45., 2., 1., result); // build index
+    start = clock::now();
+    for (int i = 0; i < loops; ++i) {
+      index.Radius(45. + i * 0.005, 2. + i * 0.01, 20000., result);
+      index_count += result.size();
+    }
+    const auto grid = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+
+    CHECK(brute_count == index_count);
+    MESSAGE("50000 waypoints, 20km radius : brute force " << (brute / loops) << "us, index " << (grid / loops) << "us");
+  }
+}
+
+#endif
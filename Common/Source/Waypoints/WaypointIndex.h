@@ -0,0 +1,90 @@
+/*
+ * LK8000 Tactical Flight Computer -  WWW.LK8000.IT
+ * Released under GNU/GPL License v.2 or later
+ * See CREDITS.TXT file for authors and copyrights
+ *
+ * File:   WaypointIndex.h
+ */
+
+#ifndef _Waypoints_WaypointIndex_h_
+#define _Waypoints_WaypointIndex_h_
+
+#include "Thread/Mutex.hpp"
+#include <functional>
+#include <vector>
+
+struct WAYPOINT;
+
+/**
+ * Lat/lon bucket grid over waypoint list, used to avoid scanning all
+ * waypoints for range and nearest queries.
+ *
+ * Only waypoints loaded from files are indexed (index >= NUMRESWP), reserved
+ * waypoints are moving all the time and must be checked by caller.
+ *
+ * Index is rebuilt on next query when list size change or after
+ * Invalidate(). Caller must call Invalidate() after changing the position of
+ * an existing waypoint.
+ */
+class WaypointIndex final {
+public:
+  explicit WaypointIndex(const std::vector<WAYPOINT>& list) : _list(list) { }
+
+  WaypointIndex(const WaypointIndex&) = delete;
+  WaypointIndex& operator=(const WaypointIndex&) = delete;
+
+  void Invalidate();
+
+  /**
+   * Fill @out with index of waypoints inside box, in ascending order.
+   * box is not wrapped around antimeridian.
+   */
+  void Box(double lat_min, double lat_max, double lon_min, double lon_max, std::vector<int>& out);
+
+  /**
+   * Fill @out with index of waypoints within @range meters of @lat,@lon, in
+   * ascending order.
+   */
+  void Radius(double lat, double lon, double range, std::vector<int>& out);
+
+  using filter_t = std::function<bool(int)>;
+
+  /**
+   * @return up to @count index of waypoints within @range meters accepted by
+   *         @filter, nearest first.
+   */
+  std::vector<int> Nearest(double lat, double lon, size_t count, double range, const filter_t& filter);
+
+private:
+  struct item_t {
+    int index;
+    double latitude;
+    double longitude;
+  };
+
+  void Update();
+
+  void Candidates(double lat, double lon, double range, std::vector<std::pair<double, int>>& out);
+
+  template<typename Callback>
+  void ForEach(double lat_min, double lat_max, double lon_min, double lon_max, Callback&& callback) const;
+
+  const std::vector<WAYPOINT>& _list;
+
+  Mutex _mutex;
+  bool _valid = false;
+  size_t _size = 0; // size of the list when index was built
+
+  double _lat_min = 0;
+  double _lon_min = 0;
+  double _cell = 1; // degree
+  int _cols = 0;
+  int _rows = 0;
+
+  std::vector<unsigned> _cell_begin; // [_rows * _cols + 1], offset of first item of each cell
+  std::vector<item_t> _items; // sorted by cell, then by index
+};
+
+extern WaypointIndex WayPointIndex;
+
+#endif // _Waypoints_WaypointIndex_h_
@@ -38,6 +38,8 @@
 #include "ChangeScreen.h"
 #include "IO/Async/GlobalIOThread.hpp"
 #include "Tracking/Tracking.h"
+#include "Topology/TopologyLoader.h"
+#include "ReachabilityEngine.h"
 
 WndMain::WndMain() : WndMainBase(), _MouseButtonDown(), _isRunning() {
 }
@@ -137,6 +139,9 @@ void BeforeShutdown(void) {
   StartupStore(TEXT(".... CloseTerrainTopology%s"),NEWLINE);
   #endif
 
+  ReachEngine.Stop();
+  TopoLoader.Stop();
+
   LockTerrainDataGraphics();
   CloseTopology();
   CloseTerrainRenderer();
@@ -175,6 +180,7 @@ void BeforeShutdown(void) {
 
   // Wait end of Calculation thread before deinit critical section.
   WaitThreadCalculation();
+  CContestMgr::Instance().StopOptimizer();
 
   #if TESTBENCH
   StartupStore(TEXT(".... Close Calculations%s"),NEWLINE);
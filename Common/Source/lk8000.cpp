@@ -53,11 +53,15 @@
 #include <OS/RotateScreen.h>
 #include <dlgFlarmIGCDownload.h>
 #include <memory>
+#include <optional>
 #include "Calc/Vario.h"
 #include "IO/Async/GlobalIOThread.hpp"
 #include "Tracking/Tracking.h"
 #include "Waypoints/SetHome.h"
 #include "Baro.h"
+#include "Topology/TopologyLoader.h"
+#include "ReachabilityEngine.h"
+#include "Thread/TaskGraph.hpp"
 
 #ifdef __linux__
 #include <sys/utsname.h>
@@ -87,6 +91,7 @@ extern bool LKProfileLoad(const TCHAR *szFile);
 
 
 static bool realexitforced=false;
+static bool replayfailed=false;
 
 void DetectKeyboardModel() {
 #ifdef ANDROID
@@ -281,8 +286,16 @@ bool Startup(const TCHAR* szCmdLine) {
   if (!LK8000GetOpts(szCmdLine)) return 0;
 #endif
 
+  // needed by calculations, also in headless replay
   InitSineTable();
 
+  if (ReplayBatch::IsRequested()) {
+    // headless replay, no window : program exit when replay is done.
+    replayfailed = !ReplayBatch::Run();
+    realexitforced = true;
+    return false;
+  }
+
   main_window = std::make_unique<WndMain>();
 
   // Perform application initialization: also ScreenGeometry and LKIBLSCALE, and Objects
@@ -328,8 +341,7 @@ bool Startup(const TCHAR* szCmdLine) {
   memset( &(GPS_INFO), 0, sizeof(GPS_INFO));
   memset( &(CALCULATED_INFO), 0,sizeof(CALCULATED_INFO));
 
-  memset( SnailTrail, 0, sizeof(SnailTrail));
-  memset( LongSnailTrail, 0, sizeof(LongSnailTrail));
+  FullTrail.Clear();
 
   ResetBaroAvailable(GPS_INFO);
   ResetVarioAvailable(GPS_INFO);
@@ -407,24 +419,44 @@ bool Startup(const TCHAR* szCmdLine) {
     CreateProgressDialog(MsgToken(1215));
   }
 
-  LockTerrainDataGraphics();
-  RasterTerrain::OpenTerrain();
-  UnlockTerrainDataGraphics();
-
-  ReadWayPoints();
-  StartupStore(_T(". LOADED %d WAYPOINTS + %u virtuals%s"),(unsigned)WayPointList.size()-NUMRESWP,NUMRESWP,NEWLINE);
-  InitLDRotary(&rotaryLD);
-  InitWindRotary(&rotaryWind); // 100103
-  MapWindow::zoom.Reset();
-  InitLK8000();
-  ReadAirfieldFile();
-  SetHome(false);
+  // messages are used by all loading tasks, language file can't be reloaded while they are running.
   LKLoadLanguageFile();
 
-  CreateProgressDialog(MsgToken(399));
-  CAirspaceManager::Instance().ReadAirspaces();
-  CAirspaceManager::Instance().SortAirspaces();
-  OpenTopology();
+  // Terrain, waypoints, airspaces and topology are loaded concurrently.
+  // Draw and calculation threads are not yet running, only dependencies between files matter.
+  // Tasks which can show a message box or load bitmaps are run by main thread.
+  TaskGraph startup;
+
+  const auto terrain = startup.Add(_T("Terrain"), []() {
+    RasterTerrain::OpenTerrain();
+  });
+
+  startup.Add(_T("Topology"), []() {
+    OpenTopology();
+  }, {}, true);
+
+  // altitude of waypoints and terrain range check need terrain
+  startup.Add(_T("Waypoints"), []() {
+    ReadWayPoints();
+    StartupStore(_T(". LOADED %d WAYPOINTS + %u virtuals%s"),(unsigned)WayPointList.size()-NUMRESWP,NUMRESWP,NEWLINE);
+    InitLDRotary(&rotaryLD);
+    InitWindRotary(&rotaryWind); // 100103
+    MapWindow::zoom.Reset();
+    InitLK8000();
+    ReadAirfieldFile();
+    SetHome(false);
+  }, { terrain }, true);
+
+  // AGL airspace altitude and terrain range check need terrain
+  startup.Add(_T("Airspaces"), []() {
+    CAirspaceManager::Instance().ReadAirspaces(false);
+    CAirspaceManager::Instance().SortAirspaces();
+  }, { terrain });
+
+  startup.Run(2);
+
+  // airspaces parse errors can't be shown by worker thread.
+  CAirspaceManager::Instance().ShowParseWarnings();
 
   CreateProgressDialog(MsgToken(1808));	// Loading FLARMNET database
   OpenFLARMDetails();
@@ -474,6 +506,9 @@ bool Startup(const TCHAR* szCmdLine) {
   GlobalRunning = true;
 	
 	InitAirspaceSonar();
+	CContestMgr::Instance().StartOptimizer();
+	TopoLoader.Start();
+	ReachEngine.Start();
 
 #ifndef ANDROID
     if (WarningHomeDir) {
@@ -511,6 +546,10 @@ bool Startup(const TCHAR* szCmdLine) {
 }
 
 void Shutdown() {
+  if (!main_window) {
+    // Startup stopped before window creation (command line help or headless replay)
+    return;
+  }
   main_window->Destroy();
   Message::Destroy();
 
@@ -545,6 +584,8 @@ void Shutdown() {
 //  111 for normal program termination with automatic relaunch, if using lkrun
 //  222 for normal program termination, with request to quit lkrun if running
 //
+//  1 for headless replay failure
+//
 //  259 is reserved by OS (STILL_ACTIVE) status
 #ifdef WIN32
 HINSTANCE _hInstance;
@@ -600,7 +641,14 @@ int main(int argc, char *argv[]) {
   }
 #endif
 
-  ScreenGlobalInit InitScreen;
+  // headless replay (see ReplayBatch) must run without display.
+  std::optional<ScreenGlobalInit> InitScreen;
+#if !defined(UNDER_CE) || (defined(__linux__) && !defined(ANDROID))
+  if (!LK8000GetReplayOpt(szCmdLine))
+#endif
+  {
+    InitScreen.emplace();
+  }
   SoundGlobalInit InitSound;
   
   std::unique_ptr<CScreenOrientation> pSaveScreen(new CScreenOrientation(LKGetLocalPath()));
@@ -641,6 +689,7 @@ int main(int argc, char *argv[]) {
   }
 #endif
 
+  if (replayfailed) return 1;
   if (realexitforced) return 222;
   else return 111;
 }
@@ -13,6 +13,7 @@
 #define	FILESYSTEM_H
 #include "tchar.h"
 #include <string.h>
+#include <cstdint>
 
 namespace lk {
     namespace filesystem {
@@ -28,6 +29,9 @@ namespace lk {
 
         size_t getFileSize(const TCHAR* szPath);
 
+        // last modification time of file, unit depends on platform, 0 if unknown
+        uint64_t getLastWriteTime(const TCHAR* szPath);
+
         inline bool isDots(const TCHAR* szName) {
             return ((_tcscmp(szName, _T(".")) == 0) || (_tcscmp(szName, _T("..")) == 0));
         }
@@ -63,6 +67,9 @@ namespace lk {
         // user directory ( ".../MyDocument/" on Windows, "/home/username/" on linux )
         bool getUserPath(TCHAR* szPath, size_t MaxSize);
 
+        // directory for temporary files, included trail path separator
+        bool getTempPath(TCHAR* szPath, size_t MaxSize);
+
         // fix directory separator
         void fixPath(TCHAR* szPath);
 
@@ -284,6 +284,22 @@ bool lk::filesystem::getUserPath(TCHAR* szPath, size_t MaxSize) {
 }
 #endif
 
+bool lk::filesystem::getTempPath(TCHAR* szPath, size_t MaxSize) {
+    const char* szTmp = getenv("TMPDIR");
+    if (!szTmp || szTmp[0] == '\0') {
+        szTmp = "/tmp";
+    }
+    const size_t n = strlen(szTmp);
+    if (n + 2 > MaxSize) {
+        return false;
+    }
+    strcpy(szPath, szTmp);
+    if (szPath[n - 1] != '/') {
+        _tcscat(szPath, "/");
+    }
+    return true;
+}
+
 void lk::filesystem::fixPath(TCHAR* szPath) {
     TCHAR * sz = _tcsstr(szPath, _T("\\"));
     while(sz) {
@@ -300,3 +316,12 @@ size_t lk::filesystem::getFileSize(const TCHAR* szPath) {
 
     return st.st_size;
 }
+
+uint64_t lk::filesystem::getLastWriteTime(const TCHAR* szPath) {
+    struct stat st;
+    if (stat(szPath, &st) < 0 || !S_ISREG(st.st_mode)) {
+        return 0;
+    }
+
+    return st.st_mtime;
+}
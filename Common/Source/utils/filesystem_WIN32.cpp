@@ -196,6 +196,11 @@ bool lk::filesystem::getUserPath(TCHAR* szPath, size_t MaxSize) {
     return false;
 }
 
+bool lk::filesystem::getTempPath(TCHAR* szPath, size_t MaxSize) {
+    const DWORD n = GetTempPath(MaxSize, szPath);
+    return (n > 0 && n < MaxSize);
+}
+
 void lk::filesystem::fixPath(TCHAR* szPath) {
     TCHAR * sz = _tcsstr(szPath, _T("/"));
     while(sz) {
@@ -213,3 +218,13 @@ size_t lk::filesystem::getFileSize(const TCHAR* szPath) {
 
     return data.nFileSizeLow | (uint64_t(data.nFileSizeHigh) << 32);
 }
+
+uint64_t lk::filesystem::getLastWriteTime(const TCHAR* szPath) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesEx(szPath, GetFileExInfoStandard, &data) ||
+            (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+        return 0;
+    }
+
+    return data.ftLastWriteTime.dwLowDateTime | (uint64_t(data.ftLastWriteTime.dwHighDateTime) << 32);
+}
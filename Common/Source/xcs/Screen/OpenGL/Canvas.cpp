@@ -309,6 +309,47 @@ Canvas::DrawPolygon(const RasterPoint *points, unsigned num_points)
   }
 }
 
+void
+Canvas::DrawPolygon(const TessellatedPolygon &fill, const FloatPoint *fill_points,
+                    const RasterPoint *points, unsigned num_points)
+{
+  if (brush.IsHollow() && !pen.IsDefined())
+    return;
+
+#ifdef USE_GLSL
+  OpenGL::solid_shader->Use();
+#endif
+
+  if (!brush.IsHollow()) {
+    brush.Bind();
+
+    std::unique_ptr<const ScopeAlphaBlend> blend;
+    if(!brush.IsOpaque()) {
+      blend = std::make_unique<const ScopeAlphaBlend>();
+    }
+
+    fill.Draw(fill_points);
+  }
+
+  if (IsPenOverBrush() && num_points >= 2) {
+    pen.Bind();
+
+    if (pen.GetWidth() <= OpenGL::max_line_width) {
+      ScopeVertexPointer vp(points);
+      glDrawArrays(GL_LINE_LOOP, 0, num_points);
+    } else {
+      unsigned vertices = LineToTriangles(points, num_points, vertex_buffer,
+                                          pen.GetWidth(), true);
+      if (vertices > 0) {
+        ScopeVertexPointer vp(vertex_buffer.begin());
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices);
+      }
+    }
+
+    pen.Unbind();
+  }
+}
+
 void
 Canvas::DrawTriangleFan(const RasterPoint *points, unsigned num_points)
 {
@@ -54,6 +54,7 @@ Copyright_License {
 class Angle;
 class Bitmap;
 class GLTexture;
+class TessellatedPolygon;
 template<class T> class AllocatedArray;
 
 /**
@@ -278,6 +279,13 @@ public:
 
   void DrawPolygon(const RasterPoint *points, unsigned num_points);
 
+  /**
+   * Same as above, but fill using already tessellated polygon.
+   * @fill_points : vertices of @fill converted to screen coordinate.
+   */
+  void DrawPolygon(const TessellatedPolygon &fill, const FloatPoint *fill_points,
+                   const RasterPoint *points, unsigned num_points);
+
   /**
    * Draw a triangle fan (GL_TRIANGLE_FAN).  The first point is the
    * origin of the fan.
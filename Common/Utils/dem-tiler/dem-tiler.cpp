@@ -0,0 +1,115 @@
+/*
+ * convert raw LK8000 .DEM terrain file to tiled layout
+ *
+ *  usage : dem-tiler <input.DEM> <output.DEM>
+ *
+ * see Common/Source/Terrain/DEMFormat.h for file layout.
+ */
+
+#include "../../Source/Terrain/DEMFormat.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+    uint32_t PageSize() {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        const long size = info.dwPageSize;
+#else
+        const long size = sysconf(_SC_PAGESIZE);
+#endif
+        return IsValidDEMAlign(size) ? size : 4096;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "usage : " << argv[0] << " <input.DEM> <output.DEM>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "failed to open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    TILED_DEM_HEADER header = {};
+    memcpy(header.Magic, DEM_TILED_MAGIC, sizeof(header.Magic));
+    header.Version = DEM_TILED_VERSION;
+    header.TileShift = DEM_TILE_SHIFT;
+    header.DataAlign = PageSize();
+
+    in.read(reinterpret_cast<char*>(&header.Info), sizeof(header.Info));
+    if (!in) {
+        std::cerr << "invalid input file" << std::endl;
+        return 1;
+    }
+    if (memcmp(&header.Info, DEM_TILED_MAGIC, sizeof(DEM_TILED_MAGIC)) == 0) {
+        std::cerr << "input file is already tiled" << std::endl;
+        return 1;
+    }
+
+    const TERRAIN_INFO& info = header.Info;
+    if (!info.StepSize || !info.Rows || !info.Columns) {
+        std::cerr << "invalid terrain header" << std::endl;
+        return 1;
+    }
+
+    const size_t columns = info.Columns;
+    const size_t rows = info.Rows;
+
+    std::vector<int16_t> raw(columns * rows);
+    in.read(reinterpret_cast<char*>(raw.data()), raw.size() * sizeof(int16_t));
+    if (!in) {
+        std::cerr << "input file is truncated" << std::endl;
+        return 1;
+    }
+
+    header.TilesX = DEMTileCount(info.Columns);
+    header.TilesY = DEMTileCount(info.Rows);
+
+    const std::vector<uint32_t> slots = DEMTileSlots(header.TilesX, header.TilesY);
+
+    // padding cells are set to TERRAIN_INVALID
+    std::vector<int16_t> tiles(slots.size() * DEM_TILE_CELLS, 32767);
+    for (size_t y = 0; y < rows; ++y) {
+        for (size_t x = 0; x < columns; ++x) {
+            const size_t slot = slots[(y >> DEM_TILE_SHIFT) * header.TilesX + (x >> DEM_TILE_SHIFT)];
+            const size_t offset = ((y & DEM_TILE_MASK) << DEM_TILE_SHIFT) | (x & DEM_TILE_MASK);
+            tiles[slot * DEM_TILE_CELLS + offset] = raw[y * columns + x];
+        }
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "failed to create " << argv[2] << std::endl;
+        return 1;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(uint32_t));
+
+    const size_t table_end = sizeof(header) + slots.size() * sizeof(uint32_t);
+    const std::vector<char> padding(DEMTiledDataOffset(header.TilesX, header.TilesY, header.DataAlign) - table_end, 0);
+    out.write(padding.data(), padding.size());
+
+    out.write(reinterpret_cast<const char*>(tiles.data()), tiles.size() * sizeof(int16_t));
+    if (!out) {
+        std::cerr << "failed to write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << columns << "x" << rows << " cells, " << header.TilesX << "x" << header.TilesY << " tiles" << std::endl;
+    return 0;
+}
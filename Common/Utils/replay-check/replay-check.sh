@@ -0,0 +1,94 @@
+#!/bin/sh
+#
+# Headless replay regression check.
+#
+#  usage : replay-check.sh <LK8000 executable> [update]
+#
+# IGC and NMEA fixtures are replayed with -replay= in a temporary data
+# directory holding only default profile, polars and language files, then
+# CSV output is compared to reference files. Values must match within a small
+# tolerance, flags must match exactly.
+#
+# With "update", reference files are rewritten from current output.
+#
+
+set -e
+
+if [ -z "$1" ] || [ ! -x "$1" ]; then
+  echo "usage : $0 <LK8000 executable> [update]"
+  exit 2
+fi
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../../.." && pwd)
+EXE=$1
+UPDATE=$2
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+DATA=$WORK/LK8000
+mkdir -p "$DATA/_Language" "$DATA/_Polars" "$DATA/_Logger"
+cp "$EXE" "$DATA/"
+cp "$ROOT/Common/Data/Language/language.json" "$ROOT/Common/Data/Language/Translations/en.json" "$DATA/_Language/"
+cp "$ROOT"/Common/Distribution/LK8000/_Polars/*.plr "$DATA/_Polars/"
+
+FAILED=0
+
+for INPUT in replay.igc replay.nmea; do
+  cp "$HERE/$INPUT" "$DATA/_Logger/"
+
+  # HOME is used for all user data, keep it inside temporary directory.
+  # program exit with 222 (normal termination, no relaunch) when replay is done,
+  # with 1 if replay failed (missing input, unwritable output...).
+  STATUS=0
+  HOME=$WORK "$DATA/$(basename "$EXE")" -replay=$INPUT -csv=$INPUT.csv > "$WORK/$INPUT.log" 2>&1 || STATUS=$?
+  if [ $STATUS -ne 222 ]; then
+    echo "FAILED $INPUT : exit status $STATUS"
+    cat "$WORK/$INPUT.log"
+    FAILED=1
+    continue
+  fi
+  if [ ! -s "$DATA/_Logger/$INPUT.csv" ]; then
+    echo "FAILED $INPUT : no output"
+    cat "$WORK/$INPUT.log"
+    FAILED=1
+    continue
+  fi
+
+  if [ "$UPDATE" = "update" ]; then
+    cp "$DATA/_Logger/$INPUT.csv" "$HERE/$INPUT.csv"
+    echo "UPDATED $INPUT.csv"
+    continue
+  fi
+
+  if awk -F, -v name=$INPUT '
+      function abs(x) { return x < 0 ? -x : x }
+      NR == FNR { ref[FNR] = $0; rows = FNR; next }
+      FNR == 1 {
+        if ($0 != ref[1]) { print name ": header mismatch"; bad = 1 }
+        split($0, title, ",")
+        next
+      }
+      {
+        n = split(ref[FNR], r, ",")
+        if (n != NF) { print name ":" FNR ": field count mismatch"; bad = 1; next }
+        for (i = 1; i <= NF; ++i) {
+          if (abs($i - r[i]) > 0.05 + 0.001 * abs(r[i])) {
+            if (++errors <= 10) print name ":" FNR ": " title[i] " = " $i ", expected " r[i]
+            bad = 1
+          }
+        }
+      }
+      END {
+        if (FNR != rows) { print name ": " FNR " rows, expected " rows; bad = 1 }
+        exit bad
+      }' "$HERE/$INPUT.csv" "$DATA/_Logger/$INPUT.csv"; then
+    echo "OK $INPUT"
+  else
+    echo "FAILED $INPUT"
+    FAILED=1
+  fi
+done
+
+exit $FAILED